@@ -70,6 +70,8 @@ add_library(core
   fboss/agent/DHCPv4Handler.cpp
   fboss/agent/DHCPv6Handler.cpp
   fboss/agent/HwSwitch.cpp
+  fboss/agent/ICMPErrorTemplates.cpp
+  fboss/agent/ICMPRateLimiter.cpp
   fboss/agent/IPHeaderV4.cpp
   fboss/agent/IPv4Handler.cpp
   fboss/agent/IPv6Handler.cpp
@@ -86,6 +88,8 @@ add_library(core
   fboss/agent/MirrorManager.cpp
   fboss/agent/MirrorManagerImpl.cpp
   fboss/agent/NdpCache.cpp
+  fboss/agent/NeighborChangeQueue.cpp
+  fboss/agent/NeighborHoldQueue.cpp
   fboss/agent/NeighborUpdater.cpp
   fboss/agent/NeighborUpdaterImpl.cpp
   fboss/agent/PortUpdateHandler.cpp
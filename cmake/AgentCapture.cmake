@@ -4,6 +4,7 @@
 # cmake/FooBar.cmake
 
 add_library(capture
+  fboss/agent/capture/PacketTap.cpp
   fboss/agent/capture/PcapFile.cpp
   fboss/agent/capture/PcapPkt.cpp
   fboss/agent/capture/PcapQueue.cpp
@@ -6,6 +6,7 @@
 add_library(sai_switch
   fboss/agent/hw/sai/switch/ConcurrentIndices.cpp
   fboss/agent/hw/sai/switch/SaiBridgeManager.cpp
+  fboss/agent/hw/sai/switch/SaiFdbEventQueue.cpp
   fboss/agent/hw/sai/switch/SaiFdbManager.cpp
   fboss/agent/hw/sai/switch/SaiHashManager.cpp
   fboss/agent/hw/sai/switch/SaiHostifManager.cpp
@@ -20,6 +21,7 @@ add_library(sai_switch
   fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.cpp
   fboss/agent/hw/sai/switch/SaiRxPacket.cpp
   fboss/agent/hw/sai/switch/SaiSchedulerManager.cpp
+  fboss/agent/hw/sai/switch/SaiStateChangeStages.cpp
   fboss/agent/hw/sai/switch/SaiSwitch.cpp
   fboss/agent/hw/sai/switch/SaiSwitchManager.cpp
   fboss/agent/hw/sai/switch/SaiTxPacket.cpp
@@ -58,3 +60,20 @@ target_link_libraries(thrift_handler
   handler
   sai_ctrl_cpp2
 )
+
+add_executable(sai_l2_table_benchmark
+    fboss/agent/hw/sai/switch/tests/L2TableBenchmark.cpp
+)
+
+target_link_libraries(sai_l2_table_benchmark
+    sai_switch
+    fake_sai
+    Folly::folly
+    Folly::follybenchmark
+)
+
+set_target_properties(sai_l2_table_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
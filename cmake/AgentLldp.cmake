@@ -6,6 +6,7 @@
 add_library(lldp
   fboss/agent/lldp/LinkNeighbor.cpp
   fboss/agent/lldp/LinkNeighborDB.cpp
+  fboss/agent/lldp/LldpPduView.cpp
 )
 
 target_link_libraries(lldp
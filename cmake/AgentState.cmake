@@ -18,6 +18,7 @@ add_library(state
   fboss/agent/state/ForwardingInformationBaseMap.cpp
   fboss/agent/state/Interface.cpp
   fboss/agent/state/InterfaceMap.cpp
+  fboss/agent/state/JsonStreamWriter.cpp
   fboss/agent/state/LabelForwardingEntry.cpp
   fboss/agent/state/LabelForwardingInformationBase.cpp
   fboss/agent/state/LoadBalancer.cpp
@@ -50,6 +51,7 @@ add_library(state
   fboss/agent/state/SflowCollector.cpp
   fboss/agent/state/SflowCollectorMap.cpp
   fboss/agent/state/StateDelta.cpp
+  fboss/agent/state/StateDeltaSlicer.cpp
   fboss/agent/state/StateUtils.cpp
   fboss/agent/state/SwitchSettings.cpp
   fboss/agent/state/SwitchState.cpp
@@ -12,6 +12,7 @@
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
 #include "fboss/agent/types.h"
 
 #include <folly/IPAddress.h>
@@ -209,9 +210,11 @@ class HwSwitch {
 
   /*
    * Allow hardware to perform any warm boot related cleanup
-   * before we exit the application.
+   * before we exit the application, and store the warm boot state:
+   * switchState along with the hardware's own state.
    */
-  virtual void gracefulExit(folly::dynamic& switchState) = 0;
+  virtual void gracefulExit(
+      const std::shared_ptr<SwitchState>& switchState) = 0;
 
   /*
    * Get Hw Switch state in a folly::dynamic
@@ -220,6 +223,14 @@ class HwSwitch {
    */
   virtual folly::dynamic toFollyDynamic() const = 0;
 
+  /*
+   * Write the state toFollyDynamic() returns. Switches with large state
+   * override this to stream it rather than build it first.
+   */
+  virtual void writeJson(JsonStreamWriter& writer) const {
+    writer.value(toFollyDynamic());
+  }
+
   /*
    * When SwSwitch changes its SwitchRunState, such as when it transitions
    * to INITIALIZED or CONFIGURED, HwSwitch may need to react. For
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/ICMPErrorTemplates.h"
+
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/SwitchState.h"
+
+namespace facebook::fboss {
+
+template <typename HdrT, typename BuildFn>
+HdrT ICMPErrorTemplates::getHeader(
+    folly::Synchronized<Templates<HdrT>, std::mutex>* templates,
+    const std::shared_ptr<SwitchState>& state,
+    VlanID vlan,
+    BuildFn build) {
+  auto locked = templates->lock();
+  const auto& interfaces = state->getInterfaces();
+  if (locked->interfaces != interfaces) {
+    locked->headers.clear();
+    locked->interfaces = interfaces;
+  }
+  auto it = locked->headers.find(vlan);
+  if (it == locked->headers.end()) {
+    // Throws if the vlan has no address, nothing is cached then
+    it = locked->headers.emplace(vlan, build()).first;
+  }
+  return it->second;
+}
+
+IPv4Hdr ICMPErrorTemplates::getV4Header(
+    const std::shared_ptr<SwitchState>& state,
+    VlanID vlan) {
+  return getHeader(&v4Templates_, state, vlan, [&state, vlan]() {
+    return IPv4Hdr(
+        getSwitchVlanIP(state, vlan),
+        folly::IPAddressV4(),
+        static_cast<uint8_t>(IP_PROTO::IP_PROTO_ICMP),
+        0);
+  });
+}
+
+IPv6Hdr ICMPErrorTemplates::getV6Header(
+    const std::shared_ptr<SwitchState>& state,
+    VlanID vlan) {
+  return getHeader(&v6Templates_, state, vlan, [&state, vlan]() {
+    IPv6Hdr ipv6(getSwitchVlanIPv6(state, vlan), folly::IPAddressV6());
+    ipv6.trafficClass = 0xe0; // CS7 precedence (network control)
+    ipv6.nextHeader = static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP);
+    ipv6.hopLimit = 255;
+    return ipv6;
+  });
+}
+
+} // namespace facebook::fboss
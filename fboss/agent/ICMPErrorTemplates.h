@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/packet/IPv4Hdr.h"
+#include "fboss/agent/packet/IPv6Hdr.h"
+#include "fboss/agent/types.h"
+
+#include <boost/container/flat_map.hpp>
+#include <folly/Synchronized.h>
+
+#include <memory>
+#include <mutex>
+
+namespace facebook::fboss {
+
+class InterfaceMap;
+class SwitchState;
+
+/*
+ * IP headers of the ICMP errors sent on each vlan, with everything but the
+ * destination and the length filled in. They only depend on the interfaces
+ * of the switch state, so they are built once per vlan and interface map
+ * instead of looking up the switch address for every error.
+ *
+ * Thread safe, errors are generated on the packet RX threads.
+ */
+class ICMPErrorTemplates {
+ public:
+  IPv4Hdr getV4Header(const std::shared_ptr<SwitchState>& state, VlanID vlan);
+  IPv6Hdr getV6Header(const std::shared_ptr<SwitchState>& state, VlanID vlan);
+
+ private:
+  template <typename HdrT>
+  struct Templates {
+    // Interfaces the headers were built from
+    std::shared_ptr<InterfaceMap> interfaces;
+    boost::container::flat_map<VlanID, HdrT> headers;
+  };
+
+  template <typename HdrT, typename BuildFn>
+  static HdrT getHeader(
+      folly::Synchronized<Templates<HdrT>, std::mutex>* templates,
+      const std::shared_ptr<SwitchState>& state,
+      VlanID vlan,
+      BuildFn build);
+
+  folly::Synchronized<Templates<IPv4Hdr>, std::mutex> v4Templates_;
+  folly::Synchronized<Templates<IPv6Hdr>, std::mutex> v6Templates_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/ICMPRateLimiter.h"
+
+#include <functional>
+
+DEFINE_double(
+    icmp_error_rate_per_prefix,
+    0,
+    "ICMP errors per second sent to each source prefix (/24 for IPv4, /64 for "
+    "IPv6). 0 disables the limit");
+DEFINE_double(
+    icmp_error_burst_per_prefix,
+    50,
+    "Maximum burst of ICMP errors sent to each source prefix");
+DEFINE_double(
+    icmp_error_rate_per_port,
+    0,
+    "ICMP errors per second sent for packets received on each port. 0 "
+    "disables the limit");
+DEFINE_double(
+    icmp_error_burst_per_port,
+    200,
+    "Maximum burst of ICMP errors sent for packets received on each port");
+
+namespace facebook::fboss {
+
+namespace {
+
+ICMPRateLimiter::Config configFromFlags() {
+  ICMPRateLimiter::Config config;
+  config.ratePerPrefix = FLAGS_icmp_error_rate_per_prefix;
+  config.burstPerPrefix = FLAGS_icmp_error_burst_per_prefix;
+  config.ratePerPort = FLAGS_icmp_error_rate_per_port;
+  config.burstPerPort = FLAGS_icmp_error_burst_per_port;
+  return config;
+}
+
+} // namespace
+
+ICMPRateLimiter::ICMPRateLimiter() : ICMPRateLimiter(configFromFlags()) {}
+
+ICMPRateLimiter::ICMPRateLimiter(const Config& config)
+    : config_(config),
+      prefixBuckets_(config.ratePerPrefix > 0 ? config.numPrefixBuckets : 0),
+      portBuckets_(config.ratePerPort > 0 ? config.numPortBuckets : 0) {}
+
+bool ICMPRateLimiter::allow(
+    PortID ingressPort,
+    const folly::IPAddress& src,
+    double now) {
+  auto prefix = prefixBuckets_.empty() ? nullptr : &prefixBucket(src);
+  auto port = portBuckets_.empty()
+      ? nullptr
+      : &portBuckets_[static_cast<size_t>(ingressPort) % portBuckets_.size()];
+  // Don't take a token from one bucket when the other denies
+  if (prefix &&
+      prefix->available(config_.ratePerPrefix, config_.burstPerPrefix, now) <
+          1) {
+    return false;
+  }
+  if (port &&
+      !port->consume(1, config_.ratePerPort, config_.burstPerPort, now)) {
+    return false;
+  }
+  return !prefix ||
+      prefix->consume(1, config_.ratePerPrefix, config_.burstPerPrefix, now);
+}
+
+folly::DynamicTokenBucket& ICMPRateLimiter::prefixBucket(
+    const folly::IPAddress& src) {
+  auto prefix = src.isV4() ? src.mask(config_.v4PrefixLength)
+                           : src.mask(config_.v6PrefixLength);
+  return prefixBuckets_[std::hash<folly::IPAddress>()(prefix) %
+                        prefixBuckets_.size()];
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+#include <folly/TokenBucket.h>
+#include <gflags/gflags.h>
+
+#include <vector>
+
+DECLARE_double(icmp_error_rate_per_prefix);
+DECLARE_double(icmp_error_burst_per_prefix);
+DECLARE_double(icmp_error_rate_per_port);
+DECLARE_double(icmp_error_burst_per_port);
+
+namespace facebook::fboss {
+
+/*
+ * Token bucket rate limiting of the ICMP errors generated by the agent (time
+ * exceeded, packet too big), as recommended by RFC 4443 section 2.4 (f).
+ *
+ * An error is only sent if both the source prefix of the offending packet
+ * and its ingress port have a token left, and then takes one from each.
+ * Buckets are hashed into fixed size arrays, so memory does not grow with
+ * the number of sources; sources that collide share a bucket.
+ *
+ * Both limits are disabled by default.
+ */
+class ICMPRateLimiter {
+ public:
+  struct Config {
+    // Errors per second and burst size. A rate of 0 disables the limit.
+    double ratePerPrefix{0};
+    double burstPerPrefix{0};
+    double ratePerPort{0};
+    double burstPerPort{0};
+    uint8_t v4PrefixLength{24};
+    uint8_t v6PrefixLength{64};
+    size_t numPrefixBuckets{4096};
+    size_t numPortBuckets{512};
+  };
+
+  // Limits from the --icmp_error_* flags
+  ICMPRateLimiter();
+  explicit ICMPRateLimiter(const Config& config);
+
+  /*
+   * Whether an ICMP error may be sent for a packet from src received on
+   * ingressPort, consuming a token if so. Thread safe.
+   */
+  bool allow(
+      PortID ingressPort,
+      const folly::IPAddress& src,
+      double now = folly::DynamicTokenBucket::defaultClockNow());
+
+  const Config& getConfig() const {
+    return config_;
+  }
+
+ private:
+  folly::DynamicTokenBucket& prefixBucket(const folly::IPAddress& src);
+
+  // Forbidden copy constructor and assignment operator
+  ICMPRateLimiter(ICMPRateLimiter const&) = delete;
+  ICMPRateLimiter& operator=(ICMPRateLimiter const&) = delete;
+
+  const Config config_;
+  std::vector<folly::DynamicTokenBucket> prefixBuckets_;
+  std::vector<folly::DynamicTokenBucket> portBuckets_;
+};
+
+} // namespace facebook::fboss
@@ -19,6 +19,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/IPHeaderV4.h"
+#include "fboss/agent/NeighborHoldQueue.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -51,23 +52,24 @@ using std::unique_ptr;
 
 namespace facebook::fboss {
 
+/*
+ * ipv4 is the header template of the vlan, with the source address and all
+ * constant fields set.
+ */
 template <typename BodyFn>
 std::unique_ptr<TxPacket> createICMPv4Pkt(
     SwSwitch* sw,
     folly::MacAddress dstMac,
     folly::MacAddress srcMac,
     VlanID vlan,
-    folly::IPAddressV4& dstIP,
-    folly::IPAddressV4& srcIP,
+    IPv4Hdr ipv4,
+    const folly::IPAddressV4& dstIP,
     ICMPv4Type icmpType,
     ICMPv4Code icmpCode,
     uint32_t bodyLength,
     BodyFn serializeBody) {
-  IPv4Hdr ipv4(
-      srcIP,
-      dstIP,
-      static_cast<uint8_t>(IP_PROTO::IP_PROTO_ICMP),
-      ICMPHdr::SIZE + bodyLength);
+  ipv4.dstAddr = dstIP;
+  ipv4.length = IPv4Hdr::minSize() + ICMPHdr::SIZE + bodyLength;
   ipv4.computeChecksum();
 
   ICMPHdr icmp4(
@@ -84,11 +86,16 @@ std::unique_ptr<TxPacket> createICMPv4Pkt(
 IPv4Handler::IPv4Handler(SwSwitch* sw) : sw_(sw) {}
 
 void IPv4Handler::sendICMPTimeExceeded(
+    PortID srcPort,
     VlanID srcVlan,
     MacAddress dst,
     MacAddress src,
     IPv4Hdr& v4Hdr,
     Cursor cursor) {
+  if (!icmpRateLimiter_.allow(srcPort, IPAddress(v4Hdr.srcAddr))) {
+    sw_->portStats(srcPort)->icmpErrorSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   // payload serialization function
@@ -101,14 +108,15 @@ void IPv4Handler::sendICMPTimeExceeded(
     sendCursor->push(cursor.data(), ICMPHdr::ICMPV4_SENDER_BYTES);
   };
 
-  IPAddressV4 srcIp = getSwitchVlanIP(state, srcVlan);
+  auto ipv4 = icmpTemplates_.getV4Header(state, srcVlan);
+  IPAddressV4 srcIp = ipv4.srcAddr;
   auto icmpPkt = createICMPv4Pkt(
       sw_,
       dst,
       src,
       srcVlan,
+      ipv4,
       v4Hdr.srcAddr,
-      srcIp,
       ICMPv4Type::ICMPV4_TYPE_TIME_EXCEEDED,
       ICMPv4Code::ICMPV4_CODE_TIME_EXCEEDED_TTL_EXCEEDED,
       bodyLength,
@@ -212,7 +220,8 @@ void IPv4Handler::handlePacket(
     stats->port(port)->ipv4TtlExceeded();
     // Look up cpu mac from platform
     MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-    sendICMPTimeExceeded(pkt->getSrcVlan(), cpuMac, cpuMac, v4Hdr, cursor);
+    sendICMPTimeExceeded(
+        port, pkt->getSrcVlan(), cpuMac, cpuMac, v4Hdr, cursor);
     return;
   }
 
@@ -230,13 +239,24 @@ void IPv4Handler::handlePacket(
   // We will need to manage the rate somehow. Either from HW
   // or a SW control here
   stats->port(port)->ipv4Nexthop();
-  if (!resolveMac(state, port, v4Hdr.dstAddr, pkt->getSrcVlan())) {
+  auto holdQueue = sw_->getNeighborHoldQueue();
+  std::optional<std::pair<VlanID, IPAddressV4>> pendingNeighbor;
+  if (!resolveMac(
+          state,
+          port,
+          v4Hdr.dstAddr,
+          pkt->getSrcVlan(),
+          holdQueue->enabled() ? &pendingNeighbor : nullptr)) {
     stats->port(port)->ipv4NoArp();
     XLOG(DBG4) << "Cannot find the interface to send out ARP request for "
                << v4Hdr.dstAddr.str();
   }
-  // TODO: ideally, we need to store this packet until the ARP is done and
-  // then send this pkt out. For now, just drop it.
+  // Send the packet out once the ARP is done
+  if (pendingNeighbor &&
+      holdQueue->hold(
+          pendingNeighbor->first, IPAddress(pendingNeighbor->second), *pkt)) {
+    return;
+  }
   stats->port(port)->pktDropped();
 }
 
@@ -245,7 +265,8 @@ bool IPv4Handler::resolveMac(
     std::shared_ptr<SwitchState> state,
     PortID ingressPort,
     IPAddressV4 dest,
-    VlanID ingressVlan) {
+    VlanID ingressVlan,
+    std::optional<std::pair<VlanID, IPAddressV4>>* pendingNeighbor) {
   // need to find out our own IP and MAC addresses so that we can send the
   // ARP request out. Since the request will be broadcast, there is no need to
   // worry about which port to send the packet out.
@@ -281,6 +302,10 @@ bool IPv4Handler::resolveMac(
       auto vlan = state->getVlans()->getVlanIf(vlanID);
       if (vlan) {
         auto entry = vlan->getArpTable()->getEntryIf(target);
+        if (pendingNeighbor && !*pendingNeighbor &&
+            (entry == nullptr || entry->isPending())) {
+          *pendingNeighbor = std::make_pair(vlanID, target);
+        }
         if (entry == nullptr) {
           // No entry in ARP table, send ARP request
           auto mac = intf->getMac();
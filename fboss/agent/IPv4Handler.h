@@ -9,9 +9,13 @@
  */
 #pragma once
 
+#include "fboss/agent/ICMPErrorTemplates.h"
+#include "fboss/agent/ICMPRateLimiter.h"
 #include "fboss/agent/types.h"
 
 #include <memory>
+#include <optional>
+#include <utility>
 
 #include <folly/IPAddressV4.h>
 #include <folly/MacAddress.h>
@@ -45,15 +49,21 @@ class IPv4Handler {
   /*
    * TODO(aeckert): t17949183 unify packet handling pipeline and then
    * make this private again.
+   *
+   * If pendingNeighbor is set, it receives the first next hop towards dest,
+   * with its vlan, that is not resolved yet.
    */
   bool resolveMac(
       std::shared_ptr<SwitchState> state,
       PortID ingressPort,
       folly::IPAddressV4 dest,
-      VlanID ingressVlan);
+      VlanID ingressVlan,
+      std::optional<std::pair<VlanID, folly::IPAddressV4>>* pendingNeighbor =
+          nullptr);
 
  private:
   void sendICMPTimeExceeded(
+      PortID srcPort,
       VlanID srcVlan,
       folly::MacAddress dst,
       folly::MacAddress src,
@@ -65,6 +75,8 @@ class IPv4Handler {
   IPv4Handler& operator=(IPv4Handler const&) = delete;
 
   SwSwitch* sw_{nullptr};
+  ICMPRateLimiter icmpRateLimiter_;
+  ICMPErrorTemplates icmpTemplates_;
 };
 
 } // namespace facebook::fboss
@@ -12,8 +12,10 @@
 #include <folly/Format.h>
 #include <folly/MacAddress.h>
 #include <folly/logging/xlog.h>
+#include <optional>
 #include "fboss/agent/DHCPv6Handler.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborHoldQueue.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/RxPacket.h"
@@ -78,6 +80,36 @@ std::unique_ptr<TxPacket> createICMPv6Pkt(
   return pkt;
 }
 
+/*
+ * Same as above, with the source address and constant fields taken from the
+ * header template ipv6 of the vlan.
+ */
+template <typename BodyFn>
+std::unique_ptr<TxPacket> createICMPv6Pkt(
+    SwSwitch* sw,
+    folly::MacAddress dstMac,
+    folly::MacAddress srcMac,
+    VlanID vlan,
+    IPv6Hdr ipv6,
+    const folly::IPAddressV6& dstIP,
+    ICMPv6Type icmp6Type,
+    ICMPv6Code icmp6Code,
+    uint32_t bodyLength,
+    BodyFn serializeBody) {
+  ipv6.dstAddr = dstIP;
+  ipv6.payloadLength = ICMPHdr::SIZE + bodyLength;
+
+  ICMPHdr icmp6(
+      static_cast<uint8_t>(icmp6Type), static_cast<uint8_t>(icmp6Code), 0);
+
+  uint32_t pktLen = icmp6.computeTotalLengthV6(bodyLength);
+  auto pkt = sw->allocatePacket(pktLen);
+  RWPrivateCursor cursor(pkt->buf());
+  icmp6.serializeFullPacket(
+      &cursor, dstMac, srcMac, vlan, ipv6, bodyLength, serializeBody);
+  return pkt;
+}
+
 struct IPv6Handler::ICMPHeaders {
   folly::MacAddress dst;
   folly::MacAddress src;
@@ -199,7 +231,8 @@ void IPv6Handler::handlePacket(
     sw_->portStats(port)->ipv6HopExceeded();
     // Look up cpu mac from platform
     MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-    sendICMPv6TimeExceeded(pkt->getSrcVlan(), cpuMac, cpuMac, ipv6, cursor);
+    sendICMPv6TimeExceeded(
+        port, pkt->getSrcVlan(), cpuMac, cpuMac, ipv6, cursor);
     return;
   }
 
@@ -537,11 +570,16 @@ void IPv6Handler::handleNeighborAdvertisement(
 }
 
 void IPv6Handler::sendICMPv6TimeExceeded(
+    PortID srcPort,
     VlanID srcVlan,
     MacAddress dst,
     MacAddress src,
     IPv6Hdr& v6Hdr,
     folly::io::Cursor cursor) {
+  if (!icmpRateLimiter_.allow(srcPort, folly::IPAddress(v6Hdr.srcAddr))) {
+    sw_->portStats(srcPort)->icmpErrorSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   /*
@@ -564,14 +602,15 @@ void IPv6Handler::sendICMPv6TimeExceeded(
     sendCursor->push(cursor, remainingLength);
   };
 
-  IPAddressV6 srcIp = getSwitchVlanIPv6(state, srcVlan);
+  auto ipv6 = icmpTemplates_.getV6Header(state, srcVlan);
+  IPAddressV6 srcIp = ipv6.srcAddr;
   auto icmpPkt = createICMPv6Pkt(
       sw_,
       dst,
       src,
       srcVlan,
+      ipv6,
       v6Hdr.srcAddr,
-      srcIp,
       ICMPv6Type::ICMPV6_TYPE_TIME_EXCEEDED,
       ICMPv6Code::ICMPV6_CODE_TIME_EXCEEDED_HOPLIMIT_EXCEEDED,
       icmpPayloadLength,
@@ -591,6 +630,10 @@ void IPv6Handler::sendICMPv6PacketTooBig(
     IPv6Hdr& v6Hdr,
     int expectedMtu,
     folly::io::Cursor cursor) {
+  if (!icmpRateLimiter_.allow(srcPort, folly::IPAddress(v6Hdr.srcAddr))) {
+    sw_->portStats(srcPort)->icmpErrorSuppressed();
+    return;
+  }
   auto state = sw_->getState();
 
   // payload serialization function
@@ -610,14 +653,15 @@ void IPv6Handler::sendICMPv6PacketTooBig(
     sendCursor->push(cursor, remainingLength);
   };
 
-  IPAddressV6 srcIp = getSwitchVlanIPv6(state, srcVlan);
+  auto ipv6 = icmpTemplates_.getV6Header(state, srcVlan);
+  IPAddressV6 srcIp = ipv6.srcAddr;
   auto icmpPkt = createICMPv6Pkt(
       sw_,
       dst,
       src,
       srcVlan,
+      ipv6,
       v6Hdr.srcAddr,
-      srcIp,
       ICMPv6Type::ICMPV6_TYPE_PACKET_TOO_BIG,
       ICMPv6Code::ICMPV6_CODE_PACKET_TOO_BIG,
       bodyLength,
@@ -751,6 +795,8 @@ void IPv6Handler::resolveDestAndHandlePacket(
 
   auto interfaces = state->getInterfaces();
   auto nexthops = route->getForwardInfo().getNextHopSet();
+  auto holdQueue = sw_->getNeighborHoldQueue();
+  std::optional<std::pair<VlanID, IPAddressV6>> pendingNeighbor;
 
   for (auto nexthop : nexthops) {
     // get interface needed to reach next hop
@@ -783,6 +829,9 @@ void IPv6Handler::resolveDestAndHandlePacket(
         auto vlan = state->getVlans()->getVlanIf(vlanID);
         if (vlan) {
           auto entry = vlan->getNdpTable()->getEntryIf(target);
+          if (!pendingNeighbor && (nullptr == entry || entry->isPending())) {
+            pendingNeighbor = std::make_pair(vlanID, target);
+          }
           if (nullptr == entry) {
             // No entry in NDP table, create a neighbor solicitation packet
             sendMulticastNeighborSolicitation(
@@ -799,6 +848,14 @@ void IPv6Handler::resolveDestAndHandlePacket(
       }
     }
   }
+  // Send the packet out once the NDP is done
+  if (pendingNeighbor && holdQueue->enabled() &&
+      holdQueue->hold(
+          pendingNeighbor->first,
+          folly::IPAddress(pendingNeighbor->second),
+          *pkt)) {
+    return;
+  }
   sw_->portStats(pkt)->pktDropped();
 }
 
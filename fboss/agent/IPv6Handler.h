@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include "fboss/agent/ICMPErrorTemplates.h"
+#include "fboss/agent/ICMPRateLimiter.h"
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/ndp/IPv6RouteAdvertiser.h"
 #include "fboss/agent/packet/ICMPHdr.h"
@@ -102,6 +104,7 @@ class IPv6Handler : public AutoRegisterStateObserver {
   void intfDeleted(const Interface* intf);
 
   void sendICMPv6TimeExceeded(
+      PortID srcPort,
       VlanID srcVlan,
       folly::MacAddress dst,
       folly::MacAddress src,
@@ -183,6 +186,8 @@ class IPv6Handler : public AutoRegisterStateObserver {
 
   SwSwitch* sw_{nullptr};
   RAMap routeAdvertisers_;
+  ICMPRateLimiter icmpRateLimiter_;
+  ICMPErrorTemplates icmpTemplates_;
 };
 
 } // namespace facebook::fboss
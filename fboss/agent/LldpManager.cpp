@@ -21,6 +21,7 @@
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/lldp/LldpPduView.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/PortDescriptor.h"
 
@@ -88,10 +89,21 @@ void LldpManager::handlePacket(
     folly::MacAddress /*dst*/,
     folly::MacAddress src,
     folly::io::Cursor cursor) {
-  LinkNeighbor neighbor;
-
   sw_->stats()->LldpRecvdPkt();
 
+  // Most PDUs just refresh a neighbor we already know about. Unless the
+  // port has LLDP validations to run, handle those without copying
+  // anything out of the packet.
+  LldpPduView view;
+  if (view.parse(cursor)) {
+    auto port = sw_->getState()->getPorts()->getPortIf(pkt->getSrcPort());
+    if (port && port->getLLDPValidations().empty() &&
+        db_.refresh(pkt->getSrcPort(), pkt->getSrcVlan(), src, view)) {
+      return;
+    }
+  }
+
+  LinkNeighbor neighbor;
   bool ret = neighbor.parseLldpPdu(
       pkt->getSrcPort(), pkt->getSrcVlan(), src, ETHERTYPE_LLDP, &cursor);
 
@@ -145,6 +157,9 @@ void LldpManager::timeoutExpired() noexcept {
     XLOG(ERR) << "Failed to send LLDP on all ports. Error:"
               << folly::exceptionStr(ex);
   }
+  // Publish expired neighbors within an interval, even when no LLDP
+  // frames are received at all
+  db_.pruneExpiredNeighbors();
   scheduleTimeout(intervalMsecs_);
 }
 
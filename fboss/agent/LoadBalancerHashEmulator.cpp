@@ -0,0 +1,425 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/LoadBalancerHashEmulator.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace facebook::fboss {
+
+namespace {
+
+constexpr size_t kLanes = 4;
+constexpr size_t kBlockSize = 64;
+
+template <uint32_t kPoly, int kWidth>
+struct MsbFirstCrc {
+  static constexpr uint32_t kMask =
+      kWidth == 32 ? 0xFFFFFFFF : (uint32_t(1) << (kWidth % 32)) - 1;
+
+  static const std::array<uint32_t, 256>& table() {
+    static const auto kTable = []() {
+      std::array<uint32_t, 256> t{};
+      constexpr uint32_t kTopBit = uint32_t(1) << (kWidth - 1);
+      for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b << (kWidth - 8);
+        for (int i = 0; i < 8; ++i) {
+          crc = (crc & kTopBit) ? (crc << 1) ^ kPoly : crc << 1;
+        }
+        t[b] = crc & kMask;
+      }
+      return t;
+    }();
+    return kTable;
+  }
+  static uint32_t init(uint32_t seed) {
+    return seed & kMask;
+  }
+  static uint32_t step(const uint32_t* t, uint32_t crc, uint8_t byte) {
+    return ((crc << 8) ^ t[((crc >> (kWidth - 8)) ^ byte) & 0xFF]) & kMask;
+  }
+};
+
+template <uint32_t kReflectedPoly>
+struct LsbFirstCrc {
+  static const std::array<uint32_t, 256>& table() {
+    static const auto kTable = []() {
+      std::array<uint32_t, 256> t{};
+      for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (int i = 0; i < 8; ++i) {
+          crc = (crc & 1) ? (crc >> 1) ^ kReflectedPoly : crc >> 1;
+        }
+        t[b] = crc;
+      }
+      return t;
+    }();
+    return kTable;
+  }
+  static uint32_t init(uint32_t seed) {
+    return seed;
+  }
+  static uint32_t step(const uint32_t* t, uint32_t crc, uint8_t byte) {
+    return (crc >> 8) ^ t[(crc ^ byte) & 0xFF];
+  }
+};
+
+using Crc16Ccitt = MsbFirstCrc<0x1021, 16>;
+using Crc32 = MsbFirstCrc<0x04C11DB7, 32>;
+using Crc32Koopman = MsbFirstCrc<0x741B8CD7, 32>;
+using Crc32Ethernet = LsbFirstCrc<0xEDB88320>;
+
+template <typename Crc>
+uint32_t crc(uint32_t seed, const uint8_t* data, size_t len) {
+  const auto* t = Crc::table().data();
+  uint32_t c = Crc::init(seed);
+  for (size_t i = 0; i < len; ++i) {
+    c = Crc::step(t, c, data[i]);
+  }
+  return c;
+}
+
+/*
+ * CRC of n keys of possibly different lengths. Lanes of kLanes keys are run
+ * in lock step over their common length, which gives the CPU kLanes
+ * independent dependency chains to overlap.
+ */
+template <typename Crc>
+void crcBlock(
+    uint32_t seed,
+    const uint8_t (*keys)[LoadBalancerHashEmulator::kMaxKeyLen],
+    const size_t* lens,
+    size_t n,
+    uint32_t* out) {
+  const auto* t = Crc::table().data();
+  size_t k = 0;
+  for (; k + kLanes <= n; k += kLanes) {
+    uint32_t c[kLanes];
+    size_t minLen = lens[k];
+    for (size_t l = 0; l < kLanes; ++l) {
+      c[l] = Crc::init(seed);
+      minLen = std::min(minLen, lens[k + l]);
+    }
+    for (size_t i = 0; i < minLen; ++i) {
+      for (size_t l = 0; l < kLanes; ++l) {
+        c[l] = Crc::step(t, c[l], keys[k + l][i]);
+      }
+    }
+    for (size_t l = 0; l < kLanes; ++l) {
+      for (size_t i = minLen; i < lens[k + l]; ++i) {
+        c[l] = Crc::step(t, c[l], keys[k + l][i]);
+      }
+      out[k + l] = c[l];
+    }
+  }
+  for (; k < n; ++k) {
+    out[k] = crc<Crc>(seed, keys[k], lens[k]);
+  }
+}
+
+uint16_t fold(cfg::HashingAlgorithm algorithm, uint32_t crc) {
+  switch (algorithm) {
+    case cfg::HashingAlgorithm::CRC16_CCITT:
+    case cfg::HashingAlgorithm::CRC32_LO:
+    case cfg::HashingAlgorithm::CRC32_ETHERNET_LO:
+    case cfg::HashingAlgorithm::CRC32_KOOPMAN_LO:
+      return crc & 0xFFFF;
+    case cfg::HashingAlgorithm::CRC32_HI:
+    case cfg::HashingAlgorithm::CRC32_ETHERNET_HI:
+    case cfg::HashingAlgorithm::CRC32_KOOPMAN_HI:
+      return crc >> 16;
+  }
+  throw FbossError("Unrecognized HashingAlgorithm");
+}
+
+void putLabel(uint8_t* key, uint32_t label) {
+  // MPLS labels are 20 bits
+  key[0] = (label >> 16) & 0x0F;
+  key[1] = (label >> 8) & 0xFF;
+  key[2] = label & 0xFF;
+}
+
+void putPort(uint8_t* key, uint16_t port) {
+  key[0] = port >> 8;
+  key[1] = port & 0xFF;
+}
+
+} // namespace
+
+namespace loadbalancer_hash {
+uint16_t crc16Ccitt(uint32_t seed, const uint8_t* data, size_t len) {
+  return crc<Crc16Ccitt>(seed, data, len);
+}
+uint32_t crc32(uint32_t seed, const uint8_t* data, size_t len) {
+  return crc<Crc32>(seed, data, len);
+}
+uint32_t crc32Ethernet(uint32_t seed, const uint8_t* data, size_t len) {
+  return crc<Crc32Ethernet>(seed, data, len);
+}
+uint32_t crc32Koopman(uint32_t seed, const uint8_t* data, size_t len) {
+  return crc<Crc32Koopman>(seed, data, len);
+}
+} // namespace loadbalancer_hash
+
+LoadBalancerFlow::LoadBalancerFlow(
+    const folly::IPAddress& src,
+    const folly::IPAddress& dst,
+    uint16_t srcPort,
+    uint16_t dstPort,
+    uint32_t flowLabel)
+    : flowLabel(flowLabel),
+      srcPort(srcPort),
+      dstPort(dstPort),
+      isV6(src.isV6()) {
+  if (src.isV6() != dst.isV6()) {
+    throw FbossError("Flow from ", src, " to ", dst, " mixes address families");
+  }
+  auto srcBytes = src.bytes();
+  auto dstBytes = dst.bytes();
+  std::memcpy(srcIp.data(), srcBytes, src.byteCount());
+  std::memcpy(dstIp.data(), dstBytes, dst.byteCount());
+}
+
+LoadBalancerHashEmulator::LoadBalancerHashEmulator(
+    const LoadBalancer& loadBalancer)
+    : LoadBalancerHashEmulator(
+          loadBalancer.getAlgorithm(),
+          loadBalancer.getSeed(),
+          LoadBalancer::IPv4Fields(
+              loadBalancer.getIPv4Fields().begin(),
+              loadBalancer.getIPv4Fields().end()),
+          LoadBalancer::IPv6Fields(
+              loadBalancer.getIPv6Fields().begin(),
+              loadBalancer.getIPv6Fields().end()),
+          LoadBalancer::TransportFields(
+              loadBalancer.getTransportFields().begin(),
+              loadBalancer.getTransportFields().end()),
+          LoadBalancer::MPLSFields(
+              loadBalancer.getMPLSFields().begin(),
+              loadBalancer.getMPLSFields().end())) {}
+
+LoadBalancerHashEmulator::LoadBalancerHashEmulator(
+    cfg::HashingAlgorithm algorithm,
+    uint32_t seed,
+    LoadBalancer::IPv4Fields v4Fields,
+    LoadBalancer::IPv6Fields v6Fields,
+    LoadBalancer::TransportFields transportFields,
+    LoadBalancer::MPLSFields mplsFields)
+    : algorithm_(algorithm), seed_(seed) {
+  // Validates the algorithm
+  fold(algorithm_, 0);
+  v4Src_ = v4Fields.count(LoadBalancer::IPv4Field::SOURCE_ADDRESS);
+  v4Dst_ = v4Fields.count(LoadBalancer::IPv4Field::DESTINATION_ADDRESS);
+  v6Src_ = v6Fields.count(LoadBalancer::IPv6Field::SOURCE_ADDRESS);
+  v6Dst_ = v6Fields.count(LoadBalancer::IPv6Field::DESTINATION_ADDRESS);
+  v6FlowLabel_ = v6Fields.count(LoadBalancer::IPv6Field::FLOW_LABEL);
+  srcPort_ = transportFields.count(LoadBalancer::TransportField::SOURCE_PORT);
+  dstPort_ =
+      transportFields.count(LoadBalancer::TransportField::DESTINATION_PORT);
+  labels_[0] = mplsFields.count(LoadBalancer::MPLSField::TOP_LABEL);
+  labels_[1] = mplsFields.count(LoadBalancer::MPLSField::SECOND_LABEL);
+  labels_[2] = mplsFields.count(LoadBalancer::MPLSField::THIRD_LABEL);
+}
+
+size_t LoadBalancerHashEmulator::buildKey(
+    const LoadBalancerFlow& flow,
+    uint8_t* key) const {
+  bool hashOnLabels = flow.numLabels > 0 &&
+      std::any_of(labels_.begin(), labels_.end(), [](bool b) { return b; });
+  if (hashOnLabels) {
+    std::memset(key, 0, 9);
+    for (size_t i = 0; i < labels_.size(); ++i) {
+      if (labels_[i] && i < flow.numLabels) {
+        putLabel(key + 3 * i, flow.labels[i]);
+      }
+    }
+    return 9;
+  }
+  size_t len = 0;
+  auto putAddr = [&](bool selected, const std::array<uint8_t, 16>& addr) {
+    size_t addrLen = flow.isV6 ? 16 : 4;
+    if (selected) {
+      std::memcpy(key + len, addr.data(), addrLen);
+    } else {
+      std::memset(key + len, 0, addrLen);
+    }
+    len += addrLen;
+  };
+  putAddr(flow.isV6 ? v6Src_ : v4Src_, flow.srcIp);
+  putAddr(flow.isV6 ? v6Dst_ : v4Dst_, flow.dstIp);
+  if (flow.isV6) {
+    putLabel(key + len, v6FlowLabel_ ? flow.flowLabel : 0);
+    len += 3;
+  }
+  putPort(key + len, srcPort_ ? flow.srcPort : 0);
+  putPort(key + len + 2, dstPort_ ? flow.dstPort : 0);
+  return len + 4;
+}
+
+uint16_t LoadBalancerHashEmulator::hash(const LoadBalancerFlow& flow) const {
+  uint16_t h;
+  hash(
+      folly::Range<const LoadBalancerFlow*>(&flow, 1),
+      folly::MutableRange<uint16_t*>(&h, 1));
+  return h;
+}
+
+void LoadBalancerHashEmulator::hash(
+    folly::Range<const LoadBalancerFlow*> flows,
+    folly::MutableRange<uint16_t*> hashes) const {
+  if (hashes.size() < flows.size()) {
+    throw FbossError(
+        "Need room for ", flows.size(), " hashes, got ", hashes.size());
+  }
+  uint8_t keys[kBlockSize][kMaxKeyLen];
+  size_t lens[kBlockSize];
+  uint32_t crcs[kBlockSize];
+  for (size_t begin = 0; begin < flows.size(); begin += kBlockSize) {
+    auto n = std::min(kBlockSize, flows.size() - begin);
+    for (size_t i = 0; i < n; ++i) {
+      lens[i] = buildKey(flows[begin + i], keys[i]);
+    }
+    switch (algorithm_) {
+      case cfg::HashingAlgorithm::CRC16_CCITT:
+        crcBlock<Crc16Ccitt>(seed_, keys, lens, n, crcs);
+        break;
+      case cfg::HashingAlgorithm::CRC32_LO:
+      case cfg::HashingAlgorithm::CRC32_HI:
+        crcBlock<Crc32>(seed_, keys, lens, n, crcs);
+        break;
+      case cfg::HashingAlgorithm::CRC32_ETHERNET_LO:
+      case cfg::HashingAlgorithm::CRC32_ETHERNET_HI:
+        crcBlock<Crc32Ethernet>(seed_, keys, lens, n, crcs);
+        break;
+      case cfg::HashingAlgorithm::CRC32_KOOPMAN_LO:
+      case cfg::HashingAlgorithm::CRC32_KOOPMAN_HI:
+        crcBlock<Crc32Koopman>(seed_, keys, lens, n, crcs);
+        break;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      hashes[begin + i] = fold(algorithm_, crcs[i]);
+    }
+  }
+}
+
+MultiStageEcmpEmulator::MultiStageEcmpEmulator(std::vector<Stage> stages)
+    : stages_(std::move(stages)) {
+  uint64_t numSwitches = 1;
+  for (const auto& stage : stages_) {
+    if (stage.fanout == 0) {
+      throw FbossError("ECMP stages need a non zero fanout");
+    }
+    numSwitches *= stage.fanout;
+    if (numSwitches > (uint64_t(1) << 32)) {
+      throw FbossError("Too many switches in the emulated fabric");
+    }
+  }
+}
+
+uint32_t MultiStageEcmpEmulator::switchSeed(
+    uint32_t seed,
+    uint64_t switchIndex) {
+  return seed ^ folly::hash::twang_32from64(switchIndex + 1);
+}
+
+std::vector<MultiStageEcmpEmulator::StageReport> MultiStageEcmpEmulator::run(
+    folly::Range<const LoadBalancerFlow*> flows) const {
+  std::vector<StageReport> reports;
+  // Switch each flow is hashed on at the current stage
+  std::vector<uint32_t> switchOf(flows.size(), 0);
+  std::vector<uint16_t> hashes(flows.size());
+  uint64_t numSwitches = 1;
+  // Index of the first switch of the current stage in the whole fabric
+  uint64_t firstSwitch = 0;
+  for (const auto& stage : stages_) {
+    StageReport report;
+    report.numSwitches = numSwitches;
+    report.fanout = stage.fanout;
+    report.memberLoad.assign(numSwitches * stage.fanout, 0);
+
+    if (!stage.perSwitchSeed) {
+      stage.hasher.hash(
+          flows, folly::MutableRange<uint16_t*>(hashes.data(), hashes.size()));
+    } else {
+      // Gather the flows of every switch and hash them with its own seed
+      std::vector<std::vector<size_t>> flowsOf(numSwitches);
+      for (size_t i = 0; i < flows.size(); ++i) {
+        flowsOf[switchOf[i]].push_back(i);
+      }
+      auto hasher = stage.hasher;
+      std::vector<LoadBalancerFlow> switchFlows;
+      std::vector<uint16_t> switchHashes;
+      for (uint32_t sw = 0; sw < numSwitches; ++sw) {
+        if (flowsOf[sw].empty()) {
+          continue;
+        }
+        switchFlows.clear();
+        for (auto i : flowsOf[sw]) {
+          switchFlows.push_back(flows[i]);
+        }
+        switchHashes.resize(switchFlows.size());
+        hasher.setSeed(
+            switchSeed(stage.hasher.getSeed(), firstSwitch + sw));
+        hasher.hash(
+            folly::Range<const LoadBalancerFlow*>(
+                switchFlows.data(), switchFlows.size()),
+            folly::MutableRange<uint16_t*>(
+                switchHashes.data(), switchHashes.size()));
+        for (size_t j = 0; j < flowsOf[sw].size(); ++j) {
+          hashes[flowsOf[sw][j]] = switchHashes[j];
+        }
+      }
+    }
+
+    for (size_t i = 0; i < flows.size(); ++i) {
+      auto member = hashes[i] % stage.fanout;
+      auto slot = uint64_t(switchOf[i]) * stage.fanout + member;
+      ++report.memberLoad[slot];
+      switchOf[i] = slot;
+    }
+
+    uint32_t loadedSwitches = 0;
+    for (uint64_t sw = 0; sw < numSwitches; ++sw) {
+      auto begin = report.memberLoad.begin() + sw * stage.fanout;
+      auto end = begin + stage.fanout;
+      uint64_t total = 0;
+      uint64_t max = 0;
+      uint64_t unused = 0;
+      for (auto it = begin; it != end; ++it) {
+        total += *it;
+        max = std::max(max, *it);
+        unused += *it == 0;
+      }
+      if (!total) {
+        continue;
+      }
+      ++loadedSwitches;
+      double imbalance = double(max) * stage.fanout / total;
+      report.maxImbalance = std::max(report.maxImbalance, imbalance);
+      report.meanImbalance += imbalance;
+      if (total >= stage.fanout) {
+        report.unusedMembers += unused;
+      }
+    }
+    if (loadedSwitches) {
+      report.meanImbalance /= loadedSwitches;
+    }
+    reports.push_back(std::move(report));
+    firstSwitch += numSwitches;
+    numSwitches *= stage.fanout;
+  }
+  return reports;
+}
+
+} // namespace facebook::fboss
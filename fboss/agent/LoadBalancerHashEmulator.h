@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/state/LoadBalancer.h"
+
+#include <folly/IPAddress.h>
+#include <folly/Range.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * The header fields of a packet which can take part in ECMP/LAG hashing.
+ *
+ * Addresses are stored in network byte order; IPv4 addresses only use the
+ * first 4 bytes. A flow with labels is an MPLS flow, and is hashed on its
+ * labels when the load balancer selects MPLS fields.
+ */
+struct LoadBalancerFlow {
+  LoadBalancerFlow() {}
+  LoadBalancerFlow(
+      const folly::IPAddress& src,
+      const folly::IPAddress& dst,
+      uint16_t srcPort,
+      uint16_t dstPort,
+      uint32_t flowLabel = 0);
+
+  std::array<uint8_t, 16> srcIp{};
+  std::array<uint8_t, 16> dstIp{};
+  uint32_t flowLabel{0};
+  uint16_t srcPort{0};
+  uint16_t dstPort{0};
+  bool isV6{false};
+  uint8_t numLabels{0};
+  std::array<uint32_t, 3> labels{};
+};
+
+/*
+ * Software model of the RTAG7 style hashing configured through a LoadBalancer:
+ * the fields selected by the load balancer are gathered into a fixed layout
+ * hash key (deselected fields are zeroed, as the ASIC masks them), which is
+ * run through the configured CRC seeded with the load balancer seed. The
+ * 16 bit result (the low or high half for the 32 bit CRCs) is what gets
+ * reduced modulo the number of members.
+ *
+ * The relative field order in the ASIC's hash key is not documented, so hash
+ * values are not bit exact with any particular ASIC. What the model preserves
+ * is which fields contribute, the CRC's mixing properties and the effect of
+ * seeds, which is what determines balance and polarization.
+ */
+class LoadBalancerHashEmulator {
+ public:
+  explicit LoadBalancerHashEmulator(const LoadBalancer& loadBalancer);
+  LoadBalancerHashEmulator(
+      cfg::HashingAlgorithm algorithm,
+      uint32_t seed,
+      LoadBalancer::IPv4Fields v4Fields,
+      LoadBalancer::IPv6Fields v6Fields,
+      LoadBalancer::TransportFields transportFields,
+      LoadBalancer::MPLSFields mplsFields = LoadBalancer::MPLSFields{});
+
+  uint16_t hash(const LoadBalancerFlow& flow) const;
+
+  /*
+   * Hash flows.size() flows into hashes, which must be at least as large.
+   * Keys for a whole block of flows are built first, then several CRCs are
+   * computed in an interleaved fashion so that their table lookups overlap.
+   */
+  void hash(
+      folly::Range<const LoadBalancerFlow*> flows,
+      folly::MutableRange<uint16_t*> hashes) const;
+
+  uint32_t getSeed() const {
+    return seed_;
+  }
+  void setSeed(uint32_t seed) {
+    seed_ = seed;
+  }
+
+  // Largest hash key built by buildKey()
+  static constexpr size_t kMaxKeyLen = 40;
+
+  /*
+   * Gather the selected fields of flow into key, returning the key length.
+   */
+  size_t buildKey(const LoadBalancerFlow& flow, uint8_t* key) const;
+
+ private:
+  cfg::HashingAlgorithm algorithm_;
+  uint32_t seed_;
+  bool v4Src_{false};
+  bool v4Dst_{false};
+  bool v6Src_{false};
+  bool v6Dst_{false};
+  bool v6FlowLabel_{false};
+  bool srcPort_{false};
+  bool dstPort_{false};
+  std::array<bool, 3> labels_{};
+};
+
+namespace loadbalancer_hash {
+/*
+ * The CRCs available to the load balancer. The seed is the initial value of
+ * the CRC register and there is no final xor.
+ */
+uint16_t crc16Ccitt(uint32_t seed, const uint8_t* data, size_t len);
+uint32_t crc32(uint32_t seed, const uint8_t* data, size_t len);
+uint32_t crc32Ethernet(uint32_t seed, const uint8_t* data, size_t len);
+uint32_t crc32Koopman(uint32_t seed, const uint8_t* data, size_t len);
+} // namespace loadbalancer_hash
+
+/*
+ * Emulates the distribution of flows through several stages of ECMP, e.g.
+ * RSW -> FSW -> SSW. Every stage has its own hash configuration and fanout.
+ * A flow picks a member at every stage, and the member it picked at a stage
+ * determines the switch it is hashed on at the next stage, so stage N has as
+ * many switches as the product of the fanouts of the stages before it.
+ *
+ * Reusing the same hash configuration on consecutive stages leads to
+ * polarization: all the flows reaching a switch hash identically there and
+ * only use a fraction of its members. Setting perSwitchSeed models the
+ * default agent behavior of deriving each switch's seed from its MAC address.
+ *
+ * Note that CRCs are linear: for keys of a given length, changing the seed
+ * xors every hash with the same constant. With power of two fanouts, distinct
+ * seeds alone therefore do not undo polarization; changing the algorithm, the
+ * hash half or the selected fields between stages does.
+ */
+class MultiStageEcmpEmulator {
+ public:
+  struct Stage {
+    LoadBalancerHashEmulator hasher;
+    uint32_t fanout;
+    bool perSwitchSeed{false};
+  };
+
+  struct StageReport {
+    uint32_t numSwitches{0};
+    uint32_t fanout{0};
+    // Number of flows which picked member m of switch s, at s * fanout + m
+    std::vector<uint64_t> memberLoad;
+    // Largest member load divided by the mean load, over switches which saw
+    // any flows. 1.0 is perfectly balanced.
+    double maxImbalance{0};
+    double meanImbalance{0};
+    // Number of members which did not get any flow on switches which saw at
+    // least fanout flows
+    uint64_t unusedMembers{0};
+  };
+
+  explicit MultiStageEcmpEmulator(std::vector<Stage> stages);
+
+  std::vector<StageReport> run(
+      folly::Range<const LoadBalancerFlow*> flows) const;
+
+  static uint32_t switchSeed(uint32_t seed, uint64_t switchIndex);
+
+ private:
+  std::vector<Stage> stages_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborChangeQueue.h"
+
+using folly::IPAddress;
+
+namespace facebook::fboss {
+
+void NeighborChangeQueue::neighborAdded(
+    const IPAddress& ip,
+    Clock::time_point now) {
+  neighborChanged(ip, true, now);
+}
+
+void NeighborChangeQueue::neighborRemoved(
+    const IPAddress& ip,
+    Clock::time_point now) {
+  neighborChanged(ip, false, now);
+}
+
+void NeighborChangeQueue::neighborChanged(
+    const IPAddress& ip,
+    bool resolved,
+    Clock::time_point now) {
+  noteChangeTime(now);
+  if (resync_) {
+    // The resync will carry the neighbors resolved by then
+    return;
+  }
+  auto it = pending_.find(ip);
+  if (it != pending_.end()) {
+    it->second.resolved = resolved;
+    return;
+  }
+  if (maxPending_ && pending_.size() >= maxPending_) {
+    requestResync(now);
+    return;
+  }
+  pending_.emplace(ip, PendingChange{!resolved, resolved});
+}
+
+void NeighborChangeQueue::requestResync(Clock::time_point now) {
+  noteChangeTime(now);
+  pending_.clear();
+  resync_ = true;
+}
+
+void NeighborChangeQueue::noteChangeTime(Clock::time_point now) {
+  if (!oldestChange_ || now < *oldestChange_) {
+    oldestChange_ = now;
+  }
+}
+
+std::optional<NeighborChangeQueue::Changes> NeighborChangeQueue::take() {
+  Changes changes;
+  changes.resync = resync_;
+  for (const auto& [ip, change] : pending_) {
+    if (change.resolved == change.wasResolved) {
+      continue;
+    }
+    if (change.resolved) {
+      changes.added.push_back(ip);
+    } else {
+      changes.removed.push_back(ip);
+    }
+  }
+  auto oldestChange = oldestChange_;
+  pending_.clear();
+  resync_ = false;
+  oldestChange_.reset();
+
+  if (!changes.resync && changes.added.empty() && changes.removed.empty()) {
+    return std::nullopt;
+  }
+  changes.oldestChange = oldestChange.value_or(Clock::time_point());
+  return changes;
+}
+
+} // namespace facebook::fboss
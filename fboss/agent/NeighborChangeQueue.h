@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/IPAddress.h>
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * The neighbor changes not yet delivered to one neighbor listener.
+ *
+ * Changes to the same neighbor are coalesced: only whether it is resolved
+ * at delivery time, compared to the last delivery, is kept. A neighbor
+ * which was added and removed again in between is not delivered at all.
+ *
+ * The number of neighbors pending is bounded. When a listener falls so far
+ * behind that the bound is exceeded, the pending changes are dropped and
+ * the next delivery is a resync, which carries every resolved neighbor
+ * instead.
+ *
+ * Not thread safe, each queue is only used from its listener's thread.
+ */
+class NeighborChangeQueue {
+ public:
+  // Wall clock, as the listeners compare the change times with theirs
+  using Clock = std::chrono::system_clock;
+
+  struct Changes {
+    std::vector<folly::IPAddress> added;
+    std::vector<folly::IPAddress> removed;
+    // Whether changes were dropped, and the listener needs to replace its
+    // neighbors with the resolved ones.
+    bool resync{false};
+    // When the oldest of these changes happened
+    Clock::time_point oldestChange;
+  };
+
+  /*
+   * At most maxPending neighbors are pending, 0 for no bound.
+   */
+  explicit NeighborChangeQueue(size_t maxPending = 0)
+      : maxPending_(maxPending) {}
+
+  void neighborAdded(const folly::IPAddress& ip, Clock::time_point now);
+  void neighborRemoved(const folly::IPAddress& ip, Clock::time_point now);
+
+  /*
+   * Drop the pending changes, and resync on the next delivery, e.g. for a
+   * new listener.
+   */
+  void requestResync(Clock::time_point now);
+
+  /*
+   * Take the changes to deliver, if any are left once coalesced. For a
+   * resync, the added neighbors are left for the caller to fill in.
+   */
+  std::optional<Changes> take();
+
+  bool empty() const {
+    return pending_.empty() && !resync_;
+  }
+  size_t numPending() const {
+    return pending_.size();
+  }
+  bool resyncPending() const {
+    return resync_;
+  }
+
+ private:
+  struct PendingChange {
+    // Whether the listener was last told the neighbor is resolved
+    bool wasResolved;
+    bool resolved;
+  };
+
+  void neighborChanged(
+      const folly::IPAddress& ip,
+      bool resolved,
+      Clock::time_point now);
+  void noteChangeTime(Clock::time_point now);
+
+  size_t maxPending_{0};
+  std::unordered_map<folly::IPAddress, PendingChange> pending_;
+  bool resync_{false};
+  std::optional<Clock::time_point> oldestChange_;
+};
+
+} // namespace facebook::fboss
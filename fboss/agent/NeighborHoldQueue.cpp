@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborHoldQueue.h"
+
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/TxPacket.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/logging/xlog.h>
+
+DEFINE_bool(
+    neighbor_hold_queue,
+    false,
+    "Hold packets punted to the CPU for next hop resolution until the next "
+    "hop is resolved, instead of dropping them");
+DEFINE_int32(
+    neighbor_hold_queue_packets_per_neighbor,
+    3,
+    "Maximum number of packets held per unresolved next hop. The oldest "
+    "packet is dropped to make room for a new one");
+DEFINE_int32(
+    neighbor_hold_queue_max_bytes,
+    256 * 1024,
+    "Maximum number of bytes held for all unresolved next hops");
+DEFINE_int32(
+    neighbor_hold_queue_max_age_ms,
+    1000,
+    "Packets held for longer than this are dropped");
+
+using folly::IPAddress;
+
+namespace facebook::fboss {
+
+NeighborHoldQueue::NeighborHoldQueue(SwSwitch* sw) : sw_(sw) {}
+
+NeighborHoldQueue::~NeighborHoldQueue() {}
+
+bool NeighborHoldQueue::enabled() const {
+  return FLAGS_neighbor_hold_queue &&
+      FLAGS_neighbor_hold_queue_packets_per_neighbor > 0;
+}
+
+bool NeighborHoldQueue::hold(
+    VlanID vlan,
+    const IPAddress& neighbor,
+    const RxPacket& pkt) {
+  auto length = pkt.buf()->computeChainDataLength();
+  auto maxBytes = static_cast<size_t>(FLAGS_neighbor_hold_queue_max_bytes);
+  auto maxPackets =
+      static_cast<size_t>(FLAGS_neighbor_hold_queue_packets_per_neighbor);
+  if (length > maxBytes) {
+    sw_->stats()->neighborHoldDropOverflow();
+    return false;
+  }
+  // Copy the packet, RX buffers may belong to a small pool of the hardware
+  auto copy = sw_->allocatePacket(length);
+  folly::io::RWPrivateCursor cursor(copy->buf());
+  cursor.push(folly::io::Cursor(pkt.buf()), length);
+
+  auto now = Clock::now();
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (numBytes_ + length > maxBytes) {
+    expireAllLocked(now);
+    if (numBytes_ + length > maxBytes) {
+      sw_->stats()->neighborHoldDropOverflow();
+      return false;
+    }
+  }
+  auto& queue = queues_[std::make_pair(vlan, neighbor)];
+  expireLocked(&queue, now);
+  while (queue.size() >= maxPackets) {
+    popFrontLocked(&queue);
+    sw_->stats()->neighborHoldDropOverflow();
+  }
+  queue.push_back(HeldPacket{std::move(copy), length, now});
+  numBytes_ += length;
+  ++numPackets_;
+  sw_->stats()->neighborHoldQueued();
+  return true;
+}
+
+void NeighborHoldQueue::neighborReachable(
+    VlanID vlan,
+    const IPAddress& neighbor) {
+  if (empty()) {
+    return;
+  }
+  PacketQueue toSend;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = queues_.find(std::make_pair(vlan, neighbor));
+    if (it == queues_.end()) {
+      return;
+    }
+    expireLocked(&it->second, Clock::now());
+    toSend.swap(it->second);
+    queues_.erase(it);
+    for (const auto& held : toSend) {
+      numBytes_ -= held.length;
+    }
+    numPackets_ -= toSend.size();
+  }
+  if (toSend.empty()) {
+    return;
+  }
+  XLOG(DBG4) << "sending " << toSend.size() << " held packets to " << neighbor
+             << " on vlan " << vlan;
+  sw_->stats()->neighborHoldFlushed(toSend.size());
+  for (auto& held : toSend) {
+    sw_->sendPacketSwitchedAsync(std::move(held.pkt));
+  }
+}
+
+void NeighborHoldQueue::neighborRemoved(
+    VlanID vlan,
+    const IPAddress& neighbor) {
+  if (empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = queues_.find(std::make_pair(vlan, neighbor));
+  if (it == queues_.end()) {
+    return;
+  }
+  auto dropped = it->second.size();
+  while (!it->second.empty()) {
+    popFrontLocked(&it->second);
+  }
+  queues_.erase(it);
+  sw_->stats()->neighborHoldDropExpired(dropped);
+}
+
+size_t NeighborHoldQueue::numBytes() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return numBytes_;
+}
+
+void NeighborHoldQueue::expireLocked(
+    PacketQueue* queue,
+    Clock::time_point now) {
+  auto maxAge = std::chrono::milliseconds(FLAGS_neighbor_hold_queue_max_age_ms);
+  size_t expired = 0;
+  while (!queue->empty() && now - queue->front().heldSince > maxAge) {
+    popFrontLocked(queue);
+    ++expired;
+  }
+  if (expired) {
+    sw_->stats()->neighborHoldDropExpired(expired);
+  }
+}
+
+void NeighborHoldQueue::expireAllLocked(Clock::time_point now) {
+  for (auto it = queues_.begin(); it != queues_.end();) {
+    expireLocked(&it->second, now);
+    if (it->second.empty()) {
+      it = queues_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void NeighborHoldQueue::popFrontLocked(PacketQueue* queue) {
+  numBytes_ -= queue->front().length;
+  --numPackets_;
+  queue->pop_front();
+}
+
+} // namespace facebook::fboss
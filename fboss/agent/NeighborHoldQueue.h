@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+DECLARE_bool(neighbor_hold_queue);
+DECLARE_int32(neighbor_hold_queue_packets_per_neighbor);
+DECLARE_int32(neighbor_hold_queue_max_bytes);
+DECLARE_int32(neighbor_hold_queue_max_age_ms);
+
+namespace facebook::fboss {
+
+class RxPacket;
+class SwSwitch;
+class TxPacket;
+
+/*
+ * Packets punted to the CPU because their next hop is not resolved yet are
+ * held here, per neighbor, instead of being dropped. Once the neighbor
+ * becomes reachable, i.e. the hardware can forward to it, they are sent
+ * through the pipeline again with sendPacketSwitchedAsync().
+ *
+ * Packets are bounded per neighbor, in total bytes and in age. Packets over
+ * the age limit are dropped lazily: when their neighbor gets more packets or
+ * becomes reachable, or when the byte limit is reached.
+ *
+ * Packets can be held from the RX threads while the update thread flushes
+ * them, so all methods are thread safe.
+ */
+class NeighborHoldQueue {
+ public:
+  explicit NeighborHoldQueue(SwSwitch* sw);
+  ~NeighborHoldQueue();
+
+  /*
+   * Whether packets should be held at all (--neighbor_hold_queue).
+   */
+  bool enabled() const;
+
+  /*
+   * Hold a copy of pkt until neighbor in vlan is reachable. Returns false,
+   * and counts a drop, if the packet does not fit in the queue.
+   */
+  bool hold(VlanID vlan, const folly::IPAddress& neighbor, const RxPacket& pkt);
+
+  /*
+   * Send the packets held for neighbor in vlan, which was just resolved.
+   */
+  void neighborReachable(VlanID vlan, const folly::IPAddress& neighbor);
+
+  /*
+   * Drop the packets held for neighbor in vlan, e.g. because its vlan went
+   * away.
+   */
+  void neighborRemoved(VlanID vlan, const folly::IPAddress& neighbor);
+
+  bool empty() const {
+    return numPackets_.load(std::memory_order_relaxed) == 0;
+  }
+  size_t numPackets() const {
+    return numPackets_.load(std::memory_order_relaxed);
+  }
+  size_t numBytes() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using NeighborKey = std::pair<VlanID, folly::IPAddress>;
+
+  struct HeldPacket {
+    std::unique_ptr<TxPacket> pkt;
+    size_t length;
+    Clock::time_point heldSince;
+  };
+  using PacketQueue = std::deque<HeldPacket>;
+
+  // Remove the packets of queue older than the age limit
+  void expireLocked(PacketQueue* queue, Clock::time_point now);
+  // Remove the packets older than the age limit of all neighbors
+  void expireAllLocked(Clock::time_point now);
+  void popFrontLocked(PacketQueue* queue);
+
+  // Forbidden copy constructor and assignment operator
+  NeighborHoldQueue(NeighborHoldQueue const&) = delete;
+  NeighborHoldQueue& operator=(NeighborHoldQueue const&) = delete;
+
+  SwSwitch* sw_{nullptr};
+  mutable std::mutex mutex_;
+  std::map<NeighborKey, PacketQueue> queues_;
+  size_t numBytes_{0};
+  // Read without the lock, to skip flushes when nothing is held
+  std::atomic<size_t> numPackets_{0};
+};
+
+} // namespace facebook::fboss
@@ -1,16 +1,22 @@
 #include "fboss/agent/if/gen-cpp2/NeighborListenerClient.h"
+#include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
 
+#include <folly/IPAddress.h>
 #include <folly/SocketAddress.h>
+#include <folly/experimental/FunctionScheduler.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
 #include <gflags/gflags.h>
 #include <thrift/lib/cpp/async/TAsyncSocket.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 
 using namespace apache::thrift;
 using namespace apache::thrift::util;
@@ -21,20 +27,64 @@ using namespace folly;
 
 DEFINE_string(host, "", "The host to connect to");
 DEFINE_int32(port, 5909, "The port to connect to");
+DEFINE_int32(
+    lag_report_interval_s,
+    10,
+    "How often to log the neighbor change delivery lag");
 
+/*
+ * Keeps track of the resolved neighbors, and of how long changes took to be
+ * delivered, e.g. to check the agent keeps up under neighbor churn.
+ */
 class NeighborListenerClientInterface : public NeighborListenerClientSvIf {
  public:
-  void async_tm_neighboursChanged(
+  void async_tm_binaryNeighborsChanged(
       std::unique_ptr<apache::thrift::HandlerCallback<void>> cb,
-      std::unique_ptr<std::vector<std::string>> added,
-      std::unique_ptr<std::vector<std::string>> removed) {
-    for (const auto& up : *added) {
-      XLOG(INFO) << "neighbour added: " << up << "\n";
-    }
-    for (const auto& down : *removed) {
-      XLOG(INFO) << "neighbour added: " << down << "\n";
+      std::unique_ptr<NeighborChangesThrift> changes) override {
+    auto nowUsec = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+    auto lagUsec = std::max<int64_t>(0, nowUsec - changes->oldestChangeUsec);
+    {
+      std::lock_guard<std::mutex> g(mutex_);
+      if (changes->resync) {
+        XLOG(INFO) << "resync with " << changes->added.size() << " neighbors";
+        neighbors_.clear();
+        ++resyncs_;
+      }
+      for (const auto& added : changes->added) {
+        neighbors_.insert(facebook::network::toIPAddress(added));
+      }
+      for (const auto& removed : changes->removed) {
+        neighbors_.erase(facebook::network::toIPAddress(removed));
+      }
+      ++batches_;
+      changesDelivered_ += changes->added.size() + changes->removed.size();
+      totalLagUsec_ += lagUsec;
+      maxLagUsec_ = std::max(maxLagUsec_, lagUsec);
     }
+    cb->done();
+  }
+
+  void reportLag() {
+    std::lock_guard<std::mutex> g(mutex_);
+    XLOG(INFO) << neighbors_.size() << " neighbors, " << batches_
+               << " batches with " << changesDelivered_ << " changes and "
+               << resyncs_ << " resyncs, lag avg "
+               << (batches_ ? totalLagUsec_ / batches_ : 0) << "us max "
+               << maxLagUsec_ << "us";
+    batches_ = changesDelivered_ = resyncs_ = 0;
+    totalLagUsec_ = maxLagUsec_ = 0;
   }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_set<IPAddress> neighbors_;
+  uint64_t batches_{0};
+  uint64_t changesDelivered_{0};
+  uint64_t resyncs_{0};
+  int64_t totalLagUsec_{0};
+  int64_t maxLagUsec_{0};
 };
 
 int main(int argc, char** argv) {
@@ -50,16 +100,22 @@ int main(int argc, char** argv) {
       std::make_shared<DuplexChannel>(DuplexChannel::Who::CLIENT, socket);
   ThriftServer clients_server(chan->getServerChannel());
   clients_server.setIdleTimeout(std::chrono::milliseconds(0));
-  clients_server.setInterface(
-      std::make_shared<NeighborListenerClientInterface>());
+  auto listener = std::make_shared<NeighborListenerClientInterface>();
+  clients_server.setInterface(listener);
   clients_server.serve();
 
   FbossCtrlAsyncClient client(chan->getClientChannel());
-  client.registerForNeighborChanged([](ClientReceiveState&& state) {
-    PortStatus ps;
-    FbossCtrlAsyncClient::recv_registerForNeighborChanged(state);
-    XLOG(INFO) << "registered for port status on " << FLAGS_host << "\n";
+  client.registerForBinaryNeighborChanges([](ClientReceiveState&& state) {
+    FbossCtrlAsyncClient::recv_registerForBinaryNeighborChanges(state);
+    XLOG(INFO) << "registered for neighbor changes on " << FLAGS_host;
   });
 
+  folly::FunctionScheduler scheduler;
+  scheduler.addFunction(
+      [listener] { listener->reportLag(); },
+      std::chrono::seconds(FLAGS_lag_report_interval_s),
+      "reportLag");
+  scheduler.start();
+
   base.loopForever();
 }
@@ -13,6 +13,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/IPv6Handler.h"
 #include "fboss/agent/NdpCache.h"
+#include "fboss/agent/NeighborHoldQueue.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/state/ArpTable.h"
@@ -76,6 +77,7 @@ void NeighborUpdater::stateUpdated(const StateDelta& delta) {
   CHECK(sw_->getUpdateEvb()->inRunningEventBaseThread());
   for (const auto& entry : delta.getVlansDelta()) {
     sendNeighborUpdates(entry);
+    flushHeldPackets(entry);
     auto oldEntry = entry.getOld();
     auto newEntry = entry.getNew();
 
@@ -118,34 +120,34 @@ void NeighborUpdater::stateUpdated(const StateDelta& delta) {
 template <typename T>
 void collectPresenceChange(
     const T& delta,
-    std::vector<std::string>* added,
-    std::vector<std::string>* deleted) {
+    std::vector<folly::IPAddress>* added,
+    std::vector<folly::IPAddress>* deleted) {
   for (const auto& entry : delta) {
     auto oldEntry = entry.getOld();
     auto newEntry = entry.getNew();
     if (oldEntry && !newEntry) {
       if (oldEntry->nonZeroPort()) {
-        deleted->push_back(folly::to<std::string>(oldEntry->getIP()));
+        deleted->push_back(oldEntry->getIP());
       }
     } else if (newEntry && !oldEntry) {
       if (newEntry->nonZeroPort()) {
-        added->push_back(folly::to<std::string>(newEntry->getIP()));
+        added->push_back(newEntry->getIP());
       }
     } else {
       if (oldEntry->zeroPort() && newEntry->nonZeroPort()) {
         // Entry was resolved, add it
-        added->push_back(folly::to<std::string>(newEntry->getIP()));
+        added->push_back(newEntry->getIP());
       } else if (oldEntry->nonZeroPort() && newEntry->zeroPort()) {
         // Entry became unresolved, prune it
-        deleted->push_back(folly::to<std::string>(oldEntry->getIP()));
+        deleted->push_back(oldEntry->getIP());
       }
     }
   }
 }
 
 void NeighborUpdater::sendNeighborUpdates(const VlanDelta& delta) {
-  std::vector<std::string> added;
-  std::vector<std::string> deleted;
+  std::vector<folly::IPAddress> added;
+  std::vector<folly::IPAddress> deleted;
   collectPresenceChange(delta.getArpDelta(), &added, &deleted);
   collectPresenceChange(delta.getNdpDelta(), &added, &deleted);
   if (!(added.empty() && deleted.empty())) {
@@ -153,6 +155,35 @@ void NeighborUpdater::sendNeighborUpdates(const VlanDelta& delta) {
   }
 }
 
+template <typename T>
+void flushHeldPacketsForNeighbors(
+    VlanID vlan,
+    const T& delta,
+    NeighborHoldQueue* holdQueue) {
+  for (const auto& entry : delta) {
+    auto oldEntry = entry.getOld();
+    auto newEntry = entry.getNew();
+    if (!newEntry) {
+      holdQueue->neighborRemoved(vlan, IPAddress(oldEntry->getIP()));
+    } else if (!newEntry->isPending() && (!oldEntry || oldEntry->isPending())) {
+      // The hardware was programmed with the new entry before observers got
+      // the delta, so held packets can now be forwarded
+      holdQueue->neighborReachable(vlan, IPAddress(newEntry->getIP()));
+    }
+  }
+}
+
+void NeighborUpdater::flushHeldPackets(const VlanDelta& delta) {
+  auto holdQueue = sw_->getNeighborHoldQueue();
+  if (holdQueue->empty()) {
+    return;
+  }
+  auto vlan =
+      delta.getNew() ? delta.getNew()->getID() : delta.getOld()->getID();
+  flushHeldPacketsForNeighbors(vlan, delta.getArpDelta(), holdQueue);
+  flushHeldPacketsForNeighbors(vlan, delta.getNdpDelta(), holdQueue);
+}
+
 void NeighborUpdater::portChanged(
     const std::shared_ptr<Port>& oldPort,
     const std::shared_ptr<Port>& newPort) {
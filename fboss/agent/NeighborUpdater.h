@@ -105,6 +105,8 @@ class NeighborUpdater : public AutoRegisterStateObserver {
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
   void sendNeighborUpdates(const VlanDelta& delta);
+  // Send or drop packets held until neighbors in delta are resolved
+  void flushHeldPackets(const VlanDelta& delta);
 
   // Forbidden copy constructor and assignment operator
   NeighborUpdater(NeighborUpdater const&) = delete;
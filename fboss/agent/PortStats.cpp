@@ -179,6 +179,10 @@ void PortStats::pktTooBig() {
   switchStats_->pktTooBig();
 }
 
+void PortStats::icmpErrorSuppressed() {
+  switchStats_->icmpErrorSuppressed();
+}
+
 std::string PortStats::getCounterKey(const std::string& key) {
   return folly::to<std::string>(portName_, kNameKeySeperator, key);
 }
@@ -66,6 +66,7 @@ class PortStats {
   void clearPortStatusCounter();
 
   void pktTooBig();
+  void icmpErrorSuppressed();
 
   void setPortName(const std::string& portName);
   std::string getPortName() {
@@ -10,30 +10,196 @@
 
 #include "fboss/agent/StandaloneRibConversions.h"
 
+#include "fboss/agent/Constants.h"
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableRib.h"
+
+#include <boost/container/container_fwd.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 
+namespace {
+
+template <
+    typename DstNextHop,
+    typename ResolvedT,
+    typename UnresolvedT,
+    typename SrcNextHop>
+DstNextHop convertNextHop(const SrcNextHop& nhop) {
+  if (nhop.isResolved()) {
+    return ResolvedT(
+        nhop.addr(), nhop.intf(), nhop.weight(), nhop.labelForwardingAction());
+  }
+  return UnresolvedT(nhop.addr(), nhop.weight(), nhop.labelForwardingAction());
+}
+
+rib::RouteNextHopEntry toStandaloneRib(const RouteNextHopEntry& entry) {
+  switch (entry.getAction()) {
+    case RouteForwardAction::DROP:
+      return rib::RouteNextHopEntry(
+          rib::RouteForwardAction::DROP, entry.getAdminDistance());
+    case RouteForwardAction::TO_CPU:
+      return rib::RouteNextHopEntry(
+          rib::RouteForwardAction::TO_CPU, entry.getAdminDistance());
+    case RouteForwardAction::NEXTHOPS: {
+      rib::RouteNextHopEntry::NextHopSet nhops;
+      nhops.reserve(entry.getNextHopSet().size());
+      for (const auto& nhop : entry.getNextHopSet()) {
+        nhops.insert(
+            nhops.end(),
+            convertNextHop<
+                rib::NextHop,
+                rib::ResolvedNextHop,
+                rib::UnresolvedNextHop>(nhop));
+      }
+      return rib::RouteNextHopEntry(std::move(nhops), entry.getAdminDistance());
+    }
+  }
+  throw FbossError("Unknown RouteForwardAction: ", entry.getAction());
+}
+
+RouteNextHopEntry toSwitchStateRib(const rib::RouteNextHopEntry& entry) {
+  switch (entry.getAction()) {
+    case rib::RouteForwardAction::DROP:
+      return RouteNextHopEntry(
+          RouteForwardAction::DROP, entry.getAdminDistance());
+    case rib::RouteForwardAction::TO_CPU:
+      return RouteNextHopEntry(
+          RouteForwardAction::TO_CPU, entry.getAdminDistance());
+    case rib::RouteForwardAction::NEXTHOPS: {
+      RouteNextHopEntry::NextHopSet nhops;
+      nhops.reserve(entry.getNextHopSet().size());
+      for (const auto& nhop : entry.getNextHopSet()) {
+        nhops.insert(
+            nhops.end(),
+            convertNextHop<NextHop, ResolvedNextHop, UnresolvedNextHop>(nhop));
+      }
+      return RouteNextHopEntry(std::move(nhops), entry.getAdminDistance());
+    }
+  }
+  throw FbossError("Unknown RouteForwardAction: ", entry.getAction());
+}
+
+template <typename AddrT>
+rib::NetworkToRouteMap<AddrT> toStandaloneRib(
+    const RouteTableRib<AddrT>& swStateRib) {
+  using NetworkToRouteMap = rib::NetworkToRouteMap<AddrT>;
+  std::vector<typename NetworkToRouteMap::BulkLoadEntry> entries;
+  entries.reserve(swStateRib.size());
+  for (const auto& node : swStateRib.routes()->getAllNodes()) {
+    const auto& fields = node.second->getFields();
+    rib::RouteNextHopsMulti nexthopsmulti;
+    for (const auto& clientAndEntry : fields->nexthopsmulti.getAllEntries()) {
+      nexthopsmulti.update(
+          clientAndEntry.first, toStandaloneRib(clientAndEntry.second));
+    }
+    rib::RoutePrefix<AddrT> prefix{fields->prefix.network, fields->prefix.mask};
+    entries.push_back({prefix.network,
+                       prefix.mask,
+                       rib::Route<AddrT>(
+                           prefix,
+                           std::move(nexthopsmulti),
+                           toStandaloneRib(fields->fwd),
+                           fields->flags)});
+  }
+  // SwitchState orders prefixes by mask length first, bulkLoad() sorts them
+  // into tree order
+  NetworkToRouteMap networkToRoute;
+  networkToRoute.bulkLoad(std::move(entries));
+  return networkToRoute;
+}
+
+template <typename AddrT>
+std::shared_ptr<RouteTableRib<AddrT>> toSwitchStateRib(
+    const rib::NetworkToRouteMap<AddrT>& networkToRoute) {
+  using RouteTableRibT = RouteTableRib<AddrT>;
+  std::vector<std::pair<RoutePrefix<AddrT>, std::shared_ptr<Route<AddrT>>>>
+      routes;
+  routes.reserve(networkToRoute.size());
+  std::vector<typename RouteTableRibT::RoutesRadixTree::BulkLoadEntry>
+      radixTreeEntries;
+  radixTreeEntries.reserve(networkToRoute.size());
+  for (const auto& node : networkToRoute) {
+    const auto& ribRoute = node.value();
+    RoutePrefix<AddrT> prefix{ribRoute.prefix().network,
+                              ribRoute.prefix().mask};
+    auto route = std::make_shared<Route<AddrT>>(prefix);
+    auto fields = route->writableFields();
+    for (const auto& clientAndEntry :
+         ribRoute.getNextHopsMulti().getAllEntries()) {
+      fields->nexthopsmulti.update(
+          clientAndEntry.first, toSwitchStateRib(clientAndEntry.second));
+    }
+    fields->fwd = toSwitchStateRib(ribRoute.getForwardInfo());
+    fields->flags = ribRoute.getFlags();
+    radixTreeEntries.push_back({prefix.network, prefix.mask, route});
+    routes.emplace_back(prefix, std::move(route));
+  }
+
+  auto swStateRib = std::make_shared<RouteTableRibT>();
+  // The radix tree takes the routes in the order we walked them, while the
+  // node map orders them by mask length first
+  swStateRib->writableRoutesRadixTree().bulkLoad(std::move(radixTreeEntries));
+  std::sort(routes.begin(), routes.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  swStateRib->writableRoutes()->writableNodes() =
+      typename RouteTableRibT::RoutesNodeMap::NodeContainer(
+          boost::container::ordered_unique_range,
+          std::make_move_iterator(routes.begin()),
+          std::make_move_iterator(routes.end()));
+  return swStateRib;
+}
+
+} // namespace
+
 rib::RoutingInformationBase switchStateToStandaloneRib(
     const std::shared_ptr<RouteTableMap>& swStateRib) {
-  auto serializedSwState = swStateRib->toFollyDynamic();
-  folly::dynamic serialized = folly::dynamic::object;
-  for (const auto& entry : serializedSwState[kEntries]) {
-    serialized[folly::to<std::string>(entry[kRouterId].asInt())] = entry;
+  rib::RoutingInformationBase rib;
+  for (const auto& routeTable : *swStateRib) {
+    rib.setVrfRoutes(
+        routeTable->getID(),
+        toStandaloneRib(*routeTable->getRibV4()),
+        toStandaloneRib(*routeTable->getRibV6()));
+  }
+  return rib;
+}
+
+rib::RoutingInformationBase switchStateToStandaloneRib(
+    const folly::dynamic& swStateRibJson) {
+  // The route JSON of both representations is the same, so each route table
+  // can be loaded as is
+  rib::RoutingInformationBase rib;
+  for (const auto& entry : swStateRibJson[kEntries]) {
+    rib.setVrfRoutes(
+        RouterID(entry[kRouterId].asInt()),
+        rib::IPv4NetworkToRouteMap::fromFollyDynamic(entry[kRibV4]),
+        rib::IPv6NetworkToRouteMap::fromFollyDynamic(entry[kRibV6]));
   }
-  return rib::RoutingInformationBase::fromFollyDynamic(serialized);
+  return rib;
 }
 
 std::shared_ptr<RouteTableMap> standaloneToSwitchStateRib(
     const rib::RoutingInformationBase& standaloneRib) {
-  auto serializedRib = standaloneRib.toFollyDynamic();
-  folly::dynamic serialized = folly::dynamic::object;
-  serialized[kExtraFields] = folly::dynamic::object;
-  serialized[kEntries] = folly::dynamic::array;
-  for (const auto& entry : serializedRib.values()) {
-    serialized[kEntries].push_back(entry);
-  }
-  return RouteTableMap::fromFollyDynamic(serialized);
+  auto swStateRib = std::make_shared<RouteTableMap>();
+  standaloneRib.forEachVrf([&swStateRib](
+                               RouterID rid,
+                               const rib::IPv4NetworkToRouteMap& v4,
+                               const rib::IPv6NetworkToRouteMap& v6) {
+    auto routeTable = std::make_shared<RouteTable>(rid);
+    routeTable->setRib(toSwitchStateRib(v4));
+    routeTable->setRib(toSwitchStateRib(v6));
+    swStateRib->addRouteTable(routeTable);
+  });
+  return swStateRib;
 }
 
 static void dynamicFibUpdate(
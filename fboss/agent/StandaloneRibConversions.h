@@ -14,6 +14,8 @@
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/RouteTableMap.h"
 
+#include <folly/dynamic.h>
+
 #include <memory>
 
 namespace facebook::fboss {
@@ -21,6 +23,14 @@ namespace facebook::fboss {
 rib::RoutingInformationBase switchStateToStandaloneRib(
     const std::shared_ptr<RouteTableMap>& swStateRib);
 
+/*
+ * Same as above, but straight from the serialized RouteTableMap, e.g. the
+ * route tables of the warm boot state, without building SwitchState routes
+ * first.
+ */
+rib::RoutingInformationBase switchStateToStandaloneRib(
+    const folly::dynamic& swStateRibJson);
+
 std::shared_ptr<RouteTableMap> standaloneToSwitchStateRib(
     const rib::RoutingInformationBase& standaloneRib);
 
@@ -25,6 +25,7 @@
 #include "fboss/agent/LookupClassUpdater.h"
 #include "fboss/agent/MacTableManager.h"
 #include "fboss/agent/MirrorManager.h"
+#include "fboss/agent/NeighborHoldQueue.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -39,6 +40,7 @@
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/capture/PacketTap.h"
 #include "fboss/agent/capture/PcapPkt.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
 #include "fboss/agent/gen-cpp2/switch_config_types_custom_protocol.h"
@@ -47,7 +49,9 @@
 #include "fboss/agent/packet/IPv6Hdr.h"
 #include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/state/AggregatePort.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
 #include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateDeltaSlicer.h"
 #include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
@@ -94,10 +98,24 @@ using namespace apache::thrift::protocol;
 using namespace apache::thrift::async;
 
 DEFINE_int32(thread_heartbeat_ms, 1000, "Thread heartbeat interval (ms)");
+DEFINE_string(
+    packet_tap_name,
+    "",
+    "Name of the shared memory segment exposing CPU RX/TX packets to local "
+    "consumers. The tap is disabled if empty.");
 DEFINE_int32(
-    distribution_timeout_ms,
-    1000,
-    "Timeout for sending to distribution_service (ms)");
+    packet_tap_slots,
+    8192,
+    "Number of packets held in the packet tap ring");
+DEFINE_int32(
+    packet_tap_snaplen,
+    256,
+    "Maximum number of bytes of each packet copied into the packet tap");
+DEFINE_int32(
+    max_route_changes_per_hw_update,
+    0,
+    "Program larger route changes in slices of at most this many routes, "
+    "processing other state updates in between. 0 disables slicing.");
 
 namespace {
 
@@ -139,6 +157,28 @@ facebook::fboss::PortStatus fillInPortStatus(
   }
   return status;
 }
+
+/*
+ * The ethertype and 802.1Q vlan of an outgoing frame, for the packet tap.
+ * Both are 0 for frames too short to hold them.
+ */
+std::pair<uint16_t, uint16_t> getTxEthertypeAndVlan(const folly::IOBuf* buf) {
+  Cursor c(buf);
+  if (!c.canAdvance(14)) {
+    return {0, 0};
+  }
+  c += 12; // Skip the destination and source MACs
+  auto ethertype = c.readBE<uint16_t>();
+  uint16_t vlan = 0;
+  if (ethertype == 0x8100) {
+    if (!c.canAdvance(4)) {
+      return {0, 0};
+    }
+    vlan = c.readBE<uint16_t>() & 0xfff;
+    ethertype = c.readBE<uint16_t>();
+  }
+  return {ethertype, vlan};
+}
 } // anonymous namespace
 
 namespace facebook::fboss {
@@ -150,6 +190,7 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
       nUpdater_(new NeighborUpdater(this)),
+      neighborHoldQueue_(new NeighborHoldQueue(this)),
       pcapMgr_(new PktCaptureManager(this)),
       mirrorManager_(new MirrorManager(this)),
       routeUpdateLogger_(new RouteUpdateLogger(this)),
@@ -297,20 +338,12 @@ void SwSwitch::gracefulExit() {
                       stopThreadsAndHandlersDone - neighborFloodDone)
                       .count();
 
-    folly::dynamic switchState = folly::dynamic::object;
     // TODO - Serialize both desired and applied state to
     // file. Right now we just serialize applied state and
     // then rely on a route/FIB sync on warm boot to recover
-    // desired state.
-    switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
-
-    steady_clock::time_point switchStateToFollyDone = steady_clock::now();
-    XLOG(INFO) << "[Exit] Switch state to folly dynamic "
-               << duration_cast<duration<float>>(
-                      switchStateToFollyDone - stopThreadsAndHandlersDone)
-                      .count();
+    // desired state. The HwSwitch streams it to the warm boot file.
     // Cleanup if we ever initialized
-    hw_->gracefulExit(switchState);
+    hw_->gracefulExit(getAppliedState());
     XLOG(INFO)
         << "[Exit] SwSwitch Graceful Exit time "
         << duration_cast<duration<float>>(steady_clock::now() - begin).count();
@@ -334,16 +367,16 @@ void SwSwitch::updateStats() {
 
 void SwSwitch::registerNeighborListener(
     std::function<void(
-        const std::vector<std::string>& added,
-        const std::vector<std::string>& deleted)> callback) {
+        const std::vector<folly::IPAddress>& added,
+        const std::vector<folly::IPAddress>& deleted)> callback) {
   XLOG(DBG2) << "Registering neighbor listener";
   lock_guard<mutex> g(neighborListenerMutex_);
   neighborListener_ = std::move(callback);
 }
 
 void SwSwitch::invokeNeighborListener(
-    const std::vector<std::string>& added,
-    const std::vector<std::string>& removed) {
+    const std::vector<folly::IPAddress>& added,
+    const std::vector<folly::IPAddress>& removed) {
   lock_guard<mutex> g(neighborListenerMutex_);
   if (neighborListener_) {
     neighborListener_(added, removed);
@@ -355,36 +388,61 @@ bool SwSwitch::getAndClearNeighborHit(RouterID vrf, folly::IPAddress ip) {
 }
 
 void SwSwitch::exitFatal() const noexcept {
-  folly::dynamic switchState = folly::dynamic::object;
-  switchState[kSwSwitch] = getAppliedState()->toFollyDynamic();
-  switchState[kHwSwitch] = hw_->toFollyDynamic();
-  if (!dumpStateToFile(platform_->getCrashSwitchStateFile(), switchState)) {
+  // Stream the state out rather than building it all in memory first, we may
+  // well be here because memory is short
+  auto appliedState = getAppliedState();
+  auto writeState = [this, &appliedState](JsonStreamWriter& writer) {
+    writer.beginObject();
+    writer.key(kSwSwitch);
+    appliedState->writeJson(writer);
+    writer.key(kHwSwitch);
+    hw_->writeJson(writer);
+    writer.endObject();
+  };
+  if (!dumpStateToFile(platform_->getCrashSwitchStateFile(), writeState)) {
     XLOG(ERR) << "Unable to write switch state JSON to file";
   }
 }
 
 void SwSwitch::publishRxPacket(RxPacket* pkt, uint16_t ethertype) {
-  RxPacketData pubPkt;
-  pubPkt.srcPort = pkt->getSrcPort();
-  pubPkt.srcVlan = pkt->getSrcVlan();
-
-  for (const auto& r : pkt->getReasons()) {
-    RxReason reason;
-    reason.bytes = r.bytes;
-    reason.description = r.description;
-    pubPkt.reasons.push_back(reason);
+  if (packetTap_) {
+    packetTap_->publish(pkt, ethertype);
   }
+}
 
-  folly::IOBuf buf_copy;
-  pkt->buf()->cloneInto(buf_copy);
-  pubPkt.packetData = buf_copy.moveToFbString();
+void SwSwitch::publishTxPacket(
+    TxPacket* pkt,
+    PortID port,
+    uint16_t vlan,
+    uint16_t ethertype) {
+  if (!packetTap_) {
+    return;
+  }
+  AggregatePortID aggregatePort{0};
+  if (port != PortID(0)) {
+    auto members = tapAggregatePorts_.rlock();
+    auto itr = members->find(port);
+    if (itr != members->end()) {
+      aggregatePort = itr->second;
+    }
+  }
+  packetTap_->publish(pkt, port, aggregatePort, vlan, ethertype);
 }
 
-void SwSwitch::publishTxPacket(TxPacket* pkt, uint16_t ethertype) {
-  TxPacketData pubPkt;
-  folly::IOBuf copy_buf;
-  pkt->buf()->cloneInto(copy_buf);
-  pubPkt.packetData = copy_buf.moveToFbString();
+void SwSwitch::updateTapAggregatePorts(
+    const std::shared_ptr<SwitchState>& oldState,
+    const std::shared_ptr<SwitchState>& newState) {
+  if (!packetTap_ ||
+      oldState->getAggregatePorts() == newState->getAggregatePorts()) {
+    return;
+  }
+  std::unordered_map<PortID, AggregatePortID> members;
+  for (const auto& aggPort : *newState->getAggregatePorts()) {
+    for (const auto& subport : aggPort->sortedSubports()) {
+      members.emplace(subport.portID, aggPort->getID());
+    }
+  }
+  tapAggregatePorts_.wlock()->swap(members);
 }
 
 void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
@@ -397,6 +455,13 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   auto initialStateDesired = hwInitRet.switchState;
   bootType_ = hwInitRet.bootType;
 
+  if (!FLAGS_packet_tap_name.empty()) {
+    packetTap_ = std::make_unique<PacketTapWriter>(
+        FLAGS_packet_tap_name,
+        FLAGS_packet_tap_slots,
+        FLAGS_packet_tap_snaplen);
+  }
+
   XLOG(DBG0) << "hardware initialized in " << hwInitRet.bootTime
              << " seconds; applying initial config";
 
@@ -407,6 +472,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   initialState->publish();
   initialStateDesired->publish();
   setStateInternal(initialState, initialStateDesired);
+  updateTapAggregatePorts(
+      std::make_shared<SwitchState>(), initialStateDesired);
 
   if (flags & SwitchFlags::ENABLE_TUN) {
     if (tunMgr) {
@@ -434,7 +501,7 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       // send a state update to h/w
       updateEventBase_.runInEventBaseThread(
           [alpmInitState, initialStateDesired, this]() {
-            applyUpdate(initialStateDesired, alpmInitState);
+            applyUpdate(initialStateDesired, alpmInitState, alpmInitState);
           });
     }
   }
@@ -757,16 +824,38 @@ void SwSwitch::handlePendingUpdates() {
 
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
-    // There was some change during these state updates
-    auto newAppliedState = applyUpdate(oldAppliedState, newDesiredState);
-    // Stick the initial applied->desired in the beginning
-    bool newOutOfSync = (newAppliedState != newDesiredState);
+    // There was some change during these state updates. Huge changes are
+    // programmed one slice at a time, so that the update thread gets to
+    // process other updates in between.
+    auto hwTargetState = newDesiredState;
+    if (FLAGS_max_route_changes_per_hw_update > 0) {
+      auto slice = sliceRouteChanges(
+          StateDelta(oldAppliedState, newDesiredState),
+          FLAGS_max_route_changes_per_hw_update,
+          &hwSliceCursor_);
+      fb303::fbData->setCounter(
+          "hw_update_pending_route_changes", slice.remainingRouteChanges);
+      if (slice.state != newDesiredState) {
+        XLOG(INFO) << "programming " << slice.routeChanges
+                   << " route changes, " << slice.remainingRouteChanges
+                   << " left";
+        fb303::fbData->addStatValue("hw_update_slices", 1, fb303::SUM);
+        slice.state->publish();
+        hwTargetState = slice.state;
+      }
+    }
+    auto newAppliedState =
+        applyUpdate(oldAppliedState, hwTargetState, newDesiredState);
+    // Only failures to program the slice mean that hardware is out of sync
+    bool newOutOfSync = (newAppliedState != hwTargetState);
     fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
-    if (newOutOfSync) {
-      // If we could not apply the whole delta successfully, put the difference
-      // as a state update at the beginning
+    if (newAppliedState != newDesiredState) {
+      // If we could not apply the whole delta, put the difference as a state
+      // update at the beginning. The rest of a sliced update needs to be
+      // processed right away rather than with the next incoming update.
       queueStateUpdateForGettingHwInSync(
-          "state update for failed hardware application",
+          newOutOfSync ? "state update for failed hardware application"
+                       : "state update for remaining hardware slices",
           [newDesiredState,
            newAppliedState](const std::shared_ptr<SwitchState>& /*oldState*/) {
             // clone the newDesiredState and then inheritGeneration from
@@ -776,6 +865,9 @@ void SwSwitch::handlePendingUpdates() {
             hwOutOfSyncState->inheritGeneration(*newAppliedState);
             return hwOutOfSyncState;
           });
+      if (!newOutOfSync) {
+        updateEventBase_.runInEventBaseThread(handlePendingUpdatesHelper, this);
+      }
     }
   }
 
@@ -812,7 +904,8 @@ void SwSwitch::setDesiredState(std::shared_ptr<SwitchState> newDesiredState) {
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     const shared_ptr<SwitchState>& oldState,
-    const shared_ptr<SwitchState>& newState) {
+    const shared_ptr<SwitchState>& newState,
+    const shared_ptr<SwitchState>& desiredState) {
   // Check that we are starting from what has been already applied
   DCHECK_EQ(oldState, getAppliedState());
 
@@ -857,7 +950,10 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
                 << folly::exceptionStr(ex);
   }
 
-  setStateInternal(newAppliedState, newState);
+  // The rest of a sliced update is still desired, so that readers of the
+  // state see their changes before the hardware has all of them
+  setStateInternal(newAppliedState, desiredState);
+  updateTapAggregatePorts(oldState, newState);
 
   // Notifies all observers of the current state update. We notify them that
   // the state changed to "desired state", even if the whole state might not
@@ -881,13 +977,17 @@ void SwSwitch::dumpBadStateUpdate(
   utilCreateDir(platform_->getCrashBadStateUpdateDir());
   if (!dumpStateToFile(
           platform_->getCrashBadStateUpdateOldStateFile(),
-          oldState->toFollyDynamic())) {
+          [&oldState](JsonStreamWriter& writer) {
+            oldState->writeJson(writer);
+          })) {
     XLOG(ERR) << "Unable to write old switch state JSON to "
               << platform_->getCrashBadStateUpdateOldStateFile();
   }
   if (!dumpStateToFile(
           platform_->getCrashBadStateUpdateNewStateFile(),
-          newState->toFollyDynamic())) {
+          [&newState](JsonStreamWriter& writer) {
+            newState->writeJson(writer);
+          })) {
     XLOG(ERR) << "Unable to write new switch state JSON to "
               << platform_->getCrashBadStateUpdateNewStateFile();
   }
@@ -1002,6 +1102,8 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
              << " src=" << srcMac << " dst=" << dstMac << " ethertype=0x"
              << std::hex << ethertype << " :: " << pkt->describeDetails();
 
+  publishRxPacket(pkt.get(), ethertype);
+
   switch (ethertype) {
     case ArpHandler::ETHERTYPE_ARP:
       arp_->handlePacket(std::move(pkt), dstMac, srcMac, c);
@@ -1081,10 +1183,6 @@ void SwSwitch::startThreads() {
       [=] { this->threadLoop("fbossUpdateThread", &updateEventBase_); }));
   packetTxThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossPktTxThread", &packetTxEventBase_); }));
-  pcapDistributionThread_.reset(new std::thread([=] {
-    this->threadLoop(
-        "fbossPcapDistributionThread", &pcapDistributionEventBase_);
-  }));
   lacpThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossLacpThread", &lacpEventBase_); }));
   neighborCacheThread_.reset(new std::thread([=] {
@@ -1111,10 +1209,6 @@ void SwSwitch::stopThreads() {
     packetTxEventBase_.runInEventBaseThread(
         [this] { packetTxEventBase_.terminateLoopSoon(); });
   }
-  if (pcapDistributionThread_) {
-    pcapDistributionEventBase_.runInEventBaseThread(
-        [this] { pcapDistributionEventBase_.terminateLoopSoon(); });
-  }
   if (lacpThread_) {
     lacpEventBase_.runInEventBaseThread(
         [this] { lacpEventBase_.terminateLoopSoon(); });
@@ -1132,9 +1226,6 @@ void SwSwitch::stopThreads() {
   if (packetTxThread_) {
     packetTxThread_->join();
   }
-  if (pcapDistributionThread_) {
-    pcapDistributionThread_->join();
-  }
   if (lacpThread_) {
     lacpThread_->join();
   }
@@ -1204,15 +1295,9 @@ void SwSwitch::sendPacketOutOfPortAsync(
 
   pcapMgr_->packetSent(pkt.get());
 
-  Cursor c(pkt->buf());
-  // unused to parse the ethertype correctly
-  PktUtil::readMac(&c);
-  PktUtil::readMac(&c);
-  auto ethertype = c.readBE<uint16_t>();
-  if (ethertype == 0x8100) {
-    // 802.1Q
-    c += 2; // Advance over the VLAN tag.  We ignore it for now
-    ethertype = c.readBE<uint16_t>();
+  if (packetTap_) {
+    auto [ethertype, vlan] = getTxEthertypeAndVlan(pkt->buf());
+    publishTxPacket(pkt.get(), portID, vlan, ethertype);
   }
 
   if (!hw_->sendPacketOutOfPortAsync(std::move(pkt), portID, queue)) {
@@ -1268,6 +1353,11 @@ void SwSwitch::sendPacketOutOfPortAsync(
 
 void SwSwitch::sendPacketSwitchedAsync(std::unique_ptr<TxPacket> pkt) noexcept {
   pcapMgr_->packetSent(pkt.get());
+  if (packetTap_) {
+    auto [ethertype, vlan] = getTxEthertypeAndVlan(pkt->buf());
+    // The egress port is up to the ASIC
+    publishTxPacket(pkt.get(), PortID(0), vlan, ethertype);
+  }
   if (!hw_->sendPacketSwitchedAsync(std::move(pkt))) {
     // Just log an error for now.  There's not much the caller can do about
     // send failures--even on successful return from sendPacketSwitchedAsync()
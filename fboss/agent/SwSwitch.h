@@ -15,12 +15,14 @@
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/state/StateDeltaSlicer.h"
 #include "fboss/agent/state/StateUpdate.h"
 #include "fboss/agent/types.h"
 
 #include <folly/IntrusiveList.h>
 #include <folly/Range.h>
 #include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
 #include <folly/io/async/EventBase.h>
 #include <optional>
@@ -30,6 +32,7 @@
 #include <mutex>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
 
 namespace facebook::fboss {
 
@@ -38,6 +41,7 @@ class IPv4Handler;
 class IPv6Handler;
 class LinkAggregationManager;
 class LldpManager;
+class PacketTapWriter;
 class PktCaptureManager;
 class Platform;
 class Port;
@@ -48,6 +52,7 @@ class RxPacket;
 class SwitchState;
 class SwitchStats;
 class StateDelta;
+class NeighborHoldQueue;
 class NeighborUpdater;
 class RouteUpdateLogger;
 class StateObserver;
@@ -528,6 +533,17 @@ class SwSwitch : public HwSwitch::Callback {
     return nUpdater_.get();
   }
 
+  /**
+   * Get the NeighborHoldQueue object, holding packets which wait for their
+   * next hop to be resolved.
+   *
+   * The NeighborHoldQueue returned is owned by the SwSwitch, and is only valid
+   * as long as the SwSwitch object.
+   */
+  NeighborHoldQueue* getNeighborHoldQueue() {
+    return neighborHoldQueue_.get();
+  }
+
   /*
    * Get the PktCaptureManager object.
    */
@@ -600,12 +616,12 @@ class SwSwitch : public HwSwitch::Callback {
    */
   void registerNeighborListener(
       std::function<void(
-          const std::vector<std::string>& added,
-          const std::vector<std::string>& deleted)> callback);
+          const std::vector<folly::IPAddress>& added,
+          const std::vector<folly::IPAddress>& deleted)> callback);
 
   void invokeNeighborListener(
-      const std::vector<std::string>& added,
-      const std::vector<std::string>& deleted);
+      const std::vector<folly::IPAddress>& added,
+      const std::vector<folly::IPAddress>& deleted);
 
   /*
    * Returns true if the arp/ndp entry for the passed in ip has been hit.
@@ -652,7 +668,11 @@ class SwSwitch : public HwSwitch::Callback {
   }
 
   void publishRxPacket(RxPacket* packet, uint16_t ethertype);
-  void publishTxPacket(TxPacket* packet, uint16_t ethertype);
+  void publishTxPacket(
+      TxPacket* packet,
+      PortID port,
+      uint16_t vlan,
+      uint16_t ethertype);
 
   /*
    * Clear PortStats of the specified port.
@@ -697,6 +717,12 @@ class SwSwitch : public HwSwitch::Callback {
       std::shared_ptr<SwitchState> newDesiredState);
 
   void setDesiredState(std::shared_ptr<SwitchState> newDesiredState);
+  /*
+   * Rebuild tapAggregatePorts_ when the aggregate ports changed.
+   */
+  void updateTapAggregatePorts(
+      const std::shared_ptr<SwitchState>& oldState,
+      const std::shared_ptr<SwitchState>& newState);
 
   void publishInitTimes(std::string name, const float& time);
   void updatePortInfo();
@@ -708,9 +734,15 @@ class SwSwitch : public HwSwitch::Callback {
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
+  /*
+   * Program the hardware from oldState to newState, and make desiredState
+   * the desired state. desiredState differs from newState when only a slice
+   * of it is programmed.
+   */
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
-      const std::shared_ptr<SwitchState>& newState);
+      const std::shared_ptr<SwitchState>& newState,
+      const std::shared_ptr<SwitchState>& desiredState);
 
   void startThreads();
   void stopThreads();
@@ -798,6 +830,10 @@ class SwSwitch : public HwSwitch::Callback {
   std::shared_ptr<SwitchState> desiredStateDontUseDirectly_;
   mutable folly::SpinLock stateLock_;
 
+  // Where the last hardware slice of a huge update stopped. Only used by the
+  // update thread.
+  StateDeltaSliceCursor hwSliceCursor_;
+
   /*
    * A thread for performing various background tasks.
    */
@@ -814,12 +850,6 @@ class SwSwitch : public HwSwitch::Callback {
   folly::EventBase packetTxEventBase_;
   std::unique_ptr<ThreadHeartbeat> packetTxThreadHeartbeat_;
 
-  /*
-   * A thread for sending packets to the distribution process
-   */
-  std::unique_ptr<std::thread> pcapDistributionThread_;
-  folly::EventBase pcapDistributionEventBase_;
-
   /*
    * A thread for processing SwitchState updates.
    */
@@ -846,8 +876,8 @@ class SwSwitch : public HwSwitch::Callback {
    */
   std::mutex neighborListenerMutex_;
   std::function<void(
-      const std::vector<std::string>& added,
-      const std::vector<std::string>& deleted)>
+      const std::vector<folly::IPAddress>& added,
+      const std::vector<folly::IPAddress>& deleted)>
       neighborListener_{nullptr};
 
   /*
@@ -861,7 +891,16 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<IPv4Handler> ipv4_;
   std::unique_ptr<IPv6Handler> ipv6_;
   std::unique_ptr<NeighborUpdater> nUpdater_;
+  std::unique_ptr<NeighborHoldQueue> neighborHoldQueue_;
   std::unique_ptr<PktCaptureManager> pcapMgr_;
+  /*
+   * Shared memory tap of CPU RX/TX packets for local consumers. Only created
+   * when --packet_tap_name is set.
+   */
+  std::unique_ptr<PacketTapWriter> packetTap_;
+  // Aggregate port of each member port, for the packets published to the tap
+  folly::Synchronized<std::unordered_map<PortID, AggregatePortID>>
+      tapAggregatePorts_;
   std::unique_ptr<MirrorManager> mirrorManager_;
   std::unique_ptr<RouteUpdateLogger> routeUpdateLogger_;
   std::unique_ptr<LinkAggregationManager> lagManager_;
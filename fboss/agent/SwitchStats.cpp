@@ -177,12 +177,37 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           kCounterPrefix + "update_stats_exceptions",
           SUM),
       trapPktTooBig_(map, kCounterPrefix + "trapped.packet_too_big", SUM, RATE),
+      icmpErrorSuppressed_(
+          map,
+          kCounterPrefix + "icmp.error_suppressed",
+          SUM,
+          RATE),
       LldpRecvdPkt_(map, kCounterPrefix + "lldp.recvd", SUM, RATE),
       LldpBadPkt_(map, kCounterPrefix + "lldp.recv_bad", SUM, RATE),
       LldpValidateMisMatch_(
           map,
           kCounterPrefix + "lldp.validate_mismatch",
           SUM,
+          RATE),
+      neighborHoldQueued_(
+          map,
+          kCounterPrefix + "neighbor_hold.queued",
+          SUM,
+          RATE),
+      neighborHoldFlushed_(
+          map,
+          kCounterPrefix + "neighbor_hold.flushed",
+          SUM,
+          RATE),
+      neighborHoldDropOverflow_(
+          map,
+          kCounterPrefix + "neighbor_hold.drop_overflow",
+          SUM,
+          RATE),
+      neighborHoldDropExpired_(
+          map,
+          kCounterPrefix + "neighbor_hold.drop_expired",
+          SUM,
           RATE) {}
 
 PortStats* FOLLY_NULLABLE SwitchStats::port(PortID portID) {
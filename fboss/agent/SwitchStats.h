@@ -290,6 +290,10 @@ class SwitchStats : public boost::noncopyable {
     trapPktTooBig_.addValue(1);
   }
 
+  void icmpErrorSuppressed() {
+    icmpErrorSuppressed_.addValue(1);
+  }
+
   void LldpRecvdPkt() {
     LldpRecvdPkt_.addValue(1);
   }
@@ -300,6 +304,19 @@ class SwitchStats : public boost::noncopyable {
     LldpValidateMisMatch_.addValue(1);
   }
 
+  void neighborHoldQueued() {
+    neighborHoldQueued_.addValue(1);
+  }
+  void neighborHoldFlushed(int64_t count) {
+    neighborHoldFlushed_.addValue(count);
+  }
+  void neighborHoldDropOverflow() {
+    neighborHoldDropOverflow_.addValue(1);
+  }
+  void neighborHoldDropExpired(int64_t count) {
+    neighborHoldDropExpired_.addValue(count);
+  }
+
  private:
   // Forbidden copy constructor and assignment operator
   SwitchStats(SwitchStats const&) = delete;
@@ -477,12 +494,24 @@ class SwitchStats : public boost::noncopyable {
   // Number of packet too big ICMPv6 triggered
   TLTimeseries trapPktTooBig_;
 
+  // ICMP errors not sent because of rate limiting
+  TLTimeseries icmpErrorSuppressed_;
+
   // Number of LLDP packets.
   TLTimeseries LldpRecvdPkt_;
   // Number of bad LLDP packets.
   TLTimeseries LldpBadPkt_;
   // Number of LLDP packets that did not match configured, expected values.
   TLTimeseries LldpValidateMisMatch_;
+
+  // Packets held until their next hop is resolved
+  TLTimeseries neighborHoldQueued_;
+  // Held packets sent once their next hop was resolved
+  TLTimeseries neighborHoldFlushed_;
+  // Packets dropped as the hold queue was full
+  TLTimeseries neighborHoldDropOverflow_;
+  // Held packets dropped as their next hop was not resolved in time
+  TLTimeseries neighborHoldDropExpired_;
 };
 
 } // namespace facebook::fboss
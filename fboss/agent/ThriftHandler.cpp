@@ -34,6 +34,7 @@
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
 #include "fboss/agent/state/LabelForwardingEntry.h"
 #include "fboss/agent/state/NdpEntry.h"
 #include "fboss/agent/state/NdpTable.h"
@@ -61,6 +62,7 @@
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
 
+#include <atomic>
 #include <limits>
 
 using apache::thrift::ClientReceiveState;
@@ -94,6 +96,16 @@ DEFINE_bool(
     enable_running_config_mutations,
     false,
     "Allow external mutations of running config");
+DEFINE_int32(
+    neighbor_listener_interval_ms,
+    100,
+    "Neighbor changes are coalesced over this interval before they are sent "
+    "to the neighbor listeners");
+DEFINE_int32(
+    neighbor_listener_max_pending,
+    10000,
+    "Maximum number of neighbor changes queued for a binary neighbor "
+    "listener, beyond which it is resynced with all the resolved neighbors");
 
 namespace facebook::fboss {
 
@@ -417,6 +429,61 @@ LinkNeighborThrift thriftLinkNeighbor(
   }
   return tn;
 }
+
+LinkNeighborEventType thriftLinkNeighborEventType(
+    LinkNeighborDB::ChangeType type) {
+  switch (type) {
+    case LinkNeighborDB::ChangeType::ADDED:
+      return LinkNeighborEventType::ADDED;
+    case LinkNeighborDB::ChangeType::CHANGED:
+      return LinkNeighborEventType::CHANGED;
+    case LinkNeighborDB::ChangeType::EXPIRED:
+      return LinkNeighborEventType::EXPIRED;
+  }
+  throw FbossError("Unknown LLDP neighbor change type");
+}
+
+/*
+ * Owned by the LinkNeighborDB subscription, ends the stream when the
+ * subscription goes away.
+ */
+class LldpEventPublisher {
+ public:
+  explicit LldpEventPublisher(
+      apache::thrift::ServerStreamPublisher<LinkNeighborEventThrift>&&
+          publisher)
+      : publisher_(std::move(publisher)) {}
+  ~LldpEventPublisher() {
+    std::move(publisher_).complete();
+  }
+  void next(LinkNeighborEventThrift event) {
+    publisher_.next(std::move(event));
+  }
+
+ private:
+  apache::thrift::ServerStreamPublisher<LinkNeighborEventThrift> publisher_;
+};
+
+template <typename Table>
+void addResolvedNeighbors(const Table& table, std::vector<IPAddress>* ips) {
+  for (const auto& entry : table) {
+    if (entry->nonZeroPort()) {
+      ips->push_back(entry->getIP());
+    }
+  }
+}
+
+/*
+ * The neighbors reported as added to the neighbor listeners, for a resync.
+ */
+std::vector<IPAddress> resolvedNeighbors(const SwitchState& state) {
+  std::vector<IPAddress> ips;
+  for (const auto& vlan : *state.getVlans()) {
+    addResolvedNeighbors(*vlan->getArpTable(), &ips);
+    addResolvedNeighbors(*vlan->getNdpTable(), &ips);
+  }
+  return ips;
+}
 } // namespace
 
 namespace facebook::fboss {
@@ -446,14 +513,14 @@ class RouteUpdateStats {
 
 ThriftHandler::ThriftHandler(SwSwitch* sw) : FacebookBase2("FBOSS"), sw_(sw) {
   if (sw) {
-    sw->registerNeighborListener([=](const std::vector<std::string>& added,
-                                     const std::vector<std::string>& deleted) {
+    sw->registerNeighborListener([=](const std::vector<IPAddress>& added,
+                                     const std::vector<IPAddress>& deleted) {
+      auto now = NeighborChangeQueue::Clock::now();
       for (auto& listener : listeners_.accessAllThreads()) {
-        XLOG(INFO) << "Sending notification to bgpD";
+        XLOG(DBG2) << "Queueing neighbor changes for listeners";
         auto listenerPtr = &listener;
         listener.eventBase->runInEventBaseThread([=] {
-          XLOG(INFO) << "firing off notification";
-          invokeNeighborListeners(listenerPtr, added, deleted);
+          queueNeighborChanges(listenerPtr, added, deleted, now);
         });
       }
     });
@@ -933,8 +1000,28 @@ void ThriftHandler::getCurrentStateJSON(
   if (!jsonPtr) {
     throw FbossError("Malformed JSON Pointer");
   }
-  auto swState = sw_->getState()->toFollyDynamic();
-  auto dyn = swState.get_ptr(jsonPtr.value());
+  auto state = sw_->getState();
+  const auto& tokens = jsonPtr->tokens();
+  if (tokens.empty()) {
+    JsonStreamWriter writer(&ret);
+    state->writeJson(writer);
+    return;
+  }
+  // Only serialize the top level field the pointer refers into
+  std::string fieldJson;
+  JsonStreamWriter writer(&fieldJson);
+  if (!state->getFields()->writeFieldJson(tokens[0], writer)) {
+    throw FbossError("No state at JSON Pointer ", *jsonPointerStr);
+  }
+  if (tokens.size() == 1) {
+    ret = std::move(fieldJson);
+    return;
+  }
+  auto field = folly::dynamic::object(tokens[0], folly::parseJson(fieldJson));
+  auto dyn = field.get_ptr(jsonPtr.value());
+  if (!dyn) {
+    throw FbossError("No state at JSON Pointer ", *jsonPointerStr);
+  }
   ret = folly::json::serialize(*dyn, folly::json::serialization_opts{});
 }
 
@@ -1177,31 +1264,182 @@ void ThriftHandler::getLldpNeighbors(vector<LinkNeighborThrift>& results) {
   }
 }
 
-void ThriftHandler::invokeNeighborListeners(
-    ThreadLocalListener* listener,
-    std::vector<std::string> added,
-    std::vector<std::string> removed) {
-  // Collect the iterators to avoid erasing and potentially reordering
-  // the iterators in the list.
-  for (const auto& ctx : brokenClients_) {
-    listener->clients.erase(ctx);
+apache::thrift::
+    ResponseAndServerStream<LinkNeighborSnapshotThrift, LinkNeighborEventThrift>
+ThriftHandler::subscribeLldpNeighbors() {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured();
+  auto lldpMgr = sw_->getLldpMgr();
+  if (lldpMgr == nullptr) {
+    throw std::runtime_error("lldpMgr is not configured");
+  }
+  auto* db = lldpMgr->getDB();
+  db->pruneExpiredNeighbors();
+
+  // The client may go away before we even subscribed
+  constexpr auto kNotSubscribed = std::numeric_limits<uint64_t>::max();
+  constexpr auto kCancelled = kNotSubscribed - 1;
+  auto subscriptionId = std::make_shared<std::atomic<uint64_t>>(kNotSubscribed);
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<LinkNeighborEventThrift>::createPublisher(
+          [db, subscriptionId]() {
+            auto id = subscriptionId->exchange(kCancelled);
+            if (id != kNotSubscribed && id != kCancelled) {
+              db->unsubscribe(id);
+            }
+          });
+  auto publisher = std::make_shared<LldpEventPublisher>(
+      std::move(streamAndPublisher.second));
+
+  auto subscription = db->subscribe(
+      [sw = sw_, publisher](const LinkNeighborDB::Change& change) {
+        LinkNeighborEventThrift event;
+        event.type = thriftLinkNeighborEventType(change.type);
+        event.sequence = change.sequence;
+        event.neighbor =
+            thriftLinkNeighbor(*sw, change.neighbor, steady_clock::now());
+        publisher->next(std::move(event));
+      });
+  if (subscriptionId->exchange(subscription.id) == kCancelled) {
+    db->unsubscribe(subscription.id);
+  }
+
+  LinkNeighborSnapshotThrift snapshot;
+  snapshot.sequence = subscription.sequence;
+  auto now = steady_clock::now();
+  snapshot.neighbors.reserve(subscription.neighbors.size());
+  for (const auto& neighbor : subscription.neighbors) {
+    snapshot.neighbors.push_back(thriftLinkNeighbor(*sw_, neighbor, now));
+  }
+  return {std::move(snapshot), std::move(streamAndPublisher.first)};
+}
+
+void ThriftHandler::queueNeighborChanges(
+    ThreadLocalListener* info,
+    const std::vector<IPAddress>& added,
+    const std::vector<IPAddress>& removed,
+    NeighborChangeQueue::Clock::time_point now) {
+  for (auto& [ctx, listener] : info->clients) {
+    for (const auto& ip : added) {
+      listener.changes.neighborAdded(ip, now);
+    }
+    for (const auto& ip : removed) {
+      listener.changes.neighborRemoved(ip, now);
+    }
+  }
+  scheduleNeighborListenersFlush(info);
+}
+
+void ThriftHandler::scheduleNeighborListenersFlush(ThreadLocalListener* info) {
+  if (info->flushScheduled) {
+    return;
+  }
+  info->flushScheduled = true;
+  info->eventBase->runAfterDelay(
+      [=] {
+        info->flushScheduled = false;
+        flushNeighborListeners(info);
+      },
+      FLAGS_neighbor_listener_interval_ms);
+}
+
+void ThriftHandler::flushNeighborListeners(ThreadLocalListener* info) {
+  for (auto it = info->clients.begin(); it != info->clients.end();) {
+    auto& listener = it->second;
+    if (listener.broken) {
+      it = info->clients.erase(it);
+      continue;
+    }
+    if (!listener.inFlight && !listener.changes.empty()) {
+      sendNeighborChanges(info, it->first, &listener);
+    }
+    ++it;
+  }
+}
+
+void ThriftHandler::sendNeighborChanges(
+    ThreadLocalListener* info,
+    const TConnectionContext* ctx,
+    NeighborListener* listener) {
+  auto changes = listener->changes.take();
+  if (!changes) {
+    return;
   }
-  brokenClients_.clear();
-  for (auto& client : listener->clients) {
-    auto clientDone = [&](ClientReceiveState&& state) {
-      try {
+  if (changes->resync) {
+    changes->added = resolvedNeighbors(*sw_->getState());
+    fb303::fbData->addStatValue("neighbor_listener.resyncs", 1, fb303::SUM);
+  }
+  auto binary = listener->binary;
+  // The client may be gone by the time the notification returns, so look
+  // it up again rather than holding on to it.
+  auto clientDone = [=](ClientReceiveState&& state) {
+    auto it = info->clients.find(ctx);
+    try {
+      if (binary) {
+        NeighborListenerClientAsyncClient::recv_binaryNeighborsChanged(state);
+      } else {
         NeighborListenerClientAsyncClient::recv_neighborsChanged(state);
-      } catch (const std::exception& ex) {
-        XLOG(ERR) << "Exception in neighbor listener: " << ex.what();
-        brokenClients_.push_back(client.first);
       }
-    };
-    client.second->neighborsChanged(clientDone, added, removed);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Exception in neighbor listener: " << ex.what();
+      // Erased on the next flush, not from within its own callback
+      if (it != info->clients.end()) {
+        it->second.broken = true;
+        scheduleNeighborListenersFlush(info);
+      }
+      return;
+    }
+    if (it != info->clients.end()) {
+      it->second.inFlight = false;
+      if (!it->second.changes.empty()) {
+        scheduleNeighborListenersFlush(info);
+      }
+    }
+  };
+
+  listener->inFlight = true;
+  if (binary) {
+    NeighborChangesThrift thrift;
+    thrift.added.reserve(changes->added.size());
+    for (const auto& ip : changes->added) {
+      thrift.added.push_back(toBinaryAddress(ip));
+    }
+    thrift.removed.reserve(changes->removed.size());
+    for (const auto& ip : changes->removed) {
+      thrift.removed.push_back(toBinaryAddress(ip));
+    }
+    thrift.resync = changes->resync;
+    thrift.oldestChangeUsec =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            changes->oldestChange.time_since_epoch())
+            .count();
+    listener->client->binaryNeighborsChanged(clientDone, thrift);
+  } else {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    for (const auto& ip : changes->added) {
+      added.push_back(ip.str());
+    }
+    for (const auto& ip : changes->removed) {
+      removed.push_back(ip.str());
+    }
+    listener->client->neighborsChanged(clientDone, added, removed);
   }
 }
 
 void ThriftHandler::async_eb_registerForNeighborChanged(
     ThriftCallback<void> cb) {
+  registerNeighborListener(std::move(cb), false);
+}
+
+void ThriftHandler::async_eb_registerForBinaryNeighborChanges(
+    ThriftCallback<void> cb) {
+  registerNeighborListener(std::move(cb), true);
+}
+
+void ThriftHandler::registerNeighborListener(
+    ThriftCallback<void> cb,
+    bool binary) {
   auto ctx = cb->getConnectionContext()->getConnectionContext();
   auto client = ctx->getDuplexClient<NeighborListenerClientAsyncClient>();
   auto info = listeners_.get();
@@ -1214,7 +1452,21 @@ void ThriftHandler::async_eb_registerForNeighborChanged(
   if (!info->eventBase) {
     info->eventBase = cb->getEventBase();
   }
-  info->clients.emplace(ctx, client);
+  NeighborListener listener;
+  listener.client = client;
+  listener.binary = binary;
+  if (binary) {
+    // Listeners which can resync are bounded, and start with a resync. The
+    // string lists can not express one, but their queues are bounded by the
+    // number of neighbors anyway.
+    listener.changes =
+        NeighborChangeQueue(std::max(FLAGS_neighbor_listener_max_pending, 1));
+    listener.changes.requestResync(NeighborChangeQueue::Clock::now());
+  }
+  info->clients.insert_or_assign(ctx, std::move(listener));
+  if (binary) {
+    scheduleNeighborListenersFlush(info);
+  }
   cb->done();
 }
 
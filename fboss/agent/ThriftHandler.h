@@ -16,6 +16,7 @@
 
 #include "common/fb303/cpp/FacebookBase2.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborChangeQueue.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
 #include "fboss/agent/if/gen-cpp2/NeighborListenerClient.h"
@@ -25,6 +26,7 @@
 #include <folly/Synchronized.h>
 #include <thrift/lib/cpp/server/TServerEventHandler.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
+#include <thrift/lib/cpp2/async/ServerStream.h>
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 
 namespace facebook::fboss {
@@ -59,6 +61,8 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
 
   void async_eb_registerForNeighborChanged(
       ThriftCallback<void> callback) override;
+  void async_eb_registerForBinaryNeighborChanges(
+      ThriftCallback<void> callback) override;
 
   void flushCountersNow() override;
 
@@ -199,6 +203,10 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   BootType getBootType() override;
 
   void getLldpNeighbors(std::vector<LinkNeighborThrift>& results) override;
+  apache::thrift::ResponseAndServerStream<
+      LinkNeighborSnapshotThrift,
+      LinkNeighborEventThrift>
+  subscribeLldpNeighbors() override;
 
   void startPktCapture(std::unique_ptr<CaptureInfo> info) override;
   void stopPktCapture(std::unique_ptr<std::string> name) override;
@@ -330,20 +338,39 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   }
 
  private:
+  struct NeighborListener {
+    std::shared_ptr<NeighborListenerClientAsyncClient> client;
+    NeighborChangeQueue changes;
+    // Whether the client registered for binaryNeighborsChanged()
+    bool binary{false};
+    // Only one notification is outstanding per client, changes coalesce in
+    // the queue until it returns
+    bool inFlight{false};
+    bool broken{false};
+  };
   struct ThreadLocalListener {
     EventBase* eventBase;
     std::unordered_map<
         const apache::thrift::server::TConnectionContext*,
-        std::shared_ptr<NeighborListenerClientAsyncClient>>
+        NeighborListener>
         clients;
+    bool flushScheduled{false};
 
     explicit ThreadLocalListener(EventBase* eb) : eventBase(eb){};
   };
   folly::ThreadLocalPtr<ThreadLocalListener, int> listeners_;
-  void invokeNeighborListeners(
+  void registerNeighborListener(ThriftCallback<void> callback, bool binary);
+  void queueNeighborChanges(
+      ThreadLocalListener* info,
+      const std::vector<folly::IPAddress>& added,
+      const std::vector<folly::IPAddress>& removed,
+      NeighborChangeQueue::Clock::time_point now);
+  void scheduleNeighborListenersFlush(ThreadLocalListener* info);
+  void flushNeighborListeners(ThreadLocalListener* info);
+  void sendNeighborChanges(
       ThreadLocalListener* info,
-      std::vector<std::string> added,
-      std::vector<std::string> deleted);
+      const TConnectionContext* ctx,
+      NeighborListener* listener);
   void updateUnicastRoutesImpl(
       int32_t vrf,
       int16_t client,
@@ -378,7 +405,6 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   SwSwitch* sw_;
 
   int thriftIdleTimeout_;
-  std::vector<const TConnectionContext*> brokenClients_;
 
   apache::thrift::SSLPolicy sslPolicy_;
 };
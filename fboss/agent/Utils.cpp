@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/Utils.h"
 
+#include <fcntl.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 
@@ -16,9 +17,13 @@
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <folly/ExceptionString.h>
 #include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <folly/String.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
 #include <folly/logging/xlog.h>
@@ -91,7 +96,32 @@ void incNiceValue(const uint32_t increment) {
 }
 
 bool dumpStateToFile(const std::string& filename, const folly::dynamic& json) {
-  return folly::writeFile(folly::toPrettyJson(json), filename.c_str());
+  return dumpStateToFile(
+      filename, [&json](JsonStreamWriter& writer) { writer.value(json); });
+}
+
+bool dumpStateToFile(
+    const std::string& filename,
+    const std::function<void(JsonStreamWriter&)>& writeJson) {
+  int fd = folly::openNoInt(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC);
+  if (fd < 0) {
+    XLOG(ERR) << "Unable to open " << filename << ": "
+              << folly::errnoStr(errno);
+    return false;
+  }
+  SCOPE_EXIT {
+    folly::closeNoInt(fd);
+  };
+  try {
+    JsonStreamWriter writer(fd);
+    writeJson(writer);
+    writer.flush();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Unable to write " << filename << ": "
+              << folly::exceptionStr(ex);
+    return false;
+  }
+  return true;
 }
 
 std::string getLocalHostname() {
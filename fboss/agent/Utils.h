@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 #include <type_traits> // To use 'std::integral_constant'.
 
@@ -29,6 +30,7 @@ struct dynamic;
 
 namespace facebook::fboss {
 
+class JsonStreamWriter;
 class SwitchState;
 
 template <typename T>
@@ -80,6 +82,14 @@ void incNiceValue(const uint32_t increment);
  */
 bool dumpStateToFile(const std::string& filename, const folly::dynamic& json);
 
+/*
+ * Write JSON to file as writeJson produces it, without building the whole
+ * document in memory first. Returns false if anything went wrong.
+ */
+bool dumpStateToFile(
+    const std::string& filename,
+    const std::function<void(JsonStreamWriter&)>& writeJson);
+
 std::vector<ClientID> AllClientIDs();
 
 /*
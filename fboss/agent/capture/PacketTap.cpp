@@ -0,0 +1,354 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/capture/PacketTap.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/TxPacket.h"
+
+#include <folly/String.h>
+#include <folly/io/Cursor.h>
+#include <folly/logging/xlog.h>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace facebook::fboss {
+
+namespace packet_tap {
+
+size_t slotSize(uint32_t snapLen) {
+  // Keep every slot cache line aligned so that writers filling adjacent
+  // slots do not contend on the same line.
+  auto size = sizeof(SlotHeader) + snapLen;
+  return (size + 63) & ~size_t(63);
+}
+
+size_t segmentSize(uint32_t numSlots, uint32_t snapLen) {
+  return sizeof(RingHeader) + size_t(numSlots) * slotSize(snapLen);
+}
+
+} // namespace packet_tap
+
+using namespace packet_tap;
+
+namespace {
+
+uint8_t* mapSegment(int fd, size_t size) {
+  auto addr =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    throw FbossError(
+        "Failed to map packet tap segment: ", folly::errnoStr(errno));
+  }
+  return static_cast<uint8_t*>(addr);
+}
+
+SlotHeader* slotHeader(uint8_t* base, const RingHeader* header, uint64_t seq) {
+  auto offset =
+      sizeof(RingHeader) + (seq % header->numSlots) * header->slotSize;
+  return reinterpret_cast<SlotHeader*>(base + offset);
+}
+
+uint8_t* slotData(SlotHeader* slot) {
+  return reinterpret_cast<uint8_t*>(slot) + sizeof(SlotHeader);
+}
+
+bool processAlive(int32_t pid) {
+  return pid <= 0 || ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+PacketTapWriter::PacketTapWriter(
+    const std::string& name,
+    uint32_t numSlots,
+    uint32_t snapLen)
+    : name_(name) {
+  if (numSlots == 0 || snapLen == 0) {
+    throw FbossError(
+        "Invalid packet tap geometry: ", numSlots, " slots of ", snapLen);
+  }
+  // Any segment left over from a previous agent run is stale. Readers still
+  // mapping it keep their mapping until they reopen the tap.
+  ::shm_unlink(name_.c_str());
+  fd_ = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+  if (fd_ < 0) {
+    throw FbossError(
+        "Failed to create packet tap ", name_, ": ", folly::errnoStr(errno));
+  }
+  size_ = segmentSize(numSlots, snapLen);
+  if (::ftruncate(fd_, size_) != 0) {
+    auto err = errno;
+    ::close(fd_);
+    ::shm_unlink(name_.c_str());
+    throw FbossError(
+        "Failed to size packet tap ", name_, ": ", folly::errnoStr(err));
+  }
+  base_ = mapSegment(fd_, size_);
+  // ftruncate() zero fills the segment, which is a valid initial value for
+  // all the atomics in the header and the slots.
+  header_ = reinterpret_cast<RingHeader*>(base_);
+  header_->numSlots = numSlots;
+  header_->snapLen = snapLen;
+  header_->slotSize = slotSize(snapLen);
+  header_->version = kVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = kMagic;
+  XLOG(INFO) << "Created packet tap " << name_ << " with " << numSlots
+             << " slots, snaplen " << snapLen;
+}
+
+PacketTapWriter::~PacketTapWriter() {
+  ::munmap(base_, size_);
+  ::close(fd_);
+  ::shm_unlink(name_.c_str());
+}
+
+void PacketTapWriter::publish(const RxPacket* pkt, uint16_t ethertype) {
+  publish(
+      PacketTapDirection::RX,
+      pkt->getSrcPort(),
+      pkt->isFromAggregatePort() ? pkt->getSrcAggregatePort() : 0,
+      pkt->getSrcVlan(),
+      ethertype,
+      pkt->buf());
+}
+
+void PacketTapWriter::publish(
+    const TxPacket* pkt,
+    uint32_t port,
+    uint32_t aggregatePort,
+    uint16_t vlan,
+    uint16_t ethertype) {
+  publish(
+      PacketTapDirection::TX, port, aggregatePort, vlan, ethertype, pkt->buf());
+}
+
+uint64_t PacketTapWriter::computeSubscriberMask(
+    PacketTapDirection direction,
+    uint32_t port,
+    uint16_t ethertype) {
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < kMaxSubscribers; ++i) {
+    auto& entry = header_->subscribers[i];
+    if (entry.state.load(std::memory_order_acquire) != ACTIVE) {
+      continue;
+    }
+    const auto& filter = entry.filter;
+    if (filter.directions &&
+        !(filter.directions & static_cast<uint8_t>(direction))) {
+      continue;
+    }
+    if (filter.ethertype && filter.ethertype != ethertype) {
+      continue;
+    }
+    if (filter.port && filter.port != port) {
+      continue;
+    }
+    if (filter.sampleRate > 1 &&
+        sampleCounters_[i].fetch_add(1, std::memory_order_relaxed) %
+                filter.sampleRate !=
+            0) {
+      continue;
+    }
+    mask |= uint64_t(1) << i;
+  }
+  return mask;
+}
+
+void PacketTapWriter::publish(
+    PacketTapDirection direction,
+    uint32_t port,
+    uint32_t aggregatePort,
+    uint16_t vlan,
+    uint16_t ethertype,
+    const folly::IOBuf* buf) {
+  auto mask = computeSubscriberMask(direction, port, ethertype);
+  if (!mask) {
+    unsubscribed_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto seq = header_->writeSeq.fetch_add(1, std::memory_order_relaxed);
+  auto slot = slotHeader(base_, header_, seq);
+  // Keep track of who the packet we overwrite was for, so that readers which
+  // missed it know whether to count it as lost
+  uint64_t prevMask = 0;
+  if (seq >= header_->numSlots) {
+    auto prevSeq = seq - header_->numSlots;
+    prevMask = slot->lock.load(std::memory_order_acquire) == 2 * prevSeq + 2
+        ? slot->subscriberMask
+        : ~uint64_t(0);
+  }
+  slot->prevSubscriberMask.store(prevMask, std::memory_order_relaxed);
+  slot->lock.store(2 * seq + 1, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto origLen = buf->computeChainDataLength();
+  auto capLen = std::min<size_t>(origLen, header_->snapLen);
+  auto& record = slot->record;
+  record.seqNum = seq;
+  record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+  record.port = port;
+  record.aggregatePort = aggregatePort;
+  record.vlan = vlan;
+  record.ethertype = ethertype;
+  record.direction = direction;
+  record.origLen = origLen;
+  record.capLen = capLen;
+  slot->subscriberMask = mask;
+  folly::io::Cursor cursor(buf);
+  cursor.pull(slotData(slot), capLen);
+
+  slot->lock.store(2 * seq + 2, std::memory_order_release);
+  published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+PacketTapReader::PacketTapReader(
+    const std::string& name,
+    const PacketTapFilter& filter) {
+  fd_ = ::shm_open(name.c_str(), O_RDWR, 0);
+  if (fd_ < 0) {
+    throw FbossError(
+        "Failed to open packet tap ", name, ": ", folly::errnoStr(errno));
+  }
+  struct stat st;
+  if (::fstat(fd_, &st) != 0 || st.st_size < sizeof(RingHeader)) {
+    ::close(fd_);
+    throw FbossError("Packet tap ", name, " is not initialized");
+  }
+  size_ = st.st_size;
+  base_ = mapSegment(fd_, size_);
+  header_ = reinterpret_cast<RingHeader*>(base_);
+  if (header_->magic != kMagic || header_->version != kVersion ||
+      segmentSize(header_->numSlots, header_->snapLen) > size_) {
+    ::munmap(base_, size_);
+    ::close(fd_);
+    throw FbossError("Packet tap ", name, " has an unexpected layout");
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  for (uint32_t i = 0; i < kMaxSubscribers; ++i) {
+    auto& entry = header_->subscribers[i];
+    // Reclaim entries left behind by readers that died without unsubscribing
+    uint32_t state = ACTIVE;
+    if (!processAlive(entry.pid)) {
+      entry.state.compare_exchange_strong(state, FREE);
+    }
+    state = FREE;
+    if (!entry_ && entry.state.compare_exchange_strong(state, CLAIMED)) {
+      entry_ = &entry;
+      subscriberBit_ = uint64_t(1) << i;
+    }
+  }
+  if (!entry_) {
+    ::munmap(base_, size_);
+    ::close(fd_);
+    throw FbossError(
+        "Packet tap ", name, " already has ", kMaxSubscribers, " subscribers");
+  }
+  entry_->pid = ::getpid();
+  entry_->filter = filter;
+  entry_->delivered.store(0, std::memory_order_relaxed);
+  entry_->lost.store(0, std::memory_order_relaxed);
+  // Only packets published after we subscribed are of interest
+  cursor_ = header_->writeSeq.load(std::memory_order_acquire);
+  entry_->cursor.store(cursor_, std::memory_order_relaxed);
+  entry_->state.store(ACTIVE, std::memory_order_release);
+}
+
+PacketTapReader::~PacketTapReader() {
+  entry_->state.store(FREE, std::memory_order_release);
+  ::munmap(base_, size_);
+  ::close(fd_);
+}
+
+void PacketTapReader::skip(uint64_t count, bool lost) {
+  cursor_ += count;
+  if (lost) {
+    entry_->lost.fetch_add(count, std::memory_order_relaxed);
+  }
+}
+
+bool PacketTapReader::readNext(
+    PacketTapRecordHeader* record,
+    folly::MutableByteRange buf) {
+  const auto numSlots = header_->numSlots;
+  while (true) {
+    auto writeSeq = header_->writeSeq.load(std::memory_order_acquire);
+    if (cursor_ >= writeSeq) {
+      entry_->cursor.store(cursor_, std::memory_order_relaxed);
+      return false;
+    }
+    if (writeSeq - cursor_ > 2 * numSlots) {
+      // We were lapped twice, both the oldest packets and the record of who
+      // they were for are gone
+      skip(writeSeq - 2 * numSlots - cursor_, true);
+      continue;
+    }
+    auto slot = slotHeader(base_, header_, cursor_);
+    auto expected = 2 * cursor_ + 2;
+    auto lock = slot->lock.load(std::memory_order_acquire);
+    if (lock < expected) {
+      // The writer which claimed this sequence number is still filling it
+      entry_->cursor.store(cursor_, std::memory_order_relaxed);
+      return false;
+    }
+    if (lock > expected) {
+      // Overwritten before we could check whether it was ours. The next
+      // packet in the slot tells, as long as it was not overwritten too.
+      auto nextGeneration = 2 * (cursor_ + numSlots) + 2;
+      auto prevMask = slot->prevSubscriberMask.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (lock > nextGeneration ||
+          slot->lock.load(std::memory_order_relaxed) > nextGeneration) {
+        prevMask = ~uint64_t(0);
+      }
+      skip(1, (prevMask & subscriberBit_) != 0);
+      continue;
+    }
+    auto mask = slot->subscriberMask;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->lock.load(std::memory_order_relaxed) != lock) {
+      // Overwritten while we were checking it, try again from the next
+      // packet's record
+      continue;
+    }
+    if (!(mask & subscriberBit_)) {
+      skip(1, false);
+      continue;
+    }
+    *record = slot->record;
+    auto capLen = std::min<size_t>(record->capLen, buf.size());
+    std::memcpy(buf.begin(), slotData(slot), capLen);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->lock.load(std::memory_order_relaxed) != lock) {
+      // Overwritten while we were copying out one of ours
+      skip(1, true);
+      continue;
+    }
+    record->capLen = capLen;
+    ++cursor_;
+    entry_->cursor.store(cursor_, std::memory_order_relaxed);
+    entry_->delivered.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+}
+
+} // namespace facebook::fboss
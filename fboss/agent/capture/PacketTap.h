@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace facebook::fboss {
+
+class RxPacket;
+class TxPacket;
+
+/*
+ * The packet tap exposes packets received and transmitted by the agent's CPU
+ * to local consumers (sFlow agents, debugging tools, ...) through a ring of
+ * fixed size slots in a POSIX shared memory segment.
+ *
+ * There is a single writer process (the agent) which may publish from any
+ * number of threads, and up to kMaxSubscribers reader processes. Every
+ * subscriber owns a cursor into the ring and registers a filter and a
+ * sampling rate in the shared header. The writer evaluates filters and
+ * sampling before touching a slot, so packets nobody asked for are never
+ * copied. Packets wanted by at least one subscriber are copied exactly once,
+ * from the packet IOBuf chain straight into shared memory.
+ *
+ * The writer never waits for readers. A subscriber that falls more than a
+ * ring's worth of packets behind loses the oldest packets, and the loss is
+ * accounted for in its subscriber entry. Only packets that were published
+ * for the subscriber count as its losses: a slot remembers who the packet it
+ * replaced was for, until it is overwritten again. A subscriber lapped twice
+ * can no longer tell, and counts every packet it missed.
+ */
+
+enum class PacketTapDirection : uint8_t {
+  RX = 0x1,
+  TX = 0x2,
+};
+
+struct PacketTapFilter {
+  // Bitmask of PacketTapDirection values, 0 matches both directions
+  uint8_t directions{0};
+  // Ethertype to match (after the optional 802.1Q tag), 0 matches any
+  uint16_t ethertype{0};
+  // Port to match, 0 matches any port
+  uint32_t port{0};
+  // Deliver one out of every sampleRate matching packets, 0 and 1 deliver all
+  uint32_t sampleRate{1};
+};
+
+/*
+ * Metadata stored in front of every packet in the ring.
+ */
+struct PacketTapRecordHeader {
+  uint64_t seqNum{0};
+  int64_t timestampNs{0};
+  uint32_t port{0};
+  uint32_t aggregatePort{0};
+  uint16_t vlan{0};
+  uint16_t ethertype{0};
+  PacketTapDirection direction{PacketTapDirection::RX};
+  uint8_t pad[3]{};
+  // Length of the packet on the wire
+  uint32_t origLen{0};
+  // Number of bytes captured, at most the ring snaplen
+  uint32_t capLen{0};
+};
+
+namespace packet_tap {
+
+constexpr uint32_t kMagic = 0xFB055AB0;
+constexpr uint32_t kVersion = 2;
+constexpr uint32_t kMaxSubscribers = 16;
+
+enum SubscriberState : uint32_t {
+  FREE = 0,
+  CLAIMED = 1,
+  ACTIVE = 2,
+};
+
+struct alignas(64) SubscriberEntry {
+  std::atomic<uint32_t> state;
+  int32_t pid;
+  PacketTapFilter filter;
+  // Updated by the reader only, exported by the writer for debugging
+  std::atomic<uint64_t> cursor;
+  std::atomic<uint64_t> delivered;
+  std::atomic<uint64_t> lost;
+};
+
+struct alignas(64) RingHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t numSlots;
+  uint32_t snapLen;
+  uint32_t slotSize;
+  // Sequence number of the next packet to be claimed by a writer
+  alignas(64) std::atomic<uint64_t> writeSeq;
+  std::array<SubscriberEntry, kMaxSubscribers> subscribers;
+};
+
+/*
+ * Each slot is guarded by a sequence lock. A writer claiming sequence number
+ * N stores 2N + 1 while it is filling the slot and 2N + 2 once the slot is
+ * complete, so readers can detect both in-progress and overwritten slots.
+ */
+struct alignas(64) SlotHeader {
+  std::atomic<uint64_t> lock;
+  // Bitmask of subscriber indices this packet was published for
+  uint64_t subscriberMask;
+  // subscriberMask of the packet this one overwrote, all ones if unknown
+  std::atomic<uint64_t> prevSubscriberMask;
+  PacketTapRecordHeader record;
+};
+
+size_t slotSize(uint32_t snapLen);
+size_t segmentSize(uint32_t numSlots, uint32_t snapLen);
+
+} // namespace packet_tap
+
+/*
+ * Writer side of the tap, owned by the SwSwitch.
+ *
+ * publish() is safe to call from any thread.
+ */
+class PacketTapWriter {
+ public:
+  PacketTapWriter(const std::string& name, uint32_t numSlots, uint32_t snapLen);
+  ~PacketTapWriter();
+
+  void publish(const RxPacket* pkt, uint16_t ethertype);
+  /*
+   * port and aggregatePort are 0 for packets switched by the ASIC, whose
+   * egress port is not known. vlan is 0 for untagged packets.
+   */
+  void publish(
+      const TxPacket* pkt,
+      uint32_t port,
+      uint32_t aggregatePort,
+      uint16_t vlan,
+      uint16_t ethertype);
+
+  /*
+   * Copy a raw frame into the ring. This is the common path of the publish()
+   * overloads and is exposed so the tap can be exercised without packets.
+   */
+  void publish(
+      PacketTapDirection direction,
+      uint32_t port,
+      uint32_t aggregatePort,
+      uint16_t vlan,
+      uint16_t ethertype,
+      const folly::IOBuf* buf);
+
+  uint64_t published() const {
+    return published_.load(std::memory_order_relaxed);
+  }
+  uint64_t unsubscribed() const {
+    return unsubscribed_.load(std::memory_order_relaxed);
+  }
+
+  const std::string& getName() const {
+    return name_;
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  PacketTapWriter(PacketTapWriter const&) = delete;
+  PacketTapWriter& operator=(PacketTapWriter const&) = delete;
+
+  uint64_t computeSubscriberMask(
+      PacketTapDirection direction,
+      uint32_t port,
+      uint16_t ethertype);
+
+  const std::string name_;
+  int fd_{-1};
+  size_t size_{0};
+  uint8_t* base_{nullptr};
+  packet_tap::RingHeader* header_{nullptr};
+  // Per subscriber sampling counters. These live in writer memory since only
+  // the writer needs them.
+  std::array<std::atomic<uint64_t>, packet_tap::kMaxSubscribers>
+      sampleCounters_{};
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> unsubscribed_{0};
+};
+
+/*
+ * Reader side of the tap. A PacketTapReader registers one subscriber and must
+ * only be used from a single thread.
+ */
+class PacketTapReader {
+ public:
+  PacketTapReader(const std::string& name, const PacketTapFilter& filter);
+  ~PacketTapReader();
+
+  /*
+   * Read the next packet published for this subscriber. The packet bytes are
+   * copied into buf, which must hold at least snapLen() bytes.
+   *
+   * Returns false if there is currently nothing to read.
+   */
+  bool readNext(PacketTapRecordHeader* record, folly::MutableByteRange buf);
+
+  uint32_t snapLen() const {
+    return header_->snapLen;
+  }
+  uint64_t lost() const {
+    return entry_->lost.load(std::memory_order_relaxed);
+  }
+  uint64_t delivered() const {
+    return entry_->delivered.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  PacketTapReader(PacketTapReader const&) = delete;
+  PacketTapReader& operator=(PacketTapReader const&) = delete;
+
+  void skip(uint64_t count, bool lost);
+
+  int fd_{-1};
+  size_t size_{0};
+  uint8_t* base_{nullptr};
+  packet_tap::RingHeader* header_{nullptr};
+  packet_tap::SubscriberEntry* entry_{nullptr};
+  uint64_t subscriberBit_{0};
+  uint64_t cursor_{0};
+};
+
+} // namespace facebook::fboss
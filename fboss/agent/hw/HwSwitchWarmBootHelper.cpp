@@ -139,6 +139,12 @@ bool HwSwitchWarmBootHelper::storeWarmBootState(
   return warmBootStateWritten_;
 }
 
+bool HwSwitchWarmBootHelper::storeWarmBootState(
+    const std::function<void(JsonStreamWriter&)>& writeState) {
+  warmBootStateWritten_ = dumpStateToFile(warmBootSwitchStateFile(), writeState);
+  return warmBootStateWritten_;
+}
+
 folly::dynamic HwSwitchWarmBootHelper::getWarmBootState() const {
   std::string warmBootJson;
   auto ret = folly::readFile(warmBootSwitchStateFile().c_str(), warmBootJson);
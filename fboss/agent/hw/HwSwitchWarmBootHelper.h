@@ -11,10 +11,13 @@
 
 #include <folly/dynamic.h>
 
+#include <functional>
 #include <string>
 
 namespace facebook::fboss {
 
+class JsonStreamWriter;
+
 /*
  * This class encapsulates much of the warm boot functionality for an individual
  * HwSwitch. It will store all the files necessary to perform warm boot on a
@@ -41,6 +44,12 @@ class HwSwitchWarmBootHelper {
   void setCanWarmBoot();
 
   bool storeWarmBootState(const folly::dynamic& switchState);
+  /*
+   * Stream the warm boot state as writeState writes it, without building
+   * it in memory first.
+   */
+  bool storeWarmBootState(
+      const std::function<void(JsonStreamWriter&)>& writeState);
   folly::dynamic getWarmBootState() const;
 
   std::string startupSdkDumpFile() const;
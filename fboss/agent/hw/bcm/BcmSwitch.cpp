@@ -480,7 +480,7 @@ void BcmSwitch::unregisterCallbacks() {
   }
 }
 
-void BcmSwitch::gracefulExit(folly::dynamic& switchState) {
+void BcmSwitch::gracefulExit(const std::shared_ptr<SwitchState>& switchState) {
   steady_clock::time_point begin = steady_clock::now();
   XLOG(INFO) << "[Exit] Starting BCM Switch graceful exit";
   // Ideally, preparePortsForGracefulExit() would run in update EVB of the
@@ -495,8 +495,7 @@ void BcmSwitch::gracefulExit(folly::dynamic& switchState) {
   // the underlying bcm sdk state
   dumpState(platform_->getWarmBootHelper()->shutdownSdkDumpFile());
 
-  switchState[kHwSwitch] = toFollyDynamic();
-  unitObject_->writeWarmBootState(switchState);
+  unitObject_->writeWarmBootState(*switchState, toFollyDynamic());
   unitObject_.reset();
   XLOG(INFO)
       << "[Exit] BRCM Graceful Exit time "
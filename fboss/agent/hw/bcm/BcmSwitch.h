@@ -347,7 +347,7 @@ class BcmSwitch : public BcmSwitchIf {
    * state changes while we are calling cleanup
    * shutdown apis in the BCM sdk.
    */
-  void gracefulExit(folly::dynamic& switchState) override;
+  void gracefulExit(const std::shared_ptr<SwitchState>& switchState) override;
 
   /*
    * BcmSwitch state as folly::dynamic
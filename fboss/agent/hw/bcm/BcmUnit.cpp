@@ -9,12 +9,15 @@
  */
 #include "fboss/agent/hw/bcm/BcmUnit.h"
 
+#include "fboss/agent/Constants.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/hw/bcm/BcmAPI.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
 #include "fboss/agent/hw/bcm/BcmPlatform.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootHelper.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
+#include "fboss/agent/state/SwitchState.h"
 
 #include <folly/FileUtil.h>
 #include <folly/ScopeGuard.h>
@@ -182,7 +185,9 @@ BcmUnit::BcmUnit(int deviceIndex, BcmPlatform* platform)
   unit_ = createHwUnit();
 }
 
-void BcmUnit::writeWarmBootState(const folly::dynamic& switchState) {
+void BcmUnit::writeWarmBootState(
+    const SwitchState& switchState,
+    const folly::dynamic& hwSwitch) {
   steady_clock::time_point begin = steady_clock::now();
   XLOG(INFO) << " [Exit] Syncing BRCM switch state to file";
   // Force the device to write out its warm boot state
@@ -195,7 +200,15 @@ void BcmUnit::writeWarmBootState(const folly::dynamic& switchState) {
       << duration_cast<duration<float>>(bcmWarmBootSyncDone - begin).count();
   // Now write our state to file
   XLOG(INFO) << " [Exit] Syncing FBOSS switch state to file";
-  if (!warmBootHelper()->storeWarmBootState(switchState)) {
+  auto writeState = [&switchState, &hwSwitch](JsonStreamWriter& writer) {
+    writer.beginObject();
+    writer.key(kSwSwitch);
+    switchState.writeJson(writer);
+    writer.key(kHwSwitch);
+    writer.value(hwSwitch);
+    writer.endObject();
+  };
+  if (!warmBootHelper()->storeWarmBootState(writeState)) {
     XLOG(FATAL) << "Unable to write switch state JSON to file";
   }
   steady_clock::time_point fbossWarmBootSyncDone = steady_clock::now();
@@ -25,6 +25,7 @@ struct dynamic;
 namespace facebook::fboss {
 
 class BcmWarmBootHelper;
+class SwitchState;
 
 class BcmUnit {
  public:
@@ -58,7 +59,13 @@ class BcmUnit {
   /*
    * Flush warm boot state to disk,
    */
-  void writeWarmBootState(const folly::dynamic& switchState);
+  /*
+   * Sync the SDK warm boot state, and stream switchState along with
+   * hwSwitch, the BcmSwitch state, to the warm boot file.
+   */
+  void writeWarmBootState(
+      const SwitchState& switchState,
+      const folly::dynamic& hwSwitch);
 
   bool isAttached() const {
     return attached_.load(std::memory_order_acquire);
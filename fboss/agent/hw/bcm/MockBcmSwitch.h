@@ -101,7 +101,9 @@ class MockBcmSwitch : public BcmSwitchIf {
   MOCK_METHOD1(
       stateChanged,
       std::shared_ptr<SwitchState>(const StateDelta& delta));
-  MOCK_METHOD1(gracefulExit, void(folly::dynamic& switchState));
+  MOCK_METHOD1(
+      gracefulExit,
+      void(const std::shared_ptr<SwitchState>& switchState));
   MOCK_CONST_METHOD0(toFollyDynamic, folly::dynamic());
   MOCK_METHOD1(switchRunStateChanged, void(SwitchRunState newState));
   MOCK_METHOD1(updateStats, void(SwitchStats* switchStats));
@@ -62,7 +62,9 @@ class MockHwSwitch : public HwSwitch {
 
   MOCK_METHOD1(updateStats, void(SwitchStats* switchStats));
   MOCK_CONST_METHOD1(fetchL2Table, void(std::vector<L2EntryThrift>* l2Table));
-  MOCK_METHOD1(gracefulExit, void(folly::dynamic& switchState));
+  MOCK_METHOD1(
+      gracefulExit,
+      void(const std::shared_ptr<SwitchState>& switchState));
   MOCK_CONST_METHOD0(toFollyDynamic, folly::dynamic());
   MOCK_METHOD1(switchRunStateChanged, void(SwitchRunState newState));
   MOCK_CONST_METHOD0(exitFatal, void());
@@ -112,6 +112,26 @@ class NextHopGroupApi : public SaiApi<NextHopGroupApi> {
     return api_->create_next_hop_group_member(
         rawSaiId(id), switch_id, count, attr_list);
   }
+  using SaiApi<NextHopGroupApi>::_bulkCreate;
+  sai_status_t _bulkCreate(
+      NextHopGroupMemberSaiId* ids,
+      sai_object_id_t switch_id,
+      size_t count,
+      const uint32_t* attr_counts,
+      const sai_attribute_t** attr_lists,
+      sai_status_t* statuses) {
+    if (!api_->create_next_hop_group_members) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->create_next_hop_group_members(
+        switch_id,
+        count,
+        attr_counts,
+        attr_lists,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        rawSaiId(ids),
+        statuses);
+  }
   sai_status_t _remove(NextHopGroupSaiId next_hop_group_id) {
     return api_->remove_next_hop_group(next_hop_group_id);
   }
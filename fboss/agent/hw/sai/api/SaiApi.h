@@ -91,6 +91,74 @@ class SaiApi {
     XLOGF(DBG5, "created SAI object: {}: {}", entry, createAttributes);
   }
 
+  /*
+   * Create several objects of the same type. If the adapter implements the
+   * bulk create api for this object type, this is a single adapter call,
+   * otherwise we fall back to creating the objects one at a time. Either way,
+   * the objects are created under a single acquisition of the api lock.
+   *
+   * On failure, objects which were created are removed again before
+   * throwing, so callers never have to deal with partially applied batches.
+   */
+  template <typename SaiObjectTraits>
+  std::enable_if_t<
+      AdapterKeyIsObjectId<SaiObjectTraits>::value,
+      std::vector<typename SaiObjectTraits::AdapterKey>>
+  bulkCreate(
+      const std::vector<typename SaiObjectTraits::CreateAttributes>&
+          createAttributes,
+      sai_object_id_t switch_id) {
+    static_assert(
+        std::is_same_v<typename SaiObjectTraits::SaiApiT, ApiT>,
+        "invalid traits for the api");
+    using AdapterKey = typename SaiObjectTraits::AdapterKey;
+    auto count = createAttributes.size();
+    std::vector<AdapterKey> keys(count);
+    if (count == 0) {
+      return keys;
+    }
+    std::vector<std::vector<sai_attribute_t>> saiAttributeTs;
+    std::vector<uint32_t> attrCounts;
+    std::vector<const sai_attribute_t*> attrLists;
+    saiAttributeTs.reserve(count);
+    attrCounts.reserve(count);
+    attrLists.reserve(count);
+    for (const auto& attributes : createAttributes) {
+      saiAttributeTs.push_back(saiAttrs(attributes));
+      attrCounts.push_back(saiAttributeTs.back().size());
+      attrLists.push_back(saiAttributeTs.back().data());
+    }
+    std::vector<sai_status_t> statuses(count, SAI_STATUS_FAILURE);
+    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    sai_status_t status = impl()._bulkCreate(
+        keys.data(),
+        switch_id,
+        count,
+        attrCounts.data(),
+        attrLists.data(),
+        statuses.data());
+    if (status == SAI_STATUS_NOT_IMPLEMENTED) {
+      status = SAI_STATUS_SUCCESS;
+      for (size_t i = 0; i < count && status == SAI_STATUS_SUCCESS; ++i) {
+        status = statuses[i] = impl()._create(
+            &keys[i],
+            switch_id,
+            saiAttributeTs[i].size(),
+            saiAttributeTs[i].data());
+      }
+    }
+    if (status != SAI_STATUS_SUCCESS) {
+      for (size_t i = 0; i < count; ++i) {
+        if (statuses[i] == SAI_STATUS_SUCCESS) {
+          impl()._remove(keys[i]);
+        }
+      }
+    }
+    saiApiCheckError(status, ApiT::ApiType, "Failed to bulk create sai entity");
+    XLOGF(DBG5, "bulk created {} SAI objects", count);
+    return keys;
+  }
+
   template <typename AdapterKeyT>
   void remove(const AdapterKeyT& key) {
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
@@ -204,6 +272,23 @@ class SaiApi {
         SaiObjectTraits::CounterIds.size());
   }
 
+ protected:
+  /*
+   * Default for apis (or object types) without bulk create support. Apis which
+   * support bulk create for an object type shadow this with an overload
+   * taking that object type's adapter key.
+   */
+  template <typename AdapterKeyT>
+  sai_status_t _bulkCreate(
+      AdapterKeyT* /* keys */,
+      sai_object_id_t /* switch_id */,
+      size_t /* object_count */,
+      const uint32_t* /* attr_counts */,
+      const sai_attribute_t** /* attr_lists */,
+      sai_status_t* /* statuses */) {
+    return SAI_STATUS_NOT_IMPLEMENTED;
+  }
+
  private:
   template <typename SaiObjectTraits>
   std::vector<uint64_t> getStatsImpl(
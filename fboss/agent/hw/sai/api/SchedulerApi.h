@@ -58,9 +58,14 @@ struct SaiSchedulerTraits {
         sai_uint64_t>;
   };
   using AdapterKey = SchedulerSaiId;
+  // Keyed on all the attributes, so that queues with identical scheduling
+  // share a scheduler profile, and queues with different ones never do
   using AdapterHostKey = std::tuple<
       std::optional<Attributes::SchedulingType>,
-      std::optional<Attributes::SchedulingWeight>>;
+      std::optional<Attributes::SchedulingWeight>,
+      std::optional<Attributes::MeterType>,
+      std::optional<Attributes::MinBandwidthRate>,
+      std::optional<Attributes::MaxBandwidthRate>>;
   using CreateAttributes = std::tuple<
       std::optional<Attributes::SchedulingType>,
       std::optional<Attributes::SchedulingWeight>,
@@ -11,7 +11,9 @@
 
 #include <folly/logging/xlog.h>
 
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 
 extern "C" {
@@ -20,6 +22,19 @@ extern "C" {
 
 namespace facebook::fboss {
 
+/*
+ * Time every create and remove of a fake object takes, to model the round
+ * trips to a real adapter in benchmarks. None by default.
+ *
+ * The wait happens with the SaiApiLock released, as if the device rather
+ * than the agent was busy, so calls made from several threads overlap. A
+ * latency must only be set while every fake call goes through the SaiApi
+ * wrappers, which hold the lock.
+ */
+void setFakeSaiCallLatency(std::chrono::microseconds latency);
+std::chrono::microseconds getFakeSaiCallLatency();
+void simulateFakeSaiCallLatency();
+
 template <typename K, typename T>
 class FakeManager {
  public:
@@ -27,6 +42,7 @@ class FakeManager {
   typename std::
       enable_if<std::is_same<E, sai_object_id_t>::value, sai_object_id_t>::type
       create(Args&&... args) {
+    simulateFakeSaiCallLatency();
     sai_object_id_t id = static_cast<sai_object_id_t>(count_++);
     auto ins = map_.emplace(id, T{std::forward<Args>(args)...});
     ins.first->second.id = id;
@@ -36,6 +52,7 @@ class FakeManager {
   template <typename E = K, typename... Args>
   typename std::enable_if<!std::is_same<E, sai_object_id_t>::value, void>::type
   create(const K& k, Args&&... args) {
+    simulateFakeSaiCallLatency();
     auto ins = map_.emplace(k, T{std::forward<Args>(args)...});
     if (!ins.second) {
       throw std::runtime_error("Object already exists, create failed");
@@ -44,6 +61,7 @@ class FakeManager {
   }
 
   size_t remove(const K& k) {
+    simulateFakeSaiCallLatency();
     return map_.erase(k);
   }
 
@@ -8,15 +8,47 @@
  *
  */
 #include "FakeSai.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 
 #include <folly/Singleton.h>
 
 #include <folly/logging/xlog.h>
 
+#include <atomic>
+#include <thread>
+
 namespace {
 struct singleton_tag_type {};
+
+std::atomic<int64_t> fakeSaiCallLatencyUs{0};
 } // namespace
 
+namespace facebook::fboss {
+
+void setFakeSaiCallLatency(std::chrono::microseconds latency) {
+  fakeSaiCallLatencyUs.store(latency.count(), std::memory_order_relaxed);
+}
+
+std::chrono::microseconds getFakeSaiCallLatency() {
+  return std::chrono::microseconds(
+      fakeSaiCallLatencyUs.load(std::memory_order_relaxed));
+}
+
+void simulateFakeSaiCallLatency() {
+  auto latency = getFakeSaiCallLatency();
+  if (!latency.count()) {
+    return;
+  }
+  // Taken by the SaiApi wrapper making this call, and taken again before
+  // the fake objects are touched
+  auto& apiLock = SaiApiLock::getInstance()->lock;
+  apiLock.unlock();
+  std::this_thread::sleep_for(latency);
+  apiLock.lock();
+}
+
+} // namespace facebook::fboss
+
 using facebook::fboss::FakeSai;
 static folly::Singleton<FakeSai, singleton_tag_type> fakeSaiSingleton{};
 std::shared_ptr<FakeSai> FakeSai::getInstance() {
@@ -44,6 +76,7 @@ void FakeSai::clear() {
   fs->switchManager.clear();
   fs->virtualRouteManager.clear();
   fs->vlanManager.clearWithMembers();
+  fs->apiCallCounts.clear();
 }
 
 sai_object_id_t FakeSai::getCpuPort() {
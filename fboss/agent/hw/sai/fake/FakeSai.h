@@ -28,6 +28,7 @@
 #include "fboss/agent/hw/sai/fake/FakeSaiVlan.h"
 
 #include <memory>
+#include <unordered_map>
 
 extern "C" {
 #include <sai.h>
@@ -59,6 +60,13 @@ struct FakeSai {
   FakeVlanManager vlanManager;
   bool initialized = false;
   sai_object_id_t cpuPortId;
+  /*
+   * Create, remove and set attribute calls made for each object type, for
+   * tests checking how much programming a change takes. Only kept for
+   * schedulers, queues and next hop group members so far. A bulk create
+   * counts as one call.
+   */
+  std::unordered_map<sai_object_type_t, uint64_t> apiCallCounts;
   sai_object_id_t getCpuPort();
 };
 
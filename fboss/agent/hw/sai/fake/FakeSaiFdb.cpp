@@ -13,6 +13,7 @@
 #include "fboss/agent/hw/sai/api/AddressUtil.h"
 
 #include <folly/logging/xlog.h>
+#include <algorithm>
 #include <optional>
 
 using facebook::fboss::FakeFdb;
@@ -93,6 +94,49 @@ sai_status_t get_fdb_entry_attribute_fn(
 
 namespace facebook::fboss {
 
+size_t fake_fdb_event_notify(
+    sai_object_id_t switchId,
+    const std::vector<FakeFdbEvent>& events,
+    size_t batchSize) {
+  auto fs = FakeSai::getInstance();
+  auto notify = fs->switchManager.get(switchId).fdbEventNotification();
+
+  std::vector<sai_attribute_t> attrs(events.size());
+  std::vector<sai_fdb_event_notification_data_t> data(events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    auto key = std::make_tuple(switchId, event.bridgeVlanId, event.mac);
+    switch (event.type) {
+      case SAI_FDB_EVENT_LEARNED:
+      case SAI_FDB_EVENT_MOVE:
+        fs->fdbManager.map().insert_or_assign(key, FakeFdb{event.bridgePortId});
+        break;
+      case SAI_FDB_EVENT_AGED:
+      case SAI_FDB_EVENT_FLUSHED:
+        fs->fdbManager.remove(key);
+        break;
+    }
+    attrs[i].id = SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID;
+    attrs[i].value.oid = event.bridgePortId;
+    data[i].event_type = event.type;
+    data[i].fdb_entry.switch_id = switchId;
+    data[i].fdb_entry.bv_id = event.bridgeVlanId;
+    toSaiMacAddress(event.mac, data[i].fdb_entry.mac_address);
+    data[i].attr_count = 1;
+    data[i].attr = &attrs[i];
+  }
+
+  if (!notify) {
+    return 0;
+  }
+  size_t notifications = 0;
+  for (size_t i = 0; i < data.size(); i += batchSize) {
+    notify(std::min(batchSize, data.size() - i), data.data() + i);
+    ++notifications;
+  }
+  return notifications;
+}
+
 static sai_fdb_api_t _fdb_api;
 
 void populate_fdb_api(sai_fdb_api_t** fdb_api) {
@@ -14,6 +14,7 @@
 #include <folly/MacAddress.h>
 
 #include <tuple>
+#include <vector>
 
 extern "C" {
 #include <sai.h>
@@ -30,6 +31,23 @@ using FakeFdbEntry =
     std::tuple<sai_object_id_t, sai_object_id_t, folly::MacAddress>;
 using FakeFdbManager = FakeManager<FakeFdbEntry, FakeFdb>;
 
+struct FakeFdbEvent {
+  sai_fdb_event_t type;
+  sai_object_id_t bridgeVlanId;
+  folly::MacAddress mac;
+  sai_object_id_t bridgePortId;
+};
+
+/*
+ * Play the part of a learning ASIC: apply the events to the fake fdb table,
+ * then report them to the FDB_EVENT_NOTIFY callback of the switch, at most
+ * batchSize events per notification. Returns the number of notifications.
+ */
+size_t fake_fdb_event_notify(
+    sai_object_id_t switchId,
+    const std::vector<FakeFdbEvent>& events,
+    size_t batchSize);
+
 void populate_fdb_api(sai_fdb_api_t** fdb_api);
 
 } // namespace facebook::fboss
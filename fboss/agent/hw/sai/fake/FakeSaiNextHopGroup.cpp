@@ -92,9 +92,10 @@ sai_status_t set_next_hop_group_attribute_fn(
   return SAI_STATUS_SUCCESS;
 }
 
-sai_status_t create_next_hop_group_member_fn(
+namespace {
+
+sai_status_t createNextHopGroupMember(
     sai_object_id_t* next_hop_group_member_id,
-    sai_object_id_t /* switch_id */,
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
@@ -127,6 +128,19 @@ sai_status_t create_next_hop_group_member_fn(
   return SAI_STATUS_SUCCESS;
 }
 
+} // namespace
+
+sai_status_t create_next_hop_group_member_fn(
+    sai_object_id_t* next_hop_group_member_id,
+    sai_object_id_t /* switch_id */,
+    uint32_t attr_count,
+    const sai_attribute_t* attr_list) {
+  auto fs = FakeSai::getInstance();
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER];
+  return createNextHopGroupMember(
+      next_hop_group_member_id, attr_count, attr_list);
+}
+
 sai_status_t remove_next_hop_group_member_fn(
     sai_object_id_t next_hop_group_member_id) {
   auto fs = FakeSai::getInstance();
@@ -134,6 +148,32 @@ sai_status_t remove_next_hop_group_member_fn(
   return SAI_STATUS_SUCCESS;
 }
 
+sai_status_t create_next_hop_group_members_fn(
+    sai_object_id_t /* switch_id */,
+    uint32_t object_count,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_object_id_t* object_id,
+    sai_status_t* object_statuses) {
+  auto fs = FakeSai::getInstance();
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER];
+  sai_status_t status = SAI_STATUS_SUCCESS;
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (status != SAI_STATUS_SUCCESS &&
+        mode == SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR) {
+      object_statuses[i] = SAI_STATUS_FAILURE;
+      continue;
+    }
+    object_statuses[i] =
+        createNextHopGroupMember(&object_id[i], attr_count[i], attr_list[i]);
+    if (object_statuses[i] != SAI_STATUS_SUCCESS) {
+      status = object_statuses[i];
+    }
+  }
+  return status;
+}
+
 sai_status_t get_next_hop_group_member_attribute_fn(
     sai_object_id_t next_hop_group_member_id,
     uint32_t attr_count,
@@ -187,6 +227,8 @@ void populate_next_hop_group_api(
       &create_next_hop_group_member_fn;
   _next_hop_group_api.remove_next_hop_group_member =
       &remove_next_hop_group_member_fn;
+  _next_hop_group_api.create_next_hop_group_members =
+      &create_next_hop_group_members_fn;
   _next_hop_group_api.set_next_hop_group_member_attribute =
       &set_next_hop_group_member_attribute_fn;
   _next_hop_group_api.get_next_hop_group_member_attribute =
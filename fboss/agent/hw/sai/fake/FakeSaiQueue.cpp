@@ -67,6 +67,7 @@ sai_status_t set_queue_attribute_fn(
   if (!attr) {
     return SAI_STATUS_INVALID_PARAMETER;
   }
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_QUEUE];
   switch (attr->id) {
     case SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE:
       queue.parentScheduler = attr->value.oid;
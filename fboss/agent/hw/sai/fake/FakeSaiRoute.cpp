@@ -17,6 +17,11 @@
 using facebook::fboss::FakeRoute;
 using facebook::fboss::FakeSai;
 
+namespace {
+// Fake SAI calls are serialized by the SaiApiLock
+uint64_t routesCreated{0};
+} // namespace
+
 sai_status_t set_route_entry_attribute_fn(
     const sai_route_entry_t* route_entry,
     const sai_attribute_t* attr) {
@@ -49,6 +54,7 @@ sai_status_t create_route_entry_fn(
       route_entry->vr_id,
       facebook::fboss::fromSaiIpPrefix(route_entry->destination));
   fs->routeManager.create(re);
+  fs->routeManager.get(re).createOrder = routesCreated++;
   for (int i = 0; i < attr_count; ++i) {
     set_route_entry_attribute_fn(route_entry, &attr_list[i]);
   }
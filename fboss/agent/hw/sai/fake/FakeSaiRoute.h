@@ -25,6 +25,8 @@ struct FakeRoute {
   FakeRoute() {}
   sai_object_id_t nextHopId{0};
   int32_t packetAction{0};
+  // Routes created before this one, for tests of the programming order
+  uint64_t createOrder{0};
 };
 
 using FakeRouteEntry =
@@ -58,6 +58,7 @@ sai_status_t create_scheduler_fn(
     }
   }
   *scheduler_id = fs->scheduleManager.create();
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER];
   auto& scheduler = fs->scheduleManager.get(*scheduler_id);
   if (schedulingType) {
     scheduler.schedulingType = schedulingType.value();
@@ -86,6 +87,7 @@ sai_status_t create_scheduler_fn(
 sai_status_t remove_scheduler_fn(sai_object_id_t scheduler_id) {
   auto fs = FakeSai::getInstance();
   fs->scheduleManager.remove(scheduler_id);
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER];
   return SAI_STATUS_SUCCESS;
 }
 
@@ -98,6 +100,7 @@ sai_status_t set_scheduler_attribute_fn(
   if (!attr) {
     return SAI_STATUS_INVALID_PARAMETER;
   }
+  ++fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER];
   switch (attr->id) {
     case SAI_SCHEDULER_ATTR_SCHEDULING_TYPE:
       scheduler.schedulingType =
@@ -73,6 +73,10 @@ sai_status_t set_switch_attribute_fn(
     case SAI_SWITCH_ATTR_RESTART_WARM:
       sw.setRestartWarm(attr->value.booldata);
       break;
+    case SAI_SWITCH_ATTR_FDB_EVENT_NOTIFY:
+      sw.setFdbEventNotification(
+          reinterpret_cast<sai_fdb_event_notification_fn>(attr->value.ptr));
+      break;
     default:
       res = SAI_STATUS_INVALID_PARAMETER;
       break;
@@ -60,6 +60,9 @@ class FakeSwitch {
   void setRestartWarm(bool warm) {
     restartWarm_ = warm;
   }
+  void setFdbEventNotification(sai_fdb_event_notification_fn fn) {
+    fdbEventNotification_ = fn;
+  }
   bool isShellEnabled() const {
     return shellEnabled_;
   }
@@ -90,6 +93,9 @@ class FakeSwitch {
   bool restartWarm() const {
     return restartWarm_;
   }
+  sai_fdb_event_notification_fn fdbEventNotification() const {
+    return fdbEventNotification_;
+  }
   sai_object_id_t id;
 
  private:
@@ -104,6 +110,7 @@ class FakeSwitch {
   sai_object_id_t ecmpHashV6_{0};
   std::vector<int8_t> hwInfo_;
   bool restartWarm_{false};
+  sai_fdb_event_notification_fn fdbEventNotification_{nullptr};
 };
 
 using FakeSwitchManager = FakeManager<sai_object_id_t, FakeSwitch>;
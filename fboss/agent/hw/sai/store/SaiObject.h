@@ -157,12 +157,15 @@ typename std::
  * moved from. If it is live, destroying the SaiObject removes the
  * corresponding object from SAI.
  *
- * A SaiObject can be constructed in three ways:
+ * A SaiObject can be constructed in four ways:
  * 1. By loading it from the SAI adapter using the AdapterKey. This can be
  *    thought of as the SaiObject taking control of an existing object in SAI.
  * 2. By creating a new object in the SAI adapter using the AdapterHostKey and
  *    CreateAttributes
- * 3. Moving from another SaiObject. If the moved-from SaiObject was live,
+ * 3. By adopting an object which was just created in the SAI adapter with the
+ *    given AdapterHostKey and CreateAttributes (e.g., by a bulk create), in
+ *    which case no adapter call is made.
+ * 4. Moving from another SaiObject. If the moved-from SaiObject was live,
  *    after the move, it is no longer live, so that at any point, only one
  *    SaiObject manages a given SAI object. (N.B., there is no general hard
  *    guarantee for this property -- a user could load the same SaiObject more
@@ -207,6 +210,16 @@ class SaiObject {
     live_ = true;
   }
 
+  // Adopt an object already created with adapter host key and attributes
+  SaiObject(
+      const typename SaiObjectTraits::AdapterKey& adapterKey,
+      const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
+      const typename SaiObjectTraits::CreateAttributes& attributes)
+      : live_(true),
+        adapterKey_(adapterKey),
+        adapterHostKey_(adapterHostKey),
+        attributes_(attributes) {}
+
   // Forbid copy construction and copy assignment
   SaiObject(const SaiObject& other) = delete;
   SaiObject& operator=(const SaiObject& other) = delete;
@@ -33,6 +33,13 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
       sai_object_id_t switchId)
       : SaiObject<SaiObjectTraits>(adapterHostKey, attributes, switchId) {}
 
+  // Adopt an object already created with adapter host key and attributes
+  SaiObjectWithCounters(
+      const typename SaiObjectTraits::AdapterKey& adapterKey,
+      const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
+      const typename SaiObjectTraits::CreateAttributes& attributes)
+      : SaiObject<SaiObjectTraits>(adapterKey, adapterHostKey, attributes) {}
+
   template <typename T = SaiObjectTraits>
   void updateStats() {
     static_assert(SaiObjectHasStats<T>::value, "invalid traits for the api");
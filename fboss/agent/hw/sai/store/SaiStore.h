@@ -18,11 +18,15 @@
 #include "fboss/agent/hw/sai/store/SaiObject.h"
 #include "fboss/agent/hw/sai/store/SaiObjectWithCounters.h"
 #include "fboss/lib/RefMap.h"
+#include "fboss/lib/TupleUtils.h"
 
 #include <folly/dynamic.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 extern "C" {
 #include <sai.h>
@@ -130,6 +134,57 @@ class SaiObjectStore {
     return ins.first;
   }
 
+  /*
+   * Batched flavor of setObject. Objects which already exist get their
+   * attributes updated, the remaining ones are created with a single bulk
+   * create in the adapter (where the object type and adapter support it).
+   * Returns the objects in the same order as the input.
+   */
+  std::vector<std::shared_ptr<ObjectType>> setObjects(
+      const std::vector<std::pair<
+          typename SaiObjectTraits::AdapterHostKey,
+          typename SaiObjectTraits::CreateAttributes>>& objects) {
+    std::vector<std::shared_ptr<ObjectType>> ret(objects.size());
+    if constexpr (AdapterKeyIsObjectId<SaiObjectTraits>::value) {
+      std::vector<size_t> toCreate;
+      std::vector<typename SaiObjectTraits::CreateAttributes> createAttributes;
+      std::unordered_map<typename SaiObjectTraits::AdapterHostKey, size_t>
+          firstIndex;
+      for (size_t i = 0; i < objects.size(); ++i) {
+        const auto& [adapterHostKey, attributes] = objects[i];
+        if (auto existing = objects_.ref(adapterHostKey)) {
+          existing->setAttributes(attributes);
+          ret[i] = existing;
+        } else if (firstIndex.emplace(adapterHostKey, i).second) {
+          toCreate.push_back(i);
+          createAttributes.push_back(attributes);
+        }
+      }
+      auto& api = SaiApiTable::getInstance()
+                      ->getApi<typename SaiObjectTraits::SaiApiT>();
+      auto adapterKeys = api.template bulkCreate<SaiObjectTraits>(
+          createAttributes, switchId_.value());
+      for (size_t j = 0; j < toCreate.size(); ++j) {
+        const auto& [adapterHostKey, attributes] = objects[toCreate[j]];
+        auto ins = objects_.refOrEmplace(
+            adapterHostKey, adapterKeys[j], adapterHostKey, attributes);
+        ret[toCreate[j]] = ins.first;
+      }
+      // Fill in duplicates of keys created in this batch
+      for (size_t i = 0; i < objects.size(); ++i) {
+        if (!ret[i]) {
+          ret[i] = ret[firstIndex[objects[i].first]];
+        }
+      }
+    } else {
+      for (size_t i = 0; i < objects.size(); ++i) {
+        ret[i] = setObject(objects[i].first, objects[i].second);
+      }
+    }
+    XLOGF(DBG5, "SaiStore set {} objects", objects.size());
+    return ret;
+  }
+
   std::shared_ptr<ObjectType> get(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey) {
     XLOGF(DBG5, "SaiStore get object {}", adapterHostKey);
@@ -148,6 +203,17 @@ class SaiObjectStore {
     }
     return adapterKeys;
   }
+  /*
+   * Write the elements of adapterKeysFollyDynamic() to writer, a
+   * JsonStreamWriter in an array, one at a time.
+   */
+  template <typename Writer>
+  void writeAdapterKeysJson(Writer& writer) const {
+    for (const auto& hostKeyAndObj : objects_) {
+      writer.value(toFollyDynamic<SaiObjectTraits>(
+          hostKeyAndObj.second.lock()->adapterKey()));
+    }
+  }
   static std::vector<typename SaiObjectTraits::AdapterKey>
   adapterKeysFromFollyDynamic(const folly::dynamic& json) {
     std::vector<typename SaiObjectTraits::AdapterKey> adapterKeys;
@@ -218,6 +284,37 @@ class SaiStore {
 
   folly::dynamic adapterKeysFollyDynamic() const;
 
+  /*
+   * Write the members of the adapterKeysFollyDynamic() object to writer, a
+   * JsonStreamWriter in an object, without building them first.
+   */
+  template <typename Writer>
+  void writeAdapterKeysJson(Writer& writer) const {
+    // Object types of several traits, like next hops, share one array
+    std::vector<folly::StringPiece> objNames;
+    tupleForEach(
+        [&objNames](const auto& store) {
+          auto objName = store.objectTypeName();
+          if (std::find(objNames.begin(), objNames.end(), objName) ==
+              objNames.end()) {
+            objNames.push_back(objName);
+          }
+        },
+        stores_);
+    for (auto objName : objNames) {
+      writer.key(objName);
+      writer.beginArray();
+      tupleForEach(
+          [&writer, objName](const auto& store) {
+            if (store.objectTypeName() == objName) {
+              store.writeAdapterKeysJson(writer);
+            }
+          },
+          stores_);
+      writer.endArray();
+    }
+  }
+
   void exitForWarmBoot();
 
  private:
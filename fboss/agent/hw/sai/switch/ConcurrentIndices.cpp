@@ -10,8 +10,87 @@
 
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 
+#include <folly/logging/xlog.h>
+
 namespace facebook::fboss {
 
 ConcurrentIndices::~ConcurrentIndices() {}
 
+void ConcurrentIndices::fetchL2Table(
+    std::vector<L2EntryThrift>* l2Table) const {
+  l2Table->reserve(l2Table->size() + fdbEntries.size());
+  for (const auto& [fdbEntry, shadowEntry] : fdbEntries) {
+    // Entries whose vlan or port is being removed are skipped, they go
+    // away along with it
+    const auto vlanItr = bridgeVlanIds.find(VlanSaiId{fdbEntry.bridgeVlanId()});
+    if (vlanItr == bridgeVlanIds.cend()) {
+      XLOG(DBG2) << "l2 table entry had unknown vlan sai id: "
+                 << fdbEntry.bridgeVlanId();
+      continue;
+    }
+    const auto portItr = bridgePortIds.find(shadowEntry.bridgePortId);
+    if (portItr == bridgePortIds.cend()) {
+      XLOG(DBG2) << "l2 table entry had unknown bridge port sai id: "
+                 << shadowEntry.bridgePortId;
+      continue;
+    }
+    L2EntryThrift entry;
+    entry.mac = fdbEntry.mac().toString();
+    entry.vlanID = vlanItr->second;
+    entry.port = portItr->second;
+    l2Table->push_back(entry);
+  }
+}
+
+bool ConcurrentIndices::learnFdbEntry(
+    const SaiFdbTraits::FdbEntry& fdbEntry,
+    BridgePortSaiId bridgePortId) {
+  const auto itr = fdbEntries.find(fdbEntry);
+  if (itr != fdbEntries.cend() && itr->second.isStatic) {
+    return false;
+  }
+  fdbEntries.insert_or_assign(fdbEntry, FdbShadowEntry{bridgePortId, false});
+  return true;
+}
+
+bool ConcurrentIndices::unlearnFdbEntry(
+    const SaiFdbTraits::FdbEntry& fdbEntry) {
+  const auto itr = fdbEntries.find(fdbEntry);
+  if (itr != fdbEntries.cend() && itr->second.isStatic) {
+    return false;
+  }
+  fdbEntries.erase(fdbEntry);
+  return true;
+}
+
+std::vector<std::pair<SaiFdbTraits::FdbEntry, BridgePortSaiId>>
+ConcurrentIndices::flushFdbEntries(
+    BridgePortSaiId bridgePortId,
+    VlanSaiId bridgeVlanId,
+    const folly::MacAddress& mac) {
+  std::vector<std::pair<SaiFdbTraits::FdbEntry, BridgePortSaiId>> flushed;
+  // Collect first, erasing invalidates the iteration
+  for (const auto& [fdbEntry, shadowEntry] : fdbEntries) {
+    if (shadowEntry.isStatic) {
+      continue;
+    }
+    if (bridgePortId != BridgePortSaiId{0} &&
+        shadowEntry.bridgePortId != bridgePortId) {
+      continue;
+    }
+    if (bridgeVlanId != VlanSaiId{0} &&
+        VlanSaiId{fdbEntry.bridgeVlanId()} != bridgeVlanId) {
+      continue;
+    }
+    if (mac != folly::MacAddress() && fdbEntry.mac() != mac) {
+      continue;
+    }
+    flushed.emplace_back(fdbEntry, shadowEntry.bridgePortId);
+  }
+  for (const auto& [fdbEntry, flushedPortId] : flushed) {
+    fdbEntries.erase(fdbEntry);
+  }
+  return flushed;
+}
+
 } // namespace facebook::fboss
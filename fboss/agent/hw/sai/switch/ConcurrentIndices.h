@@ -11,15 +11,26 @@
 #pragma once
 
 #include <folly/concurrency/ConcurrentHashMap.h>
+#include "fboss/agent/hw/sai/api/FdbApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/types.h"
 
+#include <utility>
+#include <vector>
+
 extern "C" {
 #include <sai.h>
 }
 
 namespace facebook::fboss {
 
+struct FdbShadowEntry {
+  BridgePortSaiId bridgePortId{0};
+  // Programmed by SaiFdbManager rather than learned, kept by bulk flushes
+  bool isStatic{false};
+};
+
 struct ConcurrentIndices {
   ~ConcurrentIndices();
   /*
@@ -31,6 +42,49 @@ struct ConcurrentIndices {
   // callback supports punt with vlan id in either an attribute
   // or the frame itself
   folly::ConcurrentHashMap<PortSaiId, VlanID> vlanIds;
+
+  /*
+   * bridgePortIds and bridgeVlanIds are read by fdb event processing, to
+   * map the bridge port and vlan sai ids of learned macs back to SwitchState
+   */
+  folly::ConcurrentHashMap<BridgePortSaiId, PortID> bridgePortIds;
+  folly::ConcurrentHashMap<VlanSaiId, VlanID> bridgeVlanIds;
+
+  /*
+   * A shadow of the fdb, with the bridge port and type of each entry. Static
+   * entries are maintained by SaiFdbManager, learned ones by fdb event
+   * processing, so that the l2 table is read without the switch lock or SAI
+   * calls.
+   */
+  folly::ConcurrentHashMap<SaiFdbTraits::FdbEntry, FdbShadowEntry> fdbEntries;
+
+  /*
+   * Record a learned entry of the fdb, or remove one that aged out or was
+   * flushed. Static entries stay as SaiFdbManager programmed them; returns
+   * false, leaving fdbEntries unchanged, if fdbEntry is one.
+   */
+  bool learnFdbEntry(
+      const SaiFdbTraits::FdbEntry& fdbEntry,
+      BridgePortSaiId bridgePortId);
+  bool unlearnFdbEntry(const SaiFdbTraits::FdbEntry& fdbEntry);
+
+  /*
+   * Remove the learned entries of fdbEntries flushed by a bulk flush, e.g.
+   * of a port going down. A null bridgePortId or bridgeVlanId, or a zero
+   * mac, matches any. Returns the removed entries with their bridge port.
+   */
+  std::vector<std::pair<SaiFdbTraits::FdbEntry, BridgePortSaiId>>
+  flushFdbEntries(
+      BridgePortSaiId bridgePortId,
+      VlanSaiId bridgeVlanId,
+      const folly::MacAddress& mac);
+
+  /*
+   * Fill l2Table from fdbEntries, mapped to SwitchState ids through
+   * bridgePortIds and bridgeVlanIds. Safe to call while any of them is
+   * updated.
+   */
+  void fetchL2Table(std::vector<L2EntryThrift>* l2Table) const;
 };
 
 } // namespace facebook::fboss
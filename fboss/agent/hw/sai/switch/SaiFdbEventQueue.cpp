@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/SaiFdbEventQueue.h"
+
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/hw/sai/api/AddressUtil.h"
+
+#include <folly/container/F14Map.h>
+#include <folly/logging/xlog.h>
+
+#include <chrono>
+#include <utility>
+
+namespace {
+// How often an idle consumer checks whether it should exit
+constexpr auto kStopPollInterval = std::chrono::milliseconds(100);
+
+std::pair<uint64_t, sai_object_id_t> macAndVlan(
+    const facebook::fboss::SaiFdbEvent& event) {
+  return std::make_pair(
+      event.mac.u64HBO(), static_cast<sai_object_id_t>(event.bridgeVlanId));
+}
+} // namespace
+
+namespace facebook::fboss {
+
+SaiFdbEventQueue::SaiFdbEventQueue(
+    size_t capacity,
+    size_t maxBatchSize,
+    Handler handler)
+    : maxBatchSize_(maxBatchSize),
+      handler_(std::move(handler)),
+      queue_(capacity) {}
+
+SaiFdbEventQueue::~SaiFdbEventQueue() {
+  stop();
+}
+
+void SaiFdbEventQueue::start() {
+  if (thread_) {
+    return;
+  }
+  stopping_ = false;
+  thread_ = std::make_unique<std::thread>([this]() {
+    initThread("fbossSaiFdbEvent");
+    run();
+  });
+}
+
+void SaiFdbEventQueue::stop() {
+  if (!thread_) {
+    return;
+  }
+  stopping_ = true;
+  thread_->join();
+  thread_.reset();
+}
+
+void SaiFdbEventQueue::enqueue(
+    uint32_t count,
+    const sai_fdb_event_notification_data_t* data) {
+  for (uint32_t i = 0; i < count; ++i) {
+    SaiFdbEvent event;
+    event.type = data[i].event_type;
+    event.mac = fromSaiMacAddress(data[i].fdb_entry.mac_address);
+    event.bridgeVlanId = VlanSaiId{data[i].fdb_entry.bv_id};
+    for (uint32_t j = 0; j < data[i].attr_count; ++j) {
+      if (data[i].attr[j].id == SAI_FDB_ENTRY_ATTR_BRIDGE_PORT_ID) {
+        event.bridgePortId = BridgePortSaiId{data[i].attr[j].value.oid};
+      }
+    }
+    if (queue_.write(std::move(event))) {
+      enqueued_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::vector<SaiFdbEvent> SaiFdbEventQueue::coalesce(
+    std::vector<SaiFdbEvent> events) {
+  // (mac, vlan) -> index of its last event
+  folly::F14FastMap<std::pair<uint64_t, sai_object_id_t>, size_t> last;
+  last.reserve(events.size());
+  size_t bulkFlushes = 0;
+  for (size_t i = 0; i < events.size(); ++i) {
+    if (events[i].isBulkFlush()) {
+      ++bulkFlushes;
+      continue;
+    }
+    last[macAndVlan(events[i])] = i;
+  }
+  if (last.size() + bulkFlushes == events.size()) {
+    return events;
+  }
+  std::vector<SaiFdbEvent> coalesced;
+  coalesced.reserve(last.size() + bulkFlushes);
+  for (size_t i = 0; i < events.size(); ++i) {
+    if (events[i].isBulkFlush() || last[macAndVlan(events[i])] == i) {
+      coalesced.push_back(std::move(events[i]));
+    }
+  }
+  return coalesced;
+}
+
+void SaiFdbEventQueue::run() {
+  std::vector<SaiFdbEvent> batch;
+  while (true) {
+    SaiFdbEvent event;
+    if (!queue_.tryReadUntil(
+            std::chrono::steady_clock::now() + kStopPollInterval, event)) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+    batch.push_back(std::move(event));
+    while (batch.size() < maxBatchSize_ && queue_.read(event)) {
+      batch.push_back(std::move(event));
+    }
+
+    auto received = batch.size();
+    auto events = coalesce(std::move(batch));
+    batch.clear();
+    coalesced_.fetch_add(received - events.size(), std::memory_order_relaxed);
+    delivered_.fetch_add(events.size(), std::memory_order_relaxed);
+    try {
+      handler_(std::move(events));
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to handle fdb events: " << ex.what();
+    }
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/hw/sai/api/Types.h"
+
+#include <folly/MPMCQueue.h>
+#include <folly/MacAddress.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+struct SaiFdbEvent {
+  sai_fdb_event_t type{SAI_FDB_EVENT_LEARNED};
+  folly::MacAddress mac;
+  VlanSaiId bridgeVlanId{0};
+  BridgePortSaiId bridgePortId{0};
+
+  /*
+   * Flushes of every entry of a bridge port and/or vlan, e.g. on link down,
+   * are reported with a zero mac or a null vlan rather than per entry.
+   */
+  bool isBulkFlush() const {
+    return type == SAI_FDB_EVENT_FLUSHED &&
+        (mac == folly::MacAddress() || bridgeVlanId == VlanSaiId{0});
+  }
+};
+
+/*
+ * Hands fdb (learn, age, move, flush) events from the SAI adapter's
+ * callback thread over to a thread of its own.
+ *
+ * The callback thread only copies the events into a bounded lock free
+ * queue and never blocks: during a learning storm, the events which do not
+ * fit are dropped and counted. The consumer thread drains the queue in
+ * batches, keeps only the last event of each (mac, vlan) in a batch, and
+ * passes the batch to the handler.
+ */
+class SaiFdbEventQueue {
+ public:
+  using Handler = std::function<void(std::vector<SaiFdbEvent>)>;
+
+  SaiFdbEventQueue(size_t capacity, size_t maxBatchSize, Handler handler);
+  ~SaiFdbEventQueue();
+
+  void start();
+  /*
+   * Events already queued are handled before the consumer thread exits.
+   * Must not be called from the handler.
+   */
+  void stop();
+
+  /*
+   * Only called from the SAI adapter's fdb event callback thread.
+   */
+  void enqueue(uint32_t count, const sai_fdb_event_notification_data_t* data);
+
+  /*
+   * Drop the events superseded by a later event for the same (mac, vlan),
+   * keeping the order of the remaining ones. Bulk flushes are always kept.
+   */
+  static std::vector<SaiFdbEvent> coalesce(std::vector<SaiFdbEvent> events);
+
+  uint64_t getEnqueued() const {
+    return enqueued_.load(std::memory_order_relaxed);
+  }
+  uint64_t getDropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+  uint64_t getCoalesced() const {
+    return coalesced_.load(std::memory_order_relaxed);
+  }
+  uint64_t getDelivered() const {
+    return delivered_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void run();
+
+  const size_t maxBatchSize_;
+  Handler handler_;
+  folly::MPMCQueue<SaiFdbEvent> queue_;
+  std::unique_ptr<std::thread> thread_;
+  std::atomic<bool> stopping_{false};
+
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> coalesced_{0};
+  std::atomic<uint64_t> delivered_{0};
+};
+
+} // namespace facebook::fboss
@@ -9,13 +9,16 @@
  */
 
 #include "fboss/agent/hw/sai/switch/SaiFdbManager.h"
+#include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
+#include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiBridgeManager.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/agent/hw/sai/switch/SaiVlanManager.h"
+#include "fboss/agent/platforms/sai/SaiPlatform.h"
 
 #include <memory>
 #include <tuple>
@@ -24,8 +27,11 @@ namespace facebook::fboss {
 
 SaiFdbManager::SaiFdbManager(
     SaiManagerTable* managerTable,
-    const SaiPlatform* platform)
-    : managerTable_(managerTable), platform_(platform) {}
+    const SaiPlatform* platform,
+    ConcurrentIndices* concurrentIndices)
+    : managerTable_(managerTable),
+      platform_(platform),
+      concurrentIndices_(concurrentIndices) {}
 
 std::shared_ptr<SaiFdbEntry> SaiFdbManager::addFdbEntry(
     const InterfaceID& intfId,
@@ -52,7 +58,44 @@ std::shared_ptr<SaiFdbEntry> SaiFdbManager::addFdbEntry(
   SaiFdbTraits::CreateAttributes attributes{SAI_FDB_ENTRY_TYPE_STATIC,
                                             bridgePortId};
   auto& store = SaiStore::getInstance()->get<SaiFdbTraits>();
-  return store.setObject(entry, attributes);
+  auto fdbEntry = store.setObject(entry, attributes);
+  concurrentIndices_->fdbEntries.insert_or_assign(
+      entry, FdbShadowEntry{BridgePortSaiId{bridgePortId}, true});
+  ++fdbEntryRefs_[entry];
+  // Neighbors on the same mac share the entry, so only the release of the
+  // last reference removes it from the index
+  return std::shared_ptr<SaiFdbEntry>(
+      fdbEntry.get(), [this, entry, fdbEntry](SaiFdbEntry*) mutable {
+        fdbEntry.reset();
+        releaseFdbEntry(entry);
+      });
+}
+
+void SaiFdbManager::releaseFdbEntry(const SaiFdbTraits::FdbEntry& entry) {
+  auto itr = fdbEntryRefs_.find(entry);
+  CHECK(itr != fdbEntryRefs_.end());
+  if (--itr->second == 0) {
+    fdbEntryRefs_.erase(itr);
+    concurrentIndices_->fdbEntries.erase(entry);
+  }
+}
+
+void SaiFdbManager::loadFdbEntries() {
+  if (!platform_->getObjectKeysSupported()) {
+    return;
+  }
+  auto switchId = managerTable_->switchManager().getSwitchSaiId();
+  auto& fdbApi = SaiApiTable::getInstance()->fdbApi();
+  for (const auto& entry : getObjectKeys<SaiFdbTraits>(switchId)) {
+    auto bridgePortId = fdbApi.getAttribute(
+        entry, SaiFdbTraits::Attributes::BridgePortId{});
+    auto type =
+        fdbApi.getAttribute(entry, SaiFdbTraits::Attributes::Type{});
+    concurrentIndices_->fdbEntries.insert_or_assign(
+        entry,
+        FdbShadowEntry{
+            BridgePortSaiId{bridgePortId}, type == SAI_FDB_ENTRY_TYPE_STATIC});
+  }
 }
 
 } // namespace facebook::fboss
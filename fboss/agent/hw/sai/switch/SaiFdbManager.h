@@ -20,6 +20,7 @@
 
 namespace facebook::fboss {
 
+struct ConcurrentIndices;
 class SaiManagerTable;
 class SaiPlatform;
 
@@ -27,15 +28,34 @@ using SaiFdbEntry = SaiObject<SaiFdbTraits>;
 
 class SaiFdbManager {
  public:
-  SaiFdbManager(SaiManagerTable* managerTable, const SaiPlatform* platform);
+  SaiFdbManager(
+      SaiManagerTable* managerTable,
+      const SaiPlatform* platform,
+      ConcurrentIndices* concurrentIndices);
+  /*
+   * The entry stays in ConcurrentIndices::fdbEntries until the last
+   * reference returned for it is released.
+   */
   std::shared_ptr<SaiFdbEntry> addFdbEntry(
       const InterfaceID& intfId,
       const folly::MacAddress& mac,
       const PortDescriptor& portDesc);
 
+  /*
+   * Add the fdb entries already in the adapter, e.g. learned before a warm
+   * boot, to ConcurrentIndices::fdbEntries. Later changes to learned
+   * entries come through fdb events.
+   */
+  void loadFdbEntries();
+
  private:
+  void releaseFdbEntry(const SaiFdbTraits::FdbEntry& entry);
+
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
+  ConcurrentIndices* concurrentIndices_;
+  // Number of references handed out by addFdbEntry() per entry
+  std::unordered_map<SaiFdbTraits::FdbEntry, size_t> fdbEntryRefs_;
 };
 
 } // namespace facebook::fboss
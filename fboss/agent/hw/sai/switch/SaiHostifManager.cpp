@@ -250,7 +250,18 @@ void SaiHostifManager::changeCpuQueue(
     SaiQueueConfig saiQueueConfig =
         std::make_pair(newPortQueue->getID(), newPortQueue->getStreamType());
     auto queueHandle = getQueueHandle(saiQueueConfig);
-    managerTable_->queueManager().changeQueue(queueHandle, *newPortQueue);
+    auto oldPortQueueIter = std::find_if(
+        oldQueueConfig.begin(),
+        oldQueueConfig.end(),
+        [&](const std::shared_ptr<PortQueue> portQueue) {
+          return portQueue->getID() == newPortQueue->getID() &&
+              portQueue->getStreamType() == newPortQueue->getStreamType();
+        });
+    managerTable_->queueManager().changeQueue(
+        queueHandle,
+        *newPortQueue,
+        oldPortQueueIter == oldQueueConfig.end() ? nullptr
+                                                 : oldPortQueueIter->get());
     auto queueName = newPortQueue->getName()
         ? *newPortQueue->getName()
         : folly::to<std::string>("cpuQueue", newPortQueue->getID());
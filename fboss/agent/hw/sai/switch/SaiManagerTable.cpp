@@ -43,7 +43,8 @@ void SaiManagerTable::createSaiTableManagers(
     SaiPlatform* platform,
     ConcurrentIndices* concurrentIndices) {
   bridgeManager_ = std::make_unique<SaiBridgeManager>(this, platform);
-  fdbManager_ = std::make_unique<SaiFdbManager>(this, platform);
+  fdbManager_ =
+      std::make_unique<SaiFdbManager>(this, platform, concurrentIndices);
   hashManager_ = std::make_unique<SaiHashManager>(this);
   hostifManager_ = std::make_unique<SaiHostifManager>(this);
   portManager_ =
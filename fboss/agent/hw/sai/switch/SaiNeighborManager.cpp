@@ -20,6 +20,9 @@
 #include "fboss/agent/state/DeltaFunctions.h"
 #include "fboss/agent/state/NdpEntry.h"
 
+#include <folly/ScopeGuard.h>
+#include <folly/logging/xlog.h>
+
 namespace facebook::fboss {
 
 SaiNeighborManager::SaiNeighborManager(
@@ -129,6 +132,20 @@ void SaiNeighborManager::removeNeighbor(
 }
 
 void SaiNeighborManager::processNeighborDelta(const StateDelta& delta) {
+  // Defer propagating resolved neighbors to next hop groups until the whole
+  // delta has been processed, so that mass resolution (e.g., after a reboot)
+  // is propagated in one pass with bulk member creation.
+  auto& nextHopGroupManager = managerTable_->nextHopGroupManager();
+  nextHopGroupManager.startNeighborBatch();
+  SCOPE_FAIL {
+    // Neighbors programmed before the failure still have to join their
+    // groups, and later resolutions must not be held back in the batch.
+    try {
+      nextHopGroupManager.flushNeighborBatch();
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to flush neighbor batch: " << ex.what();
+    }
+  };
   for (const auto& vlanDelta : delta.getVlansDelta()) {
     auto processChanged =
         [this](const auto& oldNeighbor, const auto& newNeighbor) {
@@ -145,6 +162,7 @@ void SaiNeighborManager::processNeighborDelta(const StateDelta& delta) {
     DeltaFunctions::forEachChanged(
         vlanDelta.getNdpDelta(), processChanged, processAdded, processRemoved);
   }
+  nextHopGroupManager.flushNeighborBatch();
 }
 
 void SaiNeighborManager::clear() {
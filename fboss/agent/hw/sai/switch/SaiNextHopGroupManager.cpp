@@ -31,6 +31,16 @@ SaiNextHopGroupMembership::SaiNextHopGroupMembership(
 
 void SaiNextHopGroupMembership::joinNextHopGroup(
     SaiManagerTable* managerTable) {
+  auto [memberAdapterHostKey, memberAttributes] = prepareJoin(managerTable);
+  auto& memberStore =
+      SaiStore::getInstance()->get<SaiNextHopGroupMemberTraits>();
+  completeJoin(memberStore.setObject(memberAdapterHostKey, memberAttributes));
+}
+
+std::pair<
+    SaiNextHopGroupMemberTraits::AdapterHostKey,
+    SaiNextHopGroupMemberTraits::CreateAttributes>
+SaiNextHopGroupMembership::prepareJoin(SaiManagerTable* managerTable) {
   saiNextHop_ = managerTable->nextHopManager().refOrEmplace(nexthop_);
   CHECK(saiNextHop_.has_value()) << "failed to get next hop";
   auto nexthopId = std::visit(
@@ -42,9 +52,12 @@ void SaiNextHopGroupMembership::joinNextHopGroup(
       groupId_,
       nexthopId,
       (nexthop_.weight() == ECMP_WEIGHT ? 1 : nexthop_.weight())};
-  auto& memberStore =
-      SaiStore::getInstance()->get<SaiNextHopGroupMemberTraits>();
-  member_ = memberStore.setObject(memberAdapterHostKey, memberAttributes);
+  return {memberAdapterHostKey, memberAttributes};
+}
+
+void SaiNextHopGroupMembership::completeJoin(
+    std::shared_ptr<SaiNextHopGroupMember> member) {
+  member_ = std::move(member);
 }
 
 void SaiNextHopGroupMembership::leaveNextHopGroup() {
@@ -132,6 +145,10 @@ SaiNextHopGroupManager::incRefOrAddNextHopGroup(
 
 void SaiNextHopGroupManager::handleResolvedNeighbor(
     const SaiNeighborTraits::NeighborEntry& neighborEntry) {
+  if (batchingNeighbors_) {
+    pendingResolvedNeighbors_.push_back(neighborEntry);
+    return;
+  }
   for (auto itr : handles_) {
     auto groupHandle = itr.second.lock();
     auto neighborIter = groupHandle->neighbor2Memberships.find(neighborEntry);
@@ -144,8 +161,89 @@ void SaiNextHopGroupManager::handleResolvedNeighbor(
   }
 }
 
+void SaiNextHopGroupManager::startNeighborBatch() {
+  batchingNeighbors_ = true;
+  pendingResolvedNeighbors_.clear();
+}
+
+void SaiNextHopGroupManager::flushNeighborBatch() {
+  batchingNeighbors_ = false;
+  std::vector<SaiNeighborTraits::NeighborEntry> resolved;
+  resolved.swap(pendingResolvedNeighbors_);
+  if (!resolved.empty()) {
+    handleResolvedNeighbors(resolved);
+  }
+}
+
+void SaiNextHopGroupManager::handleResolvedNeighbors(
+    const std::vector<SaiNeighborTraits::NeighborEntry>& neighborEntries) {
+  folly::F14FastSet<SaiNeighborTraits::NeighborEntry> resolved(
+      neighborEntries.begin(), neighborEntries.end());
+  std::vector<SaiNextHopGroupMembership*> toJoin;
+  for (auto itr : handles_) {
+    auto groupHandle = itr.second.lock();
+    auto& neighbor2Memberships = groupHandle->neighbor2Memberships;
+    // Walk whichever of the group's neighbors and the resolved neighbors is
+    // smaller, so that a large batch costs one pass over the groups.
+    if (resolved.size() < neighbor2Memberships.size()) {
+      for (const auto& neighborEntry : resolved) {
+        auto neighborIter = neighbor2Memberships.find(neighborEntry);
+        if (neighborIter == neighbor2Memberships.end()) {
+          continue;
+        }
+        for (const auto& membership : neighborIter->second) {
+          toJoin.push_back(membership.get());
+        }
+      }
+    } else {
+      for (const auto& [neighborEntry, memberships] : neighbor2Memberships) {
+        if (resolved.find(neighborEntry) == resolved.end()) {
+          continue;
+        }
+        for (const auto& membership : memberships) {
+          toJoin.push_back(membership.get());
+        }
+      }
+    }
+  }
+  joinNextHopGroups(toJoin);
+}
+
+void SaiNextHopGroupManager::joinNextHopGroups(
+    const std::vector<SaiNextHopGroupMembership*>& memberships) {
+  if (memberships.empty()) {
+    return;
+  }
+  // Next hops are shared across groups, so acquire all of them first; the
+  // next hop manager creates each distinct next hop once.
+  std::vector<std::pair<
+      SaiNextHopGroupMemberTraits::AdapterHostKey,
+      SaiNextHopGroupMemberTraits::CreateAttributes>>
+      members;
+  members.reserve(memberships.size());
+  for (auto membership : memberships) {
+    members.push_back(membership->prepareJoin(managerTable_));
+  }
+  auto& memberStore =
+      SaiStore::getInstance()->get<SaiNextHopGroupMemberTraits>();
+  auto saiMembers = memberStore.setObjects(members);
+  for (size_t i = 0; i < memberships.size(); ++i) {
+    memberships[i]->completeJoin(std::move(saiMembers[i]));
+  }
+  XLOG(DBG2) << "Joined " << memberships.size()
+             << " next hop group members in one batch";
+}
+
 void SaiNextHopGroupManager::handleUnresolvedNeighbor(
     const SaiNeighborTraits::NeighborEntry& neighborEntry) {
+  if (batchingNeighbors_) {
+    pendingResolvedNeighbors_.erase(
+        std::remove(
+            pendingResolvedNeighbors_.begin(),
+            pendingResolvedNeighbors_.end(),
+            neighborEntry),
+        pendingResolvedNeighbors_.end());
+  }
   for (auto itr : handles_) {
     auto groupHandle = itr.second.lock();
     auto neighborIter = groupHandle->neighbor2Memberships.find(neighborEntry);
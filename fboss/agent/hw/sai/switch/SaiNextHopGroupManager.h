@@ -59,6 +59,18 @@ class SaiNextHopGroupMembership {
   void joinNextHopGroup(SaiManagerTable* managerTable);
   void leaveNextHopGroup();
 
+  /*
+   * Two phase flavor of joinNextHopGroup, used to join many memberships at
+   * once: prepareJoin acquires the next hop and returns what is needed to
+   * create the group member, completeJoin takes the member once it has been
+   * created (typically by a bulk create of all the members in a batch).
+   */
+  std::pair<
+      SaiNextHopGroupMemberTraits::AdapterHostKey,
+      SaiNextHopGroupMemberTraits::CreateAttributes>
+  prepareJoin(SaiManagerTable* managerTable);
+  void completeJoin(std::shared_ptr<SaiNextHopGroupMember> member);
+
   SaiNextHopGroupMembership(const SaiNextHopGroupMembership&) = delete;
   SaiNextHopGroupMembership(SaiNextHopGroupMembership&&) = delete;
   SaiNextHopGroupMembership& operator=(const SaiNextHopGroupMembership&) =
@@ -94,13 +106,33 @@ class SaiNextHopGroupManager {
   void handleUnresolvedNeighbor(
       const SaiNeighborTraits::NeighborEntry& neighborEntry);
 
+  /*
+   * Neighbor resolution batching. Between startNeighborBatch and
+   * flushNeighborBatch, resolved neighbors are only recorded. On flush, all
+   * of them are propagated to the next hop group memberships in a single pass
+   * over the next hop groups, and the resulting group members are created
+   * with one bulk create rather than one SAI call per member.
+   *
+   * Unresolved neighbors are always handled immediately, since their group
+   * members must be gone before the neighbor itself is removed.
+   */
+  void startNeighborBatch();
+  void flushNeighborBatch();
+
  private:
+  void handleResolvedNeighbors(
+      const std::vector<SaiNeighborTraits::NeighborEntry>& neighborEntries);
+  void joinNextHopGroups(
+      const std::vector<SaiNextHopGroupMembership*>& memberships);
+
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
   // TODO(borisb): improve SaiObject/SaiStore to the point where they
   // support the next hop group use case correctly, rather than this
   // abomination of multiple levels of RefMaps :(
   FlatRefMap<RouteNextHopEntry::NextHopSet, SaiNextHopGroupHandle> handles_;
+  bool batchingNeighbors_{false};
+  std::vector<SaiNeighborTraits::NeighborEntry> pendingResolvedNeighbors_;
 };
 
 } // namespace facebook::fboss
@@ -193,6 +193,7 @@ PortSaiId SaiPortManager::addPort(const std::shared_ptr<Port>& swPort) {
   handle->port = saiPort;
   handle->bridgePort =
       managerTable_->bridgeManager().addBridgePort(saiPort->adapterKey());
+  auto bridgePortSaiId = handle->bridgePort->adapterKey();
   loadPortQueues(handle.get());
   managerTable_->queueManager().ensurePortQueueConfig(
       saiPort->adapterKey(), handle->queues, swPort->getPortQueues());
@@ -202,6 +203,7 @@ PortSaiId SaiPortManager::addPort(const std::shared_ptr<Port>& swPort) {
         swPort->getID(), std::make_unique<HwPortFb303Stats>(swPort->getName()));
   }
   concurrentIndices_->portIds.emplace(saiPort->adapterKey(), swPort->getID());
+  concurrentIndices_->bridgePortIds.emplace(bridgePortSaiId, swPort->getID());
   return saiPort->adapterKey();
 }
 
@@ -211,6 +213,8 @@ void SaiPortManager::removePort(PortID swId) {
     throw FbossError("Attempted to remove non-existent port: ", swId);
   }
   concurrentIndices_->portIds.erase(itr->second->port->adapterKey());
+  concurrentIndices_->bridgePortIds.erase(
+      itr->second->bridgePort->adapterKey());
   handles_.erase(itr);
   portStats_.erase(swId);
 }
@@ -229,7 +233,18 @@ void SaiPortManager::changeQueue(
     SaiQueueConfig saiQueueConfig =
         std::make_pair(newPortQueue->getID(), newPortQueue->getStreamType());
     auto queueHandle = getQueueHandle(swId, saiQueueConfig);
-    managerTable_->queueManager().changeQueue(queueHandle, *newPortQueue);
+    auto oldPortQueueIter = std::find_if(
+        oldQueueConfig.begin(),
+        oldQueueConfig.end(),
+        [&](const std::shared_ptr<PortQueue> portQueue) {
+          return portQueue->getID() == newPortQueue->getID() &&
+              portQueue->getStreamType() == newPortQueue->getStreamType();
+        });
+    managerTable_->queueManager().changeQueue(
+        queueHandle,
+        *newPortQueue,
+        oldPortQueueIter == oldQueueConfig.end() ? nullptr
+                                                 : oldPortQueueIter->get());
     auto queueName = newPortQueue->getName()
         ? *newPortQueue->getName()
         : folly::to<std::string>("queue", newPortQueue->getID());
@@ -15,6 +15,8 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/lib/TupleUtils.h"
 
+#include <utility>
+
 namespace facebook::fboss {
 
 namespace {
@@ -89,10 +91,41 @@ SaiQueueManager::SaiQueueManager(
 
 void SaiQueueManager::changeQueue(
     SaiQueueHandle* queueHandle,
-    const PortQueue& newPortQueue) {
+    const PortQueue& newPortQueue,
+    const PortQueue* oldPortQueue) {
   CHECK(queueHandle);
-  queueHandle->scheduler =
-      managerTable_->schedulerManager().createScheduler(newPortQueue);
+  auto& schedulerManager = managerTable_->schedulerManager();
+  if (oldPortQueue && queueHandle->scheduler &&
+      !schedulerManager.schedulerChanged(*oldPortQueue, newPortQueue)) {
+    ++programmingStats_.queuesUnchanged;
+    return;
+  }
+  ++programmingStats_.queuesChanged;
+
+  // Queues scheduled the same way, on this or other ports, share one
+  // scheduler profile
+  auto scheduler = schedulerManager.getScheduler(newPortQueue);
+  if (scheduler) {
+    ++programmingStats_.schedulersShared;
+  } else {
+    scheduler = schedulerManager.createScheduler(newPortQueue);
+    ++programmingStats_.schedulersCreated;
+    ++programmingStats_.saiCalls;
+  }
+  if (scheduler == queueHandle->scheduler) {
+    return;
+  }
+  SaiQueueTraits::Attributes::SchedulerProfileId schedulerId{
+      scheduler->adapterKey()};
+  SaiApiTable::getInstance()->queueApi().setAttribute(
+      queueHandle->queue->adapterKey(), schedulerId);
+  ++programmingStats_.saiCalls;
+  if (queueHandle->scheduler && queueHandle->scheduler.use_count() == 1) {
+    // The previous profile goes away along with its last queue
+    ++programmingStats_.schedulersRemoved;
+    ++programmingStats_.saiCalls;
+  }
+  queueHandle->scheduler = std::move(scheduler);
 }
 
 void SaiQueueManager::resetQueue(SaiQueueHandle* queueHandle) {
@@ -107,6 +140,7 @@ void SaiQueueManager::resetQueue(SaiQueueHandle* queueHandle) {
       SAI_NULL_OBJECT_ID};
   SaiApiTable::getInstance()->queueApi().setAttribute(
       queueHandle->queue->adapterKey(), schedulerId);
+  queueHandle->scheduler.reset();
 }
 
 void SaiQueueManager::ensurePortQueueConfig(
@@ -184,4 +218,8 @@ QueueConfig SaiQueueManager::getQueueSettings(
   return queueConfig;
 }
 
+SaiQueueManager::ProgrammingStats SaiQueueManager::resetProgrammingStats() {
+  return std::exchange(programmingStats_, ProgrammingStats{});
+}
+
 } // namespace facebook::fboss
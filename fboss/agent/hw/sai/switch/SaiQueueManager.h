@@ -41,11 +41,32 @@ using SaiQueueHandles =
 
 class SaiQueueManager {
  public:
+  /*
+   * What programming queues cost, between two calls to
+   * resetProgrammingStats(), e.g. over one state delta
+   */
+  struct ProgrammingStats {
+    uint64_t queuesChanged{0};
+    uint64_t queuesUnchanged{0};
+    uint64_t schedulersCreated{0};
+    uint64_t schedulersShared{0};
+    uint64_t schedulersRemoved{0};
+    uint64_t saiCalls{0};
+  };
+
   SaiQueueManager(SaiManagerTable* managerTable, const SaiPlatform* platform);
   SaiQueueHandles loadQueues(
       PortSaiId portSaiId,
       const std::vector<QueueSaiId>& queueSaiIds);
-  void changeQueue(SaiQueueHandle* queueHandle, const PortQueue& newPortQueue);
+  /*
+   * Only reprograms the queue if its scheduler attributes differ from
+   * oldPortQueue, the queue's current settings. Without an oldPortQueue
+   * the queue is programmed unconditionally.
+   */
+  void changeQueue(
+      SaiQueueHandle* queueHandle,
+      const PortQueue& newPortQueue,
+      const PortQueue* oldPortQueue = nullptr);
   void resetQueue(SaiQueueHandle* queueHandle);
   void ensurePortQueueConfig(
       PortSaiId portSaiId,
@@ -55,9 +76,12 @@ class SaiQueueManager {
   void getStats(SaiQueueHandles& queueHandles, HwPortStats& hwPortStats);
   QueueConfig getQueueSettings(const SaiQueueHandles& queueHandles) const;
 
+  ProgrammingStats resetProgrammingStats();
+
  private:
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
+  ProgrammingStats programmingStats_;
 };
 
 } // namespace facebook::fboss
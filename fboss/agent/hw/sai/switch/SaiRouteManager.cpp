@@ -16,14 +16,91 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/agent/hw/sai/switch/SaiVirtualRouterManager.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/String.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <optional>
 
+DEFINE_string(
+    sai_critical_route_prefixes,
+    "",
+    "Comma separated prefixes whose routes (and more specific ones) are "
+    "programmed right after the default route");
+DEFINE_string(
+    sai_critical_route_clients,
+    "",
+    "Comma separated ClientIDs whose routes are programmed right after the "
+    "default route");
+
 namespace facebook::fboss {
 
+namespace {
+
+// Below this many additions a delta converges too fast to be worth reporting
+constexpr size_t kMinRoutesForProgressStats = 100;
+constexpr std::array<int, 4> kProgressPercentiles = {50, 90, 99, 100};
+
+/*
+ * Export how long it took for each of kProgressPercentiles of the added
+ * routes to be programmed.
+ */
+class RouteProgrammingProgress {
+ public:
+  explicit RouteProgrammingProgress(size_t total)
+      : total_(total), begin_(std::chrono::steady_clock::now()) {}
+
+  void routeProgrammed() {
+    ++programmed_;
+    if (total_ < kMinRoutesForProgressStats) {
+      return;
+    }
+    while (next_ < kProgressPercentiles.size() &&
+           programmed_ * 100 >= total_ * kProgressPercentiles[next_]) {
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - begin_);
+      fb303::fbData->addStatValue(
+          folly::to<std::string>(
+              "sai.route_programming.time_to_",
+              kProgressPercentiles[next_],
+              "pct.ms"),
+          elapsed.count(),
+          fb303::AVG);
+      XLOG(DBG2) << kProgressPercentiles[next_] << "% of " << total_
+                 << " routes programmed in " << elapsed.count() << "ms";
+      ++next_;
+    }
+  }
+
+ private:
+  size_t total_;
+  size_t programmed_{0};
+  size_t next_{0};
+  std::chrono::steady_clock::time_point begin_;
+};
+
+} // namespace
+
 SaiRouteManager::SaiRouteManager(
     SaiManagerTable* managerTable,
     const SaiPlatform* platform)
-    : managerTable_(managerTable), platform_(platform) {}
+    : managerTable_(managerTable), platform_(platform) {
+  std::vector<folly::StringPiece> prefixes;
+  folly::split(',', FLAGS_sai_critical_route_prefixes, prefixes, true);
+  for (auto prefix : prefixes) {
+    criticalPrefixes_.push_back(
+        folly::IPAddress::createNetwork(folly::trimWhitespace(prefix)));
+  }
+  std::vector<folly::StringPiece> clients;
+  folly::split(',', FLAGS_sai_critical_route_clients, clients, true);
+  for (auto client : clients) {
+    criticalClients_.insert(
+        static_cast<ClientID>(folly::to<int>(folly::trimWhitespace(client))));
+  }
+}
 
 template <typename AddrT>
 SaiRouteTraits::RouteEntry SaiRouteManager::routeEntryFromSwRoute(
@@ -225,7 +302,45 @@ void SaiRouteManager::removeRoute(
   }
 }
 
+template <typename AddrT>
+bool SaiRouteManager::isCriticalRoute(
+    const std::shared_ptr<Route<AddrT>>& swRoute) const {
+  if (!criticalClients_.empty() && !swRoute->hasNoEntry() &&
+      criticalClients_.count(swRoute->getBestEntry().first)) {
+    return true;
+  }
+  folly::IPAddress network{swRoute->prefix().network};
+  return std::any_of(
+      criticalPrefixes_.begin(),
+      criticalPrefixes_.end(),
+      [&network, &swRoute](const folly::CIDRNetwork& critical) {
+        return critical.second <= swRoute->prefix().mask &&
+            network.inSubnet(critical.first, critical.second);
+      });
+}
+
+template <typename AddrT>
+uint32_t SaiRouteManager::routePriority(
+    const std::shared_ptr<Route<AddrT>>& swRoute) const {
+  // Prefix lengths are at most 128, leaving room for the tier above them
+  constexpr uint32_t kTierShift = 8;
+  uint32_t mask = swRoute->prefix().mask;
+  if (mask == 0) {
+    return 0;
+  }
+  uint32_t tier = isCriticalRoute(swRoute) ? 1 : 2;
+  return (tier << kTierShift) | mask;
+}
+
 void SaiRouteManager::processRouteDelta(const StateDelta& delta) {
+  // Exactly one of v4Route and v6Route is set
+  struct PendingAdd {
+    uint32_t priority;
+    RouterID routerId;
+    std::shared_ptr<RouteV4> v4Route;
+    std::shared_ptr<RouteV6> v6Route;
+  };
+  std::vector<PendingAdd> pendingAdds;
   for (const auto& routeDelta : delta.getRouteTablesDelta()) {
     RouterID routerId;
     if (routeDelta.getOld()) {
@@ -237,23 +352,44 @@ void SaiRouteManager::processRouteDelta(const StateDelta& delta) {
                               const auto& oldRoute, const auto& newRoute) {
       changeRoute(routerId, oldRoute, newRoute);
     };
-    auto processAdded = [this, routerId](const auto& newRoute) {
-      addRoute(routerId, newRoute);
-    };
     auto processRemoved = [this, routerId](const auto& oldRoute) {
       removeRoute(routerId, oldRoute);
     };
     DeltaFunctions::forEachChanged(
         routeDelta.getRoutesV4Delta(),
         processChanged,
-        processAdded,
+        [this, routerId, &pendingAdds](const auto& newRoute) {
+          pendingAdds.push_back(
+              {routePriority(newRoute), routerId, newRoute, nullptr});
+        },
         processRemoved);
     DeltaFunctions::forEachChanged(
         routeDelta.getRoutesV6Delta(),
         processChanged,
-        processAdded,
+        [this, routerId, &pendingAdds](const auto& newRoute) {
+          pendingAdds.push_back(
+              {routePriority(newRoute), routerId, nullptr, newRoute});
+        },
         processRemoved);
   }
+
+  // Every route is committed to hardware as it is added, so programming in
+  // priority order is enough for important prefixes to converge first.
+  std::stable_sort(
+      pendingAdds.begin(),
+      pendingAdds.end(),
+      [](const PendingAdd& lhs, const PendingAdd& rhs) {
+        return lhs.priority < rhs.priority;
+      });
+  RouteProgrammingProgress progress(pendingAdds.size());
+  for (const auto& pendingAdd : pendingAdds) {
+    if (pendingAdd.v4Route) {
+      addRoute(pendingAdd.routerId, pendingAdd.v4Route);
+    } else {
+      addRoute(pendingAdd.routerId, pendingAdd.v6Route);
+    }
+    progress.routeProgrammed();
+  }
 }
 
 SaiRouteHandle* SaiRouteManager::getRouteHandle(
@@ -291,6 +427,11 @@ SaiRouteManager::routeEntryFromSwRoute<folly::IPAddressV4>(
     RouterID routerId,
     const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry) const;
 
+template uint32_t SaiRouteManager::routePriority<folly::IPAddressV6>(
+    const std::shared_ptr<Route<folly::IPAddressV6>>& swEntry) const;
+template uint32_t SaiRouteManager::routePriority<folly::IPAddressV4>(
+    const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry) const;
+
 template void SaiRouteManager::changeRoute<folly::IPAddressV6>(
     RouterID routerId,
     const std::shared_ptr<Route<folly::IPAddressV6>>& oldSwEntry,
@@ -19,6 +19,8 @@
 #include "folly/container/F14Map.h"
 
 #include <memory>
+#include <set>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -62,8 +64,21 @@ class SaiRouteManager {
       RouterID routerId,
       const std::shared_ptr<Route<AddrT>>& swRoute);
 
+  /*
+   * Changes and removals are programmed first, then additions in priority
+   * order (see routePriority), so that the routes carrying most traffic
+   * converge first on a cold boot or a full sync.
+   */
   void processRouteDelta(const StateDelta& delta);
 
+  /*
+   * Lower values are programmed first: the default route, then critical
+   * routes (--sai_critical_route_prefixes, --sai_critical_route_clients),
+   * then everything else. Within a tier, less specific routes come first.
+   */
+  template <typename AddrT>
+  uint32_t routePriority(const std::shared_ptr<Route<AddrT>>& swRoute) const;
+
   SaiRouteHandle* getRouteHandle(const SaiRouteTraits::RouteEntry& entry);
   const SaiRouteHandle* getRouteHandle(
       const SaiRouteTraits::RouteEntry& entry) const;
@@ -82,8 +97,13 @@ class SaiRouteManager {
   template <typename AddrT>
   bool validRoute(const std::shared_ptr<Route<AddrT>>& swRoute);
 
+  template <typename AddrT>
+  bool isCriticalRoute(const std::shared_ptr<Route<AddrT>>& swRoute) const;
+
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
+  std::vector<folly::CIDRNetwork> criticalPrefixes_;
+  std::set<ClientID> criticalClients_;
   folly::F14FastMap<SaiRouteTraits::RouteEntry, std::unique_ptr<SaiRouteHandle>>
       handles_;
 };
@@ -72,6 +72,21 @@ std::shared_ptr<SaiScheduler> SaiSchedulerManager::createScheduler(
   return store.setObject(k, attributes);
 }
 
+std::shared_ptr<SaiScheduler> SaiSchedulerManager::getScheduler(
+    const PortQueue& portQueue) const {
+  SaiSchedulerTraits::AdapterHostKey k = tupleProjection<
+      SaiSchedulerTraits::CreateAttributes,
+      SaiSchedulerTraits::AdapterHostKey>(makeSchedulerAttributes(portQueue));
+  return SaiStore::getInstance()->get<SaiSchedulerTraits>().get(k);
+}
+
+bool SaiSchedulerManager::schedulerChanged(
+    const PortQueue& oldPortQueue,
+    const PortQueue& newPortQueue) const {
+  return makeSchedulerAttributes(oldPortQueue) !=
+      makeSchedulerAttributes(newPortQueue);
+}
+
 void SaiSchedulerManager::fillSchedulerSettings(
     const SaiScheduler* scheduler,
     PortQueue* portQueue) const {
@@ -33,6 +33,18 @@ class SaiSchedulerManager {
       SaiManagerTable* managerTable,
       const SaiPlatform* platform);
   std::shared_ptr<SaiScheduler> createScheduler(const PortQueue& portQueue);
+  /*
+   * The scheduler profile already programmed for queues scheduled like
+   * portQueue, if any
+   */
+  std::shared_ptr<SaiScheduler> getScheduler(const PortQueue& portQueue) const;
+  /*
+   * Whether going from oldPortQueue to newPortQueue changes any scheduler
+   * attribute, i.e. whether the queue needs a different scheduler profile
+   */
+  bool schedulerChanged(
+      const PortQueue& oldPortQueue,
+      const PortQueue& newPortQueue) const;
   void fillSchedulerSettings(
       const SaiScheduler* scheduler,
       PortQueue* portQueue) const;
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/switch/SaiStateChangeStages.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/sai/switch/SaiHostifManager.h"
+#include "fboss/agent/hw/sai/switch/SaiInSegEntryManager.h"
+#include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
+#include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
+#include "fboss/agent/hw/sai/switch/SaiPortManager.h"
+#include "fboss/agent/hw/sai/switch/SaiRouteManager.h"
+#include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
+#include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
+#include "fboss/agent/hw/sai/switch/SaiVlanManager.h"
+#include "fboss/agent/state/StateDelta.h"
+
+#include <algorithm>
+#include <utility>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace facebook::fboss {
+
+void SaiStateChangeStages::addStage(
+    std::string name,
+    const std::vector<std::string>& dependencies,
+    std::function<void()> fn) {
+  auto findStage = [this](const std::string& stageName) {
+    return std::find_if(
+        stages_.begin(), stages_.end(), [&stageName](const Stage& stage) {
+          return stage.name == stageName;
+        });
+  };
+  if (findStage(name) != stages_.end()) {
+    throw FbossError("Duplicate state change stage ", name);
+  }
+  auto index = stages_.size();
+  for (const auto& dependency : dependencies) {
+    auto it = findStage(dependency);
+    if (it == stages_.end()) {
+      throw FbossError(
+          "State change stage ", name, " depends on unknown stage ", dependency);
+    }
+    it->dependents.push_back(index);
+  }
+  stages_.push_back(Stage{std::move(name), std::move(fn), dependencies.size()});
+}
+
+void SaiStateChangeStages::run() {
+  timings_.clear();
+  auto begin = steady_clock::now();
+  if (executor_ && stages_.size() > 1) {
+    runConcurrently();
+  } else {
+    runInOrder();
+  }
+  totalDuration_ = duration_cast<microseconds>(steady_clock::now() - begin);
+  if (error_) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+void SaiStateChangeStages::runInOrder() {
+  for (const auto& stage : stages_) {
+    auto begin = steady_clock::now();
+    stage.fn();
+    timings_.push_back(
+        {stage.name,
+         duration_cast<microseconds>(steady_clock::now() - begin)});
+  }
+}
+
+void SaiStateChangeStages::runConcurrently() {
+  remaining_ = stages_.size();
+  pendingDependencies_.clear();
+  for (const auto& stage : stages_) {
+    pendingDependencies_.push_back(stage.numDependencies);
+  }
+  skip_.assign(stages_.size(), false);
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    if (stages_[i].numDependencies == 0) {
+      schedule(i);
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  allDone_.wait(lock, [this] { return remaining_ == 0; });
+}
+
+void SaiStateChangeStages::schedule(size_t index) {
+  executor_->add([this, index] { execute(index); });
+}
+
+void SaiStateChangeStages::execute(size_t index) {
+  const auto& stage = stages_[index];
+  bool skip;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    skip = skip_[index];
+  }
+  std::exception_ptr error;
+  auto begin = steady_clock::now();
+  if (!skip) {
+    try {
+      stage.fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  auto duration = duration_cast<microseconds>(steady_clock::now() - begin);
+
+  std::vector<size_t> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!skip) {
+      timings_.push_back({stage.name, duration});
+    }
+    if (error && !error_) {
+      error_ = error;
+    }
+    for (auto dependent : stage.dependents) {
+      if (skip || error) {
+        skip_[dependent] = true;
+      }
+      if (--pendingDependencies_[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+    if (--remaining_ == 0) {
+      // run() may return, and destroy us, as soon as the lock is released
+      allDone_.notify_all();
+      return;
+    }
+  }
+  for (auto next : ready) {
+    schedule(next);
+  }
+}
+
+void addManagerStages(
+    SaiStateChangeStages& stages,
+    SaiManagerTable* managerTable,
+    const StateDelta& delta) {
+  stages.addStage("port", {}, [managerTable, &delta] {
+    managerTable->portManager().processPortDelta(delta);
+  });
+  stages.addStage("vlan", {"port"}, [managerTable, &delta] {
+    managerTable->vlanManager().processVlanDelta(delta.getVlansDelta());
+  });
+  stages.addStage("routerInterface", {"vlan"}, [managerTable, &delta] {
+    managerTable->routerInterfaceManager().processInterfaceDelta(delta);
+  });
+  stages.addStage("neighbor", {"routerInterface"}, [managerTable, &delta] {
+    managerTable->neighborManager().processNeighborDelta(delta);
+  });
+  stages.addStage("route", {"neighbor"}, [managerTable, &delta] {
+    managerTable->routeManager().processRouteDelta(delta);
+  });
+  stages.addStage("hostif", {"port"}, [managerTable, &delta] {
+    managerTable->hostifManager().processHostifDelta(delta);
+  });
+  stages.addStage("inSeg", {"route"}, [managerTable, &delta] {
+    managerTable->inSegEntryManager().processInSegEntryDelta(
+        delta.getLabelForwardingInformationBaseDelta());
+  });
+  stages.addStage(
+      "loadBalancer", {"hostif", "inSeg"}, [managerTable, &delta] {
+        managerTable->switchManager().processLoadBalancerDelta(delta);
+      });
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+class SaiManagerTable;
+class StateDelta;
+
+/*
+ * The steps of programming a StateDelta (typically one per manager) and the
+ * steps each of them depends on.
+ *
+ * Without an executor, stages run on the calling thread in the order they
+ * were added. With one, every stage is scheduled on the executor as soon as
+ * all of its dependencies are done, so that independent stages run
+ * concurrently. If a stage throws, the stages depending on it are skipped,
+ * stages already running finish, and run() rethrows the first exception.
+ */
+class SaiStateChangeStages {
+ public:
+  struct StageTiming {
+    std::string name;
+    std::chrono::microseconds duration;
+  };
+
+  explicit SaiStateChangeStages(folly::Executor* executor = nullptr)
+      : executor_(executor) {}
+
+  /*
+   * Dependencies must have been added before, which keeps the stages acyclic
+   * and makes insertion order a valid sequential order.
+   */
+  void addStage(
+      std::string name,
+      const std::vector<std::string>& dependencies,
+      std::function<void()> fn);
+
+  void run();
+
+  // Timings of the stages which ran, in the order they completed
+  const std::vector<StageTiming>& getTimings() const {
+    return timings_;
+  }
+  std::chrono::microseconds getTotalDuration() const {
+    return totalDuration_;
+  }
+
+ private:
+  struct Stage {
+    std::string name;
+    std::function<void()> fn;
+    size_t numDependencies{0};
+    std::vector<size_t> dependents;
+  };
+
+  void runInOrder();
+  void runConcurrently();
+  void schedule(size_t index);
+  void execute(size_t index);
+
+  folly::Executor* executor_;
+  std::vector<Stage> stages_;
+  std::vector<StageTiming> timings_;
+  std::chrono::microseconds totalDuration_{0};
+
+  // State of a concurrent run, protected by mutex_
+  std::mutex mutex_;
+  std::condition_variable allDone_;
+  size_t remaining_{0};
+  std::vector<size_t> pendingDependencies_;
+  std::vector<bool> skip_;
+  std::exception_ptr error_;
+};
+
+/*
+ * Add the stages processing delta through the managers of managerTable:
+ *
+ *   port -> vlan -> router interface -> neighbor -> route -> in-seg
+ *   port -> hostif
+ *   hostif, in-seg -> load balancer
+ *
+ * Stages only run concurrently when they don't share managers or stores:
+ * in-seg entries share next hop groups with routes, and hostif shares the
+ * queue manager with ports. The load balancer stage sets attributes of the
+ * switch object every other stage creates objects on, so it runs last. That
+ * leaves hostif overlapping the router interface to in-seg stages.
+ */
+void addManagerStages(
+    SaiStateChangeStages& stages,
+    SaiManagerTable* managerTable,
+    const StateDelta& delta);
+
+} // namespace facebook::fboss
@@ -11,6 +11,7 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
 #include "fboss/agent/Constants.h"
+#include "fboss/agent/L2Entry.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/hw/sai/api/AdapterKeySerializers.h"
 #include "fboss/agent/hw/sai/api/FdbApi.h"
@@ -27,9 +28,11 @@
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
+#include "fboss/agent/hw/sai/switch/SaiQueueManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouteManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRxPacket.h"
+#include "fboss/agent/hw/sai/switch/SaiStateChangeStages.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/agent/hw/sai/switch/SaiTxPacket.h"
 #include "fboss/agent/hw/sai/switch/SaiVlanManager.h"
@@ -39,10 +42,13 @@
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/SwitchState.h"
 
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
 #include <folly/logging/xlog.h>
 
 #include <optional>
@@ -52,6 +58,24 @@ extern "C" {
 }
 
 DEFINE_bool(enable_sai_debug_log, false, "Turn on SAI debugging logging");
+DEFINE_bool(
+    sai_parallel_state_changes,
+    false,
+    "Program independent object types of a state delta concurrently");
+DEFINE_int32(
+    sai_state_change_threads,
+    4,
+    "Number of threads programming a state delta, "
+    "if --sai_parallel_state_changes is set");
+DEFINE_int32(
+    sai_fdb_event_queue_size,
+    16384,
+    "Number of fdb events buffered between the SAI callback thread and "
+    "the thread handling them. Events which do not fit are dropped");
+DEFINE_int32(
+    sai_fdb_event_batch_size,
+    512,
+    "Maximum number of fdb events handled at a time");
 
 namespace facebook::fboss {
 
@@ -93,6 +117,10 @@ SaiSwitch::SaiSwitch(SaiPlatform* platform, uint32_t featuresDesired)
     : HwSwitch(featuresDesired), platform_(platform) {
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+  if (FLAGS_sai_parallel_state_changes) {
+    stateChangeExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_sai_state_change_threads);
+  }
 }
 
 SaiSwitch::~SaiSwitch() {
@@ -122,6 +150,10 @@ void SaiSwitch::unregisterCallbacks() noexcept {
     rxBottomHalfThread_->join();
     // rx is completely shut-off
   }
+  // Same for the fdb events still queued
+  if (fdbEventQueue_) {
+    fdbEventQueue_->stop();
+  }
 }
 
 std::shared_ptr<SwitchState> SaiSwitch::stateChanged(const StateDelta& delta) {
@@ -173,11 +205,13 @@ void SaiSwitch::updateStats(SwitchStats* switchStats) {
 }
 
 void SaiSwitch::fetchL2Table(std::vector<L2EntryThrift>* l2Table) const {
-  std::lock_guard<std::mutex> lock(saiSwitchMutex_);
-  fetchL2TableLocked(lock, l2Table);
+  // Served from the fdb shadow in ConcurrentIndices rather than the adapter,
+  // without the switch lock, so that reading a large l2 table does not hold
+  // up packet tx, stats or state programming.
+  concurrentIndices_->fetchL2Table(l2Table);
 }
 
-void SaiSwitch::gracefulExit(folly::dynamic& switchState) {
+void SaiSwitch::gracefulExit(const std::shared_ptr<SwitchState>& switchState) {
   if (!platform_->getAsic()->isSupported(HwAsic::Feature::WARM_BOOT)) {
     XLOG(ERR) << " Asic does not support warm boot, skipping graceful exit";
     return;
@@ -199,16 +233,23 @@ void SaiSwitch::gracefulExit(folly::dynamic& switchState) {
   */
   stopNonCallbackThreads();
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
-  gracefulExitLocked(switchState, lock);
+  gracefulExitLocked(*switchState, lock);
 }
 
 void SaiSwitch::gracefulExitLocked(
-    folly::dynamic& switchState,
+    const SwitchState& switchState,
     const std::lock_guard<std::mutex>& lock) {
   SaiSwitchTraits::Attributes::SwitchRestartWarm restartWarm{true};
   SaiApiTable::getInstance()->switchApi().setAttribute(switchId_, restartWarm);
-  switchState[kHwSwitch] = toFollyDynamicLocked(lock);
-  platform_->getWarmBootHelper()->storeWarmBootState(switchState);
+  platform_->getWarmBootHelper()->storeWarmBootState(
+      [this, &switchState, &lock](JsonStreamWriter& writer) {
+        writer.beginObject();
+        writer.key(kSwSwitch);
+        switchState.writeJson(writer);
+        writer.key(kHwSwitch);
+        writeJsonLocked(lock, writer);
+        writer.endObject();
+      });
   platform_->getWarmBootHelper()->setCanWarmBoot();
   managerTable_->switchManager().gracefulExit();
 }
@@ -218,6 +259,11 @@ folly::dynamic SaiSwitch::toFollyDynamic() const {
   return toFollyDynamicLocked(lock);
 }
 
+void SaiSwitch::writeJson(JsonStreamWriter& writer) const {
+  std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+  writeJsonLocked(lock, writer);
+}
+
 void SaiSwitch::switchRunStateChanged(SwitchRunState newState) {
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
   switchRunStateChangedLocked(lock, newState);
@@ -370,7 +416,14 @@ HwInitResult SaiSwitch::initLocked(
     saiStore->reload(adapterKeysJson.get());
   }
   managerTable_->createSaiTableManagers(platform_, concurrentIndices_.get());
+  managerTable_->fdbManager().loadFdbEntries();
   callback_ = callback;
+  fdbEventQueue_ = std::make_unique<SaiFdbEventQueue>(
+      FLAGS_sai_fdb_event_queue_size,
+      FLAGS_sai_fdb_event_batch_size,
+      [this](std::vector<SaiFdbEvent> events) {
+        fdbEventCallbackBottomHalf(std::move(events));
+      });
   __gSaiSwitch = this;
   if (FLAGS_enable_sai_debug_log) {
     SaiApiTable::getInstance()->enableDebugLogging();
@@ -457,17 +510,35 @@ void SaiSwitch::unregisterCallbacksLocked(
 std::shared_ptr<SwitchState> SaiSwitch::stateChangedLocked(
     const std::lock_guard<std::mutex>& lock,
     const StateDelta& delta) {
-  managerTableLocked(lock)->portManager().processPortDelta(delta);
-  managerTableLocked(lock)->vlanManager().processVlanDelta(
-      delta.getVlansDelta());
-  managerTableLocked(lock)->routerInterfaceManager().processInterfaceDelta(
-      delta);
-  managerTableLocked(lock)->neighborManager().processNeighborDelta(delta);
-  managerTableLocked(lock)->routeManager().processRouteDelta(delta);
-  managerTableLocked(lock)->hostifManager().processHostifDelta(delta);
-  managerTableLocked(lock)->inSegEntryManager().processInSegEntryDelta(
-      delta.getLabelForwardingInformationBaseDelta());
-  managerTableLocked(lock)->switchManager().processLoadBalancerDelta(delta);
+  SaiStateChangeStages stages(stateChangeExecutor_.get());
+  addManagerStages(stages, managerTableLocked(lock), delta);
+  stages.run();
+  for (const auto& timing : stages.getTimings()) {
+    fb303::fbData->addStatValue(
+        folly::to<std::string>("sai.state_changed.", timing.name, ".us"),
+        timing.duration.count(),
+        fb303::AVG);
+  }
+  fb303::fbData->addStatValue(
+      "sai.state_changed.us", stages.getTotalDuration().count(), fb303::AVG);
+  auto queueStats =
+      managerTableLocked(lock)->queueManager().resetProgrammingStats();
+  if (queueStats.queuesChanged || queueStats.queuesUnchanged) {
+    XLOG(DBG2) << "Queue programming: " << queueStats.queuesChanged
+               << " queues changed, " << queueStats.queuesUnchanged
+               << " unchanged, " << queueStats.schedulersCreated
+               << " schedulers created, " << queueStats.schedulersShared
+               << " shared, " << queueStats.schedulersRemoved << " removed, "
+               << queueStats.saiCalls << " SAI calls";
+  }
+  fb303::fbData->addStatValue(
+      "sai.state_changed.queue.changed", queueStats.queuesChanged, fb303::SUM);
+  fb303::fbData->addStatValue(
+      "sai.state_changed.queue.unchanged",
+      queueStats.queuesUnchanged,
+      fb303::SUM);
+  fb303::fbData->addStatValue(
+      "sai.state_changed.queue.sai_calls", queueStats.saiCalls, fb303::SUM);
   return delta.newState();
 }
 
@@ -606,43 +677,18 @@ void SaiSwitch::updateStatsLocked(
     SwitchStats* /* switchStats */) {
   managerTable_->portManager().updateStats();
   managerTable_->hostifManager().updateStats();
-}
-
-void SaiSwitch::fetchL2TableLocked(
-    const std::lock_guard<std::mutex>& /* lock */,
-    std::vector<L2EntryThrift>* l2Table) const {
-  auto fdbEntries = getObjectKeys<SaiFdbTraits>(switchId_);
-  l2Table->resize(fdbEntries.size());
-  for (const auto& fdbEntry : fdbEntries) {
-    L2EntryThrift entry;
-    // SwitchState's VlanID is an attribute we store in the vlan, so
-    // we can get it via SaiApi
-    auto& vlanApi = SaiApiTable::getInstance()->vlanApi();
-    VlanID swVlanId{vlanApi.getAttribute(
-        VlanSaiId{fdbEntry.bridgeVlanId()},
-        SaiVlanTraits::Attributes::VlanId{})};
-    entry.vlanID = swVlanId;
-
-    // To get the PortID, we get the bridgePortId from the fdb entry,
-    // then get that Bridge Port's PortId attribute. We can lookup the
-    // PortID for a sai port id in ConcurrentIndices
-    auto& fdbApi = SaiApiTable::getInstance()->fdbApi();
-    auto bridgePortSaiId =
-        fdbApi.getAttribute(fdbEntry, SaiFdbTraits::Attributes::BridgePortId());
-    auto& bridgeApi = SaiApiTable::getInstance()->bridgeApi();
-    auto portSaiId = bridgeApi.getAttribute(
-        BridgePortSaiId{bridgePortSaiId},
-        SaiBridgePortTraits::Attributes::PortId{});
-    const auto portItr = concurrentIndices_->portIds.find(PortSaiId{portSaiId});
-    if (portItr == concurrentIndices_->portIds.cend()) {
-      XLOG(WARNING) << "l2 table entry had unknown port sai id: " << portSaiId;
-      continue;
-    }
-    entry.port = portItr->second;
-
-    // entry is filled out; push it onto the L2 table
-    l2Table->push_back(entry);
+  if (fdbEventQueue_) {
+    fb303::fbData->setCounter(
+        "sai.fdb_events.enqueued", fdbEventQueue_->getEnqueued());
+    fb303::fbData->setCounter(
+        "sai.fdb_events.dropped", fdbEventQueue_->getDropped());
+    fb303::fbData->setCounter(
+        "sai.fdb_events.coalesced", fdbEventQueue_->getCoalesced());
+    fb303::fbData->setCounter(
+        "sai.fdb_events.delivered", fdbEventQueue_->getDelivered());
   }
+  fb303::fbData->setCounter(
+      "sai.fdb_entries", concurrentIndices_->fdbEntries.size());
 }
 
 void SaiSwitch::stopNonCallbackThreads() {
@@ -650,6 +696,9 @@ void SaiSwitch::stopNonCallbackThreads() {
   if (asyncTxThread_) {
     asyncTxThread_->join();
   }
+  if (fdbEventQueue_) {
+    fdbEventQueue_->stop();
+  }
 }
 
 folly::dynamic SaiSwitch::toFollyDynamicLocked(
@@ -666,11 +715,27 @@ folly::dynamic SaiSwitch::toFollyDynamicLocked(
   return hwSwitch;
 }
 
+void SaiSwitch::writeJsonLocked(
+    const std::lock_guard<std::mutex>& /* lock */,
+    JsonStreamWriter& writer) const {
+  // Same document as toFollyDynamicLocked, one adapter key at a time
+  writer.beginObject();
+  writer.key(kAdapterKeys);
+  writer.beginObject();
+  SaiStore::getInstance()->writeAdapterKeysJson(writer);
+  writer.key(saiObjectTypeToString(SaiSwitchTraits::ObjectType));
+  writer.value(folly::dynamic::array(
+      facebook::fboss::toFollyDynamic<SaiSwitchTraits>(switchId_)));
+  writer.endObject();
+  writer.endObject();
+}
+
 void SaiSwitch::switchRunStateChangedLocked(
     const std::lock_guard<std::mutex>& lock,
     SwitchRunState newState) {
   switch (newState) {
     case SwitchRunState::INITIALIZED: {
+      fdbEventQueue_->start();
       auto& switchApi = SaiApiTable::getInstance()->switchApi();
       switchApi.registerFdbEventCallback(switchId_, __gFdbEventCallback);
     } break;
@@ -738,13 +803,80 @@ SaiManagerTable* SaiSwitch::managerTableLocked(
 void SaiSwitch::fdbEventCallback(
     uint32_t count,
     const sai_fdb_event_notification_data_t* data) {
-  fdbEventCallbackLocked(count, data);
+  fdbEventQueue_->enqueue(count, data);
 }
 
-void SaiSwitch::fdbEventCallbackLocked(
-    uint32_t /*count*/,
-    const sai_fdb_event_notification_data_t* /*data*/) {
-  // TODO  - program macs from learn events to FDB
+void SaiSwitch::fdbEventCallbackBottomHalf(std::vector<SaiFdbEvent> events) {
+  for (const auto& event : events) {
+    if (!event.isBulkFlush()) {
+      handleFdbEvent(event);
+      continue;
+    }
+    // Bulk flushes name no entry: report each learned entry they removed
+    // from the fdb shadow as flushed on its own
+    auto flushed = concurrentIndices_->flushFdbEntries(
+        event.bridgePortId, event.bridgeVlanId, event.mac);
+    for (const auto& [fdbEntry, bridgePortId] : flushed) {
+      handleFdbEvent(SaiFdbEvent{SAI_FDB_EVENT_FLUSHED,
+                                 fdbEntry.mac(),
+                                 VlanSaiId{fdbEntry.bridgeVlanId()},
+                                 bridgePortId});
+    }
+  }
+}
+
+void SaiSwitch::handleFdbEvent(const SaiFdbEvent& event) {
+  L2EntryUpdateType updateType;
+  switch (event.type) {
+    case SAI_FDB_EVENT_LEARNED:
+    case SAI_FDB_EVENT_MOVE:
+      updateType = L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD;
+      break;
+    case SAI_FDB_EVENT_AGED:
+    case SAI_FDB_EVENT_FLUSHED:
+      updateType = L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE;
+      break;
+    default:
+      XLOG(WARNING) << "unknown fdb event type: " << event.type;
+      return;
+  }
+
+  // Keep the fdb shadow in sync, whether or not the entry maps to the
+  // SwitchState. Events for a static entry are dropped, SaiFdbManager owns
+  // it and the SwitchState already has it.
+  SaiFdbTraits::FdbEntry fdbEntry{switchId_, event.bridgeVlanId, event.mac};
+  bool updated = updateType == L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD
+      ? concurrentIndices_->learnFdbEntry(fdbEntry, event.bridgePortId)
+      : concurrentIndices_->unlearnFdbEntry(fdbEntry);
+  if (!updated) {
+    XLOG(DBG2) << "ignoring fdb event " << event.type << " for static entry "
+               << event.mac << " on vlan sai id: " << event.bridgeVlanId;
+    return;
+  }
+
+  // Look up SwitchState VlanID and PortID by sai ids in ConcurrentIndices
+  const auto vlanItr =
+      concurrentIndices_->bridgeVlanIds.find(event.bridgeVlanId);
+  if (vlanItr == concurrentIndices_->bridgeVlanIds.cend()) {
+    XLOG(WARNING) << "fdb event for " << event.mac
+                  << " had unknown vlan sai id: " << event.bridgeVlanId;
+    return;
+  }
+  const auto portItr =
+      concurrentIndices_->bridgePortIds.find(event.bridgePortId);
+  if (portItr == concurrentIndices_->bridgePortIds.cend()) {
+    XLOG(WARNING) << "fdb event for " << event.mac
+                  << " had unknown bridge port sai id: " << event.bridgePortId;
+    return;
+  }
+
+  callback_->l2LearningUpdateReceived(
+      L2Entry(
+          event.mac,
+          vlanItr->second,
+          PortDescriptor(portItr->second),
+          L2Entry::L2EntryType::L2_ENTRY_TYPE_VALIDATED),
+      updateType);
 }
 
 } // namespace facebook::fboss
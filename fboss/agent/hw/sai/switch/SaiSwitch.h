@@ -11,10 +11,12 @@
 
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/switch/SaiFdbEventQueue.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiRxPacket.h"
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/io/async/EventBase.h>
 
 #include <memory>
@@ -63,10 +65,12 @@ class SaiSwitch : public HwSwitch {
 
   void fetchL2Table(std::vector<L2EntryThrift>* l2Table) const override;
 
-  void gracefulExit(folly::dynamic& switchState) override;
+  void gracefulExit(const std::shared_ptr<SwitchState>& switchState) override;
 
   folly::dynamic toFollyDynamic() const override;
 
+  void writeJson(JsonStreamWriter& writer) const override;
+
   void switchRunStateChanged(SwitchRunState newState) override;
 
   void exitFatal() const override;
@@ -83,6 +87,13 @@ class SaiSwitch : public HwSwitch {
   void linkStateChangedCallback(
       uint32_t count,
       const sai_port_oper_status_notification_t* data);
+  /*
+   * This method is not thread safe, it should only be used
+   * from the SAI adapter's fdb event callback caller thread.
+   *
+   * It only queues the events, which fdbEventCallbackBottomHalf
+   * handles on a thread of its own
+   */
   void fdbEventCallback(
       uint32_t count,
       const sai_fdb_event_notification_data_t* data);
@@ -175,10 +186,6 @@ class SaiSwitch : public HwSwitch {
       const std::lock_guard<std::mutex>& lock,
       SwitchStats* switchStats);
 
-  void fetchL2TableLocked(
-      const std::lock_guard<std::mutex>& lock,
-      std::vector<L2EntryThrift>* l2Table) const;
-
   void gracefulExitLocked(
       const std::lock_guard<std::mutex>& lock,
       folly::dynamic& switchState);
@@ -186,6 +193,10 @@ class SaiSwitch : public HwSwitch {
   folly::dynamic toFollyDynamicLocked(
       const std::lock_guard<std::mutex>& lock) const;
 
+  void writeJsonLocked(
+      const std::lock_guard<std::mutex>& lock,
+      JsonStreamWriter& writer) const;
+
   void switchRunStateChangedLocked(
       const std::lock_guard<std::mutex>& lock,
       SwitchRunState newState);
@@ -208,10 +219,6 @@ class SaiSwitch : public HwSwitch {
       const std::lock_guard<std::mutex>& lock,
       PortID port) const;
 
-  void fdbEventCallbackLocked(
-      uint32_t count,
-      const sai_fdb_event_notification_data_t* data);
-
   BootType getBootTypeLocked(const std::lock_guard<std::mutex>& lock) const;
 
   const SaiManagerTable* managerTableLocked(
@@ -219,7 +226,7 @@ class SaiSwitch : public HwSwitch {
   SaiManagerTable* managerTableLocked(const std::lock_guard<std::mutex>& lock);
 
   void gracefulExitLocked(
-      folly::dynamic& switchState,
+      const SwitchState& switchState,
       const std::lock_guard<std::mutex>& lock);
   void initRx(const std::lock_guard<std::mutex>& lock);
   void initAsyncTx(const std::lock_guard<std::mutex>& lock);
@@ -228,6 +235,12 @@ class SaiSwitch : public HwSwitch {
       SwitchSaiId switch_id,
       std::unique_ptr<folly::IOBuf> ioBuf,
       std::vector<sai_attribute_t> attrList);
+  /*
+   * Runs on the fdbEventQueue_ thread, with the coalesced events of a batch
+   */
+  void fdbEventCallbackBottomHalf(std::vector<SaiFdbEvent> events);
+  // Apply one event naming an fdb entry to the shadow and report it
+  void handleFdbEvent(const SaiFdbEvent& event);
   /*
    * SaiSwitch must support a few varieties of concurrent access:
    * 1. state updates on the SwSwitch update thread calling stateChanged
@@ -273,6 +286,12 @@ class SaiSwitch : public HwSwitch {
 
   std::unique_ptr<std::thread> asyncTxThread_;
   folly::EventBase asyncTxEventBase_;
+
+  // Hands fdb events over from the SAI callback thread
+  std::unique_ptr<SaiFdbEventQueue> fdbEventQueue_;
+
+  // Runs independent manager stages of stateChanged concurrently, if enabled
+  std::unique_ptr<folly::CPUThreadPoolExecutor> stateChangeExecutor_;
 };
 
 } // namespace facebook::fboss
@@ -54,6 +54,7 @@ VlanSaiId SaiVlanManager::addVlan(const std::shared_ptr<Vlan>& swVlan) {
   // createVlanMember relies on the handle being in handles_,
   // so we must do this before we create the members
   handles_.emplace(swVlanId, std::move(vlanHandle));
+  concurrentIndices_->bridgeVlanIds.emplace(saiVlan->adapterKey(), swVlanId);
 
   // Create VLAN members
   for (const auto& memberPort : swVlan->getPorts()) {
@@ -103,6 +104,7 @@ void SaiVlanManager::removeVlan(const VlanID& swVlanId) {
     throw FbossError(
         "attempted to remove a vlan which does not exist: ", swVlanId);
   }
+  concurrentIndices_->bridgeVlanIds.erase(citr->second->vlan->adapterKey());
   handles_.erase(citr);
 }
 
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/switch/SaiFdbEventQueue.h"
+#include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
+#include "fboss/agent/hw/sai/switch/SaiPortManager.h"
+#include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
+#include "fboss/agent/hw/sai/switch/SaiVlanManager.h"
+#include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
+#include "fboss/agent/types.h"
+
+#include <folly/Synchronized.h>
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+SaiFdbEventQueue* fdbEventQueue;
+
+void fdbEventCallback(
+    uint32_t count,
+    const sai_fdb_event_notification_data_t* data) {
+  fdbEventQueue->enqueue(count, data);
+}
+
+folly::MacAddress nthMac(uint64_t n) {
+  return folly::MacAddress::fromHBO(0x020000000000 + n);
+}
+} // namespace
+
+class FdbEventQueueTest : public ManagerTestBase {
+ public:
+  void SetUp() override {
+    setupStage = SetupStage::PORT | SetupStage::VLAN;
+    ManagerTestBase::SetUp();
+    switchId = saiManagerTable->switchManager().getSwitchSaiId();
+    auto vlanHandle = saiManagerTable->vlanManager().getVlanHandle(
+        VlanID(testInterfaces[1].id));
+    bridgeVlanId = vlanHandle->vlan->adapterKey();
+    auto portHandle = saiManagerTable->portManager().getPortHandle(
+        PortID(testInterfaces[1].remoteHosts[0].port.id));
+    bridgePortId = portHandle->bridgePort->adapterKey();
+  }
+
+  void TearDown() override {
+    queue.reset();
+    fdbEventQueue = nullptr;
+    ManagerTestBase::TearDown();
+  }
+
+  void makeQueue(size_t capacity, size_t maxBatchSize) {
+    queue = std::make_unique<SaiFdbEventQueue>(
+        capacity, maxBatchSize, [this](std::vector<SaiFdbEvent> events) {
+          auto locked = handled.wlock();
+          locked->insert(locked->end(), events.begin(), events.end());
+        });
+    fdbEventQueue = queue.get();
+    saiApiTable->switchApi().registerFdbEventCallback(
+        switchId, &fdbEventCallback);
+  }
+
+  FakeFdbEvent makeEvent(sai_fdb_event_t type, uint64_t n) const {
+    return FakeFdbEvent{type, bridgeVlanId, nthMac(n), bridgePortId};
+  }
+
+  SwitchSaiId switchId;
+  VlanSaiId bridgeVlanId;
+  BridgePortSaiId bridgePortId;
+  std::unique_ptr<SaiFdbEventQueue> queue;
+  folly::Synchronized<std::vector<SaiFdbEvent>> handled;
+};
+
+TEST_F(FdbEventQueueTest, concurrentIndices) {
+  EXPECT_EQ(
+      VlanID(testInterfaces[1].id),
+      concurrentIndices->bridgeVlanIds.find(bridgeVlanId)->second);
+  EXPECT_EQ(
+      PortID(testInterfaces[1].remoteHosts[0].port.id),
+      concurrentIndices->bridgePortIds.find(bridgePortId)->second);
+}
+
+TEST_F(FdbEventQueueTest, coalesce) {
+  std::vector<SaiFdbEvent> events{
+      {SAI_FDB_EVENT_LEARNED, nthMac(1), VlanSaiId(1), BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_LEARNED, nthMac(2), VlanSaiId(1), BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_LEARNED, nthMac(1), VlanSaiId(2), BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_MOVE, nthMac(1), VlanSaiId(1), BridgePortSaiId(2)},
+      {SAI_FDB_EVENT_AGED, nthMac(2), VlanSaiId(1), BridgePortSaiId(1)},
+  };
+  auto coalesced = SaiFdbEventQueue::coalesce(events);
+  ASSERT_EQ(3, coalesced.size());
+  EXPECT_EQ(nthMac(1), coalesced[0].mac);
+  EXPECT_EQ(VlanSaiId(2), coalesced[0].bridgeVlanId);
+  EXPECT_EQ(SAI_FDB_EVENT_MOVE, coalesced[1].type);
+  EXPECT_EQ(BridgePortSaiId(2), coalesced[1].bridgePortId);
+  EXPECT_EQ(SAI_FDB_EVENT_AGED, coalesced[2].type);
+}
+
+TEST_F(FdbEventQueueTest, bulkFlushNotCoalesced) {
+  std::vector<SaiFdbEvent> events{
+      {SAI_FDB_EVENT_LEARNED, nthMac(1), VlanSaiId(1), BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_FLUSHED,
+       folly::MacAddress(),
+       VlanSaiId(0),
+       BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_FLUSHED,
+       folly::MacAddress(),
+       VlanSaiId(0),
+       BridgePortSaiId(1)},
+      {SAI_FDB_EVENT_LEARNED, nthMac(2), VlanSaiId(1), BridgePortSaiId(2)},
+  };
+  EXPECT_FALSE(events[0].isBulkFlush());
+  EXPECT_TRUE(events[1].isBulkFlush());
+  // Bulk flushes share a key, yet each is kept in place
+  auto coalesced = SaiFdbEventQueue::coalesce(events);
+  ASSERT_EQ(4, coalesced.size());
+  EXPECT_EQ(nthMac(1), coalesced[0].mac);
+  EXPECT_TRUE(coalesced[1].isBulkFlush());
+  EXPECT_TRUE(coalesced[2].isBulkFlush());
+  EXPECT_EQ(nthMac(2), coalesced[3].mac);
+}
+
+TEST_F(FdbEventQueueTest, learnAndAge) {
+  makeQueue(1024, 1024);
+  // Queued while the consumer is not running, so handled as one batch
+  fake_fdb_event_notify(
+      switchId,
+      {makeEvent(SAI_FDB_EVENT_LEARNED, 1),
+       makeEvent(SAI_FDB_EVENT_LEARNED, 2),
+       makeEvent(SAI_FDB_EVENT_AGED, 1)},
+      2);
+  EXPECT_EQ(1, fs->fdbManager.map().size());
+  queue->start();
+  queue->stop();
+
+  auto events = handled.copy();
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(nthMac(2), events[0].mac);
+  EXPECT_EQ(SAI_FDB_EVENT_LEARNED, events[0].type);
+  EXPECT_EQ(bridgeVlanId, events[0].bridgeVlanId);
+  EXPECT_EQ(bridgePortId, events[0].bridgePortId);
+  EXPECT_EQ(nthMac(1), events[1].mac);
+  EXPECT_EQ(SAI_FDB_EVENT_AGED, events[1].type);
+  EXPECT_EQ(3, queue->getEnqueued());
+  EXPECT_EQ(1, queue->getCoalesced());
+  EXPECT_EQ(2, queue->getDelivered());
+}
+
+TEST_F(FdbEventQueueTest, overflow) {
+  makeQueue(8, 8);
+  std::vector<FakeFdbEvent> events;
+  for (int i = 0; i < 20; ++i) {
+    events.push_back(makeEvent(SAI_FDB_EVENT_LEARNED, i));
+  }
+  fake_fdb_event_notify(switchId, events, 5);
+  EXPECT_EQ(8, queue->getEnqueued());
+  EXPECT_EQ(12, queue->getDropped());
+  queue->start();
+  queue->stop();
+  EXPECT_EQ(8, handled.rlock()->size());
+}
+
+TEST_F(FdbEventQueueTest, learningStorm) {
+  constexpr int kMacs = 100000;
+  makeQueue(16384, 512);
+  queue->start();
+
+  std::vector<FakeFdbEvent> events;
+  for (int i = 0; i < kMacs; ++i) {
+    events.push_back(makeEvent(SAI_FDB_EVENT_LEARNED, i));
+  }
+  auto start = std::chrono::steady_clock::now();
+  // The way learning ASICs report, a few dozen events per notification
+  fake_fdb_event_notify(switchId, events, 64);
+  queue->stop();
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  EXPECT_EQ(kMacs, queue->getEnqueued() + queue->getDropped());
+  EXPECT_EQ(queue->getEnqueued(), handled.rlock()->size());
+  EXPECT_EQ(kMacs, fs->fdbManager.map().size());
+  XLOG(INFO) << "Learned " << queue->getDelivered() << " of " << kMacs
+             << " macs in " << elapsed.count() << "us, dropped "
+             << queue->getDropped();
+}
@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiBridgeManager.h"
 #include "fboss/agent/hw/sai/switch/SaiFdbManager.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
@@ -18,6 +19,7 @@
 #include "fboss/agent/types.h"
 
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -56,3 +58,134 @@ TEST_F(FdbManagerTest, addFdbEntry) {
       saiManagerTable->fdbManager().addFdbEntry(intfId, mac1, portDesc);
   checkFdbEntry(intfId, mac1, portDesc);
 }
+
+TEST_F(FdbManagerTest, fdbEntryIndexed) {
+  folly::MacAddress mac1{"00:11:11:11:11:11"};
+  InterfaceID intfId = InterfaceID(intf0.id);
+  PortDescriptor portDesc = PortDescriptor(PortID(intf0.id));
+  auto fdbEntry =
+      saiManagerTable->fdbManager().addFdbEntry(intfId, mac1, portDesc);
+  auto bridgePortId = saiManagerTable->portManager()
+                          .getPortHandle(portDesc.phyPortID())
+                          ->bridgePort->adapterKey();
+  auto itr = concurrentIndices->fdbEntries.find(fdbEntry->adapterKey());
+  ASSERT_NE(itr, concurrentIndices->fdbEntries.cend());
+  EXPECT_EQ(bridgePortId, itr->second.bridgePortId);
+  EXPECT_TRUE(itr->second.isStatic);
+
+  std::vector<L2EntryThrift> l2Table;
+  concurrentIndices->fetchL2Table(&l2Table);
+  ASSERT_EQ(1, l2Table.size());
+  EXPECT_EQ(mac1.toString(), l2Table[0].mac);
+  EXPECT_EQ(intf0.id, l2Table[0].vlanID);
+  EXPECT_EQ(intf0.id, l2Table[0].port);
+
+  fdbEntry.reset();
+  EXPECT_EQ(0, concurrentIndices->fdbEntries.size());
+  l2Table.clear();
+  concurrentIndices->fetchL2Table(&l2Table);
+  EXPECT_TRUE(l2Table.empty());
+}
+
+TEST_F(FdbManagerTest, sharedFdbEntryIndexedUntilLastRelease) {
+  // e.g. the v4 and v6 neighbors of the same host
+  folly::MacAddress mac1{"00:11:11:11:11:11"};
+  InterfaceID intfId = InterfaceID(intf0.id);
+  PortDescriptor portDesc = PortDescriptor(PortID(intf0.id));
+  auto fdbEntry1 =
+      saiManagerTable->fdbManager().addFdbEntry(intfId, mac1, portDesc);
+  auto fdbEntry2 =
+      saiManagerTable->fdbManager().addFdbEntry(intfId, mac1, portDesc);
+  EXPECT_EQ(fdbEntry1.get(), fdbEntry2.get());
+  EXPECT_EQ(1, concurrentIndices->fdbEntries.size());
+
+  fdbEntry1.reset();
+  EXPECT_EQ(1, concurrentIndices->fdbEntries.size());
+  checkFdbEntry(intfId, mac1, portDesc);
+  fdbEntry2.reset();
+  EXPECT_EQ(0, concurrentIndices->fdbEntries.size());
+}
+
+TEST_F(FdbManagerTest, portFlushRemovesLearnedEntries) {
+  auto intf1 = testInterfaces[2];
+  auto bridgePortId = [this](const TestInterface& intf) {
+    return BridgePortSaiId{saiManagerTable->portManager()
+                               .getPortHandle(PortID(intf.id))
+                               ->bridgePort->adapterKey()};
+  };
+  auto bridgePort0 = bridgePortId(intf0);
+  auto bridgePort1 = bridgePortId(intf1);
+  folly::MacAddress staticMac{"00:11:11:11:11:11"};
+  auto fdbEntry = saiManagerTable->fdbManager().addFdbEntry(
+      InterfaceID(intf0.id), staticMac, PortDescriptor(PortID(intf0.id)));
+  // Learned on both ports, as the fdb event processing records them
+  auto vlan0 = fdbEntry->adapterKey().bridgeVlanId();
+  std::vector<folly::MacAddress> learned{
+      folly::MacAddress{"00:22:22:22:22:01"},
+      folly::MacAddress{"00:22:22:22:22:02"}};
+  for (const auto& mac : learned) {
+    concurrentIndices->fdbEntries.insert_or_assign(
+        SaiFdbTraits::FdbEntry{1, vlan0, mac},
+        FdbShadowEntry{bridgePort0, false});
+  }
+  SaiFdbTraits::FdbEntry otherPortEntry{
+      1, vlan0, folly::MacAddress{"00:33:33:33:33:33"}};
+  concurrentIndices->fdbEntries.insert_or_assign(
+      otherPortEntry, FdbShadowEntry{bridgePort1, false});
+
+  // e.g. the link of port 0 going down
+  auto flushed = concurrentIndices->flushFdbEntries(
+      bridgePort0, VlanSaiId{0}, folly::MacAddress());
+  ASSERT_EQ(learned.size(), flushed.size());
+  for (const auto& [entry, flushedPort] : flushed) {
+    EXPECT_EQ(bridgePort0, flushedPort);
+    EXPECT_NE(staticMac, entry.mac());
+  }
+
+  // The static entry of the flushed port and the other port's entry stay
+  EXPECT_EQ(2, concurrentIndices->fdbEntries.size());
+  EXPECT_NE(
+      concurrentIndices->fdbEntries.cend(),
+      concurrentIndices->fdbEntries.find(fdbEntry->adapterKey()));
+  auto itr = concurrentIndices->fdbEntries.find(otherPortEntry);
+  ASSERT_NE(itr, concurrentIndices->fdbEntries.cend());
+  EXPECT_EQ(bridgePort1, itr->second.bridgePortId);
+
+  std::vector<L2EntryThrift> l2Table;
+  concurrentIndices->fetchL2Table(&l2Table);
+  EXPECT_EQ(2, l2Table.size());
+}
+
+TEST_F(FdbManagerTest, learnAndAgeKeepStaticFdbEntry) {
+  folly::MacAddress mac1{"00:11:11:11:11:11"};
+  InterfaceID intfId = InterfaceID(intf0.id);
+  PortDescriptor portDesc = PortDescriptor(PortID(intf0.id));
+  auto fdbEntry =
+      saiManagerTable->fdbManager().addFdbEntry(intfId, mac1, portDesc);
+  auto bridgePortId = saiManagerTable->portManager()
+                          .getPortHandle(portDesc.phyPortID())
+                          ->bridgePort->adapterKey();
+  auto otherBridgePortId = saiManagerTable->portManager()
+                               .getPortHandle(PortID(testInterfaces[2].id))
+                               ->bridgePort->adapterKey();
+
+  // e.g. the mac moving to another port, then aging out
+  EXPECT_FALSE(concurrentIndices->learnFdbEntry(
+      fdbEntry->adapterKey(), BridgePortSaiId{otherBridgePortId}));
+  EXPECT_FALSE(concurrentIndices->unlearnFdbEntry(fdbEntry->adapterKey()));
+  auto itr = concurrentIndices->fdbEntries.find(fdbEntry->adapterKey());
+  ASSERT_NE(itr, concurrentIndices->fdbEntries.cend());
+  EXPECT_EQ(bridgePortId, itr->second.bridgePortId);
+  EXPECT_TRUE(itr->second.isStatic);
+
+  // Learned entries are still recorded and removed
+  SaiFdbTraits::FdbEntry learnedEntry{
+      1,
+      fdbEntry->adapterKey().bridgeVlanId(),
+      folly::MacAddress{"00:22:22:22:22:22"}};
+  EXPECT_TRUE(concurrentIndices->learnFdbEntry(
+      learnedEntry, BridgePortSaiId{otherBridgePortId}));
+  EXPECT_EQ(2, concurrentIndices->fdbEntries.size());
+  EXPECT_TRUE(concurrentIndices->unlearnFdbEntry(learnedEntry));
+  EXPECT_EQ(1, concurrentIndices->fdbEntries.size());
+}
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Compare reading the l2 table from the adapter, with a get object keys and
+ * SAI calls per fdb entry to map it back to SwitchState ids, and from the
+ * fdb shadow in ConcurrentIndices. Entries are created in the fake SAI, so
+ * adapter numbers are a lower bound of what a real adapter costs.
+ */
+#include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/api/SaiObjectApi.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <vector>
+
+DEFINE_int32(num_fdb_entries, 100000, "Number of fdb entries in the table");
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr sai_object_id_t kSwitchId = 0;
+const VlanID kVlanId{1000};
+const PortID kPortId{1};
+const PortSaiId kPortSaiId{42};
+
+struct L2TableSetup {
+  L2TableSetup() {
+    auto apiTable = SaiApiTable::getInstance();
+    vlanSaiId = apiTable->vlanApi().create<SaiVlanTraits>(
+        {static_cast<uint16_t>(kVlanId)}, kSwitchId);
+    SaiBridgePortTraits::CreateAttributes bridgePortAttrs{
+        SAI_BRIDGE_PORT_TYPE_PORT,
+        kPortSaiId,
+        true,
+        SAI_BRIDGE_PORT_FDB_LEARNING_MODE_HW};
+    bridgePortSaiId = apiTable->bridgeApi().create<SaiBridgePortTraits>(
+        bridgePortAttrs, kSwitchId);
+    indices.portIds.emplace(kPortSaiId, kPortId);
+    indices.bridgePortIds.emplace(bridgePortSaiId, kPortId);
+    indices.bridgeVlanIds.emplace(vlanSaiId, kVlanId);
+
+    auto& fdbApi = apiTable->fdbApi();
+    for (uint64_t i = 0; i < FLAGS_num_fdb_entries; ++i) {
+      SaiFdbTraits::FdbEntry entry{
+          kSwitchId,
+          vlanSaiId,
+          folly::MacAddress::fromHBO(0x020000000000 + i)};
+      fdbApi.create<SaiFdbTraits>(
+          entry, {SAI_FDB_ENTRY_TYPE_DYNAMIC, bridgePortSaiId});
+      indices.fdbEntries.insert_or_assign(
+          entry, FdbShadowEntry{bridgePortSaiId, false});
+    }
+  }
+
+  ~L2TableSetup() {
+    auto& fdbApi = SaiApiTable::getInstance()->fdbApi();
+    for (const auto& entry : getObjectKeys<SaiFdbTraits>(kSwitchId)) {
+      fdbApi.remove(entry);
+    }
+    SaiApiTable::getInstance()->bridgeApi().remove(bridgePortSaiId);
+    SaiApiTable::getInstance()->vlanApi().remove(vlanSaiId);
+  }
+
+  VlanSaiId vlanSaiId;
+  BridgePortSaiId bridgePortSaiId;
+  ConcurrentIndices indices;
+};
+
+// What SaiSwitch::fetchL2Table() did under the switch lock
+void fetchL2TableFromAdapter(
+    const ConcurrentIndices& indices,
+    std::vector<L2EntryThrift>* l2Table) {
+  auto apiTable = SaiApiTable::getInstance();
+  auto fdbEntries = getObjectKeys<SaiFdbTraits>(kSwitchId);
+  l2Table->reserve(fdbEntries.size());
+  for (const auto& fdbEntry : fdbEntries) {
+    L2EntryThrift entry;
+    entry.mac = fdbEntry.mac().toString();
+    entry.vlanID = apiTable->vlanApi().getAttribute(
+        VlanSaiId{fdbEntry.bridgeVlanId()},
+        SaiVlanTraits::Attributes::VlanId{});
+    auto bridgePortSaiId = apiTable->fdbApi().getAttribute(
+        fdbEntry, SaiFdbTraits::Attributes::BridgePortId());
+    auto portSaiId = apiTable->bridgeApi().getAttribute(
+        BridgePortSaiId{bridgePortSaiId},
+        SaiBridgePortTraits::Attributes::PortId{});
+    const auto portItr = indices.portIds.find(PortSaiId{portSaiId});
+    if (portItr == indices.portIds.cend()) {
+      continue;
+    }
+    entry.port = portItr->second;
+    l2Table->push_back(entry);
+  }
+}
+
+template <typename FetchFn>
+void fetchL2Table(FetchFn fetch) {
+  folly::BenchmarkSuspender suspender;
+  L2TableSetup setup;
+  suspender.dismiss();
+  std::vector<L2EntryThrift> l2Table;
+  fetch(setup.indices, &l2Table);
+  folly::doNotOptimizeAway(l2Table);
+  suspender.rehire();
+  CHECK_EQ(FLAGS_num_fdb_entries, l2Table.size());
+}
+
+} // namespace
+
+BENCHMARK(AdapterL2Table) {
+  fetchL2Table(fetchL2TableFromAdapter);
+}
+
+BENCHMARK_RELATIVE(ShadowL2Table) {
+  fetchL2Table([](const ConcurrentIndices& indices,
+                  std::vector<L2EntryThrift>* l2Table) {
+    indices.fetchL2Table(l2Table);
+  });
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  sai_api_initialize(0, nullptr);
+  SaiApiTable::getInstance()->queryApis();
+  folly::runBenchmarks();
+  return 0;
+}
@@ -215,3 +215,88 @@ TEST_F(NextHopGroupManagerTest, testNextHopGroupMemberWeights) {
       SaiNextHopGroupMemberTraits::Attributes::Weight{});
   EXPECT_EQ(weight, 42);
 }
+
+TEST_F(NextHopGroupManagerTest, resolveNeighborsBatched) {
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  RouteNextHopEntry::NextHopSet swNextHops{nh1, nh2};
+  RouteNextHopEntry::NextHopSet swNextHops2{nh2};
+  auto& nextHopGroupManager = saiManagerTable->nextHopGroupManager();
+  auto saiNextHopGroupHandle =
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops);
+  auto saiNextHopGroupHandle2 =
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops2);
+  auto saiNextHopGroup = saiNextHopGroupHandle->nextHopGroup;
+  auto saiNextHopGroup2 = saiNextHopGroupHandle2->nextHopGroup;
+
+  nextHopGroupManager.startNeighborBatch();
+  auto arpEntry0 = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+  auto arpEntry1 = makeArpEntry(intf1.id, h1);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry1);
+  // Nothing is propagated until the batch is flushed
+  checkNextHopGroup(saiNextHopGroup->adapterKey(), {});
+  checkNextHopGroup(saiNextHopGroup2->adapterKey(), {});
+  nextHopGroupManager.flushNeighborBatch();
+  checkNextHopGroup(saiNextHopGroup->adapterKey(), {h0.ip, h1.ip});
+  checkNextHopGroup(saiNextHopGroup2->adapterKey(), {h1.ip});
+}
+
+TEST_F(NextHopGroupManagerTest, unresolveNeighborInBatch) {
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  RouteNextHopEntry::NextHopSet swNextHops{nh1, nh2};
+  auto& nextHopGroupManager = saiManagerTable->nextHopGroupManager();
+  auto saiNextHopGroupHandle =
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops);
+  auto saiNextHopGroup = saiNextHopGroupHandle->nextHopGroup;
+
+  nextHopGroupManager.startNeighborBatch();
+  auto arpEntry0 = makeArpEntry(intf0.id, h0);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+  auto arpEntry1 = makeArpEntry(intf1.id, h1);
+  saiManagerTable->neighborManager().addNeighbor(arpEntry1);
+  saiManagerTable->neighborManager().removeNeighbor(arpEntry1);
+  nextHopGroupManager.flushNeighborBatch();
+  checkNextHopGroup(saiNextHopGroup->adapterKey(), {h0.ip});
+}
+
+TEST_F(NextHopGroupManagerTest, resolveNeighborsBatchedManyGroups) {
+  // Groups only differing in weights share the same neighbors, which is
+  // the case where resolving neighbors one at a time hurts most.
+  constexpr int kNumGroups = 500;
+  auto& nextHopGroupManager = saiManagerTable->nextHopGroupManager();
+  auto fs = FakeSai::getInstance();
+  auto resolveAll = [&](bool batched) {
+    std::vector<std::shared_ptr<SaiNextHopGroupHandle>> handles;
+    for (int i = 0; i < kNumGroups; ++i) {
+      ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), 1};
+      ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), uint64_t(i + 2)};
+      handles.push_back(
+          nextHopGroupManager.incRefOrAddNextHopGroup({nh1, nh2}));
+    }
+    auto arpEntry0 = makeArpEntry(intf0.id, h0);
+    auto arpEntry1 = makeArpEntry(intf1.id, h1);
+    fs->apiCallCounts.clear();
+    if (batched) {
+      nextHopGroupManager.startNeighborBatch();
+    }
+    saiManagerTable->neighborManager().addNeighbor(arpEntry0);
+    saiManagerTable->neighborManager().addNeighbor(arpEntry1);
+    if (batched) {
+      nextHopGroupManager.flushNeighborBatch();
+    }
+    auto memberCreates =
+        fs->apiCallCounts[SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER];
+    for (const auto& handle : handles) {
+      checkNextHopGroup(handle->nextHopGroup->adapterKey(), {h0.ip, h1.ip});
+    }
+    saiManagerTable->neighborManager().removeNeighbor(arpEntry0);
+    saiManagerTable->neighborManager().removeNeighbor(arpEntry1);
+    return memberCreates;
+  };
+  // One create per member of every group
+  EXPECT_EQ(2 * kNumGroups, resolveAll(false));
+  // A single bulk create for all of them
+  EXPECT_EQ(1, resolveAll(true));
+}
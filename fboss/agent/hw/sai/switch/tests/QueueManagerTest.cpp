@@ -430,3 +430,82 @@ TEST_F(QueueManagerTest, portReenableRestartsCounterExport) {
   checkCounterExportAndValue(
       evenNewerPort->getName(), queueConfig, ExpectExport::EXPORT, portStat);
 }
+
+TEST_F(QueueManagerTest, identicalQueuesShareScheduler) {
+  auto p0 = testInterfaces[0].remoteHosts[0].port;
+  std::shared_ptr<Port> oldPort = makePort(p0);
+  auto newPort = oldPort->clone();
+  std::vector<uint8_t> queueIds = {1, 2, 3};
+  newPort->resetPortQueues(makeQueueConfig({queueIds}));
+  saiManagerTable->queueManager().resetProgrammingStats();
+  fs->apiCallCounts.clear();
+  saiManagerTable->portManager().changePort(oldPort, newPort);
+
+  auto stats = saiManagerTable->queueManager().resetProgrammingStats();
+  EXPECT_EQ(stats.queuesChanged, 3);
+  EXPECT_EQ(stats.schedulersCreated, 1);
+  EXPECT_EQ(stats.schedulersShared, 2);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER], 1);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_QUEUE], 3);
+  auto queueHandle1 = saiManagerTable->portManager().getQueueHandle(
+      newPort->getID(), makeSaiQueueConfig(cfg::StreamType::UNICAST, 1));
+  for (auto queueId : queueIds) {
+    auto queueHandle = saiManagerTable->portManager().getQueueHandle(
+        newPort->getID(),
+        makeSaiQueueConfig(cfg::StreamType::UNICAST, queueId));
+    ASSERT_TRUE(queueHandle->scheduler);
+    EXPECT_EQ(queueHandle->scheduler, queueHandle1->scheduler);
+  }
+}
+
+TEST_F(QueueManagerTest, unchangedQueuesNotReprogrammed) {
+  auto p0 = testInterfaces[0].remoteHosts[0].port;
+  std::shared_ptr<Port> oldPort = makePort(p0);
+  auto newPort = oldPort->clone();
+  newPort->resetPortQueues(makeQueueConfig({1, 2, 3}));
+  saiManagerTable->portManager().changePort(oldPort, newPort);
+
+  saiManagerTable->queueManager().resetProgrammingStats();
+  fs->apiCallCounts.clear();
+  auto newNewPort = newPort->clone();
+  newNewPort->setName("eth1/1/1");
+  saiManagerTable->portManager().changePort(newPort, newNewPort);
+
+  auto stats = saiManagerTable->queueManager().resetProgrammingStats();
+  EXPECT_EQ(stats.queuesChanged, 0);
+  EXPECT_EQ(stats.queuesUnchanged, 3);
+  EXPECT_EQ(stats.saiCalls, 0);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER], 0);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_QUEUE], 0);
+}
+
+TEST_F(QueueManagerTest, onlyChangedQueueReprogrammed) {
+  auto p0 = testInterfaces[0].remoteHosts[0].port;
+  std::shared_ptr<Port> oldPort = makePort(p0);
+  auto newPort = oldPort->clone();
+  newPort->resetPortQueues(makeQueueConfig({1, 2, 3}));
+  saiManagerTable->portManager().changePort(oldPort, newPort);
+
+  saiManagerTable->queueManager().resetProgrammingStats();
+  fs->apiCallCounts.clear();
+  auto newNewPort = newPort->clone();
+  auto newQueueConfig = newPort->getPortQueues();
+  newQueueConfig[1] = makePortQueue(
+      2,
+      cfg::StreamType::UNICAST,
+      cfg::QueueScheduling::WEIGHTED_ROUND_ROBIN,
+      50,
+      12000,
+      60000);
+  newNewPort->resetPortQueues(newQueueConfig);
+  saiManagerTable->portManager().changePort(newPort, newNewPort);
+
+  auto stats = saiManagerTable->queueManager().resetProgrammingStats();
+  EXPECT_EQ(stats.queuesChanged, 1);
+  EXPECT_EQ(stats.queuesUnchanged, 2);
+  EXPECT_EQ(stats.schedulersCreated, 1);
+  // Queues 1 and 3 still use the old scheduler
+  EXPECT_EQ(stats.schedulersRemoved, 0);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_SCHEDULER], 1);
+  EXPECT_EQ(fs->apiCallCounts[SAI_OBJECT_TYPE_QUEUE], 1);
+}
@@ -16,8 +16,17 @@
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
 #include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/types.h"
 
+#include <gflags/gflags.h>
+
+DECLARE_string(sai_critical_route_prefixes);
+DECLARE_string(sai_critical_route_clients);
+
 using namespace facebook::fboss;
 class RouteManagerTest : public ManagerTestBase {
  public:
@@ -329,3 +338,96 @@ TEST_F(ToMeRouteTest, toMeRoutesSlash32) {
   r->setConnected();
   saiManagerTable->routeManager().addRoute<folly::IPAddressV4>(RouterID(0), r);
 }
+
+TEST_F(RouteManagerTest, routePriority) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_sai_critical_route_prefixes = "10.0.0.0/8, 43.43.0.0/16";
+  FLAGS_sai_critical_route_clients = "7";
+  SaiRouteManager routeManager(saiManagerTable.get(), nullptr);
+
+  auto priority = [&routeManager, this](folly::CIDRNetwork destination) {
+    TestRoute tr{destination, {testInterfaces.at(0)}};
+    return routeManager.routePriority(makeRoute(tr));
+  };
+  auto defaultRoute = priority({folly::IPAddress{"0.0.0.0"}, 0});
+  auto critical16 = priority({folly::IPAddress{"10.1.0.0"}, 16});
+  auto critical24 = priority(d2);
+  auto other8 = priority({folly::IPAddress{"44.0.0.0"}, 8});
+  auto other24 = priority(d1);
+  EXPECT_LT(defaultRoute, critical16);
+  EXPECT_LT(critical16, critical24);
+  EXPECT_LT(critical24, other8);
+  EXPECT_LT(other8, other24);
+  // A critical prefix only covers routes at least as specific as itself
+  EXPECT_EQ(priority({folly::IPAddress{"43.0.0.0"}, 8}), other8);
+
+  // Routes from critical clients are critical whatever their prefix
+  auto r = makeRoute(tr1);
+  r->update(ClientID(7), *r->getBestEntry().second);
+  r->delEntryForClient(ClientID{42});
+  EXPECT_EQ(routeManager.routePriority(r), critical24);
+}
+
+TEST_F(RouteManagerTest, processRouteDeltaAddsAndRemoves) {
+  TestRoute defaultRoute{{folly::IPAddress{"0.0.0.0"}, 0},
+                         {testInterfaces.at(1)}};
+  auto routeTable = std::make_shared<RouteTable>(RouterID(0));
+  routeTable->writableRibV4()->addRoute(makeRoute(tr1));
+  routeTable->writableRibV4()->addRoute(makeRoute(defaultRoute));
+  auto routeTables = std::make_shared<RouteTableMap>();
+  routeTables->addRouteTable(routeTable);
+  auto oldState = std::make_shared<SwitchState>();
+  auto newState = std::make_shared<SwitchState>();
+  newState->resetRouteTables(routeTables);
+
+  auto& routeManager = saiManagerTable->routeManager();
+  auto defaultEntry =
+      routeManager.routeEntryFromSwRoute(RouterID(0), makeRoute(defaultRoute));
+  auto entry = routeManager.routeEntryFromSwRoute(RouterID(0), makeRoute(tr1));
+  routeManager.processRouteDelta(StateDelta(oldState, newState));
+  EXPECT_NE(routeManager.getRouteHandle(defaultEntry), nullptr);
+  EXPECT_NE(routeManager.getRouteHandle(entry), nullptr);
+
+  routeManager.processRouteDelta(StateDelta(newState, oldState));
+  EXPECT_EQ(routeManager.getRouteHandle(defaultEntry), nullptr);
+  EXPECT_EQ(routeManager.getRouteHandle(entry), nullptr);
+}
+
+TEST_F(RouteManagerTest, processRouteDeltaAddsInPriorityOrder) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_sai_critical_route_prefixes = "10.0.0.0/8";
+  SaiRouteManager routeManager(saiManagerTable.get(), nullptr);
+
+  // In the order they are expected to be programmed
+  std::vector<folly::CIDRNetwork> destinations{
+      {folly::IPAddress{"0.0.0.0"}, 0},
+      {folly::IPAddress{"10.1.0.0"}, 16},
+      {folly::IPAddress{"10.1.1.0"}, 24},
+      {folly::IPAddress{"44.0.0.0"}, 8},
+      {folly::IPAddress{"44.1.1.0"}, 24}};
+  auto routeTable = std::make_shared<RouteTable>(RouterID(0));
+  std::vector<SaiRouteTraits::RouteEntry> entries;
+  for (const auto& destination : destinations) {
+    TestRoute tr{destination, {testInterfaces.at(0)}};
+    auto route = makeRoute(tr);
+    routeTable->writableRibV4()->addRoute(route);
+    entries.push_back(routeManager.routeEntryFromSwRoute(RouterID(0), route));
+  }
+  auto routeTables = std::make_shared<RouteTableMap>();
+  routeTables->addRouteTable(routeTable);
+  auto oldState = std::make_shared<SwitchState>();
+  auto newState = std::make_shared<SwitchState>();
+  newState->resetRouteTables(routeTables);
+  routeManager.processRouteDelta(StateDelta(oldState, newState));
+
+  auto createOrder = [](const SaiRouteTraits::RouteEntry& entry) {
+    return FakeSai::getInstance()
+        ->routeManager
+        .get(std::make_tuple(
+            entry.switchId(), entry.virtualRouterId(), entry.destination()))
+        .createOrder;
+  };
+  for (size_t i = 1; i < entries.size(); ++i) {
+    EXPECT_LT(createOrder(entries[i - 1]), createOrder(entries[i]));
+  }
+}
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Compare programming a delta adding vlans, interfaces, neighbors, routes and
+ * CPU queues with rx reason traps over already programmed ports, stage after
+ * stage on the calling thread, and with independent stages scheduled
+ * concurrently. The hostif stage programming the control plane is the one
+ * independent of the L3 stages. Every create and remove of the fake SAI
+ * takes --fake_sai_call_latency_us, waited out with the SaiApiLock released,
+ * to model the round trips to a real adapter.
+ */
+#include "fboss/agent/hw/sai/fake/FakeManager.h"
+#include "fboss/agent/hw/sai/switch/SaiStateChangeStages.h"
+#include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/ControlPlane.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+DEFINE_int32(
+    fake_sai_call_latency_us,
+    20,
+    "Time every create and remove of a fake SAI object takes");
+DEFINE_int32(num_routes, 512, "Number of routes added by the delta");
+DEFINE_int32(num_cpu_queues, 8, "Number of CPU queues added by the delta");
+DEFINE_int32(num_stage_threads, 4, "Threads running concurrent stages");
+
+using namespace facebook::fboss;
+
+namespace {
+
+/*
+ * Reuse the switch and managers the SAI manager tests set up, starting with
+ * nothing programmed.
+ */
+class StateChangeSetup : public ManagerTestBase {
+ public:
+  StateChangeSetup() {
+    setupStage = SetupStage::BLANK;
+    SetUp();
+  }
+  ~StateChangeSetup() override {
+    TearDown();
+  }
+
+  std::shared_ptr<SwitchState> portState() const {
+    auto state = std::make_shared<SwitchState>();
+    for (const auto& testInterface : testInterfaces) {
+      for (const auto& remoteHost : testInterface.remoteHosts) {
+        state->addPort(makePort(remoteHost.port));
+      }
+    }
+    return state;
+  }
+
+  std::shared_ptr<SwitchState> mixedState() {
+    auto state = portState();
+    std::vector<TestInterface> nextHopInterfaces;
+    for (const auto& testInterface : testInterfaces) {
+      auto vlan = makeVlan(testInterface);
+      auto arpTable = std::make_shared<ArpTable>();
+      for (const auto& remoteHost : testInterface.remoteHosts) {
+        arpTable->addEntry(
+            remoteHost.ip.asV4(),
+            remoteHost.mac,
+            PortDescriptor(PortID(remoteHost.port.id)),
+            InterfaceID(testInterface.id));
+      }
+      vlan->setArpTable(arpTable);
+      state->addVlan(vlan);
+      state->addIntf(makeInterface(testInterface));
+      nextHopInterfaces.push_back(testInterface);
+    }
+
+    auto routeTable = std::make_shared<RouteTable>(RouterID(0));
+    auto rib = routeTable->writableRibV4();
+    for (int i = 0; i < FLAGS_num_routes; ++i) {
+      // Spread the routes over groups of 2 to all next hops
+      auto numNextHops = 2 + i % (nextHopInterfaces.size() - 1);
+      TestRoute route{
+          folly::CIDRNetwork(
+              folly::IPAddressV4::fromLongHBO(0x64000000 + (i << 8)), 24),
+          std::vector<TestInterface>(
+              nextHopInterfaces.begin(),
+              nextHopInterfaces.begin() + numNextHops)};
+      rib->addRoute(makeRoute(route));
+    }
+    state->addRouteTable(routeTable);
+
+    auto controlPlane = std::make_shared<ControlPlane>();
+    std::vector<uint8_t> queueIds;
+    for (int i = 0; i < FLAGS_num_cpu_queues; ++i) {
+      queueIds.push_back(i);
+    }
+    controlPlane->resetQueues(
+        makeQueueConfig(queueIds, cfg::StreamType::ALL));
+    ControlPlane::RxReasonToQueue rxReasonToQueue;
+    for (auto reason :
+         {cfg::PacketRxReason::ARP,
+          cfg::PacketRxReason::ARP_RESPONSE,
+          cfg::PacketRxReason::NDP,
+          cfg::PacketRxReason::CPU_IS_NHOP,
+          cfg::PacketRxReason::DHCP,
+          cfg::PacketRxReason::LLDP,
+          cfg::PacketRxReason::BGP,
+          cfg::PacketRxReason::BGPV6,
+          cfg::PacketRxReason::LACP}) {
+      cfg::PacketRxReasonToQueue reasonToQueue;
+      reasonToQueue.set_rxReason(reason);
+      reasonToQueue.set_queueId(rxReasonToQueue.size() % queueIds.size());
+      rxReasonToQueue.push_back(reasonToQueue);
+    }
+    controlPlane->resetRxReasonToQueue(rxReasonToQueue);
+    state->resetControlPlane(controlPlane);
+    return state;
+  }
+
+ private:
+  void TestBody() override {}
+};
+
+void programDelta(size_t iters, folly::Executor* executor) {
+  folly::BenchmarkSuspender suspender;
+  setFakeSaiCallLatency(
+      std::chrono::microseconds(FLAGS_fake_sai_call_latency_us));
+  StateChangeSetup setup;
+  auto empty = std::make_shared<SwitchState>();
+  auto ports = setup.portState();
+  auto state = setup.mixedState();
+  StateDelta addPorts(empty, ports);
+  SaiStateChangeStages portStages;
+  addManagerStages(portStages, setup.saiManagerTable.get(), addPorts);
+  portStages.run();
+
+  StateDelta add(ports, state);
+  StateDelta remove(state, ports);
+
+  for (size_t i = 0; i < iters; ++i) {
+    suspender.dismiss();
+    SaiStateChangeStages addStages(executor);
+    addManagerStages(addStages, setup.saiManagerTable.get(), add);
+    addStages.run();
+    suspender.rehire();
+
+    SaiStateChangeStages removeStages(executor);
+    addManagerStages(removeStages, setup.saiManagerTable.get(), remove);
+    removeStages.run();
+  }
+  setFakeSaiCallLatency(std::chrono::microseconds(0));
+}
+
+} // namespace
+
+BENCHMARK(MixedDeltaSequential, iters) {
+  programDelta(iters, nullptr);
+}
+
+BENCHMARK_RELATIVE(MixedDeltaStaged, iters) {
+  folly::CPUThreadPoolExecutor executor(FLAGS_num_stage_threads);
+  programDelta(iters, &executor);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
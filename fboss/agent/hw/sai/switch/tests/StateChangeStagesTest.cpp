@@ -0,0 +1,182 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/sai/switch/SaiInSegEntryManager.h"
+#include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
+#include "fboss/agent/hw/sai/switch/SaiStateChangeStages.h"
+#include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+using namespace facebook::fboss;
+
+namespace {
+
+// Record the order in which stages ran
+class StageOrder {
+ public:
+  std::function<void()> record(std::string name) {
+    return [this, name = std::move(name)] {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(name);
+    };
+  }
+
+  size_t position(const std::string& name) const {
+    auto it = std::find(order_.begin(), order_.end(), name);
+    EXPECT_NE(it, order_.end()) << name;
+    return it - order_.begin();
+  }
+
+  const std::vector<std::string>& order() const {
+    return order_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> order_;
+};
+
+} // namespace
+
+TEST(StateChangeStagesTest, runInOrderWithoutExecutor) {
+  StageOrder order;
+  SaiStateChangeStages stages;
+  stages.addStage("a", {}, order.record("a"));
+  stages.addStage("b", {}, order.record("b"));
+  stages.addStage("c", {"a"}, order.record("c"));
+  stages.run();
+  EXPECT_EQ(order.order(), (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(stages.getTimings().size(), 3);
+}
+
+TEST(StateChangeStagesTest, dependenciesRunFirst) {
+  folly::CPUThreadPoolExecutor executor(4);
+  for (int i = 0; i < 100; ++i) {
+    StageOrder order;
+    SaiStateChangeStages stages(&executor);
+    stages.addStage("port", {}, order.record("port"));
+    stages.addStage("vlan", {"port"}, order.record("vlan"));
+    stages.addStage("hostif", {"port"}, order.record("hostif"));
+    stages.addStage("route", {"vlan"}, order.record("route"));
+    stages.addStage("lb", {}, order.record("lb"));
+    stages.addStage("last", {"route", "hostif"}, order.record("last"));
+    stages.run();
+    ASSERT_EQ(order.order().size(), 6);
+    EXPECT_LT(order.position("port"), order.position("vlan"));
+    EXPECT_LT(order.position("port"), order.position("hostif"));
+    EXPECT_LT(order.position("vlan"), order.position("route"));
+    EXPECT_LT(order.position("route"), order.position("last"));
+    EXPECT_LT(order.position("hostif"), order.position("last"));
+  }
+}
+
+TEST(StateChangeStagesTest, independentStagesOverlap) {
+  folly::CPUThreadPoolExecutor executor(2);
+  SaiStateChangeStages stages(&executor);
+  folly::Baton<> aStarted, bStarted;
+  std::atomic<bool> overlapped{true};
+  // Each stage only finishes in time if the other one runs at the same time
+  stages.addStage("a", {}, [&] {
+    aStarted.post();
+    overlapped = bStarted.try_wait_for(std::chrono::seconds(10)) && overlapped;
+  });
+  stages.addStage("b", {}, [&] {
+    bStarted.post();
+    overlapped = aStarted.try_wait_for(std::chrono::seconds(10)) && overlapped;
+  });
+  stages.run();
+  EXPECT_TRUE(overlapped);
+}
+
+TEST(StateChangeStagesTest, failureSkipsDependents) {
+  folly::CPUThreadPoolExecutor executor(4);
+  StageOrder order;
+  SaiStateChangeStages stages(&executor);
+  stages.addStage("a", {}, [] { throw FbossError("stage failed"); });
+  stages.addStage("b", {"a"}, order.record("b"));
+  stages.addStage("c", {"b"}, order.record("c"));
+  stages.addStage("d", {}, order.record("d"));
+  EXPECT_THROW(stages.run(), FbossError);
+  EXPECT_EQ(order.order(), (std::vector<std::string>{"d"}));
+}
+
+TEST(StateChangeStagesTest, unknownOrDuplicateStage) {
+  SaiStateChangeStages stages;
+  stages.addStage("a", {}, [] {});
+  EXPECT_THROW(stages.addStage("b", {"c"}, [] {}), FbossError);
+  EXPECT_THROW(stages.addStage("a", {}, [] {}), FbossError);
+}
+
+class StateChangeStagesManagerTest : public ManagerTestBase {
+ public:
+  void SetUp() override {
+    setupStage = SetupStage::PORT | SetupStage::VLAN | SetupStage::INTERFACE |
+        SetupStage::NEIGHBOR;
+    ManagerTestBase::SetUp();
+  }
+
+  std::shared_ptr<SwitchState> labelFibState(int numEntries) {
+    auto fib = std::make_shared<LabelForwardingInformationBase>();
+    for (int label = 100; label < 100 + numEntries; ++label) {
+      LabelNextHopSet nexthops;
+      for (const auto& intf : testInterfaces) {
+        nexthops.emplace(makeMplsNextHop(
+            intf,
+            LabelForwardingAction{
+                LabelForwardingAction::LabelForwardingType::SWAP,
+                1000 + intf.id}));
+      }
+      fib->addNode(std::make_shared<LabelForwardingEntry>(
+          label,
+          ClientID(ClientID::OPENR),
+          LabelNextHopEntry(
+              std::move(nexthops), AdminDistance::MAX_ADMIN_DISTANCE)));
+    }
+    auto state = std::make_shared<SwitchState>();
+    state->resetLabelForwardingInformationBase(fib);
+    return state;
+  }
+
+  void programAndVerify(folly::Executor* executor) {
+    auto empty = std::make_shared<SwitchState>();
+    auto state = labelFibState(16);
+    // Stages refer to the delta, which must outlive run()
+    StateDelta add(empty, state);
+    SaiStateChangeStages stages(executor);
+    addManagerStages(stages, saiManagerTable.get(), add);
+    stages.run();
+    for (int label = 100; label < 116; ++label) {
+      EXPECT_NE(
+          saiManagerTable->inSegEntryManager().getInSegEntryHandle(label),
+          nullptr);
+    }
+    StateDelta remove(state, empty);
+    SaiStateChangeStages revert(executor);
+    addManagerStages(revert, saiManagerTable.get(), remove);
+    revert.run();
+    for (int label = 100; label < 116; ++label) {
+      EXPECT_EQ(
+          saiManagerTable->inSegEntryManager().getInSegEntryHandle(label),
+          nullptr);
+    }
+  }
+};
+
+TEST_F(StateChangeStagesManagerTest, sequential) {
+  programAndVerify(nullptr);
+}
+
+TEST_F(StateChangeStagesManagerTest, concurrent) {
+  folly::CPUThreadPoolExecutor executor(4);
+  programAndVerify(&executor);
+}
@@ -35,7 +35,8 @@ class SimSwitch : public HwSwitch {
       std::unique_ptr<TxPacket> pkt,
       PortID portID,
       std::optional<uint8_t> queue = std::nullopt) noexcept override;
-  void gracefulExit(folly::dynamic& /*switchState*/) override {}
+  void gracefulExit(
+      const std::shared_ptr<SwitchState>& /*switchState*/) override {}
 
   folly::dynamic toFollyDynamic() const override;
 
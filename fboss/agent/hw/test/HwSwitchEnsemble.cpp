@@ -196,10 +196,8 @@ void HwSwitchEnsemble::gracefulExit() {
     thriftThread_->join();
   }
   // Initiate warm boot
-  folly::dynamic switchState = folly::dynamic::object;
   getHwSwitch()->unregisterCallbacks();
-  switchState[kSwSwitch] = getProgrammedState()->toFollyDynamic();
-  getHwSwitch()->gracefulExit(switchState);
+  getHwSwitch()->gracefulExit(getProgrammedState());
 }
 
 } // namespace facebook::fboss
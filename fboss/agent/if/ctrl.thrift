@@ -452,6 +452,39 @@ struct LinkNeighborThrift {
   15: optional string localPortName
 }
 
+enum LinkNeighborEventType {
+  ADDED = 0,
+  CHANGED = 1,
+  EXPIRED = 2,
+}
+
+/*
+ * A change to the LLDP neighbors. Sequence numbers of consecutive events
+ * increase by one.
+ */
+struct LinkNeighborEventThrift {
+  1: LinkNeighborEventType type
+  2: i64 sequence
+  3: LinkNeighborThrift neighbor
+}
+
+struct LinkNeighborSnapshotThrift {
+  // Sequence number of the last change included in neighbors
+  1: i64 sequence
+  2: list<LinkNeighborThrift> neighbors
+}
+
+struct NeighborChangesThrift {
+  1: list<Address.BinaryAddress> added
+  2: list<Address.BinaryAddress> removed
+  // Set when changes were dropped because the listener fell behind, or
+  // when it just registered. added then holds every resolved neighbor, which
+  // replace the ones the listener knew about.
+  3: bool resync
+  // When the oldest of these changes happened, in microseconds since epoch
+  4: i64 oldestChangeUsec
+}
+
 enum ClientID {
   BGPD = 0,
   STATIC_ROUTE = 1,
@@ -615,6 +648,12 @@ service FbossCtrl extends fb303.FacebookService {
     throws (1: fboss.FbossBaseError error)
   void registerForNeighborChanged()
     throws (1: fboss.FbossBaseError error) (thread='eb')
+  /*
+   * Like registerForNeighborChanged(), with the changes delivered through
+   * binaryNeighborsChanged(). The first notification is a resync.
+   */
+  void registerForBinaryNeighborChanges()
+    throws (1: fboss.FbossBaseError error) (thread='eb')
   list<string> getInterfaceList()
     throws (1: fboss.FbossBaseError error)
   /*
@@ -731,6 +770,13 @@ service FbossCtrl extends fb303.FacebookService {
   list<LinkNeighborThrift> getLldpNeighbors()
     throws (1: fboss.FbossBaseError error)
 
+  /*
+   * Get the neighbors discovered via LLDP, then stream every later change
+   */
+  LinkNeighborSnapshotThrift, stream<LinkNeighborEventThrift>
+    subscribeLldpNeighbors()
+    throws (1: fboss.FbossBaseError error)
+
   /*
    * Start a packet capture
    */
@@ -809,7 +855,19 @@ service NeighborListenerClient extends fb303.FacebookService {
    * These come in the form of ip address strings which have been added
    * since the last notification. Changes are not queued between
    * subscriptions.
+   *
+   * Changes are coalesced over --neighbor_listener_interval_ms, and the next
+   * notification is only sent once the previous one returned.
    */
   void neighborsChanged(1: list<string> added, 2: list<string> removed)
     throws (1: fboss.FbossBaseError error)
+
+  /*
+   * Same as neighborsChanged(), for listeners which registered through
+   * registerForBinaryNeighborChanges(). At most
+   * --neighbor_listener_max_pending neighbors are queued for a listener,
+   * beyond that the next notification is a resync.
+   */
+  void binaryNeighborsChanged(1: NeighborChangesThrift changes)
+    throws (1: fboss.FbossBaseError error)
 }
@@ -5,6 +5,7 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/String.h>
+#include <folly/hash/Hash.h>
 #include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
 #include <glog/logging.h>
@@ -59,6 +60,47 @@ void LinkNeighbor::setTTL(std::chrono::seconds seconds) {
   expirationTime_ = std::chrono::steady_clock::now() + seconds;
 }
 
+uint64_t LinkNeighbor::getTlvFingerprint() const {
+  return tlvFingerprint(
+      protocol_,
+      chassisIdType_,
+      chassisId_,
+      portIdType_,
+      portId_,
+      receivedTTL_,
+      capabilities_,
+      enabledCapabilities_,
+      systemName_,
+      portDescription_,
+      systemDescription_);
+}
+
+uint64_t LinkNeighbor::tlvFingerprint(
+    LinkProtocol protocol,
+    LldpChassisIdType chassisIdType,
+    StringPiece chassisId,
+    LldpPortIdType portIdType,
+    StringPiece portId,
+    std::chrono::seconds ttl,
+    uint16_t capabilities,
+    uint16_t enabledCapabilities,
+    StringPiece systemName,
+    StringPiece portDescription,
+    StringPiece systemDescription) {
+  return folly::hash::hash_combine(
+      protocol,
+      chassisIdType,
+      chassisId,
+      portIdType,
+      portId,
+      ttl.count(),
+      capabilities,
+      enabledCapabilities,
+      systemName,
+      portDescription,
+      systemDescription);
+}
+
 std::string LinkNeighbor::humanReadableChassisId() const {
   if (chassisIdType_ == LldpChassisIdType::MAC_ADDRESS) {
     return humanReadableMac(chassisId_);
@@ -153,6 +153,34 @@ struct LinkNeighbor {
     return now > expirationTime_;
   }
 
+  /*
+   * Get a hash of the fields carried in the neighbor's TLVs.
+   *
+   * Two LinkNeighbor objects with the same fingerprint advertise the same
+   * information, regardless of when they were received. The local port,
+   * VLAN, source MAC and expiration time are not part of it.
+   */
+  uint64_t getTlvFingerprint() const;
+
+  /*
+   * Compute the TLV fingerprint of a neighbor from its fields.
+   *
+   * This allows parsers which do not build a LinkNeighbor (LldpPduView) to
+   * produce the same fingerprint as getTlvFingerprint().
+   */
+  static uint64_t tlvFingerprint(
+      LinkProtocol protocol,
+      LldpChassisIdType chassisIdType,
+      folly::StringPiece chassisId,
+      LldpPortIdType portIdType,
+      folly::StringPiece portId,
+      std::chrono::seconds ttl,
+      uint16_t capabilities,
+      uint16_t enabledCapabilities,
+      folly::StringPiece systemName,
+      folly::StringPiece portDescription,
+      folly::StringPiece systemDescription);
+
   /*
    * Get a human readable representation of the chassis ID.
    *
@@ -311,7 +339,7 @@ struct LinkNeighbor {
   std::string portDescription_;
   std::string systemDescription_;
 
-  std::chrono::seconds receivedTTL_;
+  std::chrono::seconds receivedTTL_{0};
   std::chrono::steady_clock::time_point expirationTime_;
 };
 
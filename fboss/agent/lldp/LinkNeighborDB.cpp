@@ -1,6 +1,8 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 #include "fboss/agent/lldp/LinkNeighborDB.h"
 
+#include "fboss/agent/lldp/LldpPduView.h"
+
 using std::lock_guard;
 using std::mutex;
 using std::vector;
@@ -65,8 +67,49 @@ void LinkNeighborDB::update(const LinkNeighbor& neighbor) {
   }
 
   NeighborKey key(neighbor);
-  // It would be nicer to use insert_or_assign() once we move to C++17
-  it->second[key] = neighbor;
+  auto fingerprint = neighbor.getTlvFingerprint();
+  auto existing = it->second.find(key);
+  if (existing == it->second.end()) {
+    it->second.emplace(key, NeighborEntry{neighbor, fingerprint});
+    publishLocked(ChangeType::ADDED, neighbor);
+    return;
+  }
+  // Most updates only refresh the expiration time
+  bool changed = existing->second.fingerprint != fingerprint;
+  existing->second = NeighborEntry{neighbor, fingerprint};
+  if (changed) {
+    publishLocked(ChangeType::CHANGED, neighbor);
+  }
+}
+
+bool LinkNeighborDB::refresh(
+    PortID port,
+    VlanID vlan,
+    folly::MacAddress srcMac,
+    const LldpPduView& pdu) {
+  auto fingerprint = pdu.getTlvFingerprint();
+  lock_guard<mutex> guard(mutex_);
+
+  auto it = byLocalPort_.find(port);
+  if (it == byLocalPort_.end()) {
+    return false;
+  }
+  // There is normally a single neighbor per port, so a scan is cheaper than
+  // building a NeighborKey (and its strings) for a lookup
+  for (auto& entry : it->second) {
+    auto& neighbor = entry.second.neighbor;
+    if (entry.second.fingerprint == fingerprint &&
+        neighbor.getProtocol() == LinkProtocol::LLDP &&
+        neighbor.getChassisIdType() == pdu.getChassisIdType() &&
+        neighbor.getPortIdType() == pdu.getPortIdType() &&
+        pdu.getChassisId() == neighbor.getChassisId() &&
+        pdu.getPortId() == neighbor.getPortId() &&
+        neighbor.getLocalVlan() == vlan && neighbor.getMac() == srcMac) {
+      neighbor.setTTL(pdu.getTTL());
+      return true;
+    }
+  }
+  return false;
 }
 
 vector<LinkNeighbor> LinkNeighborDB::getNeighbors() {
@@ -75,7 +118,7 @@ vector<LinkNeighbor> LinkNeighborDB::getNeighbors() {
 
   for (const auto& portEntry : byLocalPort_) {
     for (const auto& entry : portEntry.second) {
-      results.push_back(entry.second);
+      results.push_back(entry.second.neighbor);
     }
   }
 
@@ -89,7 +132,7 @@ vector<LinkNeighbor> LinkNeighborDB::getNeighbors(PortID port) {
   auto it = byLocalPort_.find(port);
   if (it != byLocalPort_.end()) {
     for (const auto& entry : it->second) {
-      results.push_back(entry.second);
+      results.push_back(entry.second.neighbor);
     }
   }
 
@@ -109,7 +152,52 @@ void LinkNeighborDB::pruneExpiredNeighbors(steady_clock::time_point now) {
 void LinkNeighborDB::portDown(PortID port) {
   lock_guard<mutex> guard(mutex_);
   // Port went down, prune lldp entries for that port
-  byLocalPort_.erase(port);
+  auto it = byLocalPort_.find(port);
+  if (it == byLocalPort_.end()) {
+    return;
+  }
+  for (const auto& entry : it->second) {
+    publishLocked(ChangeType::EXPIRED, entry.second.neighbor);
+  }
+  byLocalPort_.erase(it);
+}
+
+LinkNeighborDB::Subscription LinkNeighborDB::subscribe(Subscriber subscriber) {
+  lock_guard<mutex> guard(mutex_);
+  Subscription subscription;
+  subscription.id = nextSubscriptionID_++;
+  subscription.sequence = sequence_;
+  for (const auto& portEntry : byLocalPort_) {
+    for (const auto& entry : portEntry.second) {
+      subscription.neighbors.push_back(entry.second.neighbor);
+    }
+  }
+  subscribers_.emplace(subscription.id, std::move(subscriber));
+  return subscription;
+}
+
+void LinkNeighborDB::unsubscribe(SubscriptionID id) {
+  Subscriber subscriber;
+  {
+    lock_guard<mutex> guard(mutex_);
+    auto it = subscribers_.find(id);
+    if (it == subscribers_.end()) {
+      return;
+    }
+    subscriber = std::move(it->second);
+    subscribers_.erase(it);
+  }
+  // Destroy the subscriber without the lock held, whatever it owns may
+  // well call back into the DB (e.g. to unsubscribe) when destroyed
+}
+
+void LinkNeighborDB::publishLocked(
+    ChangeType type,
+    const LinkNeighbor& neighbor) {
+  Change change{type, ++sequence_, neighbor};
+  for (const auto& subscriber : subscribers_) {
+    subscriber.second(change);
+  }
 }
 
 void LinkNeighborDB::pruneLocked(steady_clock::time_point now) {
@@ -128,7 +216,8 @@ void LinkNeighborDB::pruneLocked(steady_clock::time_point now) {
     while (it != map.end()) {
       auto current = it;
       ++it;
-      if (current->second.isExpired(now)) {
+      if (current->second.neighbor.isExpired(now)) {
+        publishLocked(ChangeType::EXPIRED, current->second.neighbor);
         map.erase(current);
       }
     }
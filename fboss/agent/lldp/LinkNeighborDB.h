@@ -5,6 +5,7 @@
 #include "fboss/agent/types.h"
 
 #include <chrono>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -12,6 +13,7 @@
 namespace facebook::fboss {
 
 class LinkNeighbor;
+class LldpPduView;
 
 /*
  * LinkNeighborDB maintains information about known neighbors.
@@ -20,6 +22,35 @@ class LinkNeighbor;
  */
 class LinkNeighborDB {
  public:
+  enum class ChangeType {
+    ADDED,
+    // The neighbor now advertises different TLVs
+    CHANGED,
+    // The neighbor's TTL ran out, or its local port went down
+    EXPIRED,
+  };
+
+  struct Change {
+    ChangeType type;
+    // Increases by one with every change published by the DB
+    uint64_t sequence;
+    LinkNeighbor neighbor;
+  };
+
+  /*
+   * Subscribers are called with the DB lock held, in sequence order.
+   * They must return quickly and must not call back into the DB.
+   */
+  using Subscriber = std::function<void(const Change&)>;
+  using SubscriptionID = uint64_t;
+
+  struct Subscription {
+    SubscriptionID id;
+    // Sequence number of the last change included in neighbors
+    uint64_t sequence;
+    std::vector<LinkNeighbor> neighbors;
+  };
+
   LinkNeighborDB();
 
   /*
@@ -27,6 +58,20 @@ class LinkNeighborDB {
    */
   void update(const LinkNeighbor& neighbor);
 
+  /*
+   * Extend the lifetime of a known neighbor that sent the same TLVs again,
+   * without building a LinkNeighbor for it.
+   *
+   * Returns false if the PDU is from an unknown neighbor or carries new
+   * information, in which case the caller should update() the DB with the
+   * fully parsed neighbor.
+   */
+  bool refresh(
+      PortID port,
+      VlanID vlan,
+      folly::MacAddress srcMac,
+      const LldpPduView& pdu);
+
   /*
    * Get all known neighbors.
    *
@@ -48,6 +93,16 @@ class LinkNeighborDB {
   void pruneExpiredNeighbors(std::chrono::steady_clock::time_point now);
   void portDown(PortID port);
 
+  /*
+   * Get the known neighbors, and the changes after them as they happen.
+   *
+   * The returned snapshot and the changes passed to subscriber afterwards
+   * (starting at sequence + 1) never miss or repeat a change. Neighbors
+   * which are refreshed without changing their TLVs are not published.
+   */
+  Subscription subscribe(Subscriber subscriber);
+  void unsubscribe(SubscriptionID id);
+
  private:
   class NeighborKey {
    public:
@@ -61,16 +116,24 @@ class LinkNeighborDB {
     std::string chassisId_;
     std::string portId_;
   };
-  typedef std::map<NeighborKey, LinkNeighbor> NeighborMap;
+  struct NeighborEntry {
+    LinkNeighbor neighbor;
+    uint64_t fingerprint;
+  };
+  typedef std::map<NeighborKey, NeighborEntry> NeighborMap;
 
   // Forbidden copy constructor and assignment operator
   LinkNeighborDB(LinkNeighborDB const&) = delete;
   LinkNeighborDB& operator=(LinkNeighborDB const&) = delete;
 
   void pruneLocked(std::chrono::steady_clock::time_point now);
+  void publishLocked(ChangeType type, const LinkNeighbor& neighbor);
 
   std::mutex mutex_;
   std::map<PortID, NeighborMap> byLocalPort_;
+  uint64_t sequence_{0};
+  SubscriptionID nextSubscriptionID_{0};
+  std::map<SubscriptionID, Subscriber> subscribers_;
 };
 
 } // namespace facebook::fboss
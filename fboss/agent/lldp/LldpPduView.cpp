@@ -0,0 +1,108 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+#include "fboss/agent/lldp/LldpPduView.h"
+
+#include "fboss/agent/lldp/LinkNeighbor.h"
+
+#include <folly/io/Cursor.h>
+
+using folly::ByteRange;
+using folly::StringPiece;
+
+namespace {
+uint16_t readBE16(ByteRange buf) {
+  return (buf[0] << 8) | buf[1];
+}
+} // namespace
+
+namespace facebook::fboss {
+
+bool LldpPduView::parse(const folly::io::Cursor& cursor) {
+  *this = LldpPduView();
+  auto pdu = cursor.peekBytes();
+  if (pdu.size() != cursor.totalLength()) {
+    return false;
+  }
+
+  bool chassisIdPresent{false};
+  bool portIdPresent{false};
+  bool ttlPresent{false};
+  while (true) {
+    // Type (7 bits) and length (9 bits)
+    if (pdu.size() < 2) {
+      return false;
+    }
+    auto header = readBE16(pdu);
+    auto type = LldpTlvType(header >> 9);
+    size_t length = header & 0x01ff;
+    pdu.advance(2);
+    if (pdu.size() < length) {
+      return false;
+    }
+    auto value = pdu.subpiece(0, length);
+    pdu.advance(length);
+
+    switch (type) {
+      case LldpTlvType::PDU_END:
+        return chassisIdPresent && portIdPresent && ttlPresent;
+      case LldpTlvType::CHASSIS:
+        if (length < 1) {
+          return false;
+        }
+        chassisIdType_ = static_cast<LldpChassisIdType>(value[0]);
+        chassisId_ = StringPiece(value.subpiece(1));
+        chassisIdPresent = true;
+        break;
+      case LldpTlvType::PORT:
+        if (length < 1) {
+          return false;
+        }
+        portIdType_ = static_cast<LldpPortIdType>(value[0]);
+        portId_ = StringPiece(value.subpiece(1));
+        portIdPresent = true;
+        break;
+      case LldpTlvType::TTL:
+        if (length != 2) {
+          return false;
+        }
+        ttl_ = std::chrono::seconds(readBE16(value));
+        ttlPresent = true;
+        break;
+      case LldpTlvType::PORT_DESC:
+        portDescription_ = StringPiece(value);
+        break;
+      case LldpTlvType::SYSTEM_NAME:
+        systemName_ = StringPiece(value);
+        break;
+      case LldpTlvType::SYSTEM_DESCRIPTION:
+        systemDescription_ = StringPiece(value);
+        break;
+      case LldpTlvType::SYSTEM_CAPABILITY:
+        if (length != 4) {
+          return false;
+        }
+        capabilities_ = readBE16(value);
+        enabledCapabilities_ = readBE16(value.subpiece(2));
+        break;
+      default:
+        // Like LinkNeighbor::parseLldpPdu(), ignore any other TLV types
+        break;
+    }
+  }
+}
+
+uint64_t LldpPduView::getTlvFingerprint() const {
+  return LinkNeighbor::tlvFingerprint(
+      LinkProtocol::LLDP,
+      chassisIdType_,
+      chassisId_,
+      portIdType_,
+      portId_,
+      ttl_,
+      capabilities_,
+      enabledCapabilities_,
+      systemName_,
+      portDescription_,
+      systemDescription_);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,87 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+#pragma once
+
+#include "fboss/agent/lldp/Lldp.h"
+
+#include <folly/Range.h>
+#include <chrono>
+
+namespace folly {
+namespace io {
+class Cursor;
+}
+} // namespace folly
+
+namespace facebook::fboss {
+
+/*
+ * LldpPduView validates an LLDP PDU and fingerprints its TLVs in place.
+ *
+ * Unlike LinkNeighbor::parseLldpPdu() it copies nothing out of the packet:
+ * the string accessors point into the packet buffer, and are only valid as
+ * long as the packet is. This makes it cheap to tell whether a PDU carries
+ * anything new before building a LinkNeighbor out of it.
+ */
+class LldpPduView {
+ public:
+  /*
+   * Parse the LLDP PDU starting at the cursor, without moving it.
+   *
+   * Returns false if the PDU is malformed, is missing one of the mandatory
+   * chassis ID, port ID and TTL TLVs, or is not contiguous in memory. In the
+   * latter case LinkNeighbor::parseLldpPdu() may still be able to parse it.
+   */
+  bool parse(const folly::io::Cursor& cursor);
+
+  LldpChassisIdType getChassisIdType() const {
+    return chassisIdType_;
+  }
+  folly::StringPiece getChassisId() const {
+    return chassisId_;
+  }
+  LldpPortIdType getPortIdType() const {
+    return portIdType_;
+  }
+  folly::StringPiece getPortId() const {
+    return portId_;
+  }
+  std::chrono::seconds getTTL() const {
+    return ttl_;
+  }
+  uint16_t getCapabilities() const {
+    return capabilities_;
+  }
+  uint16_t getEnabledCapabilities() const {
+    return enabledCapabilities_;
+  }
+  folly::StringPiece getSystemName() const {
+    return systemName_;
+  }
+  folly::StringPiece getPortDescription() const {
+    return portDescription_;
+  }
+  folly::StringPiece getSystemDescription() const {
+    return systemDescription_;
+  }
+
+  /*
+   * Same as LinkNeighbor::getTlvFingerprint() for the neighbor
+   * LinkNeighbor::parseLldpPdu() would build from this PDU.
+   */
+  uint64_t getTlvFingerprint() const;
+
+ private:
+  LldpChassisIdType chassisIdType_{LldpChassisIdType::RESERVED};
+  LldpPortIdType portIdType_{LldpPortIdType::RESERVED};
+  uint16_t capabilities_{0};
+  uint16_t enabledCapabilities_{0};
+  std::chrono::seconds ttl_{0};
+
+  folly::StringPiece chassisId_;
+  folly::StringPiece portId_;
+  folly::StringPiece systemName_;
+  folly::StringPiece portDescription_;
+  folly::StringPiece systemDescription_;
+};
+
+} // namespace facebook::fboss
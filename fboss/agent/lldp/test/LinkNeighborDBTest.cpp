@@ -105,3 +105,96 @@ TEST(LinkNeighborDB, test) {
   ASSERT_EQ(1, neighbors.size());
   EXPECT_EQ("neighbor3 name", neighbors[0].getSystemName());
 }
+
+namespace {
+LinkNeighbor makeNeighbor(int port, const std::string& chassis) {
+  LinkNeighbor n;
+  n.setProtocol(LinkProtocol::LLDP);
+  n.setLocalPort(PortID(port));
+  n.setLocalVlan(VlanID(1));
+  n.setMac(MacAddress("00:11:22:33:44:55"));
+  n.setChassisId(chassis, LldpChassisIdType::LOCALLY_ASSIGNED);
+  n.setPortId("1/1", LldpPortIdType::LOCALLY_ASSIGNED);
+  n.setSystemName(chassis + " name");
+  n.setTTL(seconds(5));
+  return n;
+}
+} // namespace
+
+TEST(LinkNeighborDB, tlvFingerprint) {
+  auto n1 = makeNeighbor(1, "neighbor1");
+  auto refreshed = n1;
+  refreshed.setTTL(seconds(5), steady_clock::now() + seconds(60));
+  EXPECT_EQ(n1.getTlvFingerprint(), refreshed.getTlvFingerprint());
+
+  auto renamed = n1;
+  renamed.setSystemName("neighbor1 renamed");
+  EXPECT_NE(n1.getTlvFingerprint(), renamed.getTlvFingerprint());
+  auto recapped = n1;
+  recapped.setEnabledCapabilities(1 << 4);
+  EXPECT_NE(n1.getTlvFingerprint(), recapped.getTlvFingerprint());
+}
+
+TEST(LinkNeighborDB, subscribe) {
+  LinkNeighborDB db;
+  db.update(makeNeighbor(1, "neighbor1"));
+  db.update(makeNeighbor(2, "neighbor2"));
+
+  std::vector<LinkNeighborDB::Change> changes;
+  auto subscription = db.subscribe(
+      [&](const LinkNeighborDB::Change& change) { changes.push_back(change); });
+  // Snapshot first
+  EXPECT_EQ(2, subscription.neighbors.size());
+  EXPECT_EQ(2, subscription.sequence);
+  EXPECT_TRUE(changes.empty());
+
+  // Refreshing a neighbor without changing its TLVs publishes nothing
+  db.update(makeNeighbor(1, "neighbor1"));
+  EXPECT_TRUE(changes.empty());
+
+  auto changed = makeNeighbor(1, "neighbor1");
+  changed.setPortDescription("uplink");
+  db.update(changed);
+  db.update(makeNeighbor(3, "neighbor3"));
+  ASSERT_EQ(2, changes.size());
+  EXPECT_EQ(LinkNeighborDB::ChangeType::CHANGED, changes[0].type);
+  EXPECT_EQ(3, changes[0].sequence);
+  EXPECT_EQ("uplink", changes[0].neighbor.getPortDescription());
+  EXPECT_EQ(LinkNeighborDB::ChangeType::ADDED, changes[1].type);
+  EXPECT_EQ(4, changes[1].sequence);
+  EXPECT_EQ(PortID(3), changes[1].neighbor.getLocalPort());
+
+  // Expiring and port down both publish expired neighbors
+  db.portDown(PortID(2));
+  db.pruneExpiredNeighbors(steady_clock::now() + seconds(6));
+  ASSERT_EQ(5, changes.size());
+  EXPECT_EQ(LinkNeighborDB::ChangeType::EXPIRED, changes[2].type);
+  EXPECT_EQ(PortID(2), changes[2].neighbor.getLocalPort());
+  for (int i = 3; i < 5; ++i) {
+    EXPECT_EQ(LinkNeighborDB::ChangeType::EXPIRED, changes[i].type);
+    EXPECT_EQ(i + 3, changes[i].sequence);
+  }
+  EXPECT_TRUE(db.getNeighbors().empty());
+
+  db.unsubscribe(subscription.id);
+  db.update(makeNeighbor(1, "neighbor1"));
+  EXPECT_EQ(5, changes.size());
+}
+
+TEST(LinkNeighborDB, snapshotThenDelta) {
+  LinkNeighborDB db;
+  db.update(makeNeighbor(1, "neighbor1"));
+  auto first = db.subscribe([](const LinkNeighborDB::Change&) {});
+
+  db.update(makeNeighbor(2, "neighbor2"));
+  std::vector<LinkNeighborDB::Change> changes;
+  auto second = db.subscribe(
+      [&](const LinkNeighborDB::Change& change) { changes.push_back(change); });
+  EXPECT_NE(first.id, second.id);
+  EXPECT_EQ(first.sequence + 1, second.sequence);
+  EXPECT_EQ(2, second.neighbors.size());
+
+  db.update(makeNeighbor(3, "neighbor3"));
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(second.sequence + 1, changes[0].sequence);
+}
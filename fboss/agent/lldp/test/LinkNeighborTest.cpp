@@ -1,5 +1,7 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 #include "fboss/agent/lldp/LinkNeighbor.h"
+#include "fboss/agent/lldp/LinkNeighborDB.h"
+#include "fboss/agent/lldp/LldpPduView.h"
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include "fboss/agent/packet/PktUtil.h"
@@ -115,6 +117,56 @@ TEST(LinkNeighbor, badTlvLength) {
   EXPECT_FALSE(ret);
 }
 
+TEST(LinkNeighbor, lldpPduView) {
+  IOBuf iob(IOBuf::WRAP_BUFFER, basicLldpPacket, sizeof(basicLldpPacket));
+  Cursor cursor(&iob);
+  cursor.skip(12);
+  uint16_t ethertype = cursor.readBE<uint16_t>();
+  MacAddress srcMac("2c:54:2d:f5:89:3e");
+
+  LldpPduView view;
+  ASSERT_TRUE(view.parse(cursor));
+  EXPECT_EQ(LldpChassisIdType::MAC_ADDRESS, view.getChassisIdType());
+  EXPECT_EQ("\x2c\x54\x2d\xf5\x89\x3e", view.getChassisId());
+  EXPECT_EQ(LldpPortIdType::INTERFACE_NAME, view.getPortIdType());
+  EXPECT_EQ("Ethernet1/23", view.getPortId());
+  EXPECT_EQ(seconds(120), view.getTTL());
+  EXPECT_EQ(0x0014, view.getCapabilities());
+  EXPECT_EQ(0x0014, view.getEnabledCapabilities());
+  EXPECT_EQ("rsw1br.07.prn2.facebook.com.facebook.com", view.getSystemName());
+  EXPECT_EQ("SERVERS", view.getPortDescription());
+
+  // The view leaves the cursor alone, so the full parse can follow it
+  LinkNeighbor info;
+  ASSERT_TRUE(
+      info.parseLldpPdu(PortID(1), VlanID(1), srcMac, ethertype, &cursor));
+  EXPECT_EQ(info.getTlvFingerprint(), view.getTlvFingerprint());
+
+  LinkNeighborDB db;
+  EXPECT_FALSE(db.refresh(PortID(1), VlanID(1), srcMac, view));
+  db.update(info);
+  EXPECT_TRUE(db.refresh(PortID(1), VlanID(1), srcMac, view));
+  EXPECT_FALSE(db.refresh(PortID(2), VlanID(1), srcMac, view));
+  EXPECT_FALSE(db.refresh(PortID(1), VlanID(2), srcMac, view));
+  EXPECT_FALSE(
+      db.refresh(PortID(1), VlanID(1), MacAddress("02:00:00:00:00:01"), view));
+}
+
+TEST(LinkNeighbor, lldpPduViewBadTlvLength) {
+  IOBuf iob(IOBuf::WRAP_BUFFER, badLldpPacket, sizeof(badLldpPacket));
+  Cursor cursor(&iob);
+  cursor.skip(14);
+
+  LldpPduView view;
+  EXPECT_FALSE(view.parse(cursor));
+
+  // Truncated in the middle of the first TLV header
+  IOBuf truncated(IOBuf::WRAP_BUFFER, basicLldpPacket, 15);
+  Cursor truncatedCursor(&truncated);
+  truncatedCursor.skip(14);
+  EXPECT_FALSE(view.parse(truncatedCursor));
+}
+
 const uint8_t basicCdpPacket[] = {
     0x01, 0x00, 0x0c, 0xcc, 0xcc, 0xcc, 0x2c, 0x54, 0x2d, 0xf5, 0x89, 0x3e,
     0x01, 0x27, 0xaa, 0xaa, 0x03, 0x00, 0x00, 0x0c, 0x20, 0x00, 0x02, 0xb4,
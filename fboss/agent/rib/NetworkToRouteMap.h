@@ -16,6 +16,7 @@
 #include <folly/dynamic.h>
 
 #include <memory>
+#include <vector>
 
 namespace facebook::fboss::rib {
 
@@ -23,6 +24,7 @@ template <typename AddressT>
 class NetworkToRouteMap
     : public facebook::network::RadixTree<AddressT, Route<AddressT>> {
   static constexpr auto kRoutes = "routes";
+  using Base = facebook::network::RadixTree<AddressT, Route<AddressT>>;
 
  public:
   folly::dynamic toFollyDynamic() const {
@@ -39,12 +41,16 @@ class NetworkToRouteMap
       const folly::dynamic& routes) {
     NetworkToRouteMap<AddressT> networkToRouteMap;
 
-    auto routesJson = routes[kRoutes];
+    // Routes are serialized in tree order, so the tree can be bulk loaded
+    const auto& routesJson = routes[kRoutes];
+    std::vector<typename Base::BulkLoadEntry> entries;
+    entries.reserve(routesJson.size());
     for (const auto& routeJson : routesJson) {
       auto route = Route<AddressT>::fromFollyDynamic(routeJson);
       RoutePrefix<AddressT> prefix = route.prefix();
-      networkToRouteMap.insert(prefix.network, prefix.mask, std::move(route));
+      entries.push_back({prefix.network, prefix.mask, std::move(route)});
     }
+    networkToRouteMap.bulkLoad(std::move(entries));
 
     return networkToRouteMap;
   }
@@ -44,6 +44,19 @@ class Route {
     }
     nexthopsmulti.update(clientId, entry);
   }
+  /*
+   * Rebuild a route from its parts, e.g. when converting from the SwitchState
+   * route representation. flags uses the same bits as serialization.
+   */
+  Route(
+      const Prefix& prefix,
+      RouteNextHopsMulti nexthops,
+      RouteNextHopEntry forwardInfo,
+      uint32_t routeFlags)
+      : flags(routeFlags),
+        fwd(std::move(forwardInfo)),
+        prefix_(prefix),
+        nexthopsmulti(std::move(nexthops)) {}
 
   static Route<AddrT> fromFollyDynamic(const folly::dynamic& json);
 
@@ -95,6 +108,12 @@ class Route {
   bool hasNoEntry() const {
     return nexthopsmulti.isEmpty();
   }
+  const RouteNextHopsMulti& getNextHopsMulti() const {
+    return nexthopsmulti;
+  }
+  uint32_t getFlags() const {
+    return flags;
+  }
 
   bool has(ClientID clientId, const RouteNextHopEntry& entry) const;
 
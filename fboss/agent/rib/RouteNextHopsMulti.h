@@ -65,6 +65,12 @@ class RouteNextHopsMulti {
     return map_ == p2.map_;
   }
 
+  // All the entries, in client ID order
+  const boost::container::flat_map<ClientID, RouteNextHopEntry>& getAllEntries()
+      const {
+    return map_;
+  }
+
   bool isEmpty() const {
     // The code disallows adding/updating an empty nextHops list. So if the
     // map contains any entries, they are non-zero-length lists.
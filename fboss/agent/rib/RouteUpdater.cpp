@@ -10,6 +10,7 @@
 
 #include "RouteUpdater.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include <boost/container/flat_map.hpp>
@@ -92,6 +93,83 @@ void RouteUpdater::addInterfaceRoute(
   addRoute(network, mask, ClientID::INTERFACE_ROUTE, nextHop);
 }
 
+template <typename AddressT>
+void RouteUpdater::addRoutesImpl(
+    std::vector<std::pair<Prefix<AddressT>, RouteNextHopEntry>> toAdd,
+    NetworkToRouteMap<AddressT>* routes,
+    ClientID clientID) {
+  if (toAdd.size() <= routes->size()) {
+    for (auto& route : toAdd) {
+      addRouteImpl(route.first, routes, clientID, std::move(route.second));
+    }
+    return;
+  }
+
+  // Merge the new routes into the existing ones, both in tree order, and
+  // rebuild the tree from the result rather than descending it for each
+  // new prefix.
+  auto inTreeOrder = [](const Prefix<AddressT>& a, const Prefix<AddressT>& b) {
+    return a.network < b.network || (a.network == b.network && a.mask < b.mask);
+  };
+  auto byPrefix = [&inTreeOrder](const auto& a, const auto& b) {
+    return inTreeOrder(a.first, b.first);
+  };
+  if (!std::is_sorted(toAdd.begin(), toAdd.end(), byPrefix)) {
+    // Stable, so that the last of duplicate prefixes still wins
+    std::stable_sort(toAdd.begin(), toAdd.end(), byPrefix);
+  }
+  std::vector<typename NetworkToRouteMap<AddressT>::BulkLoadEntry> entries;
+  entries.reserve(routes->size() + toAdd.size());
+  auto addEntry = [&entries, clientID](
+                      const Prefix<AddressT>& prefix,
+                      RouteNextHopEntry entry) {
+    if (!entries.empty() && entries.back().ipAddress == prefix.network &&
+        entries.back().masklen == prefix.mask) {
+      entries.back().value.update(clientID, std::move(entry));
+      return;
+    }
+    entries.push_back({prefix.network,
+                       prefix.mask,
+                       Route<AddressT>(prefix, clientID, std::move(entry))});
+  };
+  auto next = toAdd.begin();
+  for (auto& node : *routes) {
+    Prefix<AddressT> prefix{node.ipAddress(), node.masklen()};
+    for (; next != toAdd.end() && inTreeOrder(next->first, prefix); ++next) {
+      addEntry(next->first, std::move(next->second));
+    }
+    entries.push_back({prefix.network, prefix.mask, std::move(node.value())});
+  }
+  for (; next != toAdd.end(); ++next) {
+    addEntry(next->first, std::move(next->second));
+  }
+  routes->clear();
+  routes->bulkLoad(std::move(entries));
+}
+
+void RouteUpdater::addRoutes(
+    ClientID clientID,
+    std::vector<RouteToAdd> routes) {
+  std::vector<std::pair<PrefixV4, RouteNextHopEntry>> v4Routes;
+  std::vector<std::pair<PrefixV6, RouteNextHopEntry>> v6Routes;
+  for (auto& route : routes) {
+    if (route.network.isV4()) {
+      PrefixV4 prefix{route.network.asV4().mask(route.mask), route.mask};
+      v4Routes.emplace_back(prefix, std::move(route.entry));
+    } else {
+      PrefixV6 prefix{route.network.asV6().mask(route.mask), route.mask};
+      if (prefix.network.isLinkLocal()) {
+        XLOG(DBG2) << "Ignoring v6 link-local interface route: "
+                   << prefix.str();
+        continue;
+      }
+      v6Routes.emplace_back(prefix, std::move(route.entry));
+    }
+  }
+  addRoutesImpl(std::move(v4Routes), v4Routes_, clientID);
+  addRoutesImpl(std::move(v6Routes), v6Routes_, clientID);
+}
+
 void RouteUpdater::addLinkLocalRoutes() {
   // 169.254/16 is treated as link-local only by convention. Like other vendors,
   // we choose to route 169.254/16.
@@ -20,6 +20,9 @@
 
 #include <folly/IPAddress.h>
 
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss::rib {
 
 /**
@@ -57,6 +60,19 @@ class RouteUpdater {
       uint8_t mask,
       ClientID clientID,
       RouteNextHopEntry entry);
+
+  struct RouteToAdd {
+    folly::IPAddress network;
+    uint8_t mask;
+    RouteNextHopEntry entry;
+  };
+  /*
+   * Same as addRoute() for each of routes. When routes outnumber the routes
+   * of a table, e.g. on the sync of a full table after config applied the
+   * interface routes, the table is instead rebuilt in a single pass from the
+   * existing routes merged with the new ones (see RadixTree::bulkLoad).
+   */
+  void addRoutes(ClientID clientID, std::vector<RouteToAdd> routes);
   void addLinkLocalRoutes();
   void addInterfaceRoute(
       const folly::IPAddress& network,
@@ -88,6 +104,11 @@ class RouteUpdater {
       ClientID clientID,
       RouteNextHopEntry entry);
   template <typename AddressT>
+  void addRoutesImpl(
+      std::vector<std::pair<Prefix<AddressT>, RouteNextHopEntry>> toAdd,
+      NetworkToRouteMap<AddressT>* routes,
+      ClientID clientID);
+  template <typename AddressT>
   void delRouteImpl(
       const Prefix<AddressT>& prefix,
       NetworkToRouteMap<AddressT>* routes,
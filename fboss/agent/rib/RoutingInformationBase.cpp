@@ -131,6 +131,8 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
     updater.removeAllRoutesForClient(clientID);
   }
 
+  std::vector<RouteUpdater::RouteToAdd> routesToAdd;
+  routesToAdd.reserve(toAdd.size());
   for (const auto& route : toAdd) {
     auto network = facebook::network::toIPAddress(route.dest.ip);
     auto mask = static_cast<uint8_t>(route.dest.prefixLength);
@@ -141,12 +143,12 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
       ++stats.v6RoutesAdded;
     }
 
-    updater.addRoute(
-        network,
-        mask,
-        clientID,
-        RouteNextHopEntry::from(route, adminDistanceFromClientID));
+    routesToAdd.push_back(
+        {network,
+         mask,
+         RouteNextHopEntry::from(route, adminDistanceFromClientID)});
   }
+  updater.addRoutes(clientID, std::move(routesToAdd));
 
   for (const auto& prefix : toDelete) {
     auto network = facebook::network::toIPAddress(prefix.ip);
@@ -212,6 +214,16 @@ void RoutingInformationBase::createVrf(RouterID rid) {
   lockedRouteTables->insert(std::make_pair(rid, RouteTable()));
 }
 
+void RoutingInformationBase::setVrfRoutes(
+    RouterID rid,
+    IPv4NetworkToRouteMap v4NetworkToRoute,
+    IPv6NetworkToRouteMap v6NetworkToRoute) {
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  (*lockedRouteTables)[rid] = RouteTable{std::move(v4NetworkToRoute),
+                                         std::move(v6NetworkToRoute),
+                                         UpdateStatistics{}};
+}
+
 std::vector<RouterID> RoutingInformationBase::getVrfList() const {
   auto lockedRouteTables = synchronizedRouteTables_.rlock();
   std::vector<RouterID> res(lockedRouteTables->size());
@@ -92,6 +92,29 @@ class RoutingInformationBase {
   static RoutingInformationBase fromFollyDynamic(const folly::dynamic& ribJson);
 
   void createVrf(RouterID rid);
+  /*
+   * Replace all the routes of a VRF, creating it if needed. Lets callers
+   * which already have the routes in hand, e.g. when converting from
+   * SwitchState, skip going through folly::dynamic.
+   */
+  void setVrfRoutes(
+      RouterID rid,
+      IPv4NetworkToRouteMap v4NetworkToRoute,
+      IPv6NetworkToRouteMap v6NetworkToRoute);
+  /*
+   * Call fn(RouterID, const IPv4NetworkToRouteMap&, const
+   * IPv6NetworkToRouteMap&) for each VRF, in RouterID order, while holding
+   * the RIB's read lock.
+   */
+  template <typename Fn>
+  void forEachVrf(Fn fn) const {
+    auto lockedRouteTables = synchronizedRouteTables_.rlock();
+    for (const auto& routeTable : *lockedRouteTables) {
+      fn(routeTable.first,
+         routeTable.second.v4NetworkToRoute,
+         routeTable.second.v6NetworkToRoute);
+    }
+  }
   std::vector<RouterID> getVrfList() const;
   std::vector<RouteDetails> getRouteTableDetails(RouterID rid) const;
 
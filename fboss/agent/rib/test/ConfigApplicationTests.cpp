@@ -8,8 +8,11 @@
  *
  */
 
+#include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/NetworkToRouteMap.h"
 #include "fboss/agent/rib/RouteTypes.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/ForwardingInformationBase.h"
@@ -19,6 +22,8 @@
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/Conv.h>
+
 #include <memory>
 #include <utility>
 
@@ -354,3 +359,71 @@ TEST(ConfigApplication, MultiVrfColdBoot) {
   fibContainer = fibMap->getFibContainer(RouterID(1));
   EXPECT_NE(nullptr, fibContainer);
 }
+
+TEST(ConfigApplication, SyncAfterConfigMergesIntoInterfaceRoutes) {
+  rib::RoutingInformationBase rib;
+
+  auto emptyState = std::make_shared<SwitchState>();
+  auto platform = createMockPlatform();
+  auto config = interfaceRoutesConfig();
+
+  auto state = publishAndApplyConfig(emptyState, &config, platform.get(), &rib);
+  ASSERT_NE(nullptr, state);
+  auto numConfigRoutes = rib.getRouteTableDetails(RouterID(0)).size();
+
+  // More routes than config added, so that the table gets rebuilt
+  std::vector<UnicastRoute> toAdd;
+  auto addRoute = [&toAdd](const std::string& network, uint8_t mask) {
+    UnicastRoute route;
+    IpPrefix prefix;
+    prefix.set_ip(
+        facebook::network::toBinaryAddress(folly::IPAddress(network)));
+    prefix.set_prefixLength(mask);
+    route.set_dest(prefix);
+    std::vector<NextHopThrift> nextHops(1);
+    nextHops.back().set_address(
+        facebook::network::toBinaryAddress(folly::IPAddress("1.1.1.10")));
+    route.set_nextHops(std::move(nextHops));
+    toAdd.push_back(std::move(route));
+  };
+  for (int i = 99; i >= 0; --i) {
+    addRoute(folly::to<std::string>("10.0.", i, ".0"), 24);
+  }
+  // Same prefix as an interface route
+  addRoute("1.1.1.0", 24);
+
+  bool checked = false;
+  rib.update(
+      RouterID(0),
+      ClientID::BGPD,
+      AdminDistance::EBGP,
+      toAdd,
+      {},
+      false,
+      "sync after config",
+      [&checked](
+          RouterID /*vrf*/,
+          const rib::IPv4NetworkToRouteMap& v4NetworkToRoute,
+          const rib::IPv6NetworkToRouteMap& /*v6NetworkToRoute*/,
+          void* /*cookie*/) {
+        EXPECT_TRUE(v4NetworkToRoute.equalsIncrementalInsertion());
+        auto interfaceRoute =
+            v4NetworkToRoute.exactMatch(folly::IPAddressV4("1.1.1.0"), 24);
+        ASSERT_NE(interfaceRoute, v4NetworkToRoute.end());
+        EXPECT_NE(
+            interfaceRoute->value().getEntryForClient(
+                ClientID::INTERFACE_ROUTE),
+            nullptr);
+        EXPECT_NE(
+            interfaceRoute->value().getEntryForClient(ClientID::BGPD), nullptr);
+        auto route =
+            v4NetworkToRoute.exactMatch(folly::IPAddressV4("10.0.42.0"), 24);
+        ASSERT_NE(route, v4NetworkToRoute.end());
+        EXPECT_TRUE(route->value().isResolved());
+        checked = true;
+      },
+      nullptr);
+  EXPECT_TRUE(checked);
+  EXPECT_EQ(
+      rib.getRouteTableDetails(RouterID(0)).size(), numConfigRoutes + 100);
+}
@@ -104,6 +104,10 @@ class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
    * Serialize to a folly::dynamic object
    */
   folly::dynamic toFollyDynamic() const override;
+  // Serialized as a plain array rather than the NodeMap format
+  void writeJson(JsonStreamWriter& writer) const override {
+    writer.value(toFollyDynamic());
+  }
   /*
    * Deserialize from a folly::dynamic object
    */
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/JsonStreamWriter.h"
+
+#include "fboss/agent/SysError.h"
+
+#include <folly/FileUtil.h>
+#include <glog/logging.h>
+
+namespace facebook::fboss {
+
+JsonStreamWriter::JsonStreamWriter(int fd, bool pretty, size_t bufferSize)
+    : fd_(fd), pretty_(pretty), bufferSize_(bufferSize), out_(&buffer_) {
+  buffer_.reserve(bufferSize_);
+}
+
+JsonStreamWriter::JsonStreamWriter(std::string* out, bool pretty)
+    : pretty_(pretty), out_(out) {}
+
+void JsonStreamWriter::beginObject() {
+  beginValue();
+  out_->push_back('{');
+  scopes_.push_back({true});
+}
+
+void JsonStreamWriter::endObject() {
+  CHECK(!scopes_.empty() && scopes_.back().isObject && !expectValue_);
+  auto empty = scopes_.back().empty;
+  scopes_.pop_back();
+  if (!empty) {
+    newline();
+  }
+  out_->push_back('}');
+  maybeFlush();
+}
+
+void JsonStreamWriter::beginArray() {
+  beginValue();
+  out_->push_back('[');
+  scopes_.push_back({false});
+}
+
+void JsonStreamWriter::endArray() {
+  CHECK(!scopes_.empty() && !scopes_.back().isObject);
+  auto empty = scopes_.back().empty;
+  scopes_.pop_back();
+  if (!empty) {
+    newline();
+  }
+  out_->push_back(']');
+  maybeFlush();
+}
+
+void JsonStreamWriter::key(folly::StringPiece key) {
+  CHECK(!scopes_.empty() && scopes_.back().isObject && !expectValue_);
+  auto& scope = scopes_.back();
+  if (!scope.empty) {
+    out_->push_back(',');
+  }
+  scope.empty = false;
+  newline();
+  folly::json::escapeString(key, *out_, opts_);
+  out_->append(pretty_ ? ": " : ":");
+  expectValue_ = true;
+}
+
+void JsonStreamWriter::value(const folly::dynamic& value) {
+  if (value.isObject()) {
+    beginObject();
+    for (const auto& item : value.items()) {
+      if (item.first.isString()) {
+        key(item.first.stringPiece());
+      } else {
+        key(item.first.asString());
+      }
+      this->value(item.second);
+    }
+    endObject();
+  } else if (value.isArray()) {
+    beginArray();
+    for (const auto& element : value) {
+      this->value(element);
+    }
+    endArray();
+  } else {
+    beginValue();
+    out_->append(folly::json::serialize(value, opts_));
+    maybeFlush();
+  }
+}
+
+void JsonStreamWriter::flush() {
+  if (fd_ < 0 || buffer_.empty()) {
+    return;
+  }
+  if (folly::writeFull(fd_, buffer_.data(), buffer_.size()) < 0) {
+    throw SysError(errno, "Failed to write JSON");
+  }
+  buffer_.clear();
+}
+
+void JsonStreamWriter::beginValue() {
+  if (expectValue_) {
+    expectValue_ = false;
+    return;
+  }
+  if (scopes_.empty()) {
+    return;
+  }
+  auto& scope = scopes_.back();
+  CHECK(!scope.isObject) << "Object members must start with a key";
+  if (!scope.empty) {
+    out_->push_back(',');
+  }
+  scope.empty = false;
+  newline();
+}
+
+void JsonStreamWriter::newline() {
+  if (pretty_) {
+    out_->push_back('\n');
+    out_->append(2 * scopes_.size(), ' ');
+  }
+}
+
+void JsonStreamWriter::maybeFlush() {
+  if (fd_ >= 0 && buffer_.size() >= bufferSize_) {
+    flush();
+  }
+}
+
+} // namespace facebook::fboss
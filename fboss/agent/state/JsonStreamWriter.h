@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Incremental JSON writer, used to serialize state trees which are too large
+ * to comfortably build as a single folly::dynamic (e.g. when dumping the
+ * SwitchState on a crash).
+ *
+ * Callers emit the document structure through begin/end calls and keys, and
+ * leaves as folly::dynamic values. When writing to a file descriptor, output
+ * is buffered and flushed whenever the buffer grows past bufferSize bytes, so
+ * memory use is bounded by the largest leaf rather than the whole document.
+ * Write errors throw SysError.
+ */
+class JsonStreamWriter {
+ public:
+  static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+  explicit JsonStreamWriter(
+      int fd,
+      bool pretty = true,
+      size_t bufferSize = kDefaultBufferSize);
+  // Append the serialized JSON to out
+  explicit JsonStreamWriter(std::string* out, bool pretty = false);
+
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+
+  // Key of the next object member, which must be followed by its value
+  void key(folly::StringPiece key);
+  void value(const folly::dynamic& value);
+
+  template <typename T>
+  void member(folly::StringPiece name, T&& val) {
+    key(name);
+    value(folly::dynamic(std::forward<T>(val)));
+  }
+
+  // Write out anything buffered. A no-op when appending to a string.
+  void flush();
+
+ private:
+  struct Scope {
+    bool isObject;
+    bool empty{true};
+  };
+
+  void beginValue();
+  void newline();
+  void maybeFlush();
+
+  int fd_{-1};
+  bool pretty_;
+  size_t bufferSize_{0};
+  std::string buffer_;
+  std::string* out_;
+  bool expectValue_{false};
+  std::vector<Scope> scopes_;
+  folly::json::serialization_opts opts_;
+};
+
+} // namespace facebook::fboss
@@ -34,6 +34,10 @@ class LoadBalancerMap
   void addLoadBalancer(std::shared_ptr<LoadBalancer> loadBalancer);
 
   folly::dynamic toFollyDynamic() const override;
+  // Serialized as a plain array rather than the NodeMap format
+  void writeJson(JsonStreamWriter& writer) const override {
+    writer.value(toFollyDynamic());
+  }
   static std::shared_ptr<LoadBalancerMap> fromFollyDynamic(
       const folly::dynamic& serializedLoadBalancers);
 
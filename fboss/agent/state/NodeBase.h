@@ -10,6 +10,7 @@
 #pragma once
 
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/state/JsonStreamWriter.h"
 #include "fboss/agent/types.h"
 
 #include <boost/cast.hpp>
@@ -214,6 +215,15 @@ class NodeBaseT : public NodeBase {
    */
   virtual folly::dynamic toFollyDynamic() const = 0;
 
+  /*
+   * Serialize to JSON through writer, producing the same document as
+   * toFollyDynamic(). Nodes with large numbers of children override this to
+   * write their children one at a time.
+   */
+  virtual void writeJson(JsonStreamWriter& writer) const {
+    writer.value(toFollyDynamic());
+  }
+
   /*
    * Serialize to JSON
    * Generate folly::dynamic toFollyDynamic if
@@ -113,6 +113,20 @@ folly::dynamic NodeMapT<MapTypeT, TraitsT>::toFollyDynamic() const {
   return json;
 }
 
+template <typename MapTypeT, typename TraitsT>
+void NodeMapT<MapTypeT, TraitsT>::writeJson(JsonStreamWriter& writer) const {
+  writer.beginObject();
+  writer.key(kEntries);
+  writer.beginArray();
+  for (const auto& node : *this) {
+    node->writeJson(writer);
+  }
+  writer.endArray();
+  writer.key(kExtraFields);
+  writer.value(getExtraFields().toFollyDynamic());
+  writer.endObject();
+}
+
 template <typename MapTypeT, typename TraitsT>
 std::shared_ptr<MapTypeT> NodeMapT<MapTypeT, TraitsT>::fromFollyDynamic(
     const folly::dynamic& nodesJson) {
@@ -139,6 +139,11 @@ class NodeMapT : public NodeBaseT<MapTypeT, NodeMapFields<TraitsT>> {
    */
   folly::dynamic toFollyDynamic() const override;
 
+  /*
+   * Serialize to JSON one node at a time
+   */
+  void writeJson(JsonStreamWriter& writer) const override;
+
   /*
    * Serialize to json string
    */
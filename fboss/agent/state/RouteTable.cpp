@@ -32,6 +32,16 @@ folly::dynamic RouteTableFields::toFollyDynamic() const {
   return rtable;
 }
 
+void RouteTableFields::writeJson(JsonStreamWriter& writer) const {
+  writer.beginObject();
+  writer.member(kRouterId, static_cast<uint32_t>(id));
+  writer.key(kRibV4);
+  ribV4->writeJson(writer);
+  writer.key(kRibV6);
+  ribV6->writeJson(writer);
+  writer.endObject();
+}
+
 RouteTable* RouteTable::modify(std::shared_ptr<SwitchState>* state) {
   if (!isPublished()) {
     return this;
@@ -32,6 +32,7 @@ struct RouteTableFields {
    * Serialize to folly::dynamic
    */
   folly::dynamic toFollyDynamic() const;
+  void writeJson(JsonStreamWriter& writer) const;
   /*
    * Deserialize from folly::dynamic
    */
@@ -65,6 +66,9 @@ class RouteTable : public NodeBaseT<RouteTable, RouteTableFields> {
   folly::dynamic toFollyDynamic() const override {
     return this->getFields()->toFollyDynamic();
   }
+  void writeJson(JsonStreamWriter& writer) const override {
+    getFields()->writeJson(writer);
+  }
 
   RouterID getID() const {
     return getFields()->id;
@@ -56,6 +56,18 @@ folly::dynamic RouteTableRib<AddrT>::toFollyDynamic() const {
   return routes;
 }
 
+template <typename AddrT>
+void RouteTableRib<AddrT>::writeJson(JsonStreamWriter& writer) const {
+  writer.beginObject();
+  writer.key(kRoutes);
+  writer.beginArray();
+  for (const auto& route : *nodeMap_) {
+    route->writeJson(writer);
+  }
+  writer.endArray();
+  writer.endObject();
+}
+
 template <typename AddrT>
 std::shared_ptr<RouteTableRib<AddrT>> RouteTableRib<AddrT>::fromFollyDynamic(
     const folly::dynamic& routes) {
@@ -126,6 +126,11 @@ class RouteTableRib : public NodeBase {
    */
   folly::dynamic toFollyDynamic() const;
 
+  /*
+   * Serialize to JSON one route at a time
+   */
+  void writeJson(JsonStreamWriter& writer) const;
+
   /*
    * Deserialize from folly::dynamic
    */
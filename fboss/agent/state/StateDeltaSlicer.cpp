@@ -0,0 +1,285 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/StateDeltaSlicer.h"
+
+#include "fboss/agent/state/DeltaFunctions.h"
+#include "fboss/agent/state/RouteDelta.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/VlanMapDelta.h"
+
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+namespace facebook::fboss {
+
+namespace {
+
+template <typename AddrT>
+size_t countRouteChanges(const RouteTablesDelta& routeDelta, size_t limit) {
+  size_t count = 0;
+  auto countChange = [&count, limit](const auto&...) {
+    return ++count > limit ? LoopAction::BREAK : LoopAction::CONTINUE;
+  };
+  DeltaFunctions::forEachChanged(
+      routeDelta.getRoutesDelta<AddrT>(), countChange, countChange, countChange);
+  return count;
+}
+
+size_t countRouteChanges(const StateDelta& delta, size_t limit) {
+  size_t count = 0;
+  for (const auto& routeDelta : delta.getRouteTablesDelta()) {
+    count += countRouteChanges<folly::IPAddressV4>(routeDelta, limit - count);
+    if (count > limit) {
+      break;
+    }
+    count += countRouteChanges<folly::IPAddressV6>(routeDelta, limit - count);
+    if (count > limit) {
+      break;
+    }
+  }
+  return count;
+}
+
+template <typename NTableT>
+bool removesNeighbors(const VlanDelta& vlanDelta) {
+  auto removed = [](const auto&) { return LoopAction::BREAK; };
+  return DeltaFunctions::forEachRemoved(
+             vlanDelta.getNeighborDelta<NTableT>(), removed) ==
+      LoopAction::BREAK;
+}
+
+/*
+ * Whether delta removes interfaces, vlans or neighbors routes may resolve
+ * through. The hardware needs routes removed before what they point to,
+ * while a slice takes everything but routes from the new state.
+ */
+bool removesRouteDependencies(const StateDelta& delta) {
+  auto removed = [](const auto&) { return LoopAction::BREAK; };
+  if (DeltaFunctions::forEachRemoved(delta.getIntfsDelta(), removed) ==
+      LoopAction::BREAK) {
+    return true;
+  }
+  for (const auto& vlanDelta : delta.getVlansDelta()) {
+    if (!vlanDelta.getNew() || removesNeighbors<ArpTable>(vlanDelta) ||
+        removesNeighbors<NdpTable>(vlanDelta)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename AddrT>
+RoutePrefix<AddrT> toRoutePrefix(const folly::CIDRNetwork& prefix) {
+  if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+    return RoutePrefix<AddrT>{prefix.first.asV4(), prefix.second};
+  } else {
+    return RoutePrefix<AddrT>{prefix.first.asV6(), prefix.second};
+  }
+}
+
+template <typename AddrT>
+folly::CIDRNetwork toCIDRNetwork(const RoutePrefix<AddrT>& prefix) {
+  return folly::CIDRNetwork{folly::IPAddress(prefix.network), prefix.mask};
+}
+
+template <typename AddrT>
+typename RouteTableRibNodeMap<AddrT>::Iterator lowerBound(
+    const RouteTableRibNodeMap<AddrT>* routes,
+    const RoutePrefix<AddrT>& prefix) {
+  return typename RouteTableRibNodeMap<AddrT>::Iterator(
+      routes->getAllNodes().lower_bound(prefix));
+}
+
+/*
+ * First change of routesDelta at or after prefix. Like
+ * NodeMapDelta::begin(), a missing map is walked as an empty one.
+ */
+template <typename AddrT>
+typename RouteTablesDelta::RoutesDeltaT<AddrT>::Iterator changesFrom(
+    const RouteTablesDelta::RoutesDeltaT<AddrT>& routesDelta,
+    const RoutePrefix<AddrT>& prefix) {
+  using Iterator = typename RouteTablesDelta::RoutesDeltaT<AddrT>::Iterator;
+  auto oldRoutes = routesDelta.getOld();
+  auto newRoutes = routesDelta.getNew();
+  if (!oldRoutes) {
+    return Iterator(
+        newRoutes, newRoutes->end(), newRoutes, lowerBound(newRoutes, prefix));
+  }
+  if (!newRoutes) {
+    return Iterator(
+        oldRoutes, lowerBound(oldRoutes, prefix), oldRoutes, oldRoutes->end());
+  }
+  return Iterator(
+      oldRoutes,
+      lowerBound(oldRoutes, prefix),
+      newRoutes,
+      lowerBound(newRoutes, prefix));
+}
+
+/*
+ * Apply the AddrT route changes of routeDelta to table, starting at from if
+ * set, until *budget runs out. Returns the prefix of the first change left,
+ * if any.
+ */
+template <typename AddrT>
+std::optional<RoutePrefix<AddrT>> applyRouteChanges(
+    const RouteTablesDelta& routeDelta,
+    const std::optional<RoutePrefix<AddrT>>& from,
+    RouteTable* table,
+    size_t* budget) {
+  auto routesDelta = routeDelta.getRoutesDelta<AddrT>();
+  auto it = from ? changesFrom<AddrT>(routesDelta, *from) : routesDelta.begin();
+  if (it == routesDelta.end()) {
+    return std::nullopt;
+  }
+  auto prefixOf = [](const auto& change) {
+    return (change.getOld() ? change.getOld() : change.getNew())->prefix();
+  };
+  if (*budget == 0) {
+    return prefixOf(*it);
+  }
+
+  // The clone shares the routes of the old rib, and its radix tree is a
+  // structural copy of the old one, which is in sync since the old rib is
+  // published. Neither needs any lookup.
+  const auto& oldRib = table->getRib<AddrT>();
+  auto rib = oldRib->clone();
+  rib->writableRoutesRadixTree() = oldRib->routesRadixTree().clone();
+  std::optional<RoutePrefix<AddrT>> next;
+  for (; it != routesDelta.end(); ++it) {
+    if (*budget == 0) {
+      next = prefixOf(*it);
+      break;
+    }
+    --*budget;
+    const auto& oldRoute = it->getOld();
+    const auto& newRoute = it->getNew();
+    if (!oldRoute) {
+      rib->addRoute(newRoute);
+      rib->addRouteInRadixTree(newRoute);
+    } else if (!newRoute) {
+      rib->removeRoute(oldRoute);
+      rib->removeRouteInRadixTree(oldRoute);
+    } else {
+      rib->updateRoute(newRoute);
+      rib->updateRouteInRadixTree(newRoute);
+    }
+  }
+  table->setRib(rib);
+  return next;
+}
+
+} // namespace
+
+StateDeltaSlice sliceRouteChanges(
+    const StateDelta& delta,
+    size_t maxRouteChanges,
+    StateDeltaSliceCursor* cursor) {
+  StateDeltaSlice slice;
+  bool resume = cursor && cursor->sliceRouteTables &&
+      cursor->sliceRouteTables == delta.oldState()->getRouteTables() &&
+      cursor->newRouteTables == delta.newState()->getRouteTables();
+  size_t routeChanges;
+  if (resume) {
+    routeChanges = cursor->remainingRouteChanges;
+  } else {
+    // Only count past the limit when slicing is needed: the total number of
+    // changes is then required for progress reporting anyway, and the
+    // following slices take it from the cursor.
+    routeChanges = countRouteChanges(delta, maxRouteChanges);
+    if (routeChanges > maxRouteChanges) {
+      routeChanges =
+          countRouteChanges(delta, std::numeric_limits<size_t>::max());
+    }
+  }
+  if (routeChanges <= maxRouteChanges || removesRouteDependencies(delta)) {
+    slice.state = delta.newState();
+    slice.routeChanges = routeChanges;
+    if (cursor) {
+      *cursor = StateDeltaSliceCursor();
+    }
+    return slice;
+  }
+
+  auto routeTables = delta.oldState()->getRouteTables()->clone();
+  size_t budget = maxRouteChanges;
+  StateDeltaSliceCursor next;
+  for (const auto& routeDelta : delta.getRouteTablesDelta()) {
+    auto oldTable = routeDelta.getOld();
+    auto newTable = routeDelta.getNew();
+    auto id = (newTable ? newTable : oldTable)->getID();
+    // Changes before the cursor were applied by the previous slice
+    std::optional<RoutePrefixV4> fromV4;
+    std::optional<RoutePrefixV6> fromV6;
+    bool skipV4 = false;
+    if (resume && id == cursor->routerID) {
+      skipV4 = cursor->v6;
+      if (cursor->v6) {
+        fromV6 = toRoutePrefix<folly::IPAddressV6>(cursor->prefix);
+      } else {
+        fromV4 = toRoutePrefix<folly::IPAddressV4>(cursor->prefix);
+      }
+    }
+
+    auto table =
+        oldTable ? oldTable->clone() : std::make_shared<RouteTable>(id);
+    auto budgetBefore = budget;
+    std::optional<RoutePrefixV4> nextV4;
+    std::optional<RoutePrefixV6> nextV6;
+    if (!skipV4) {
+      nextV4 = applyRouteChanges<folly::IPAddressV4>(
+          routeDelta, fromV4, table.get(), &budget);
+    }
+    if (!nextV4) {
+      nextV6 = applyRouteChanges<folly::IPAddressV6>(
+          routeDelta, fromV6, table.get(), &budget);
+    }
+
+    if (!nextV4 && !nextV6) {
+      // Tables completely applied are taken from the new state, so that the
+      // next slice does not see them as changed
+      if (!newTable) {
+        routeTables->removeRouteTable(oldTable);
+      } else if (oldTable) {
+        routeTables->updateRouteTable(newTable);
+      } else {
+        routeTables->addRouteTable(newTable);
+      }
+      continue;
+    }
+    if (budget < budgetBefore) {
+      if (oldTable) {
+        routeTables->updateRouteTable(table);
+      } else {
+        routeTables->addRouteTable(table);
+      }
+    }
+    next.routerID = id;
+    next.v6 = !nextV4;
+    next.prefix = nextV4 ? toCIDRNetwork(*nextV4) : toCIDRNetwork(*nextV6);
+    break;
+  }
+
+  slice.state = delta.newState()->clone();
+  slice.state->resetRouteTables(routeTables);
+  slice.routeChanges = maxRouteChanges - budget;
+  slice.remainingRouteChanges = routeChanges - slice.routeChanges;
+  if (cursor) {
+    next.sliceRouteTables = routeTables;
+    next.newRouteTables = delta.newState()->getRouteTables();
+    next.remainingRouteChanges = slice.remainingRouteChanges;
+    *cursor = std::move(next);
+  }
+  return slice;
+}
+
+} // namespace facebook::fboss
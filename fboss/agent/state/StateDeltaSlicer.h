@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace facebook::fboss {
+
+class RouteTableMap;
+class StateDelta;
+class SwitchState;
+
+struct StateDeltaSlice {
+  // State to program next, between the old and the new state of the delta
+  std::shared_ptr<SwitchState> state;
+  // Route changes from the old state to state
+  size_t routeChanges{0};
+  // Route changes left from state to the new state of the delta
+  size_t remainingRouteChanges{0};
+};
+
+/*
+ * Where the last slice of a delta stopped, so that slicing the rest of the
+ * delta neither recounts nor walks again the route changes already applied.
+ */
+struct StateDeltaSliceCursor {
+  // Route tables of the last slice, and of the state it was cut from
+  std::shared_ptr<RouteTableMap> sliceRouteTables;
+  std::shared_ptr<RouteTableMap> newRouteTables;
+  size_t remainingRouteChanges{0};
+  // First route change not applied by the last slice
+  RouterID routerID{0};
+  bool v6{false};
+  folly::CIDRNetwork prefix;
+};
+
+/*
+ * Split a huge delta (e.g. the initial sync of a full routing table) so that
+ * the hardware can be programmed in bounded steps.
+ *
+ * If delta has at most maxRouteChanges route additions, changes and
+ * removals, the slice is the new state itself. Otherwise, the slice is the
+ * new state with the route tables of the old state, to which only the first
+ * maxRouteChanges route changes of delta are applied. Everything but routes
+ * is always taken from the new state.
+ *
+ * Deltas removing interfaces, vlans or neighbors are never sliced: routes
+ * still pointing to them would only be removed by later slices, after what
+ * they resolve through is gone.
+ *
+ * Route changes are sliced in prefix order. The hardware may reorder the
+ * changes of a slice (e.g. by route priority), but not across slices.
+ *
+ * If cursor is not null, it is updated to where the slice stopped. When the
+ * next delta goes from the returned slice to the same route tables, passing
+ * the cursor back resumes right where the previous slice stopped. Otherwise
+ * the cursor is ignored and the route changes are counted again.
+ *
+ * Only legacy route tables are sliced: forwarding information bases are
+ * always taken from the new state.
+ *
+ * The returned state is not published yet.
+ */
+StateDeltaSlice sliceRouteChanges(
+    const StateDelta& delta,
+    size_t maxRouteChanges,
+    StateDeltaSliceCursor* cursor = nullptr);
+
+} // namespace facebook::fboss
@@ -104,6 +104,63 @@ folly::dynamic SwitchStateFields::toFollyDynamic() const {
   return switchState;
 }
 
+namespace {
+/*
+ * Call fn(name, write) for every top level field of the serialized state, in
+ * the same order as SwitchStateFields::toFollyDynamic(). write(writer)
+ * serializes the field's value.
+ */
+template <typename Fn>
+void forEachJsonField(const SwitchStateFields& fields, Fn fn) {
+  auto node = [](const auto& child) {
+    return [child = child.get()](JsonStreamWriter& writer) {
+      child->writeJson(writer);
+    };
+  };
+  fn(kInterfaces, node(fields.interfaces));
+  fn(kPorts, node(fields.ports));
+  fn(kVlans, node(fields.vlans));
+  fn(kRouteTables, node(fields.routeTables));
+  fn(kAcls, node(fields.acls));
+  fn(kSflowCollectors, node(fields.sFlowCollectors));
+  fn(kDefaultVlan, [&fields](JsonStreamWriter& writer) {
+    writer.value(static_cast<uint32_t>(fields.defaultVlan));
+  });
+  fn(kControlPlane, node(fields.controlPlane));
+  fn(kLoadBalancers, node(fields.loadBalancers));
+  fn(kMirrors, node(fields.mirrors));
+  fn(kAggregatePorts, node(fields.aggPorts));
+  fn(kLabelForwardingInformationBase, node(fields.labelFib));
+  fn(kSwitchSettings, node(fields.switchSettings));
+  if (fields.defaultDataPlaneQosPolicy) {
+    fn(kDefaultDataplaneQosPolicy, node(fields.defaultDataPlaneQosPolicy));
+  }
+  fn(kQosPolicies, node(fields.qosPolicies));
+}
+} // namespace
+
+void SwitchStateFields::writeJson(JsonStreamWriter& writer) const {
+  writer.beginObject();
+  forEachJsonField(*this, [&writer](folly::StringPiece name, auto write) {
+    writer.key(name);
+    write(writer);
+  });
+  writer.endObject();
+}
+
+bool SwitchStateFields::writeFieldJson(
+    folly::StringPiece name,
+    JsonStreamWriter& writer) const {
+  bool found = false;
+  forEachJsonField(*this, [&](folly::StringPiece field, auto write) {
+    if (!found && field == name) {
+      write(writer);
+      found = true;
+    }
+  });
+  return found;
+}
+
 SwitchStateFields SwitchStateFields::fromFollyDynamic(
     const folly::dynamic& swJson) {
   SwitchStateFields switchState;
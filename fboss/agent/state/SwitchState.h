@@ -67,6 +67,16 @@ struct SwitchStateFields {
    * Serialize to folly::dynamic
    */
   folly::dynamic toFollyDynamic() const;
+  /*
+   * Serialize to JSON incrementally, producing the same document as
+   * toFollyDynamic() without ever holding all of it in memory.
+   */
+  void writeJson(JsonStreamWriter& writer) const;
+  /*
+   * Serialize only the top level field called name, e.g. "routeTables".
+   * Returns false if there is no such field.
+   */
+  bool writeFieldJson(folly::StringPiece name, JsonStreamWriter& writer) const;
   /*
    * Reconstruct object from folly::dynamic
    */
@@ -177,6 +187,10 @@ class SwitchState : public NodeBaseT<SwitchState, SwitchStateFields> {
     return getFields()->toFollyDynamic();
   }
 
+  void writeJson(JsonStreamWriter& writer) const override {
+    getFields()->writeJson(writer);
+  }
+
   static void modify(std::shared_ptr<SwitchState>* state);
 
   template <typename EntryClassT, typename NTableT>
@@ -2,6 +2,7 @@
 
 #include <folly/dynamic.h>
 #include <folly/json.h>
+#include <thrift/lib/cpp2/folly_dynamic/folly_dynamic.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/state/NodeBase.h"
@@ -13,6 +14,12 @@ namespace facebook::fboss {
 // object to/from JSON using Thrift serializers. For this to work
 // one must supply Thrift type (ThrifT) that stores FieldsT state.
 //
+// toFollyDynamic()/fromFollyDynamic(), used for the warm boot file and
+// state dumps, convert between the Thrift struct and folly::dynamic
+// directly, in the same layout as SimpleJSONSerializer, without going
+// through JSON text. serialize()/deserialize() go straight between the node
+// and a binary Thrift protocol, for callers which don't need JSON at all.
+//
 // TODO: in future, FieldsT and ThrifT should be one type
 //
 template <typename ThriftT, typename NodeT, typename FieldsT>
@@ -21,8 +28,12 @@ class ThriftyBaseT : public NodeBaseT<NodeT, FieldsT> {
   using NodeBaseT<NodeT, FieldsT>::NodeBaseT;
 
   static std::shared_ptr<NodeT> fromFollyDynamic(folly::dynamic const& dyn) {
-    auto const jsonStr = folly::toJson(dyn);
-    return fromJson(jsonStr);
+    // Lenient, to accept files written by older versions of the agent
+    auto obj = apache::thrift::from_dynamic<ThriftT>(
+        dyn,
+        apache::thrift::dynamic_format::JSON_1,
+        apache::thrift::format_adherence::LENIENT);
+    return std::make_shared<NodeT>(FieldsT::fromThrift(obj));
   }
 
   static std::shared_ptr<NodeT> fromJson(const folly::fbstring& jsonStr) {
@@ -34,6 +45,23 @@ class ThriftyBaseT : public NodeBaseT<NodeT, FieldsT> {
     return std::make_shared<NodeT>(fields);
   }
 
+  template <typename Serializer = apache::thrift::CompactSerializer>
+  static std::shared_ptr<NodeT> deserialize(folly::ByteRange buf) {
+    auto obj = Serializer::template deserialize<ThriftT>(buf);
+    return std::make_shared<NodeT>(FieldsT::fromThrift(obj));
+  }
+
+  template <typename Serializer = apache::thrift::CompactSerializer>
+  static std::shared_ptr<NodeT> deserialize(folly::StringPiece buf) {
+    return deserialize<Serializer>(folly::ByteRange(buf));
+  }
+
+  template <typename Serializer = apache::thrift::CompactSerializer>
+  std::string serialize() const {
+    return Serializer::template serialize<std::string>(
+        this->getFields()->toThrift());
+  }
+
   std::string str() const {
     auto obj = this->getFields()->toThrift();
     std::string jsonStr;
@@ -42,7 +70,8 @@ class ThriftyBaseT : public NodeBaseT<NodeT, FieldsT> {
   }
 
   folly::dynamic toFollyDynamic() const override {
-    return folly::parseJson(this->str());
+    return apache::thrift::to_dynamic(
+        this->getFields()->toThrift(), apache::thrift::dynamic_format::JSON_1);
   }
 };
 
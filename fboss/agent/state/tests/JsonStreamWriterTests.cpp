@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/JsonStreamWriter.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+// Objects with a single member, so that member order can't differ
+folly::dynamic testDocument() {
+  return folly::dynamic::array(
+      folly::dynamic::object("name", "eth1/1/1"),
+      folly::dynamic::object("ids", folly::dynamic::array(1, 2, 3)),
+      folly::dynamic::object("empty", folly::dynamic::object),
+      folly::dynamic::array(),
+      "quote\"and\\backslash",
+      true,
+      nullptr,
+      1.5);
+}
+} // namespace
+
+TEST(JsonStreamWriter, MatchesFollyFormatting) {
+  auto doc = testDocument();
+  std::string compact;
+  JsonStreamWriter compactWriter(&compact);
+  compactWriter.value(doc);
+  EXPECT_EQ(folly::toJson(doc), compact);
+
+  std::string pretty;
+  JsonStreamWriter prettyWriter(&pretty, true);
+  prettyWriter.value(doc);
+  EXPECT_EQ(folly::toPrettyJson(doc), pretty);
+}
+
+TEST(JsonStreamWriter, Structure) {
+  std::string out;
+  JsonStreamWriter writer(&out);
+  writer.beginObject();
+  writer.member("id", 5);
+  writer.key("entries");
+  writer.beginArray();
+  for (int i = 0; i < 3; ++i) {
+    writer.beginObject();
+    writer.member("index", i);
+    writer.endObject();
+  }
+  writer.endArray();
+  writer.key("extra");
+  writer.beginObject();
+  writer.endObject();
+  writer.endObject();
+  EXPECT_EQ(
+      R"({"id":5,"entries":[{"index":0},{"index":1},{"index":2}],"extra":{}})",
+      out);
+}
+
+TEST(JsonStreamWriter, SmallBufferToFile) {
+  folly::test::TemporaryFile file;
+  auto doc = testDocument();
+  // Flush after every value
+  JsonStreamWriter writer(file.fd(), true, 1);
+  writer.value(doc);
+  writer.flush();
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(file.path().c_str(), contents));
+  EXPECT_EQ(folly::toPrettyJson(doc), contents);
+}
+
+TEST(JsonStreamWriter, SwitchStateMatchesFollyDynamic) {
+  auto state = testStateA();
+  std::string json;
+  JsonStreamWriter writer(&json);
+  state->writeJson(writer);
+  EXPECT_EQ(state->toFollyDynamic(), folly::parseJson(json));
+
+  // The streamed document must also be readable as a SwitchState
+  auto restored = SwitchState::uniquePtrFromJson(json);
+  EXPECT_EQ(state->toFollyDynamic(), restored->toFollyDynamic());
+}
+
+TEST(JsonStreamWriter, SwitchStateField) {
+  auto state = testStateA();
+  auto expected = state->toFollyDynamic();
+  for (const auto& field : expected.items()) {
+    std::string json;
+    JsonStreamWriter writer(&json);
+    EXPECT_TRUE(
+        state->getFields()->writeFieldJson(field.first.asString(), writer));
+    EXPECT_EQ(field.second, folly::parseJson(json)) << field.first;
+  }
+  std::string json;
+  JsonStreamWriter writer(&json);
+  EXPECT_FALSE(state->getFields()->writeFieldJson("noSuchField", writer));
+  EXPECT_TRUE(json.empty());
+}
+
+TEST(JsonStreamWriter, DumpStateToFile) {
+  folly::test::TemporaryDirectory dir;
+  auto path = (dir.path() / "state.json").string();
+  auto state = testStateA();
+  EXPECT_TRUE(dumpStateToFile(
+      path, [&state](JsonStreamWriter& writer) { state->writeJson(writer); }));
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(path.c_str(), contents));
+  EXPECT_EQ(state->toFollyDynamic(), folly::parseJson(contents));
+
+  // Failures are reported rather than thrown
+  EXPECT_FALSE(dumpStateToFile(
+      (dir.path() / "missing" / "state.json").string(),
+      [&state](JsonStreamWriter& writer) { state->writeJson(writer); }));
+}
@@ -174,6 +174,22 @@ TEST(PortQueue, serialization) {
   }
 }
 
+TEST(PortQueue, binarySerialization) {
+  std::vector<PortQueue*> queues = {generatePortQueue(),
+                                    generateProdPortQueue(),
+                                    generateProdCPUPortQueue(),
+                                    generateDefaultPortQueue()};
+
+  for (const auto* pqObject : queues) {
+    auto compact = pqObject->serialize();
+    EXPECT_EQ(*pqObject, *PortQueue::deserialize(compact));
+    auto binary = pqObject->serialize<apache::thrift::BinarySerializer>();
+    EXPECT_EQ(
+        *pqObject,
+        *PortQueue::deserialize<apache::thrift::BinarySerializer>(binary));
+  }
+}
+
 TEST(PortQueue, stateDelta) {
   auto platform = createMockPlatform();
   auto stateV0 = applyInitConfig();
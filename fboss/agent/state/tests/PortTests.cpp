@@ -447,6 +447,31 @@ TEST(Port, ToFromJSONLoopbackModeMissingFromJson) {
   EXPECT_EQ(dyn1, dyn2);
 }
 
+TEST(Port, ToFromFollyDynamic) {
+  auto state = testStateA();
+  for (const auto& port : *state->getPorts()) {
+    auto dyn = port->toFollyDynamic();
+    // Same layout as the JSON text the warm boot file used to go through
+    EXPECT_EQ(folly::parseJson(port->str()), dyn);
+    EXPECT_EQ(dyn, Port::fromFollyDynamic(dyn)->toFollyDynamic());
+    EXPECT_EQ(dyn, Port::fromJson(port->str())->toFollyDynamic());
+  }
+}
+
+TEST(Port, ToFromBinary) {
+  auto state = testStateA();
+  for (const auto& port : *state->getPorts()) {
+    auto compact = port->serialize();
+    auto fromCompact = Port::deserialize(compact);
+    EXPECT_EQ(port->toFollyDynamic(), fromCompact->toFollyDynamic());
+
+    auto binary = port->serialize<apache::thrift::BinarySerializer>();
+    auto fromBinary =
+        Port::deserialize<apache::thrift::BinarySerializer>(binary);
+    EXPECT_EQ(port->toFollyDynamic(), fromBinary->toFollyDynamic());
+  }
+}
+
 TEST(Port, initDefaultConfig) {
   auto platform = createMockPlatform();
   PortID portID(1);
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/StateDeltaSlicer.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+
+namespace {
+
+std::shared_ptr<Route<IPAddressV4>> makeRoute(uint32_t index) {
+  RoutePrefixV4 prefix{IPAddressV4::fromLongHBO(0x0a000000 | (index << 8)),
+                       24};
+  return std::make_shared<Route<IPAddressV4>>(
+      prefix,
+      ClientID::BGPD,
+      RouteNextHopEntry(RouteForwardAction::DROP, AdminDistance::EBGP));
+}
+
+// A state with routes [begin, end) in VRF 0
+std::shared_ptr<SwitchState> stateWithRoutes(uint32_t begin, uint32_t end) {
+  auto rib = std::make_shared<RouteTable::RibTypeV4>();
+  for (auto i = begin; i < end; ++i) {
+    auto route = makeRoute(i);
+    rib->addRoute(route);
+    rib->addRouteInRadixTree(route);
+  }
+  auto table = std::make_shared<RouteTable>(RouterID(0));
+  table->setRib(rib);
+  auto tables = std::make_shared<RouteTableMap>();
+  tables->addRouteTable(table);
+  auto state = std::make_shared<SwitchState>();
+  state->resetRouteTables(tables);
+  state->publish();
+  return state;
+}
+
+size_t numRoutes(const std::shared_ptr<SwitchState>& state) {
+  auto table = state->getRouteTables()->getRouteTableIf(RouterID(0));
+  return table ? table->getRibV4()->size() : 0;
+}
+
+} // namespace
+
+TEST(StateDeltaSlicer, SmallDeltaIsNotSliced) {
+  auto oldState = stateWithRoutes(0, 10);
+  auto newState = stateWithRoutes(5, 20);
+  auto slice = sliceRouteChanges(StateDelta(oldState, newState), 100);
+  EXPECT_EQ(slice.state, newState);
+  EXPECT_EQ(slice.routeChanges, 15);
+  EXPECT_EQ(slice.remainingRouteChanges, 0);
+}
+
+TEST(StateDeltaSlicer, SlicesConvergeToNewState) {
+  auto emptyState = std::make_shared<SwitchState>();
+  emptyState->publish();
+  auto newState = stateWithRoutes(0, 1000);
+
+  auto applied = emptyState;
+  int numSlices = 0;
+  while (applied != newState) {
+    auto slice = sliceRouteChanges(StateDelta(applied, newState), 300);
+    EXPECT_LE(slice.routeChanges, 300);
+    EXPECT_EQ(slice.routeChanges + numRoutes(applied), numRoutes(slice.state));
+    EXPECT_EQ(slice.remainingRouteChanges, 1000 - numRoutes(slice.state));
+    slice.state->publish();
+    applied = slice.state;
+    ++numSlices;
+  }
+  EXPECT_EQ(numSlices, 4);
+
+  // Removing all routes drops the table with its last route
+  applied = newState;
+  numSlices = 0;
+  while (applied != emptyState) {
+    auto slice = sliceRouteChanges(StateDelta(applied, emptyState), 600);
+    if (slice.state != emptyState) {
+      EXPECT_EQ(numRoutes(slice.state), 400);
+      EXPECT_NE(
+          slice.state->getRouteTables()->getRouteTableIf(RouterID(0)),
+          nullptr);
+    }
+    slice.state->publish();
+    applied = slice.state;
+    ++numSlices;
+  }
+  EXPECT_EQ(numSlices, 2);
+}
+
+TEST(StateDeltaSlicer, RadixTreeInSync) {
+  auto oldState = stateWithRoutes(0, 100);
+  auto newState = stateWithRoutes(50, 150);
+  auto slice = sliceRouteChanges(StateDelta(oldState, newState), 60);
+  EXPECT_EQ(slice.routeChanges, 60);
+  EXPECT_EQ(slice.remainingRouteChanges, 40);
+  auto rib = slice.state->getRouteTables()->getRouteTable(RouterID(0))
+                 ->getRibV4();
+  EXPECT_EQ(rib->size(), rib->routesRadixTree().size());
+  for (const auto& node : rib->routes()->getAllNodes()) {
+    EXPECT_EQ(node.second, rib->exactMatch(node.first));
+    EXPECT_NE(
+        rib->routesRadixTree().exactMatch(node.first.network, node.first.mask),
+        rib->routesRadixTree().end());
+  }
+  // Publishing checks that the radix tree and the routes agree
+  slice.state->publish();
+}
+
+TEST(StateDeltaSlicer, CursorResumesSlicing) {
+  auto oldState = stateWithRoutes(0, 500);
+  auto newState = stateWithRoutes(250, 1000);
+
+  StateDeltaSliceCursor cursor;
+  auto applied = oldState;
+  std::vector<size_t> remaining;
+  while (applied != newState) {
+    // The update thread queues a clone of the desired state for the rest of
+    // a sliced update, which shares its route tables
+    auto desiredState = applied == oldState ? newState : newState->clone();
+    auto slice =
+        sliceRouteChanges(StateDelta(applied, desiredState), 300, &cursor);
+    if (slice.state == desiredState) {
+      EXPECT_EQ(cursor.sliceRouteTables, nullptr);
+      break;
+    }
+    EXPECT_EQ(cursor.sliceRouteTables, slice.state->getRouteTables());
+    EXPECT_EQ(cursor.remainingRouteChanges, slice.remainingRouteChanges);
+    // Same slice as without the cursor
+    auto expected = sliceRouteChanges(StateDelta(applied, desiredState), 300);
+    EXPECT_EQ(
+        numRoutes(expected.state) - numRoutes(applied),
+        numRoutes(slice.state) - numRoutes(applied));
+    EXPECT_EQ(expected.remainingRouteChanges, slice.remainingRouteChanges);
+    remaining.push_back(slice.remainingRouteChanges);
+    slice.state->publish();
+    applied = slice.state;
+  }
+  // 250 removals and 500 additions
+  EXPECT_EQ((std::vector<size_t>{450, 150}), remaining);
+
+  auto rib =
+      applied->getRouteTables()->getRouteTable(RouterID(0))->getRibV4();
+  auto last = sliceRouteChanges(StateDelta(applied, newState), 300, &cursor);
+  EXPECT_EQ(last.state, newState);
+  EXPECT_EQ(last.routeChanges, 150);
+  EXPECT_EQ(rib->size(), rib->routesRadixTree().size());
+}
+
+TEST(StateDeltaSlicer, StaleCursorIsIgnored) {
+  auto oldState = stateWithRoutes(0, 10);
+  auto newState = stateWithRoutes(0, 1000);
+  StateDeltaSliceCursor cursor;
+  auto slice = sliceRouteChanges(StateDelta(oldState, newState), 300, &cursor);
+  EXPECT_EQ(slice.remainingRouteChanges, 690);
+  slice.state->publish();
+
+  // Routes changed again before the next slice: everything is counted again
+  auto otherState = stateWithRoutes(0, 500);
+  auto next =
+      sliceRouteChanges(StateDelta(slice.state, otherState), 100, &cursor);
+  EXPECT_EQ(next.routeChanges, 100);
+  EXPECT_EQ(next.remainingRouteChanges, 90);
+  EXPECT_EQ(numRoutes(next.state), 410);
+}
+
+TEST(StateDeltaSlicer, RemovalOfRouteDependenciesIsNotSliced) {
+  auto oldState = stateWithRoutes(0, 1000)->clone();
+  oldState->addVlan(std::make_shared<Vlan>(VlanID(1), "vlan1"));
+  oldState->publish();
+  auto newState = stateWithRoutes(0, 10);
+
+  // Routes through the vlan must be gone before it is removed
+  auto slice = sliceRouteChanges(StateDelta(oldState, newState), 100);
+  EXPECT_EQ(slice.state, newState);
+  EXPECT_EQ(slice.routeChanges, 990);
+  EXPECT_EQ(slice.remainingRouteChanges, 0);
+}
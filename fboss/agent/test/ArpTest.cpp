@@ -8,12 +8,14 @@
  *
  */
 #include <fb303/ServiceData.h>
+#include <folly/Format.h>
 #include <folly/Memory.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/ArpHandler.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborHoldQueue.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
@@ -955,6 +957,96 @@ TEST(ArpTest, PendingArp) {
   EXPECT_EQ(entry->isPending(), false);
 };
 
+TEST(ArpTest, PendingArpHoldsPackets) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_neighbor_hold_queue = true;
+  FLAGS_neighbor_hold_queue_packets_per_neighbor = 2;
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  auto holdQueue = sw->getNeighborHoldQueue();
+
+  VlanID vlanID(1);
+  IPAddressV4 senderIP = IPAddressV4("10.0.0.1");
+  CounterCache counters(sw);
+
+  // An IP pkt for 10.0.0.10, with a distinct identification for each packet
+  auto makePacket = [](int id) {
+    return PktUtil::parseHexData(folly::sformat(
+        // dst mac, src mac
+        "02 00 01 00 00 01  02 00 02 01 02 03"
+        // 802.1q, VLAN 1
+        "81 00 00 01"
+        // IPv4
+        "08 00"
+        // Version(4), IHL(5), DSCP(0), ECN(0), Total Length(20)
+        "45  00  00 14"
+        // Identification, Flags(0), Fragment offset(0)
+        "00 {:02x}  00 00"
+        // TTL(31), Protocol(6), Checksum (0, fake)
+        "1F  06  00 00"
+        // Source IP (1.2.3.4)
+        "01 02 03 04"
+        // Destination IP (10.0.0.10)
+        "0a 00 00 0a",
+        id));
+  };
+  auto checkHeldPacket = [makePacket](int id) -> TxMatchFn {
+    auto expected = makePacket(id);
+    return [expected](const TxPacket* pkt) {
+      if (!folly::IOBufEqualTo()(*pkt->buf(), expected)) {
+        throw FbossError("not the held packet");
+      }
+    };
+  };
+
+  // The first packet triggers an ARP request and is held
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(1);
+  EXPECT_SWITCHED_PKT(
+      sw,
+      "ARP request",
+      checkArpRequest(
+          senderIP,
+          MacAddress("00:02:00:00:00:01"),
+          IPAddressV4("10.0.0.10"),
+          vlanID));
+  handle->rxPacket(make_unique<IOBuf>(makePacket(1)), PortID(1), vlanID);
+  sw->getNeighborUpdater()->waitForPendingUpdates();
+  waitForStateUpdates(sw);
+  EXPECT_EQ(holdQueue->numPackets(), 1);
+
+  // Packets over the limit per neighbor push out the oldest ones
+  handle->rxPacket(make_unique<IOBuf>(makePacket(2)), PortID(1), vlanID);
+  handle->rxPacket(make_unique<IOBuf>(makePacket(3)), PortID(1), vlanID);
+  EXPECT_EQ(holdQueue->numPackets(), 2);
+
+  counters.update();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.ipv4.sum", 3);
+  counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.drops.sum", 0);
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "neighbor_hold.queued.sum", 3);
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "neighbor_hold.drop_overflow.sum", 1);
+
+  // Once the entry is resolved, the held packets are sent in order
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(1);
+  {
+    testing::InSequence seq;
+    EXPECT_SWITCHED_PKT(sw, "held packet 2", checkHeldPacket(2));
+    EXPECT_SWITCHED_PKT(sw, "held packet 3", checkHeldPacket(3));
+  }
+  sendArpReply(handle.get(), "10.0.0.10", "02:10:20:30:40:22", 1);
+  waitForStateUpdates(sw);
+  auto entry = getArpEntry(sw, IPAddressV4("10.0.0.10"), vlanID);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_FALSE(entry->isPending());
+  EXPECT_TRUE(holdQueue->empty());
+  EXPECT_EQ(holdQueue->numBytes(), 0);
+
+  counters.update();
+  counters.checkDelta(
+      SwitchStats::kCounterPrefix + "neighbor_hold.flushed.sum", 2);
+}
+
 TEST(ArpTest, PendingArpCleanup) {
   auto handle = setupTestHandle(std::chrono::seconds(1));
   auto sw = handle->getSw();
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <boost/cast.hpp>
+
+#include <folly/Benchmark.h>
+#include <folly/Memory.h>
+#include "fboss/agent/ICMPRateLimiter.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/sim/SimSwitch.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using folly::MacAddress;
+using std::make_shared;
+using std::make_unique;
+using std::shared_ptr;
+using std::unique_ptr;
+
+namespace {
+
+// Global state used by the benchmarks
+unique_ptr<SwSwitch> unlimitedSw;
+unique_ptr<SwSwitch> limitedSw;
+unique_ptr<MockRxPacket> ttlExpiredV4;
+unique_ptr<MockRxPacket> hopLimitExpiredV6;
+
+// ICMP rate limits are read from the flags when the switch is created
+unique_ptr<SwSwitch> setupSwitch() {
+  MacAddress localMac("02:00:01:00:00:01");
+  auto sw = make_unique<SwSwitch>(make_unique<SimPlatform>(localMac, 10));
+  sw->init(nullptr /* No custom TunManager */);
+
+  auto updateFn = [&](const shared_ptr<SwitchState>& oldState) {
+    auto state = oldState->clone();
+
+    // Add VLAN 1, and ports 1-9 which belong to it.
+    auto vlan1 = make_shared<Vlan>(VlanID(1), "Vlan1");
+    state->addVlan(vlan1);
+    for (int idx = 1; idx < 10; ++idx) {
+      vlan1->addPort(PortID(idx), false);
+    }
+    // Add Interface 1 to VLAN 1
+    auto intf1 = make_shared<Interface>(
+        InterfaceID(1),
+        RouterID(0),
+        VlanID(1),
+        "interface1",
+        MacAddress("02:00:01:00:00:01"),
+        9000,
+        false, /* is virtual */
+        false /* is state_sync disabled*/);
+    Interface::Addresses addrs1;
+    addrs1.emplace(IPAddress("10.0.0.1"), 24);
+    addrs1.emplace(IPAddress("2401:db00:2110:3001::1"), 64);
+    intf1->setAddresses(addrs1);
+    state->addIntf(intf1);
+    return state;
+  };
+
+  sw->updateStateBlocking("setup", updateFn);
+  return sw;
+}
+
+void init() {
+  FLAGS_icmp_error_rate_per_prefix = 0;
+  FLAGS_icmp_error_rate_per_port = 0;
+  unlimitedSw = setupSwitch();
+  FLAGS_icmp_error_rate_per_prefix = 100;
+  FLAGS_icmp_error_rate_per_port = 1000;
+  limitedSw = setupSwitch();
+
+  // An IPv4 packet from 10.0.0.15 to 10.0.1.1 with TTL 1
+  ttlExpiredV4 = MockRxPacket::fromHex(
+      // dst mac, src mac
+      "02 00 01 00 00 01  00 02 00 01 02 03"
+      // 802.1q, VLAN 1
+      "81 00  00 01"
+      // IPv4
+      "08 00"
+      // Version(4), IHL(5), DSCP(0), ECN(0), Total Length(28)
+      "45  00  00 1c"
+      // Identification(0), Flags(0), Fragment offset(0)
+      "00 00  00 00"
+      // TTL(1), Protocol(17), Checksum (0, fake)
+      "01  11  00 00"
+      // Source IP (10.0.0.15)
+      "0a 00 00 0f"
+      // Destination IP (10.0.1.1)
+      "0a 00 01 01"
+      // UDP header
+      "00 35  00 35  00 08  00 00");
+  ttlExpiredV4->padToLength(68);
+  ttlExpiredV4->setSrcPort(PortID(1));
+  ttlExpiredV4->setSrcVlan(VlanID(1));
+
+  // An IPv6 packet from 2401:db00:2110:3001::f to 2401:db00:2110:3002::1
+  // with hop limit 1
+  hopLimitExpiredV6 = MockRxPacket::fromHex(
+      // dst mac, src mac
+      "02 00 01 00 00 01  00 02 00 01 02 03"
+      // 802.1q, VLAN 1
+      "81 00  00 01"
+      // IPv6
+      "86 dd"
+      // Version 6, traffic class, flow label
+      "6e 00 00 00"
+      // Payload length: 8, next header: UDP, hop limit: 1
+      "00 08  11  01"
+      // Source IP
+      "24 01 db 00 21 10 30 01 00 00 00 00 00 00 00 0f"
+      // Destination IP
+      "24 01 db 00 21 10 30 02 00 00 00 00 00 00 00 01"
+      // UDP header
+      "00 35  00 35  00 08  00 00");
+  hopLimitExpiredV6->setSrcPort(PortID(1));
+  hopLimitExpiredV6->setSrcVlan(VlanID(1));
+}
+
+// Send pkt numIters times, and check how many ICMP errors were sent
+void receive(
+    SwSwitch* sw,
+    const MockRxPacket& pkt,
+    size_t numIters,
+    bool limited) {
+  BENCHMARK_SUSPEND {
+    SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+    sim->resetTxCount();
+  }
+
+  for (size_t n = 0; n < numIters; ++n) {
+    sw->packetReceived(pkt.clone());
+  }
+
+  BENCHMARK_SUSPEND {
+    SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+    if (limited) {
+      CHECK_LE(sim->getTxCount(), numIters);
+    } else {
+      CHECK_EQ(sim->getTxCount(), numIters);
+    }
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(TTLExceededV4, numIters) {
+  receive(unlimitedSw.get(), *ttlExpiredV4, numIters, false);
+}
+
+BENCHMARK_RELATIVE(TTLExceededV4RateLimited, numIters) {
+  receive(limitedSw.get(), *ttlExpiredV4, numIters, true);
+}
+
+BENCHMARK(HopLimitExceededV6, numIters) {
+  receive(unlimitedSw.get(), *hopLimitExpiredV6, numIters, false);
+}
+
+BENCHMARK_RELATIVE(HopLimitExceededV6RateLimited, numIters) {
+  receive(limitedSw.get(), *hopLimitExpiredV6, numIters, true);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Setting up the switches is fairly expensive, so do it once up front
+  init();
+
+  folly::runBenchmarks();
+  return 0;
+}
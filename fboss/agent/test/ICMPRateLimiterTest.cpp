@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/ICMPRateLimiter.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+
+namespace {
+// Buckets start full once this much time has passed since the epoch
+constexpr double kNow = 1000;
+
+ICMPRateLimiter::Config prefixOnly() {
+  ICMPRateLimiter::Config config;
+  config.ratePerPrefix = 10;
+  config.burstPerPrefix = 5;
+  return config;
+}
+} // namespace
+
+TEST(ICMPRateLimiter, burstThenRate) {
+  ICMPRateLimiter limiter(prefixOnly());
+  IPAddress src("10.1.1.1");
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(limiter.allow(PortID(1), src, kNow));
+  }
+  EXPECT_FALSE(limiter.allow(PortID(1), src, kNow));
+  // 10 per second, so one more after 100ms
+  EXPECT_FALSE(limiter.allow(PortID(1), src, kNow + 0.05));
+  EXPECT_TRUE(limiter.allow(PortID(1), src, kNow + 0.1));
+  EXPECT_FALSE(limiter.allow(PortID(1), src, kNow + 0.1));
+}
+
+TEST(ICMPRateLimiter, perSourcePrefix) {
+  ICMPRateLimiter limiter(prefixOnly());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.1.1.1"), kNow));
+  }
+  // Same /24 shares the bucket
+  EXPECT_FALSE(limiter.allow(PortID(2), IPAddress("10.1.1.200"), kNow));
+  EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.1.2.1"), kNow));
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("2401:db00::1"), kNow));
+  }
+  // Same /64 shares the bucket
+  EXPECT_FALSE(
+      limiter.allow(PortID(1), IPAddress("2401:db00::ffff:1"), kNow));
+  EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("2401:db00:0:1::1"), kNow));
+}
+
+TEST(ICMPRateLimiter, perPort) {
+  ICMPRateLimiter::Config config;
+  config.ratePerPort = 1;
+  config.burstPerPort = 2;
+  ICMPRateLimiter limiter(config);
+  EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.0.0.1"), kNow));
+  EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.1.0.1"), kNow));
+  EXPECT_FALSE(limiter.allow(PortID(1), IPAddress("10.2.0.1"), kNow));
+  EXPECT_TRUE(limiter.allow(PortID(2), IPAddress("10.2.0.1"), kNow));
+  EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.2.0.1"), kNow + 1));
+}
+
+TEST(ICMPRateLimiter, disabled) {
+  ICMPRateLimiter limiter(ICMPRateLimiter::Config{});
+  for (int i = 0; i < 10000; ++i) {
+    EXPECT_TRUE(limiter.allow(PortID(1), IPAddress("10.0.0.1"), kNow));
+  }
+}
+
+TEST(ICMPRateLimiter, deniedByPortKeepsPrefixToken) {
+  auto config = prefixOnly();
+  config.ratePerPort = 1;
+  config.burstPerPort = 1;
+  ICMPRateLimiter limiter(config);
+  IPAddress src("10.1.1.1");
+  EXPECT_TRUE(limiter.allow(PortID(1), src, kNow));
+  // The port is out of tokens: the prefix keeps its 4 remaining ones
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_FALSE(limiter.allow(PortID(1), src, kNow));
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(limiter.allow(PortID(2 + i), src, kNow));
+  }
+  EXPECT_FALSE(limiter.allow(PortID(10), src, kNow));
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/LacpTypes-defs.h"
+#include "fboss/agent/LacpTypes.h"
+#include "fboss/agent/lldp/LinkNeighbor.h"
+#include "fboss/agent/lldp/LinkNeighborDB.h"
+#include "fboss/agent/lldp/LldpPduView.h"
+
+#include <folly/Benchmark.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include <gflags/gflags.h>
+
+#include <array>
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::MacAddress;
+using folly::io::Cursor;
+
+namespace {
+
+const MacAddress kSrcMac("2c:54:2d:f5:89:3e");
+
+// The LLDP PDU a typical neighbor sends every few seconds, without the
+// Ethernet header
+const uint8_t kLldpPdu[] = {
+    0x02, 0x07, 0x04, 0x2c, 0x54, 0x2d, 0xf5, 0x89, 0x3e, 0x04, 0x0d, 0x05,
+    0x45, 0x74, 0x68, 0x65, 0x72, 0x6e, 0x65, 0x74, 0x31, 0x2f, 0x32, 0x33,
+    0x06, 0x02, 0x00, 0x78, 0x08, 0x07, 0x53, 0x45, 0x52, 0x56, 0x45, 0x52,
+    0x53, 0x0a, 0x1b, 0x72, 0x73, 0x77, 0x31, 0x62, 0x72, 0x2e, 0x30, 0x37,
+    0x2e, 0x70, 0x72, 0x6e, 0x32, 0x2e, 0x66, 0x61, 0x63, 0x65, 0x62, 0x6f,
+    0x6f, 0x6b, 0x2e, 0x63, 0x6f, 0x6d, 0x0e, 0x04, 0x00, 0x14, 0x00, 0x14,
+    0x00, 0x00,
+};
+
+std::array<uint8_t, LACPDU::LENGTH> makeLacpdu() {
+  std::array<uint8_t, LACPDU::LENGTH> buf;
+  buf.fill(0);
+  IOBuf iob(IOBuf::WRAP_BUFFER, buf.data(), buf.size());
+  folly::io::RWPrivateCursor cursor(&iob);
+  LACPDU(
+      ParticipantInfo::defaultParticipantInfo(),
+      ParticipantInfo::defaultParticipantInfo())
+      .to(&cursor);
+  return buf;
+}
+
+} // namespace
+
+BENCHMARK(LldpParseLinkNeighbor, iters) {
+  IOBuf iob(IOBuf::WRAP_BUFFER, kLldpPdu, sizeof(kLldpPdu));
+  for (unsigned i = 0; i < iters; ++i) {
+    Cursor cursor(&iob);
+    LinkNeighbor neighbor;
+    neighbor.parseLldpPdu(PortID(1), VlanID(1), kSrcMac, 0x88cc, &cursor);
+    folly::doNotOptimizeAway(neighbor.getTlvFingerprint());
+  }
+}
+
+BENCHMARK_RELATIVE(LldpParsePduView, iters) {
+  IOBuf iob(IOBuf::WRAP_BUFFER, kLldpPdu, sizeof(kLldpPdu));
+  for (unsigned i = 0; i < iters; ++i) {
+    LldpPduView view;
+    view.parse(Cursor(&iob));
+    folly::doNotOptimizeAway(view.getTlvFingerprint());
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(LldpUpdateUnchangedNeighbor, iters) {
+  folly::BenchmarkSuspender suspender;
+  IOBuf iob(IOBuf::WRAP_BUFFER, kLldpPdu, sizeof(kLldpPdu));
+  LinkNeighborDB db;
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    Cursor cursor(&iob);
+    LinkNeighbor neighbor;
+    neighbor.parseLldpPdu(PortID(1), VlanID(1), kSrcMac, 0x88cc, &cursor);
+    db.update(neighbor);
+  }
+}
+
+BENCHMARK_RELATIVE(LldpRefreshUnchangedNeighbor, iters) {
+  folly::BenchmarkSuspender suspender;
+  IOBuf iob(IOBuf::WRAP_BUFFER, kLldpPdu, sizeof(kLldpPdu));
+  LinkNeighborDB db;
+  {
+    Cursor cursor(&iob);
+    LinkNeighbor neighbor;
+    neighbor.parseLldpPdu(PortID(1), VlanID(1), kSrcMac, 0x88cc, &cursor);
+    db.update(neighbor);
+  }
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    LldpPduView view;
+    view.parse(Cursor(&iob));
+    folly::doNotOptimizeAway(db.refresh(PortID(1), VlanID(1), kSrcMac, view));
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(LacpduFrom, iters) {
+  folly::BenchmarkSuspender suspender;
+  auto buf = makeLacpdu();
+  IOBuf iob(IOBuf::WRAP_BUFFER, buf.data(), buf.size());
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    Cursor cursor(&iob);
+    auto lacpdu = LACPDU::from(&cursor);
+    folly::doNotOptimizeAway(lacpdu.isValid());
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/LoadBalancerHashEmulator.h"
+
+#include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+
+DEFINE_int32(num_flows, 1 << 16, "Number of distinct flows to hash");
+
+using namespace facebook::fboss;
+
+namespace {
+
+std::vector<LoadBalancerFlow> makeFlows(int count) {
+  std::vector<LoadBalancerFlow> flows;
+  for (int i = 0; i < count; ++i) {
+    auto src = folly::IPAddressV6::fromBinary(folly::ByteRange(
+        std::array<uint8_t, 16>{0x20, 0x01, 0xd, 0xb8, 0, 0, 0, 0, 0, 0,
+                                uint8_t(i >> 24), uint8_t(i >> 16), 0, 0,
+                                uint8_t(i >> 8), uint8_t(i)}));
+    flows.emplace_back(
+        folly::IPAddress(src),
+        folly::IPAddress("2401:db00::1"),
+        10000 + (i * 7) % 50000,
+        443);
+  }
+  return flows;
+}
+
+// Hash numIters flows, cycling over the same set of flows
+void hashFlows(cfg::HashingAlgorithm algorithm, size_t numIters) {
+  folly::BenchmarkSuspender suspender;
+  LoadBalancerHashEmulator hasher(
+      algorithm,
+      5,
+      {LoadBalancer::IPv4Field::SOURCE_ADDRESS,
+       LoadBalancer::IPv4Field::DESTINATION_ADDRESS},
+      {LoadBalancer::IPv6Field::SOURCE_ADDRESS,
+       LoadBalancer::IPv6Field::DESTINATION_ADDRESS},
+      {LoadBalancer::TransportField::SOURCE_PORT,
+       LoadBalancer::TransportField::DESTINATION_PORT});
+  auto flows = makeFlows(FLAGS_num_flows);
+  std::vector<uint16_t> hashes(flows.size());
+  suspender.dismiss();
+
+  while (numIters > 0) {
+    auto count = std::min(numIters, flows.size());
+    hasher.hash(
+        folly::Range<const LoadBalancerFlow*>(flows.data(), count),
+        folly::MutableRange<uint16_t*>(hashes.data(), count));
+    folly::doNotOptimizeAway(hashes[count - 1]);
+    numIters -= count;
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(HashIPv6FlowsCrc16, numIters) {
+  hashFlows(cfg::HashingAlgorithm::CRC16_CCITT, numIters);
+}
+
+BENCHMARK_RELATIVE(HashIPv6FlowsCrc32, numIters) {
+  hashFlows(cfg::HashingAlgorithm::CRC32_ETHERNET_HI, numIters);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/LoadBalancerHashEmulator.h"
+#include "fboss/agent/FbossError.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+LoadBalancerHashEmulator fullHash(
+    cfg::HashingAlgorithm algorithm = cfg::HashingAlgorithm::CRC16_CCITT,
+    uint32_t seed = 0) {
+  return LoadBalancerHashEmulator(
+      algorithm,
+      seed,
+      {LoadBalancer::IPv4Field::SOURCE_ADDRESS,
+       LoadBalancer::IPv4Field::DESTINATION_ADDRESS},
+      {LoadBalancer::IPv6Field::SOURCE_ADDRESS,
+       LoadBalancer::IPv6Field::DESTINATION_ADDRESS},
+      {LoadBalancer::TransportField::SOURCE_PORT,
+       LoadBalancer::TransportField::DESTINATION_PORT});
+}
+
+std::vector<LoadBalancerFlow> makeFlows(int count) {
+  std::vector<LoadBalancerFlow> flows;
+  for (int i = 0; i < count; ++i) {
+    auto src = folly::IPAddressV6::fromBinary(folly::ByteRange(
+        std::array<uint8_t, 16>{0x20, 0x01, 0xd, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0,
+                                0, 0, uint8_t(i >> 8), uint8_t(i)}));
+    flows.emplace_back(
+        folly::IPAddress(src),
+        folly::IPAddress("2401:db00::1"),
+        10000 + (i * 7) % 50000,
+        443);
+  }
+  return flows;
+}
+
+} // namespace
+
+TEST(LoadBalancerHashEmulator, CrcCheckValues) {
+  const std::string check = "123456789";
+  auto data = reinterpret_cast<const uint8_t*>(check.data());
+  EXPECT_EQ(0x29B1, loadbalancer_hash::crc16Ccitt(0xFFFF, data, 9));
+  EXPECT_EQ(0x0376E6E7, loadbalancer_hash::crc32(0xFFFFFFFF, data, 9));
+  EXPECT_EQ(0x340BC6D9, loadbalancer_hash::crc32Ethernet(0xFFFFFFFF, data, 9));
+  EXPECT_EQ(0x2EB14879, loadbalancer_hash::crc32Koopman(0xFFFFFFFF, data, 9));
+}
+
+TEST(LoadBalancerHashEmulator, FieldSelection) {
+  LoadBalancerHashEmulator dstOnly(
+      cfg::HashingAlgorithm::CRC32_LO,
+      42,
+      {LoadBalancer::IPv4Field::DESTINATION_ADDRESS},
+      {},
+      {});
+  LoadBalancerFlow f1(
+      folly::IPAddress("10.0.0.1"), folly::IPAddress("10.1.0.1"), 100, 200);
+  LoadBalancerFlow f2(
+      folly::IPAddress("10.0.0.2"), folly::IPAddress("10.1.0.1"), 300, 400);
+  LoadBalancerFlow f3(
+      folly::IPAddress("10.0.0.1"), folly::IPAddress("10.1.0.2"), 100, 200);
+  EXPECT_EQ(dstOnly.hash(f1), dstOnly.hash(f2));
+  EXPECT_NE(dstOnly.hash(f1), dstOnly.hash(f3));
+
+  auto full = fullHash(cfg::HashingAlgorithm::CRC32_LO, 42);
+  EXPECT_NE(full.hash(f1), full.hash(f2));
+}
+
+TEST(LoadBalancerHashEmulator, SeedAndAlgorithmMatter) {
+  auto flows = makeFlows(64);
+  auto base = fullHash(cfg::HashingAlgorithm::CRC32_LO, 1);
+  auto otherSeed = fullHash(cfg::HashingAlgorithm::CRC32_LO, 2);
+  auto hi = fullHash(cfg::HashingAlgorithm::CRC32_HI, 1);
+  int sameSeed = 0;
+  int sameHalf = 0;
+  for (const auto& flow : flows) {
+    sameSeed += base.hash(flow) == otherSeed.hash(flow);
+    sameHalf += base.hash(flow) == hi.hash(flow);
+  }
+  EXPECT_LT(sameSeed, 4);
+  EXPECT_LT(sameHalf, 4);
+}
+
+TEST(LoadBalancerHashEmulator, BatchMatchesSingle) {
+  auto flows = makeFlows(1000);
+  // Mix in IPv4 and MPLS flows to exercise lanes of different key lengths
+  for (int i = 0; i < 100; ++i) {
+    flows[i * 10] = LoadBalancerFlow(
+        folly::IPAddress("10.0.0.1"),
+        folly::IPAddress("10.1.0.1"),
+        1000 + i,
+        80);
+    flows[i * 10 + 1].numLabels = 2;
+    flows[i * 10 + 1].labels = {100u + i, 200, 0};
+  }
+  for (auto algorithm :
+       {cfg::HashingAlgorithm::CRC16_CCITT,
+        cfg::HashingAlgorithm::CRC32_HI,
+        cfg::HashingAlgorithm::CRC32_ETHERNET_LO,
+        cfg::HashingAlgorithm::CRC32_KOOPMAN_HI}) {
+    LoadBalancerHashEmulator hasher(
+        algorithm,
+        0xdeadbeef,
+        {LoadBalancer::IPv4Field::SOURCE_ADDRESS},
+        {LoadBalancer::IPv6Field::SOURCE_ADDRESS,
+         LoadBalancer::IPv6Field::FLOW_LABEL},
+        {LoadBalancer::TransportField::SOURCE_PORT},
+        {LoadBalancer::MPLSField::TOP_LABEL});
+    std::vector<uint16_t> hashes(flows.size());
+    hasher.hash(
+        folly::Range<const LoadBalancerFlow*>(flows.data(), flows.size()),
+        folly::MutableRange<uint16_t*>(hashes.data(), hashes.size()));
+    for (size_t i = 0; i < flows.size(); ++i) {
+      EXPECT_EQ(hasher.hash(flows[i]), hashes[i]);
+    }
+  }
+}
+
+TEST(LoadBalancerHashEmulator, Polarization) {
+  auto flows = makeFlows(1 << 14);
+  auto hasher = fullHash(cfg::HashingAlgorithm::CRC16_CCITT, 7);
+  // Same hash config on both tiers: every flow reaching a second tier switch
+  // was sent there because of its hash, so all of them land on few members.
+  MultiStageEcmpEmulator polarized({{hasher, 4}, {hasher, 4}});
+  auto reports = polarized.run(
+      folly::Range<const LoadBalancerFlow*>(flows.data(), flows.size()));
+  ASSERT_EQ(2, reports.size());
+  EXPECT_EQ(1, reports[0].numSwitches);
+  EXPECT_EQ(4, reports[1].numSwitches);
+  EXPECT_LT(reports[0].maxImbalance, 1.1);
+  EXPECT_GT(reports[1].unusedMembers, 0);
+  EXPECT_GT(reports[1].meanImbalance, 2.0);
+
+  // CRCs are linear, so per switch seeds only permute the members of each
+  // switch and flows stay polarized
+  MultiStageEcmpEmulator seeded({{hasher, 4, true}, {hasher, 4, true}});
+  reports = seeded.run(
+      folly::Range<const LoadBalancerFlow*>(flows.data(), flows.size()));
+  EXPECT_GT(reports[1].unusedMembers, 0);
+
+  // Using the other half of a different CRC on the second stage fixes it
+  auto hi = fullHash(cfg::HashingAlgorithm::CRC32_HI, 7);
+  MultiStageEcmpEmulator mixed({{hasher, 4}, {hi, 4}});
+  reports = mixed.run(
+      folly::Range<const LoadBalancerFlow*>(flows.data(), flows.size()));
+  EXPECT_EQ(0, reports[1].unusedMembers);
+  EXPECT_LT(reports[1].maxImbalance, 1.2);
+}
+
+TEST(LoadBalancerHashEmulator, InvalidStages) {
+  std::vector<MultiStageEcmpEmulator::Stage> stages;
+  stages.push_back({fullHash(), 0});
+  EXPECT_THROW(MultiStageEcmpEmulator{stages}, FbossError);
+}
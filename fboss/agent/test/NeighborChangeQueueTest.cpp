@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborChangeQueue.h"
+
+#include <folly/IPAddress.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using std::chrono::seconds;
+
+namespace {
+
+const auto kStart = NeighborChangeQueue::Clock::time_point(seconds(1000));
+
+std::vector<IPAddress> sorted(std::vector<IPAddress> ips) {
+  std::sort(ips.begin(), ips.end());
+  return ips;
+}
+
+} // namespace
+
+TEST(NeighborChangeQueue, emptyTake) {
+  NeighborChangeQueue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.take());
+}
+
+TEST(NeighborChangeQueue, coalesce) {
+  NeighborChangeQueue queue;
+  IPAddress ip1("10.0.0.1");
+  IPAddress ip2("2401:db00::1");
+  IPAddress ip3("10.0.0.3");
+  queue.neighborAdded(ip1, kStart + seconds(2));
+  queue.neighborAdded(ip1, kStart + seconds(3));
+  queue.neighborAdded(ip2, kStart + seconds(1));
+  queue.neighborRemoved(ip3, kStart + seconds(4));
+  EXPECT_EQ(3, queue.numPending());
+
+  auto changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_EQ(sorted({ip1, ip2}), sorted(changes->added));
+  EXPECT_EQ(std::vector<IPAddress>{ip3}, changes->removed);
+  EXPECT_FALSE(changes->resync);
+  EXPECT_EQ(kStart + seconds(1), changes->oldestChange);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.take());
+}
+
+TEST(NeighborChangeQueue, flapsCancelOut) {
+  NeighborChangeQueue queue;
+  IPAddress ip1("10.0.0.1");
+  IPAddress ip2("10.0.0.2");
+  IPAddress ip3("10.0.0.3");
+  // Resolved and gone again before delivery
+  queue.neighborAdded(ip1, kStart);
+  queue.neighborRemoved(ip1, kStart);
+  // Gone and back again
+  queue.neighborRemoved(ip2, kStart);
+  queue.neighborAdded(ip2, kStart);
+  EXPECT_FALSE(queue.take());
+
+  // The last state wins over any number of flaps
+  queue.neighborAdded(ip3, kStart);
+  for (int i = 0; i < 10; i++) {
+    queue.neighborRemoved(ip3, kStart);
+    queue.neighborAdded(ip3, kStart);
+  }
+  auto changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_EQ(std::vector<IPAddress>{ip3}, changes->added);
+  EXPECT_TRUE(changes->removed.empty());
+}
+
+TEST(NeighborChangeQueue, overflowResyncs) {
+  NeighborChangeQueue queue(2);
+  queue.neighborAdded(IPAddress("10.0.0.1"), kStart + seconds(1));
+  queue.neighborAdded(IPAddress("10.0.0.2"), kStart + seconds(2));
+  // Changes to pending neighbors still fit
+  queue.neighborRemoved(IPAddress("10.0.0.2"), kStart + seconds(3));
+  EXPECT_FALSE(queue.resyncPending());
+
+  queue.neighborAdded(IPAddress("10.0.0.3"), kStart + seconds(4));
+  EXPECT_TRUE(queue.resyncPending());
+  EXPECT_EQ(0, queue.numPending());
+  // Covered by the resync
+  queue.neighborRemoved(IPAddress("10.0.0.4"), kStart + seconds(5));
+  EXPECT_EQ(0, queue.numPending());
+
+  auto changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(changes->resync);
+  EXPECT_TRUE(changes->added.empty());
+  EXPECT_TRUE(changes->removed.empty());
+  EXPECT_EQ(kStart + seconds(1), changes->oldestChange);
+
+  // Back to incremental changes
+  queue.neighborAdded(IPAddress("10.0.0.5"), kStart + seconds(6));
+  changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_FALSE(changes->resync);
+  EXPECT_EQ(1, changes->added.size());
+  EXPECT_EQ(kStart + seconds(6), changes->oldestChange);
+}
+
+TEST(NeighborChangeQueue, requestResync) {
+  NeighborChangeQueue queue;
+  queue.requestResync(kStart);
+  EXPECT_FALSE(queue.empty());
+  auto changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(changes->resync);
+  EXPECT_EQ(kStart, changes->oldestChange);
+}
+
+TEST(NeighborChangeQueue, churnStaysBounded) {
+  // A slow listener under churn: neighbors from a small pool flap while one
+  // delivery is outstanding. The queue only grows with the pool size.
+  NeighborChangeQueue queue(1000);
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 256; i++) {
+      auto ip = IPAddress::fromLong(0x0a000000 + i);
+      auto now = kStart + seconds(round);
+      // Half of the neighbors settle as resolved, the other half flap back
+      // to where they started
+      if (round % 2 == 0 || i < 128) {
+        queue.neighborAdded(ip, now);
+      } else {
+        queue.neighborRemoved(ip, now);
+      }
+    }
+  }
+  EXPECT_FALSE(queue.resyncPending());
+  EXPECT_EQ(256, queue.numPending());
+
+  auto changes = queue.take();
+  ASSERT_TRUE(changes);
+  EXPECT_EQ(128, changes->added.size());
+  EXPECT_TRUE(changes->removed.empty());
+  // The lag is measured from the first change not yet delivered
+  EXPECT_EQ(kStart, changes->oldestChange);
+}
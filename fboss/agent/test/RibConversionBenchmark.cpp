@@ -22,12 +22,16 @@
 #include <folly/MacAddress.h>
 #include <folly/dynamic.h>
 
+#include <map>
+#include <memory>
+
 using namespace facebook::fboss;
 
-template <typename Generator>
-static void runConversionBenchmark() {
-  auto constexpr kEcmpWidth = 4;
+namespace {
+
+auto constexpr kEcmpWidth = 4;
 
+std::unique_ptr<HwTestHandle> setupTestHandle() {
   SimPlatform plat(folly::MacAddress(), 128);
   std::vector<PortID> ports;
   for (int i = 0; i < 128; ++i) {
@@ -51,16 +55,87 @@ static void runConversionBenchmark() {
             std::make_shared<RouteTable>(RouterID(0)));
         return newState;
       });
+  return testHandle;
+}
+
+struct ScaleRoutes {
+  std::shared_ptr<RouteTableMap> swStateTables;
+  folly::dynamic swStateTablesJson;
+  std::unique_ptr<rib::RoutingInformationBase> standaloneRib;
+};
 
+/*
+ * Generating a million routes takes much longer than converting them, so
+ * each route count is generated once and shared by the benchmarks.
+ */
+const ScaleRoutes& getScaleRoutes(uint32_t numRoutes) {
+  static std::map<uint32_t, ScaleRoutes> scaleRoutes;
+  auto it = scaleRoutes.find(numRoutes);
+  if (it != scaleRoutes.end()) {
+    return it->second;
+  }
+  auto testHandle = setupTestHandle();
+  // Half v6 /64s, half v4 /24s, the bulk of a full table
+  utility::RouteDistributionGenerator generator(
+      testHandle->getSw()->getAppliedState(),
+      {{64, numRoutes / 2}},
+      {{24, numRoutes - numRoutes / 2}},
+      4000,
+      kEcmpWidth);
+  auto swStateTables = generator.getSwitchStates().back()->getRouteTables();
+  auto& routes = scaleRoutes[numRoutes];
+  routes.swStateTables = swStateTables;
+  routes.swStateTablesJson = swStateTables->toFollyDynamic();
+  routes.standaloneRib = std::make_unique<rib::RoutingInformationBase>(
+      switchStateToStandaloneRib(swStateTables));
+  return routes;
+}
+
+} // namespace
+
+template <typename Generator>
+static void runConversionBenchmark() {
+  folly::BenchmarkSuspender suspender;
+  auto testHandle = setupTestHandle();
+  auto sw = testHandle->getSw();
   auto generator = Generator(sw->getAppliedState(), 1337, kEcmpWidth);
   const auto& states = generator.getSwitchStates();
   auto state = states[states.size() - 1];
+  suspender.dismiss();
 
   auto swStateTables = state->getRouteTables();
   auto standaloneRib = switchStateToStandaloneRib(swStateTables);
   auto swStateRib = standaloneToSwitchStateRib(standaloneRib);
 
   syncFibWithStandaloneRib(standaloneRib, sw);
+  suspender.rehire();
+}
+
+static void switchStateToStandalone(uint32_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  const auto& routes = getScaleRoutes(numRoutes);
+  suspender.dismiss();
+
+  auto standaloneRib = switchStateToStandaloneRib(routes.swStateTables);
+  suspender.rehire();
+}
+
+static void switchStateJsonToStandalone(uint32_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  const auto& routes = getScaleRoutes(numRoutes);
+  suspender.dismiss();
+
+  auto standaloneRib = switchStateToStandaloneRib(routes.swStateTablesJson);
+  suspender.rehire();
+}
+
+static void standaloneToSwitchState(uint32_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  const auto& routes = getScaleRoutes(numRoutes);
+  suspender.dismiss();
+
+  auto swStateRib = standaloneToSwitchStateRib(*routes.standaloneRib);
+  suspender.rehire();
 }
 
 BENCHMARK(RibConversionFSW) {
@@ -79,6 +154,15 @@ BENCHMARK(RibConversionHgridUu) {
   runConversionBenchmark<utility::HgridUuRouteScaleGenerator>();
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(switchStateToStandalone, 100000)
+BENCHMARK_PARAM(switchStateToStandalone, 1000000)
+BENCHMARK_PARAM(switchStateJsonToStandalone, 100000)
+BENCHMARK_PARAM(switchStateJsonToStandalone, 1000000)
+BENCHMARK_PARAM(standaloneToSwitchState, 100000)
+BENCHMARK_PARAM(standaloneToSwitchState, 1000000)
+
 int main(int argc, char** argv) {
   facebook::initFacebook(&argc, &argv);
   folly::runBenchmarks();
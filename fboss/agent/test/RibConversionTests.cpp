@@ -59,6 +59,12 @@ static void runConversionTest() {
   auto standaloneRib = switchStateToStandaloneRib(swStateTables);
   auto swStateRib = standaloneToSwitchStateRib(standaloneRib);
   EXPECT_EQ(swStateRib->toFollyDynamic(), swStateTables->toFollyDynamic());
+  EXPECT_TRUE(
+      switchStateToStandaloneRib(swStateTables->toFollyDynamic()) ==
+      standaloneRib);
+  EXPECT_TRUE(
+      rib::RoutingInformationBase::fromFollyDynamic(
+          standaloneRib.toFollyDynamic()) == standaloneRib);
 
   syncFibWithStandaloneRib(standaloneRib, sw);
 
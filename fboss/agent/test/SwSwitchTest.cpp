@@ -18,6 +18,7 @@
 #include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/test/CounterCache.h"
@@ -28,8 +29,12 @@
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 
+DECLARE_int32(max_route_changes_per_hw_update);
+
 using namespace facebook::fboss;
 using folly::IPAddressV4;
 using folly::IPAddressV6;
@@ -125,6 +130,45 @@ TEST_F(SwSwitchTest, HwRejectsUpdateThenAccepts) {
   EXPECT_EQ(0, counters.value(SwitchStats::kCounterPrefix + "hw_out_of_sync"));
 }
 
+TEST_F(SwSwitchTest, SlicedUpdateKeepsDesiredState) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_max_route_changes_per_hw_update = 10;
+  CounterCache counters(sw);
+  auto numRoutes = [](const std::shared_ptr<SwitchState>& state) {
+    return state->getRouteTables()->getRouteTable(RouterID(0))->getRibV4()
+        ->size();
+  };
+  auto origRoutes = numRoutes(sw->getState());
+
+  sw->updateStateBlocking(
+      "Add routes", [](const std::shared_ptr<SwitchState>& state) {
+        RouteUpdater updater(state->getRouteTables());
+        for (uint32_t i = 0; i < 100; ++i) {
+          updater.addRoute(
+              RouterID(0),
+              folly::IPAddressV4::fromLongHBO(0x64000000 | (i << 8)),
+              24,
+              ClientID::BGPD,
+              RouteNextHopEntry(RouteForwardAction::DROP, AdminDistance::EBGP));
+        }
+        auto newState = state->clone();
+        newState->resetRouteTables(updater.updateDone());
+        return newState;
+      });
+  // Callers see their changes before all slices are programmed
+  EXPECT_EQ(numRoutes(sw->getState()), origRoutes + 100);
+
+  // Each pass programs one more slice
+  for (int i = 0; i < 10 && sw->getAppliedState() != sw->getDesiredState();
+       ++i) {
+    waitForStateUpdates(sw);
+  }
+  EXPECT_EQ(sw->getAppliedState(), sw->getDesiredState());
+  EXPECT_EQ(numRoutes(sw->getAppliedState()), origRoutes + 100);
+  counters.update();
+  EXPECT_EQ(0, counters.value(SwitchStats::kCounterPrefix + "hw_out_of_sync"));
+}
+
 TEST_F(SwSwitchTest, TestStateNonCoalescing) {
   const PortID kPort1{1};
   const VlanID kVlan1{1};
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Restore throughput of the Thrifty state nodes from the JSON warm boot
+ * representation (folly::dynamic -> JSON string -> SimpleJSON) compared to
+ * the binary Thrift protocols.
+ */
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortQueue.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kNumNodes = 1000;
+
+std::shared_ptr<PortQueue> makeQueue(uint8_t id) {
+  auto queue = std::make_shared<PortQueue>(id);
+  queue->setName(folly::to<std::string>("queue", id));
+  queue->setStreamType(cfg::StreamType::UNICAST);
+  queue->setScheduling(cfg::QueueScheduling::WEIGHTED_ROUND_ROBIN);
+  queue->setWeight(id + 1);
+  queue->setReservedBytes(3328);
+  queue->setSharedBytes(19968);
+  queue->setScalingFactor(cfg::MMUScalingFactor::ONE);
+  return queue;
+}
+
+std::shared_ptr<Port> makePort(int id) {
+  auto port = std::make_shared<Port>(
+      PortID(id), folly::to<std::string>("eth1/", id, "/1"));
+  port->setDescription("benchmark port");
+  port->setAdminState(cfg::PortState::ENABLED);
+  port->setSpeed(cfg::PortSpeed::HUNDREDG);
+  port->setIngressVlan(VlanID(2000));
+  port->addVlan(VlanID(2000), false);
+  port->setMaxFrameSize(9412);
+  QueueConfig queues;
+  for (uint8_t q = 0; q < 8; ++q) {
+    queues.push_back(makeQueue(q));
+  }
+  port->resetPortQueues(queues);
+  return port;
+}
+
+template <typename Node>
+std::vector<std::shared_ptr<Node>> makeNodes();
+
+template <>
+std::vector<std::shared_ptr<Port>> makeNodes<Port>() {
+  std::vector<std::shared_ptr<Port>> ports;
+  for (int i = 1; i <= kNumNodes; ++i) {
+    ports.push_back(makePort(i));
+  }
+  return ports;
+}
+
+template <>
+std::vector<std::shared_ptr<PortQueue>> makeNodes<PortQueue>() {
+  std::vector<std::shared_ptr<PortQueue>> queues;
+  for (int i = 0; i < kNumNodes; ++i) {
+    queues.push_back(makeQueue(i % 8));
+  }
+  return queues;
+}
+
+template <typename Node>
+void restoreFromFollyDynamic(unsigned iters) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<folly::dynamic> serialized;
+  for (const auto& node : makeNodes<Node>()) {
+    serialized.push_back(node->toFollyDynamic());
+  }
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    for (const auto& dyn : serialized) {
+      folly::doNotOptimizeAway(Node::fromFollyDynamic(dyn));
+    }
+  }
+}
+
+template <typename Node, typename Serializer>
+void restoreFromThrift(unsigned iters) {
+  folly::BenchmarkSuspender suspender;
+  std::vector<std::string> serialized;
+  for (const auto& node : makeNodes<Node>()) {
+    serialized.push_back(node->template serialize<Serializer>());
+  }
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    for (const auto& buf : serialized) {
+      folly::doNotOptimizeAway(Node::template deserialize<Serializer>(buf));
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(PortRestoreFollyDynamic, iters) {
+  restoreFromFollyDynamic<Port>(iters);
+}
+
+BENCHMARK_RELATIVE(PortRestoreCompact, iters) {
+  restoreFromThrift<Port, apache::thrift::CompactSerializer>(iters);
+}
+
+BENCHMARK_RELATIVE(PortRestoreBinary, iters) {
+  restoreFromThrift<Port, apache::thrift::BinarySerializer>(iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(PortQueueRestoreFollyDynamic, iters) {
+  restoreFromFollyDynamic<PortQueue>(iters);
+}
+
+BENCHMARK_RELATIVE(PortQueueRestoreCompact, iters) {
+  restoreFromThrift<PortQueue, apache::thrift::CompactSerializer>(iters);
+}
+
+BENCHMARK_RELATIVE(PortQueueRestoreBinary, iters) {
+  restoreFromThrift<PortQueue, apache::thrift::BinarySerializer>(iters);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
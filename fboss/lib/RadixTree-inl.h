@@ -261,6 +261,95 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
   return std::make_pair(traits_.makeItr(newNodeRaw), true);
 }
 
+template <typename IPADDRTYPE, typename T, typename TreeTraits>
+void RadixTree<IPADDRTYPE, T, TreeTraits>::bulkLoad(
+    std::vector<BulkLoadEntry> entries) {
+  CHECK(!root_) << "bulkLoad requires an empty tree";
+  // Can't trust the clients to have 0s in all bits after mask length
+  for (auto& entry : entries) {
+    entry.ipAddress = entry.ipAddress.mask(entry.masklen);
+  }
+  auto inTreeOrder = [](const BulkLoadEntry& a, const BulkLoadEntry& b) {
+    return a.ipAddress < b.ipAddress ||
+        (a.ipAddress == b.ipAddress && a.masklen < b.masklen);
+  };
+  if (!std::is_sorted(entries.begin(), entries.end(), inTreeOrder)) {
+    // Stable, so that the last of duplicate entries still wins
+    std::stable_sort(entries.begin(), entries.end(), inTreeOrder);
+  }
+
+  // Path from the root to the last added node. Every following prefix is
+  // either below one of these nodes or on the right of the whole tree.
+  std::vector<TreeNode*> rightEdge;
+  rightEdge.reserve(IPADDRTYPE::bitCount() + 1);
+  for (auto& entry : entries) {
+    const auto& toAdd = entry.ipAddress;
+    auto mask = entry.masklen;
+    if (!rightEdge.empty() && rightEdge.back()->ipAddress() == toAdd &&
+        rightEdge.back()->masklen() == mask) {
+      rightEdge.back()->setValue(std::move(entry.value));
+      continue;
+    }
+    // Go up until a node covers the new prefix
+    auto toAddDirection = TreeDirection::PARENT;
+    while (!rightEdge.empty()) {
+      toAddDirection = rightEdge.back()->searchDirection(toAdd, mask);
+      if (toAddDirection == TreeDirection::LEFT ||
+          toAddDirection == TreeDirection::RIGHT) {
+        break;
+      }
+      CHECK(toAddDirection != TreeDirection::THIS_NODE);
+      rightEdge.pop_back();
+    }
+    auto newNode = makeNode(toAdd, mask, std::move(entry.value));
+    auto newNodeRaw = newNode.get();
+    ++size_;
+
+    TreeNode* parent = rightEdge.empty() ? nullptr : rightEdge.back();
+    TreeNode* sibling = parent
+        ? (toAddDirection == TreeDirection::LEFT ? parent->left()
+                                                 : parent->right())
+        : root_.get();
+    if (!sibling) {
+      if (!parent) {
+        makeRoot(std::move(newNode));
+      } else if (toAddDirection == TreeDirection::LEFT) {
+        parent->resetLeft(std::move(newNode));
+      } else {
+        parent->resetRight(std::move(newNode));
+      }
+      rightEdge.push_back(newNodeRaw);
+      continue;
+    }
+    // The new prefix is neither below nor above the subtree added last in
+    // this direction, so it gets a non value parent in common with it. As
+    // prefixes are sorted, the existing subtree goes on the left.
+    auto prefix = IPADDRTYPE::longestCommonPrefix(
+        {sibling->ipAddress(), sibling->masklen()}, {toAdd, mask});
+    DCHECK(prefix.second < mask);
+    auto internalNode = makeNode(prefix.first, prefix.second);
+    auto internalNodeRaw = internalNode.get();
+    std::unique_ptr<TreeNode> oldSibling;
+    if (!parent) {
+      oldSibling = std::move(root_);
+      makeRoot(std::move(internalNode));
+    } else if (toAddDirection == TreeDirection::LEFT) {
+      oldSibling = parent->resetLeft(std::move(internalNode));
+    } else {
+      oldSibling = parent->resetRight(std::move(internalNode));
+    }
+    DCHECK(
+        internalNodeRaw->searchDirection(oldSibling.get()) ==
+        TreeDirection::LEFT);
+    DCHECK(
+        internalNodeRaw->searchDirection(newNodeRaw) == TreeDirection::RIGHT);
+    internalNodeRaw->resetLeft(std::move(oldSibling));
+    internalNodeRaw->resetRight(std::move(newNode));
+    rightEdge.push_back(internalNodeRaw);
+    rightEdge.push_back(newNodeRaw);
+  }
+}
+
 /*
  * One condition that must be true before and after erase
  * is that all non value nodes should have 2 children. Assuming
@@ -445,6 +445,43 @@ class RadixTree {
   std::pair<Iterator, bool>
   insert(const IPADDRTYPE& ipaddr, uint8_t masklen, VALUE&& value);
 
+  struct BulkLoadEntry {
+    IPADDRTYPE ipAddress;
+    uint8_t masklen;
+    T value;
+  };
+
+  /*
+   * Build an empty tree from entries in a single linear pass. Rather than
+   * walking down from the root for each prefix like insert(), nodes are
+   * appended along the right edge of the tree, which requires entries in
+   * iteration order: by masked address, then by mask length. Entries which
+   * are not in that order are sorted first. For duplicate prefixes the last
+   * entry wins.
+   */
+  void bulkLoad(std::vector<BulkLoadEntry> entries);
+
+  /*
+   * Whether inserting the prefixes of this tree one at a time with insert()
+   * yields the same tree. Used to validate bulkLoad().
+   */
+  template <typename U = T>
+  typename std::enable_if<std::is_copy_constructible<U>::value, bool>::type
+  equalsIncrementalInsertion() const {
+    std::vector<const TreeNode*> nodes;
+    nodes.reserve(size_);
+    for (const auto& node : *this) {
+      nodes.push_back(&node);
+    }
+    // Insert in reverse iteration order, so that nodes get split rather than
+    // appended as in bulkLoad()
+    RadixTree incremental;
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+      incremental.insert((*it)->ipAddress(), (*it)->masklen(), (*it)->value());
+    }
+    return incremental == *this;
+  }
+
   // Erase a IP, mask
   bool erase(const IPADDRTYPE& ipaddr, uint8_t masklen) {
     return erase(exactMatch(ipaddr, masklen));
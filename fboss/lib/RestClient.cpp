@@ -9,21 +9,86 @@
  */
 #include "RestClient.h"
 
-#include <sstream>
-
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/Utils.h"
+
+#include <folly/io/async/EventHandler.h>
+#include <folly/logging/xlog.h>
+
+namespace {
+// Requests beyond this many connections to the server are queued by curl
+constexpr long kMaxConnections = 4;
 
-#include <curl/curl.h>
+void initCurl() {
+  static const CURLcode ret = curl_global_init(CURL_GLOBAL_DEFAULT);
+  if (ret != CURLE_OK) {
+    throw facebook::fboss::FbossError(
+        "Error initializing curl: ", curl_easy_strerror(ret));
+  }
+}
+} // namespace
 
 namespace facebook::fboss {
+
+struct RestClient::Request {
+  std::string path;
+  std::string url;
+  std::string output;
+  // for curl errors
+  char error[CURL_ERROR_SIZE]{};
+  std::chrono::steady_clock::time_point startTime;
+  folly::Promise<std::string> promise;
+};
+
+/*
+ * Watches a socket of the curl multi handle on the event base
+ */
+class RestClient::SocketHandler : public folly::EventHandler {
+ public:
+  SocketHandler(RestClient* client, curl_socket_t fd)
+      : folly::EventHandler(
+            &client->eventBase_,
+            folly::NetworkSocket::fromFd(fd)),
+        client_(client),
+        fd_(fd) {}
+
+  void update(int what) {
+    uint16_t events = folly::EventHandler::PERSIST;
+    if (what & CURL_POLL_IN) {
+      events |= folly::EventHandler::READ;
+    }
+    if (what & CURL_POLL_OUT) {
+      events |= folly::EventHandler::WRITE;
+    }
+    registerHandler(events);
+  }
+
+  void handlerReady(uint16_t events) noexcept override {
+    int action = 0;
+    if (events & folly::EventHandler::READ) {
+      action |= CURL_CSELECT_IN;
+    }
+    if (events & folly::EventHandler::WRITE) {
+      action |= CURL_CSELECT_OUT;
+    }
+    client_->socketAction(fd_, action);
+  }
+
+ private:
+  RestClient* client_;
+  curl_socket_t fd_;
+};
+
 RestClient::RestClient(std::string hostname, int port)
     : hostname_(hostname), port_(port) {
   createEndpoint();
+  start();
 }
 
 RestClient::RestClient(folly::IPAddress ipAddress, int port)
     : ipAddress_(ipAddress), port_(port) {
   createEndpoint();
+  start();
 }
 RestClient::RestClient(
     folly::IPAddress ipAddress,
@@ -31,6 +96,28 @@ RestClient::RestClient(
     std::string interface)
     : ipAddress_(ipAddress), interface_(interface), port_(port) {
   createEndpoint();
+  start();
+}
+
+RestClient::~RestClient() {
+  eventBase_.runInEventBaseThreadAndWait([&] {
+    curlTimeout_->cancelTimeout();
+    for (auto& [easy, request] : inFlight_) {
+      curl_multi_remove_handle(multi_, easy);
+      curl_easy_cleanup(easy);
+      request->promise.setException(
+          FbossError("Error querying api: ", request->url, " client stopped"));
+    }
+    inFlight_.clear();
+    for (auto easy : idleHandles_) {
+      curl_easy_cleanup(easy);
+    }
+    idleHandles_.clear();
+    // Closes the remaining sockets, through socketCallback()
+    curl_multi_cleanup(multi_);
+    eventBase_.terminateLoopSoon();
+  });
+  thread_->join();
 }
 
 void RestClient::createEndpoint() {
@@ -46,44 +133,53 @@ void RestClient::createEndpoint() {
   }
 }
 
+void RestClient::start() {
+  initCurl();
+  multi_ = curl_multi_init();
+  if (!multi_) {
+    throw FbossError("Error initializing curl interface");
+  }
+  curl_multi_setopt(
+      multi_, CURLMOPT_SOCKETFUNCTION, RestClient::socketCallback);
+  curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(
+      multi_, CURLMOPT_TIMERFUNCTION, RestClient::timerCallback);
+  curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+  // Multiplex concurrent requests on one connection if the server supports
+  // it, otherwise spread them on a few persistent connections.
+  curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, kMaxConnections);
+  curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, kMaxConnections);
+
+  curlTimeout_ = folly::AsyncTimeout::make(eventBase_, [this]() noexcept {
+    socketAction(CURL_SOCKET_TIMEOUT, 0);
+  });
+  thread_ = std::make_unique<std::thread>([this]() {
+    initThread("RestClient");
+    eventBase_.loopForever();
+  });
+}
+
 void RestClient::setTimeout(std::chrono::milliseconds timeout) {
   timeout_ = timeout;
 }
 
 std::string RestClient::requestWithOutput(std::string path) {
-  CURL* curl;
-  CURLcode resp;
-  std::stringbuf write_buffer;
-  endpoint_ = endpoint_ + path;
-  /* for curl errors */
-  char error[CURL_ERROR_SIZE];
-
-  curl = curl_easy_init();
-  if (curl) {
-    /* Set the curl options */
-    curl_easy_setopt(curl, CURLOPT_URL, endpoint_.c_str());
-    curl_easy_setopt(curl, CURLOPT_PROTOCOLS, CURLPROTO_HTTP);
-    curl_easy_setopt(curl, CURLOPT_PORT, port_);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_.count());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, RestClient::writer);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &write_buffer);
-    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error);
-    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
-
-    /* if an interface is specified use that */
-    if (!interface_.empty()) {
-      curl_easy_setopt(curl, CURLOPT_INTERFACE, interface_.c_str());
-    }
+  return futureRequestWithOutput(std::move(path)).get();
+}
 
-    resp = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    if (resp == CURLE_OK) {
-      return write_buffer.str();
-    } else {
-      throw FbossError("Error querying api: ", endpoint_, " error: ", error);
-    }
-  }
-  throw FbossError("Error initializing curl interface");
+folly::SemiFuture<std::string> RestClient::futureRequestWithOutput(
+    std::string path) {
+  auto request = std::make_unique<Request>();
+  request->url = endpoint_ + path;
+  request->path = std::move(path);
+  request->startTime = std::chrono::steady_clock::now();
+  auto future = request->promise.getSemiFuture();
+  eventBase_.runInEventBaseThread(
+      [this, request = std::move(request)]() mutable {
+        startRequest(std::move(request));
+      });
+  return future;
 }
 
 bool RestClient::request(std::string path) {
@@ -95,13 +191,150 @@ bool RestClient::request(std::string path) {
   return false;
 }
 
+std::map<std::string, RestClient::EndpointStats> RestClient::getEndpointStats()
+    const {
+  return endpointStats_.copy();
+}
+
+CURL* RestClient::getEasyHandle() {
+  if (idleHandles_.empty()) {
+    return curl_easy_init();
+  }
+  auto easy = idleHandles_.back();
+  idleHandles_.pop_back();
+  curl_easy_reset(easy);
+  return easy;
+}
+
+void RestClient::startRequest(std::unique_ptr<Request> request) {
+  CURL* curl = getEasyHandle();
+  if (!curl) {
+    request->promise.setException(
+        FbossError("Error initializing curl interface"));
+    return;
+  }
+
+  /* Set the curl options */
+  curl_easy_setopt(curl, CURLOPT_URL, request->url.c_str());
+  curl_easy_setopt(curl, CURLOPT_PROTOCOLS, CURLPROTO_HTTP);
+  curl_easy_setopt(curl, CURLOPT_PORT, port_);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_.load().count());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, RestClient::writer);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &request->output);
+  curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, request->error);
+  curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+  // Rather multiplex on a connection being set up than open another one
+  curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+  // Signals are not thread safe, and not needed to time out with a multi
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+  /* if an interface is specified use that */
+  if (!interface_.empty()) {
+    curl_easy_setopt(curl, CURLOPT_INTERFACE, interface_.c_str());
+  }
+
+  auto resp = curl_multi_add_handle(multi_, curl);
+  if (resp != CURLM_OK) {
+    curl_easy_cleanup(curl);
+    request->promise.setException(FbossError(
+        "Error querying api: ",
+        request->url,
+        " error: ",
+        curl_multi_strerror(resp)));
+    return;
+  }
+  inFlight_.emplace(curl, std::move(request));
+}
+
+void RestClient::socketAction(curl_socket_t fd, int events) {
+  int running;
+  curl_multi_socket_action(multi_, fd, events, &running);
+  completeRequests();
+}
+
+void RestClient::completeRequests() {
+  CURLMsg* msg;
+  int pending;
+  while ((msg = curl_multi_info_read(multi_, &pending))) {
+    if (msg->msg != CURLMSG_DONE) {
+      continue;
+    }
+    CURL* curl = msg->easy_handle;
+    CURLcode resp = msg->data.result;
+    long numConnects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &numConnects);
+    numConnections_ += numConnects;
+
+    curl_multi_remove_handle(multi_, curl);
+    auto it = inFlight_.find(curl);
+    auto request = std::move(it->second);
+    inFlight_.erase(it);
+    idleHandles_.push_back(curl);
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - request->startTime);
+    {
+      auto stats = endpointStats_.wlock();
+      auto& endpointStats = (*stats)[request->path];
+      ++endpointStats.requests;
+      endpointStats.failures += resp != CURLE_OK;
+      endpointStats.totalLatency += latency;
+      endpointStats.maxLatency = std::max(endpointStats.maxLatency, latency);
+    }
+
+    if (resp == CURLE_OK) {
+      request->promise.setValue(std::move(request->output));
+    } else {
+      XLOG(DBG2) << "Error querying api: " << request->url
+                 << " error: " << request->error;
+      request->promise.setException(FbossError(
+          "Error querying api: ", request->url, " error: ", request->error));
+    }
+  }
+}
+
+int RestClient::socketCallback(
+    CURL* /* easy */,
+    curl_socket_t fd,
+    int what,
+    void* userp,
+    void* socketp) {
+  auto client = static_cast<RestClient*>(userp);
+  auto handler = static_cast<SocketHandler*>(socketp);
+  if (what == CURL_POLL_REMOVE) {
+    delete handler;
+    return 0;
+  }
+  if (!handler) {
+    handler = new SocketHandler(client, fd);
+    curl_multi_assign(client->multi_, fd, handler);
+  }
+  handler->update(what);
+  return 0;
+}
+
+int RestClient::timerCallback(
+    CURLM* /* multi */,
+    long timeoutMs,
+    void* userp) {
+  auto client = static_cast<RestClient*>(userp);
+  if (timeoutMs < 0) {
+    client->curlTimeout_->cancelTimeout();
+  } else {
+    // curl can't be called back from here, even with a 0 timeout
+    client->curlTimeout_->scheduleTimeout(
+        std::chrono::milliseconds(timeoutMs));
+  }
+  return 0;
+}
+
 size_t RestClient::writer(
     char* buffer,
     size_t size,
     size_t entries,
-    std::stringbuf* writer_buffer) {
-  std::streamsize data_put = writer_buffer->sputn(buffer, size * entries);
-  return data_put;
+    std::string* writer_buffer) {
+  writer_buffer->append(buffer, size * entries);
+  return size * entries;
 }
 
 } // namespace facebook::fboss
@@ -9,24 +9,70 @@
  */
 #pragma once
 
+#include <curl/curl.h>
 #include <folly/IPAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <atomic>
 #include <chrono>
+#include <map>
+#include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace facebook::fboss {
+
+/*
+ * Client of an HTTP rest api, e.g. the one of the BMC.
+ *
+ * Requests are run by a curl multi handle driven from the event base of the
+ * client, so they don't block the thread issuing them, several can be in
+ * flight at once, and connections to the server are kept open and reused
+ * across requests. The synchronous request() and requestWithOutput() simply
+ * wait for the asynchronous version.
+ */
 class RestClient {
  public:
+  struct EndpointStats {
+    uint64_t requests{0};
+    uint64_t failures{0};
+    std::chrono::microseconds totalLatency{0};
+    std::chrono::microseconds maxLatency{0};
+  };
+
   RestClient(std::string hostname, int port);
   RestClient(folly::IPAddress ipAddress, int port);
   RestClient(folly::IPAddress ipAddress, int port, std::string interface);
+  virtual ~RestClient();
+
   /*
    * Calls the particular Rest api
    */
   bool request(std::string path);
   std::string requestWithOutput(std::string path);
+  folly::SemiFuture<std::string> futureRequestWithOutput(std::string path);
   void setTimeout(std::chrono::milliseconds timeout);
 
+  /*
+   * Latency of the requests completed so far, per path
+   */
+  std::map<std::string, EndpointStats> getEndpointStats() const;
+
+  /*
+   * Number of connections opened to the server so far
+   */
+  uint64_t getNumConnections() const {
+    return numConnections_.load(std::memory_order_relaxed);
+  }
+
  private:
+  class SocketHandler;
+  struct Request;
+
   // Forbidden copy contructor and assignment operator
   RestClient(RestClient const&) = delete;
   RestClient& operator=(RestClient const&) = delete;
@@ -35,14 +81,42 @@ class RestClient {
       char* buffer,
       size_t size,
       size_t entries,
-      std::stringbuf* writer_buffer);
+      std::string* writer_buffer);
+  static int socketCallback(
+      CURL* easy,
+      curl_socket_t fd,
+      int what,
+      void* userp,
+      void* socketp);
+  static int timerCallback(CURLM* multi, long timeoutMs, void* userp);
+
   void createEndpoint();
+  void start();
+
+  // The rest is only called in the event base thread
+  void startRequest(std::unique_ptr<Request> request);
+  void socketAction(curl_socket_t fd, int events);
+  void completeRequests();
+  CURL* getEasyHandle();
+
   std::string hostname_;
   folly::IPAddress ipAddress_;
   std::string interface_;
   int port_;
-  std::chrono::milliseconds timeout_{1000};
+  std::atomic<std::chrono::milliseconds> timeout_{
+      std::chrono::milliseconds(1000)};
   std::string endpoint_;
+
+  folly::Synchronized<std::map<std::string, EndpointStats>> endpointStats_;
+  std::atomic<uint64_t> numConnections_{0};
+
+  folly::EventBase eventBase_;
+  std::unique_ptr<std::thread> thread_;
+  CURLM* multi_{nullptr};
+  std::unique_ptr<folly::AsyncTimeout> curlTimeout_;
+  std::unordered_map<CURL*, std::unique_ptr<Request>> inFlight_;
+  // Easy handles of completed requests, reused for later ones
+  std::vector<CURL*> idleHandles_;
 };
 
 } // namespace facebook::fboss
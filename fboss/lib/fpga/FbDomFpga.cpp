@@ -6,6 +6,8 @@
 #include <folly/logging/xlog.h>
 #include "fboss/agent/FbossError.h"
 
+#include <array>
+
 namespace {
 const std::string getColorStr(facebook::fboss::FbDomFpga::LedColor ledColor) {
   switch (ledColor) {
@@ -34,7 +36,14 @@ const std::string getColorStr(facebook::fboss::FbDomFpga::LedColor ledColor) {
 
 constexpr uint32_t kFacebookFpgaPimTypeReg = 0x0;
 constexpr uint32_t kFacebookFpgaPortLedBase = 0x0310;
-constexpr uint32_t kFacebookFpgaQsfpPresentReg = 0x0048;
+constexpr uint32_t kFacebookFpgaQsfpIntrReg =
+    facebook::fboss::FbDomFpga::kQsfpIntrReg;
+constexpr uint32_t kFacebookFpgaQsfpPresentReg =
+    facebook::fboss::FbDomFpga::kQsfpPresentReg;
+constexpr uint32_t kFacebookFpgaQsfpPresentChangeReg =
+    facebook::fboss::FbDomFpga::kQsfpPresentChangeReg;
+constexpr size_t kFacebookFpgaQsfpStatusBlockRegs =
+    (kFacebookFpgaQsfpPresentChangeReg - kFacebookFpgaQsfpIntrReg) / 4 + 1;
 constexpr uint32_t kFacebookFpgaQsfpResetReg = 0x0070;
 constexpr uint32_t kFacebookFpgaPimTypeBase = 0xFF000000;
 
@@ -42,39 +51,50 @@ inline uint32_t getPortLedAddress(int port) {
   return kFacebookFpgaPortLedBase + port * 4;
 }
 
+inline size_t getQsfpStatusIndex(uint32_t reg) {
+  return (reg - kFacebookFpgaQsfpIntrReg) / 4;
+}
+
 } // namespace
 
 namespace facebook::fboss {
 FbDomFpga::FbDomFpga(uint32_t domBaseAddr, uint32_t domFpgaSize, uint8_t pim)
-    : phyMem32_(std::make_unique<FbFpgaPhysicalMemory32>(
-          domBaseAddr,
-          domFpgaSize,
-          false)),
-      pim_{pim},
-      domBaseAddr_(domBaseAddr),
-      domFpgaSize_(domFpgaSize) {
+    : FbDomFpga(
+          std::make_unique<PhysicalMemoryFpgaRegisterBus>(
+              domBaseAddr,
+              domFpgaSize),
+          pim) {
   XLOG(DBG2) << folly::format(
       "Creating Fb DOM FPGA at address={:#x} size={:d}",
-      domBaseAddr_,
-      domFpgaSize_);
+      domBaseAddr,
+      domFpgaSize);
 }
 
+FbDomFpga::FbDomFpga(std::unique_ptr<FpgaRegisterBus> bus, uint8_t pim)
+    : bus_(std::move(bus)), pim_{pim} {}
+
 void FbDomFpga::initHW() {
-  // mmap the 32bit io physical memory
-  phyMem32_->mmap();
+  bus_->init();
 }
 
 uint32_t FbDomFpga::read(uint32_t offset) const {
-  CHECK(offset >= 0 && offset <= domFpgaSize_);
-  uint32_t ret = phyMem32_->read(offset);
-  XLOG(DBG5) << folly::format("FPGA read {:#x}={:#x}", offset, ret);
-  return ret;
+  return bus_->read(offset);
 }
 
 void FbDomFpga::write(uint32_t offset, uint32_t value) {
-  CHECK(offset >= 0 && offset <= domFpgaSize_);
-  XLOG(DBG5) << folly::format("FPGA write {:#x} to {:#x}", value, offset);
-  phyMem32_->write(offset, value);
+  bus_->write(offset, value);
+}
+
+void FbDomFpga::readBurst(uint32_t offset, uint32_t* values, size_t count)
+    const {
+  bus_->readBurst(offset, values, count);
+}
+
+void FbDomFpga::writeBurst(
+    uint32_t offset,
+    const uint32_t* values,
+    size_t count) {
+  bus_->writeBurst(offset, values, count);
 }
 
 bool FbDomFpga::isQsfpPresent(int qsfp) {
@@ -89,6 +109,30 @@ uint32_t FbDomFpga::getQsfpsPresence() {
   return read(kFacebookFpgaQsfpPresentReg);
 }
 
+uint32_t FbDomFpga::takeQsfpEvents() {
+  std::lock_guard<std::mutex> g(qsfpEventsMutex_);
+  std::array<uint32_t, kFacebookFpgaQsfpStatusBlockRegs> status;
+  readBurst(kFacebookFpgaQsfpIntrReg, status.data(), status.size());
+  auto interrupts = status[getQsfpStatusIndex(kFacebookFpgaQsfpIntrReg)];
+  auto presenceChanges =
+      status[getQsfpStatusIndex(kFacebookFpgaQsfpPresentChangeReg)];
+  if (presenceChanges) {
+    // Only clear the changes seen, later ones stay latched
+    write(kFacebookFpgaQsfpPresentChangeReg, presenceChanges);
+  }
+
+  auto newInterrupts = interrupts & ~lastQsfpInterrupts_;
+  lastQsfpInterrupts_ = interrupts;
+  if (presenceChanges || newInterrupts) {
+    XLOG(DBG2) << folly::format(
+        "pim_{:d} QSFP presence changes:{:#x}, new interrupts:{:#x}",
+        pim_,
+        presenceChanges,
+        newInterrupts);
+  }
+  return presenceChanges | newInterrupts;
+}
+
 void FbDomFpga::ensureQsfpOutOfReset(int qsfp) {
   uint32_t currentResetReg = read(kFacebookFpgaQsfpResetReg);
   // 1 to hold QSFP reset active. 0 to release QSFP reset.
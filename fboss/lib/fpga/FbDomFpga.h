@@ -2,7 +2,10 @@
 
 #pragma once
 
-#include "fboss/lib/PhysicalMemory.h"
+#include "fboss/lib/fpga/FpgaRegisterBus.h"
+
+#include <memory>
+#include <mutex>
 
 namespace facebook::fboss {
 class FbDomFpga {
@@ -25,6 +28,8 @@ class FbDomFpga {
   };
 
   FbDomFpga(uint32_t domBaseAddr, uint32_t domFpgaSize, uint8_t pim);
+  // Registers behind any bus, e.g. simulated ones in tests
+  FbDomFpga(std::unique_ptr<FpgaRegisterBus> bus, uint8_t pim);
 
   /**
    * This function should be called before any read/write() to call any hardware
@@ -39,11 +44,31 @@ class FbDomFpga {
    * FPGA PCIe Register has been upgraded to 32bits data width on 32 bits
    * address.
    */
-  virtual uint32_t read(uint32_t offset) const;
-  virtual void write(uint32_t offset, uint32_t value);
+  uint32_t read(uint32_t offset) const;
+  void write(uint32_t offset, uint32_t value);
+
+  /**
+   * Read or write count contiguous registers starting at offset, e.g. a data
+   * block of an I2C controller.
+   */
+  void readBurst(uint32_t offset, uint32_t* values, size_t count) const;
+  void writeBurst(uint32_t offset, const uint32_t* values, size_t count);
+
+  FpgaRegisterBus* getRegisterBus() const {
+    return bus_.get();
+  }
 
   bool isQsfpPresent(int qsfp);
   uint32_t getQsfpsPresence();
+
+  /**
+   * QSFPs with an event pending, one bit per port: plugged in or removed, or
+   * newly raising their interrupt (e.g. for LOS/LOL or a temperature alarm).
+   * The presence change latches are cleared, so each event is only reported
+   * once. The interrupt of a module stays asserted until its flags are read,
+   * only its rising edge is reported.
+   */
+  uint32_t takeQsfpEvents();
   void ensureQsfpOutOfReset(int qsfp);
 
   /* Function to trigger the QSFP hard reset by toggling the bit from
@@ -57,16 +82,29 @@ class FbDomFpga {
 
   PimType getPimType();
 
+  /*
+   * QSFP status block, one bit per port in each register: the interrupt of
+   * the modules (1 = asserted), their presence and the latched presence
+   * changes (write 1 to clear).
+   * TODO: kQsfpIntrReg and kQsfpPresentChangeReg are not yet checked
+   * against the DOM FPGA register map, only kQsfpPresentReg is used by the
+   * presence scan. --minipack_qsfp_events, the only reader of the other
+   * two, stays off until they are.
+   */
+  static constexpr uint32_t kQsfpIntrReg = 0x0040;
+  static constexpr uint32_t kQsfpPresentReg = 0x0048;
+  static constexpr uint32_t kQsfpPresentChangeReg = 0x0050;
+
  private:
   static constexpr uint32_t kFacebookFpgaVendorID = 0x1d9b;
 
-  using FbFpgaPhysicalMemory32 = PhysicalMemory32<PhysicalMemory>;
-
-  std::unique_ptr<FbFpgaPhysicalMemory32> phyMem32_;
+  std::unique_ptr<FpgaRegisterBus> bus_;
 
   uint8_t pim_;
-  uint32_t domBaseAddr_;
-  uint32_t domFpgaSize_;
+
+  std::mutex qsfpEventsMutex_;
+  // Module interrupts seen asserted at the last takeQsfpEvents()
+  uint32_t lastQsfpInterrupts_{0};
 };
 
 } // namespace facebook::fboss
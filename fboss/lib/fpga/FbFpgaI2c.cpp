@@ -5,20 +5,17 @@
 #include "fboss/agent/Utils.h"
 #include "fboss/lib/fpga/FbFpgaRegisters.h"
 
+#include <folly/Conv.h>
 #include <folly/CppAttributes.h>
 #include <folly/Format.h>
+#include <folly/ScopeGuard.h>
 #include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
 #include <thread>
-
-namespace {
-constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
-constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
-constexpr uint32_t kFacebookFpgaRTCIOBlockSize = 0x0200;
-} // unnamed namespace
+#include <vector>
 
 namespace facebook::fboss {
 FbFpgaI2c::FbFpgaI2c(FbDomFpga* fpga, uint32_t rtcId, uint32_t pimId)
@@ -30,26 +27,25 @@ FbFpgaI2c::FbFpgaI2c(FbDomFpga* fpga, uint32_t rtcId, uint32_t pimId)
 }
 
 bool FbFpgaI2c::waitForResponse(size_t len) {
-  I2cRtcStatus rtcStatus;
-  uint32_t retries = 10;
-
   // Make the initial wait according to the length of read/write.
-  usleep(100 * len);
-
-  rtcStatus = readReg<I2cRtcStatus>();
+  usleep(kWaitPerByte.count() * len);
 
-  while (!rtcStatus.desc0done && --retries) {
-    usleep(1000);
-    rtcStatus = readReg<I2cRtcStatus>();
+  auto status = checkStatus();
+  uint32_t retries = kMaxPolls;
+  while (status == TxnStatus::PENDING && --retries) {
+    usleep(kPollInterval.count());
+    status = checkStatus();
   }
+  return status == TxnStatus::DONE;
+}
 
+FbFpgaI2c::TxnStatus FbFpgaI2c::checkStatus() {
+  auto rtcStatus = readReg<I2cRtcStatus>();
   if (rtcStatus.desc0error) {
     XLOG(DBG5) << "I2C read/write ops has error.";
-    rtcStatus.reg = 0xffffffff;
-    return false;
+    return TxnStatus::FAILED;
   }
-
-  return rtcStatus.desc0done;
+  return rtcStatus.desc0done ? TxnStatus::DONE : TxnStatus::PENDING;
 }
 
 uint8_t FbFpgaI2c::readByte(uint8_t channel, uint8_t offset) {
@@ -62,13 +58,26 @@ void FbFpgaI2c::read(
     uint8_t channel,
     uint8_t offset,
     folly::MutableByteRange buf) {
+  startRead(channel, offset, buf.size());
+
+  if (!waitForResponse(buf.size())) {
+    // Increment the counter for I2C read transaction failure and
+    // throw error
+    incrReadFailed();
+
+    throw FbFpgaI2cError("I2C read failed.");
+  }
+  finishRead(buf);
+}
+
+void FbFpgaI2c::startRead(uint8_t channel, uint8_t offset, size_t len) {
   I2cDescriptorLower descLower;
   I2cDescriptorUpper descUpper;
   descLower.reg = 0;
   descUpper.reg = 0;
 
   descLower.op = 1; // Read
-  descLower.len = buf.size();
+  descLower.len = len;
 
   descUpper.offset = offset;
   descUpper.channel = channel;
@@ -79,27 +88,18 @@ void FbFpgaI2c::read(
 
   // Increment the counter for I2C read tranbsaction issued
   incrReadTotal();
+}
 
+void FbFpgaI2c::finishRead(folly::MutableByteRange buf) {
   uint32_t readBlockAddr =
       getRegAddr(kFacebookFpgaRTCReadBlock, kFacebookFpgaRTCIOBlockSize);
 
-  if (!waitForResponse(descLower.len)) {
-    // Increment the counter for I2C read transaction failure and
-    // throw error
-    incrReadFailed();
-
-    throw FbFpgaI2cError("I2C read failed.");
-  } else {
-    for (int bytesRead = 0; bytesRead < buf.size(); bytesRead += 4) {
-      uint32_t data = fpga_->read(readBlockAddr + bytesRead);
-      std::memcpy(
-          buf.begin() + bytesRead,
-          &data,
-          std::min(buf.size() - bytesRead, (size_t)4));
-    }
-    // Update the number of bytes read
-    incrReadBytes(buf.size());
-  }
+  // Fetch the whole data block at once rather than a word at a time
+  std::vector<uint32_t> data((buf.size() + 3) / 4);
+  fpga_->readBurst(readBlockAddr, data.data(), data.size());
+  std::memcpy(buf.begin(), data.data(), buf.size());
+  // Update the number of bytes read
+  incrReadBytes(buf.size());
 }
 
 void FbFpgaI2c::writeByte(uint8_t channel, uint8_t offset, uint8_t val) {
@@ -107,6 +107,23 @@ void FbFpgaI2c::writeByte(uint8_t channel, uint8_t offset, uint8_t val) {
 }
 
 void FbFpgaI2c::write(uint8_t channel, uint8_t offset, folly::ByteRange buf) {
+  startWrite(channel, offset, buf);
+
+  if (!waitForResponse(buf.size())) {
+    // Increment the counter for I2c write transaction failure and
+    // throw error
+    incrWriteFailed();
+
+    throw FbFpgaI2cError("I2C write failed.");
+  }
+  // Update the number of bytes write
+  incrWriteBytes(buf.size());
+}
+
+void FbFpgaI2c::startWrite(
+    uint8_t channel,
+    uint8_t offset,
+    folly::ByteRange buf) {
   I2cDescriptorLower descLower;
   I2cDescriptorUpper descUpper;
   descLower.reg = 0;
@@ -125,27 +142,13 @@ void FbFpgaI2c::write(uint8_t channel, uint8_t offset, folly::ByteRange buf) {
   uint32_t writeBlockAddr =
       getRegAddr(kFacebookFpgaRTCWriteBlock, kFacebookFpgaRTCIOBlockSize);
 
-  for (int bytesWritten = 0; bytesWritten < buf.size(); bytesWritten += 4) {
-    uint32_t data;
-    std::memcpy(
-        &data,
-        buf.begin() + bytesWritten,
-        std::min(buf.size() - bytesWritten, (size_t)4));
-    fpga_->write(writeBlockAddr + bytesWritten, data);
-  }
+  // Zero pads the last word
+  std::vector<uint32_t> data((buf.size() + 3) / 4);
+  std::memcpy(data.data(), buf.begin(), buf.size());
+  fpga_->writeBurst(writeBlockAddr, data.data(), data.size());
 
   writeReg(descLower);
   writeReg(descUpper);
-
-  if (!waitForResponse(descLower.len)) {
-    // Increment the counter for I2c write transaction failure and
-    // throw error
-    incrWriteFailed();
-
-    throw FbFpgaI2cError("I2C write failed.");
-  }
-  // Update the number of bytes write
-  incrWriteBytes(buf.size());
 }
 
 template <typename Register>
@@ -191,24 +194,38 @@ FbFpgaI2cController::FbFpgaI2cController(
       thread_(new std::thread([&, pim, rtcId]() {
         initThread(folly::format("I2c_pim{:d}_rtc{:d}", pim, rtcId).str());
         eventBase_->loopForever();
-      })) {}
+      })),
+      pollTimeout_(folly::AsyncTimeout::make(
+          *eventBase_,
+          [this]() noexcept { pollTimeoutExpired(); })) {}
 
 FbFpgaI2cController::~FbFpgaI2cController() {
-  eventBase_->runInEventBaseThread([&] { eventBase_->terminateLoopSoon(); });
+  eventBase_->runInEventBaseThread([&] {
+    pollTimeout_->cancelTimeout();
+    eventBase_->terminateLoopSoon();
+  });
   thread_->join();
 }
 
-uint8_t FbFpgaI2cController::readByte(uint8_t channel, uint8_t offset) {
-  uint8_t buf;
+template <typename Fn>
+void FbFpgaI2cController::runSync(Fn&& fn) {
+  auto doSync = [&]() {
+    drainBlocking();
+    SCOPE_EXIT {
+      startNext();
+    };
+    fn(*syncedFbI2c_.lock());
+  };
   if (eventBase_->isInEventBaseThread()) {
-    buf = syncedFbI2c_.lock()->readByte(channel, offset);
+    doSync();
   } else {
-    via(eventBase_.get())
-        .thenValue([&](auto&&) mutable {
-          buf = syncedFbI2c_.lock()->readByte(channel, offset);
-        })
-        .get();
+    via(eventBase_.get()).thenValue([&](auto&&) { doSync(); }).get();
   }
+}
+
+uint8_t FbFpgaI2cController::readByte(uint8_t channel, uint8_t offset) {
+  uint8_t buf;
+  runSync([&](FbFpgaI2c& i2c) { buf = i2c.readByte(channel, offset); });
   return buf;
 }
 
@@ -216,44 +233,166 @@ void FbFpgaI2cController::read(
     uint8_t channel,
     uint8_t offset,
     folly::MutableByteRange buf) {
-  if (eventBase_->isInEventBaseThread()) {
-    syncedFbI2c_.lock()->read(channel, offset, buf);
-  } else {
-    via(eventBase_.get())
-        .thenValue([=](auto&&) mutable {
-          syncedFbI2c_.lock()->read(channel, offset, buf);
-        })
-        .get();
-  }
+  runSync([&](FbFpgaI2c& i2c) { i2c.read(channel, offset, buf); });
 }
 
 void FbFpgaI2cController::writeByte(
     uint8_t channel,
     uint8_t offset,
     uint8_t val) {
-  if (eventBase_->isInEventBaseThread()) {
-    syncedFbI2c_.lock()->writeByte(channel, offset, val);
-  } else {
-    via(eventBase_.get())
-        .thenValue([=](auto&&) mutable {
-          syncedFbI2c_.lock()->writeByte(channel, offset, val);
-        })
-        .get();
-  }
+  runSync([&](FbFpgaI2c& i2c) { i2c.writeByte(channel, offset, val); });
 }
 
 void FbFpgaI2cController::write(
     uint8_t channel,
     uint8_t offset,
     folly::ByteRange buf) {
-  if (eventBase_->isInEventBaseThread()) {
-    syncedFbI2c_.lock()->write(channel, offset, buf);
+  runSync([&](FbFpgaI2c& i2c) { i2c.write(channel, offset, buf); });
+}
+
+folly::SemiFuture<std::vector<uint8_t>>
+FbFpgaI2cController::futureRead(uint8_t channel, uint8_t offset, size_t len) {
+  Transaction txn{true, channel, offset, std::vector<uint8_t>(len)};
+  auto future = txn.promise.getSemiFuture();
+  enqueue(std::move(txn));
+  return future;
+}
+
+folly::SemiFuture<folly::Unit> FbFpgaI2cController::futureWrite(
+    uint8_t channel,
+    uint8_t offset,
+    std::vector<uint8_t> data) {
+  Transaction txn{false, channel, offset, std::move(data)};
+  auto future = txn.promise.getSemiFuture();
+  enqueue(std::move(txn));
+  return std::move(future).deferValue([](auto&&) {});
+}
+
+void FbFpgaI2cController::enqueue(Transaction txn) {
+  eventBase_->runInEventBaseThread(
+      [this, txn = std::move(txn)]() mutable {
+        pending_.push_back(std::move(txn));
+        startNext();
+      });
+}
+
+void FbFpgaI2cController::startNext() {
+  while (!inFlight_ && !pending_.empty()) {
+    inFlight_ = std::move(pending_.front());
+    pending_.pop_front();
+
+    auto& txn = *inFlight_;
+    try {
+      auto i2c = syncedFbI2c_.lock();
+      if (txn.isRead) {
+        i2c->startRead(txn.channel, txn.offset, txn.data.size());
+      } else {
+        i2c->startWrite(
+            txn.channel,
+            txn.offset,
+            folly::ByteRange(txn.data.data(), txn.data.size()));
+      }
+    } catch (const std::exception& ex) {
+      failInFlight(ex);
+      continue;
+    }
+    // Same initial wait as the synchronous accesses
+    pollTimeout_->scheduleTimeoutHighRes(
+        FbFpgaI2c::kWaitPerByte * static_cast<int64_t>(txn.data.size()));
+  }
+}
+
+bool FbFpgaI2cController::pollInFlight() {
+  auto& txn = *inFlight_;
+  bool done;
+  {
+    auto i2c = syncedFbI2c_.lock();
+    auto status = i2c->checkStatus();
+    if (status == FbFpgaI2c::TxnStatus::PENDING &&
+        ++txn.polls < FbFpgaI2c::kMaxPolls) {
+      return false;
+    }
+    done = status == FbFpgaI2c::TxnStatus::DONE;
+    if (!done && txn.isRead) {
+      i2c->incrReadFailed();
+    } else if (!done) {
+      i2c->incrWriteFailed();
+    } else if (txn.isRead) {
+      i2c->finishRead(
+          folly::MutableByteRange(txn.data.data(), txn.data.size()));
+    } else {
+      i2c->incrWriteBytes(txn.data.size());
+      txn.data.clear();
+    }
+  }
+
+  // Continuations may run inline and access the controller again, so only
+  // complete the promise once the transaction is no longer in flight.
+  auto completed = std::move(txn);
+  inFlight_.reset();
+  if (done) {
+    completed.promise.setValue(std::move(completed.data));
   } else {
-    via(eventBase_.get())
-        .thenValue([=](auto&&) mutable {
-          syncedFbI2c_.lock()->write(channel, offset, buf);
-        })
-        .get();
+    completed.promise.setException(FbFpgaI2cError(
+        completed.isRead ? "I2C read failed." : "I2C write failed."));
+  }
+  return true;
+}
+
+void FbFpgaI2cController::failInFlight(const std::exception& ex) {
+  auto failed = std::move(*inFlight_);
+  inFlight_.reset();
+  auto what = folly::to<std::string>(
+      failed.isRead ? "I2C read failed: " : "I2C write failed: ", ex.what());
+  XLOG(ERR) << what;
+  failed.promise.setException(FbFpgaI2cError(what));
+}
+
+void FbFpgaI2cController::pollTimeoutExpired() {
+  if (!inFlight_) {
+    return;
+  }
+  // Called from a noexcept callback, so a failed register access fails the
+  // transaction rather than the process
+  try {
+    if (!pollInFlight()) {
+      pollTimeout_->scheduleTimeoutHighRes(FbFpgaI2c::kPollInterval);
+      return;
+    }
+  } catch (const std::exception& ex) {
+    failInFlight(ex);
+  }
+  startNext();
+}
+
+void FbFpgaI2cController::finishInFlightBlocking() {
+  if (!inFlight_) {
+    return;
+  }
+  pollTimeout_->cancelTimeout();
+  try {
+    while (!pollInFlight()) {
+      usleep(FbFpgaI2c::kPollInterval.count());
+    }
+  } catch (const std::exception& ex) {
+    failInFlight(ex);
+    throw;
+  }
+}
+
+void FbFpgaI2cController::drainBlocking() {
+  finishInFlightBlocking();
+  while (!pending_.empty()) {
+    startNext();
+    if (!inFlight_) {
+      // The remaining transactions failed to start
+      continue;
+    }
+    // Same initial wait as the synchronous accesses
+    usleep(
+        FbFpgaI2c::kWaitPerByte.count() *
+        static_cast<int64_t>(inFlight_->data.size()));
+    finishInFlightBlocking();
   }
 }
 
@@ -8,10 +8,17 @@
 
 #include <folly/Range.h>
 #include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 
 #include <stdint.h>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <optional>
 #include <thread>
+#include <vector>
 
 namespace facebook::fboss {
 inline uint8_t getI2cControllerIdx(uint8_t port) {
@@ -29,6 +36,18 @@ class FbFpgaI2cError : public I2cError {
 
 class FbFpgaI2c : public I2cController {
  public:
+  enum class TxnStatus {
+    PENDING,
+    DONE,
+    FAILED,
+  };
+
+  // The controller needs about this long per byte to complete a transaction
+  static constexpr std::chrono::microseconds kWaitPerByte{100};
+  // How often, and how many times, the status is checked after that
+  static constexpr std::chrono::microseconds kPollInterval{1000};
+  static constexpr uint32_t kMaxPolls = 10;
+
   FbFpgaI2c(FbDomFpga* fpga, uint32_t rtcId, uint32_t pim);
 
   uint8_t readByte(uint8_t channel, uint8_t offset);
@@ -37,6 +56,16 @@ class FbFpgaI2c : public I2cController {
   void writeByte(uint8_t channel, uint8_t offset, uint8_t val);
   void write(uint8_t channel, uint8_t offset, folly::ByteRange buf);
 
+  /*
+   * Non blocking steps of read() and write(): start a transaction, check
+   * its status until it is no longer PENDING, then collect the data read.
+   * Only one transaction can be outstanding at a time.
+   */
+  void startRead(uint8_t channel, uint8_t offset, size_t len);
+  void startWrite(uint8_t channel, uint8_t offset, folly::ByteRange buf);
+  TxnStatus checkStatus();
+  void finishRead(folly::MutableByteRange buf);
+
  private:
   bool waitForResponse(size_t len);
   uint32_t getRegAddr(uint32_t regBase, uint32_t regIncr);
@@ -62,6 +91,18 @@ class FbFpgaI2cController {
   void writeByte(uint8_t channel, uint8_t offset, uint8_t val);
   void write(uint8_t channel, uint8_t offset, folly::ByteRange buf);
 
+  /*
+   * Asynchronous read() and write(). Transactions on all the channels of
+   * this controller are queued and issued back to back from its event base,
+   * which checks their status from a timer instead of sleeping. Neither the
+   * caller nor the event base thread block, so transactions on different
+   * controllers overlap even when issued from a single thread.
+   */
+  folly::SemiFuture<std::vector<uint8_t>>
+  futureRead(uint8_t channel, uint8_t offset, size_t len);
+  folly::SemiFuture<folly::Unit>
+  futureWrite(uint8_t channel, uint8_t offset, std::vector<uint8_t> data);
+
   folly::EventBase* getEventBase();
 
   /* Get the I2c transaction stats from this controller with the lock
@@ -71,9 +112,39 @@ class FbFpgaI2cController {
   }
 
  private:
+  struct Transaction {
+    bool isRead;
+    uint8_t channel;
+    uint8_t offset;
+    // Data to write, or buffer to read into
+    std::vector<uint8_t> data;
+    folly::Promise<std::vector<uint8_t>> promise;
+    uint32_t polls{0};
+  };
+
+  // The rest is only called in the event base thread
+  void enqueue(Transaction txn);
+  void startNext();
+  // Complete the in flight transaction if it is no longer pending. Returns
+  // whether it was completed.
+  bool pollInFlight();
+  // Fail the in flight transaction after its register accesses threw
+  void failInFlight(const std::exception& ex);
+  void pollTimeoutExpired();
+  void finishInFlightBlocking();
+  // Synchronous accesses first complete the in flight transaction and all of
+  // the pending ones, in order
+  void drainBlocking();
+  template <typename Fn>
+  void runSync(Fn&& fn);
+
   folly::Synchronized<FbFpgaI2c, std::mutex> syncedFbI2c_;
   std::unique_ptr<folly::EventBase> eventBase_;
   std::unique_ptr<std::thread> thread_;
+
+  std::deque<Transaction> pending_;
+  std::optional<Transaction> inFlight_;
+  std::unique_ptr<folly::AsyncTimeout> pollTimeout_;
 };
 
 } // namespace facebook::fboss
@@ -8,6 +8,11 @@
 #include <ostream>
 
 namespace facebook::fboss {
+// Data written and read by the I2C real time controllers, one block per RTC
+constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
+constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
+constexpr uint32_t kFacebookFpgaRTCIOBlockSize = 0x0200;
+
 union I2cDescriptorUpper {
   using baseAddr = std::integral_constant<uint32_t, 0x504>;
   using addrIncr = std::integral_constant<uint32_t, 0x20>;
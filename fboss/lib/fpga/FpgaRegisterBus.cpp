@@ -0,0 +1,145 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FpgaRegisterBus.h"
+
+#include <folly/Format.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+FpgaRegisterBus::FpgaRegisterBus(uint32_t size)
+    : size_(size),
+      reads_(new std::atomic<uint64_t>[size / sizeof(uint32_t)]()),
+      writes_(new std::atomic<uint64_t>[size / sizeof(uint32_t)]()) {}
+
+uint32_t FpgaRegisterBus::read(uint32_t offset) const {
+  checkRange(offset, 1);
+  uint32_t ret = readImpl(offset);
+  countAccesses(offset, 1, false);
+  XLOG(DBG5) << folly::format("FPGA read {:#x}={:#x}", offset, ret);
+  return ret;
+}
+
+void FpgaRegisterBus::write(uint32_t offset, uint32_t value) {
+  checkRange(offset, 1);
+  XLOG(DBG5) << folly::format("FPGA write {:#x} to {:#x}", value, offset);
+  writeImpl(offset, value);
+  countAccesses(offset, 1, true);
+}
+
+void FpgaRegisterBus::readBurst(
+    uint32_t offset,
+    uint32_t* values,
+    size_t count) const {
+  checkRange(offset, count);
+  readBurstImpl(offset, values, count);
+  countAccesses(offset, count, false);
+  XLOG(DBG5) << folly::format(
+      "FPGA burst read {:d} registers from {:#x}", count, offset);
+}
+
+void FpgaRegisterBus::writeBurst(
+    uint32_t offset,
+    const uint32_t* values,
+    size_t count) {
+  checkRange(offset, count);
+  XLOG(DBG5) << folly::format(
+      "FPGA burst write {:d} registers to {:#x}", count, offset);
+  writeBurstImpl(offset, values, count);
+  countAccesses(offset, count, true);
+}
+
+void FpgaRegisterBus::readBurstImpl(
+    uint32_t offset,
+    uint32_t* values,
+    size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = readImpl(offset + i * sizeof(uint32_t));
+  }
+}
+
+void FpgaRegisterBus::writeBurstImpl(
+    uint32_t offset,
+    const uint32_t* values,
+    size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    writeImpl(offset + i * sizeof(uint32_t), values[i]);
+  }
+}
+
+void FpgaRegisterBus::checkRange(uint32_t offset, size_t count) const {
+  CHECK(!(offset & (sizeof(uint32_t) - 1)))
+      << "Unaligned FPGA register " << offset;
+  CHECK_LE(offset + count * sizeof(uint32_t), size_)
+      << "FPGA registers out of range";
+}
+
+void FpgaRegisterBus::countAccesses(uint32_t offset, size_t count, bool write)
+    const {
+  auto& counts = write ? writes_ : reads_;
+  auto index = offset / sizeof(uint32_t);
+  for (size_t i = 0; i < count; ++i) {
+    counts[index + i].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+std::map<uint32_t, FpgaRegisterBus::AccessCounts>
+FpgaRegisterBus::getAccessCounts() const {
+  std::map<uint32_t, AccessCounts> accessCounts;
+  for (size_t i = 0; i < size_ / sizeof(uint32_t); ++i) {
+    AccessCounts counts;
+    counts.reads = reads_[i].load(std::memory_order_relaxed);
+    counts.writes = writes_[i].load(std::memory_order_relaxed);
+    if (counts.reads || counts.writes) {
+      accessCounts.emplace(i * sizeof(uint32_t), counts);
+    }
+  }
+  return accessCounts;
+}
+
+uint64_t FpgaRegisterBus::getTotalReads() const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < size_ / sizeof(uint32_t); ++i) {
+    total += reads_[i].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t FpgaRegisterBus::getTotalWrites() const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < size_ / sizeof(uint32_t); ++i) {
+    total += writes_[i].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void FpgaRegisterBus::resetAccessCounts() {
+  for (size_t i = 0; i < size_ / sizeof(uint32_t); ++i) {
+    reads_[i].store(0, std::memory_order_relaxed);
+    writes_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+PhysicalMemoryFpgaRegisterBus::PhysicalMemoryFpgaRegisterBus(
+    uint64_t baseAddr,
+    uint32_t size)
+    : FpgaRegisterBus(size),
+      phyMem32_(std::make_unique<PhysicalMemory32<PhysicalMemory>>(
+          baseAddr,
+          size,
+          false)) {}
+
+void PhysicalMemoryFpgaRegisterBus::init() {
+  // mmap the 32bit io physical memory
+  phyMem32_->mmap();
+}
+
+uint32_t PhysicalMemoryFpgaRegisterBus::readImpl(uint32_t offset) const {
+  return phyMem32_->read(offset);
+}
+
+void PhysicalMemoryFpgaRegisterBus::writeImpl(uint32_t offset, uint32_t value) {
+  phyMem32_->write(offset, value);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,105 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/PhysicalMemory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace facebook::fboss {
+
+/*
+ * Access to the 32 bit registers of an FPGA, at offsets from its base
+ * address.
+ *
+ * Each register access of the PhysicalMemory backend is an uncached PCIe
+ * round trip, so callers should read blocks of contiguous registers they
+ * need together with readBurst() rather than the same register over and
+ * over. Accesses are counted per register, to show where the round trips
+ * are spent, in relaxed atomics preallocated for every register of the bus
+ * so counting never contends.
+ *
+ * The backends only implement the single register accesses, bursts default
+ * to a loop over them. All methods are thread safe as long as the backend's
+ * are.
+ */
+class FpgaRegisterBus {
+ public:
+  struct AccessCounts {
+    uint64_t reads{0};
+    uint64_t writes{0};
+  };
+
+  explicit FpgaRegisterBus(uint32_t size);
+  virtual ~FpgaRegisterBus() {}
+
+  /*
+   * Make the registers accessible, e.g. mmap them. Must be called before any
+   * access.
+   */
+  virtual void init() {}
+
+  uint32_t read(uint32_t offset) const;
+  void write(uint32_t offset, uint32_t value);
+
+  /*
+   * Read or write count contiguous registers, starting at offset.
+   */
+  void readBurst(uint32_t offset, uint32_t* values, size_t count) const;
+  void writeBurst(uint32_t offset, const uint32_t* values, size_t count);
+
+  uint32_t getSize() const {
+    return size_;
+  }
+
+  /*
+   * The registers accessed since the last reset, by offset.
+   */
+  std::map<uint32_t, AccessCounts> getAccessCounts() const;
+  uint64_t getTotalReads() const;
+  uint64_t getTotalWrites() const;
+  void resetAccessCounts();
+
+ protected:
+  virtual uint32_t readImpl(uint32_t offset) const = 0;
+  virtual void writeImpl(uint32_t offset, uint32_t value) = 0;
+  virtual void readBurstImpl(uint32_t offset, uint32_t* values, size_t count)
+      const;
+  virtual void
+  writeBurstImpl(uint32_t offset, const uint32_t* values, size_t count);
+
+ private:
+  void checkRange(uint32_t offset, size_t count) const;
+  void countAccesses(uint32_t offset, size_t count, bool write) const;
+
+  // Forbidden copy constructor and assignment operator
+  FpgaRegisterBus(FpgaRegisterBus const&) = delete;
+  FpgaRegisterBus& operator=(FpgaRegisterBus const&) = delete;
+
+  const uint32_t size_;
+  // Indexed by offset / 4
+  std::unique_ptr<std::atomic<uint64_t>[]> reads_;
+  std::unique_ptr<std::atomic<uint64_t>[]> writes_;
+};
+
+/*
+ * The registers of an FPGA BAR, mmapped from /dev/mem.
+ */
+class PhysicalMemoryFpgaRegisterBus : public FpgaRegisterBus {
+ public:
+  PhysicalMemoryFpgaRegisterBus(uint64_t baseAddr, uint32_t size);
+
+  void init() override;
+
+ protected:
+  uint32_t readImpl(uint32_t offset) const override;
+  void writeImpl(uint32_t offset, uint32_t value) override;
+
+ private:
+  std::unique_ptr<PhysicalMemory32<PhysicalMemory>> phyMem32_;
+};
+
+} // namespace facebook::fboss
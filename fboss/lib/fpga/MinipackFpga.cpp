@@ -29,10 +29,9 @@ std::shared_ptr<MinipackFpga> MinipackFpga::getInstance() {
 }
 
 MinipackFpga::MinipackFpga()
-    : phyMem32_(std::make_unique<MinipackPhysicalMemory32>(
+    : smbBus_(std::make_unique<PhysicalMemoryFpgaRegisterBus>(
           kFacebookFpgaBarAddr,
-          kFacebookFpgaSmbSize,
-          false)) {
+          kFacebookFpgaSmbSize)) {
   XLOG(DBG2) << folly::format(
       "Creating Minipack FPGA at address={:#x} size={:d}",
       kFacebookFpgaBarAddr,
@@ -55,8 +54,7 @@ void MinipackFpga::initHW() {
   if (isHwInitialized_) {
     return;
   }
-  // mmap the 32bit io physical memory
-  phyMem32_->mmap();
+  smbBus_->init();
   for (uint32_t pim = 0; pim < MinipackFpga::kNumberPim; ++pim) {
     pimFpgas_[pim]->initHW();
   }
@@ -64,12 +62,7 @@ void MinipackFpga::initHW() {
 }
 
 uint32_t MinipackFpga::readSmb(uint32_t offset) {
-  CHECK(
-      offset >= 0 &&
-      offset <= kFacebookFpgaPimBase + kNumberPim * kFacebookFpgaPimSize);
-  uint32_t ret = phyMem32_->read(offset);
-  XLOG(DBG5) << folly::format("FPGA read {:#x}={:#x}", offset, ret);
-  return ret;
+  return smbBus_->read(offset);
 }
 
 uint32_t MinipackFpga::readPim(uint8_t pim, uint32_t offset) {
@@ -77,11 +70,7 @@ uint32_t MinipackFpga::readPim(uint8_t pim, uint32_t offset) {
 }
 
 void MinipackFpga::writeSmb(uint32_t offset, uint32_t value) {
-  CHECK(
-      offset >= 0 &&
-      offset <= kFacebookFpgaPimBase + kNumberPim * kFacebookFpgaPimSize);
-  XLOG(DBG5) << folly::format("FPGA write {:#x} to {:#x}", value, offset);
-  phyMem32_->write(offset, value);
+  smbBus_->write(offset, value);
 }
 
 void MinipackFpga::writePim(uint8_t pim, uint32_t offset, uint32_t value) {
@@ -105,6 +94,10 @@ std::array<bool, MinipackFpga::kNumPortsPerPim> MinipackFpga::scanQsfpPresence(
   return qsfpPresence;
 }
 
+uint32_t MinipackFpga::takeQsfpEvents(uint8_t pim) {
+  return pimFpgas_[pim - 1]->takeQsfpEvents();
+}
+
 void MinipackFpga::ensureQsfpOutOfReset(uint8_t pim, int qsfp) {
   pimFpgas_[pim - 1]->ensureQsfpOutOfReset(qsfp);
 }
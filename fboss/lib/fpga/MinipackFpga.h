@@ -9,8 +9,8 @@
  */
 #pragma once
 
-#include "fboss/lib/PhysicalMemory.h"
 #include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/fpga/FpgaRegisterBus.h"
 
 namespace facebook::fboss {
 /**
@@ -46,6 +46,9 @@ class MinipackFpga {
 
   bool isQsfpPresent(uint8_t pim, int qsfp);
   std::array<bool, kNumPortsPerPim> scanQsfpPresence(uint8_t pim);
+  // QSFPs of the pim with a presence change or new interrupt, see
+  // FbDomFpga::takeQsfpEvents()
+  uint32_t takeQsfpEvents(uint8_t pim);
   void ensureQsfpOutOfReset(uint8_t pim, int qsfp);
 
   /* Trigger the QSFP hard reset of a given port on a given line card (PIM)
@@ -64,9 +67,7 @@ class MinipackFpga {
  private:
   static constexpr uint32_t kFacebookFpgaVendorID = 0x1d9b;
 
-  using MinipackPhysicalMemory32 = PhysicalMemory32<PhysicalMemory>;
-
-  std::unique_ptr<MinipackPhysicalMemory32> phyMem32_;
+  std::unique_ptr<FpgaRegisterBus> smbBus_;
 
   std::array<std::unique_ptr<FbDomFpga>, kNumberPim> pimFpgas_;
 
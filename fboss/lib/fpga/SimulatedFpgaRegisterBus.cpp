@@ -0,0 +1,92 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/SimulatedFpgaRegisterBus.h"
+
+namespace facebook::fboss {
+
+SimulatedFpgaRegisterBus::SimulatedFpgaRegisterBus(uint32_t size)
+    : FpgaRegisterBus(size) {}
+
+void SimulatedFpgaRegisterBus::setReadHook(uint32_t offset, ReadHook hook) {
+  std::lock_guard<std::mutex> g(mutex_);
+  readHooks_[offset] = std::move(hook);
+}
+
+void SimulatedFpgaRegisterBus::setWriteHook(uint32_t offset, WriteHook hook) {
+  std::lock_guard<std::mutex> g(mutex_);
+  writeHooks_[offset] = std::move(hook);
+}
+
+void SimulatedFpgaRegisterBus::scriptReads(
+    uint32_t offset,
+    std::vector<uint32_t> values) {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto& scripted = scriptedReads_[offset];
+  scripted.insert(scripted.end(), values.begin(), values.end());
+}
+
+uint32_t SimulatedFpgaRegisterBus::peek(uint32_t offset) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto it = regs_.find(offset);
+  return it == regs_.end() ? 0 : it->second;
+}
+
+void SimulatedFpgaRegisterBus::poke(uint32_t offset, uint32_t value) {
+  std::lock_guard<std::mutex> g(mutex_);
+  regs_[offset] = value;
+}
+
+uint32_t SimulatedFpgaRegisterBus::readImpl(uint32_t offset) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return readLocked(offset);
+}
+
+void SimulatedFpgaRegisterBus::writeImpl(uint32_t offset, uint32_t value) {
+  std::lock_guard<std::mutex> g(mutex_);
+  writeLocked(offset, value);
+}
+
+void SimulatedFpgaRegisterBus::readBurstImpl(
+    uint32_t offset,
+    uint32_t* values,
+    size_t count) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = readLocked(offset + i * sizeof(uint32_t));
+  }
+}
+
+void SimulatedFpgaRegisterBus::writeBurstImpl(
+    uint32_t offset,
+    const uint32_t* values,
+    size_t count) {
+  std::lock_guard<std::mutex> g(mutex_);
+  for (size_t i = 0; i < count; ++i) {
+    writeLocked(offset + i * sizeof(uint32_t), values[i]);
+  }
+}
+
+uint32_t SimulatedFpgaRegisterBus::readLocked(uint32_t offset) const {
+  auto scripted = scriptedReads_.find(offset);
+  if (scripted != scriptedReads_.end() && !scripted->second.empty()) {
+    regs_[offset] = scripted->second.front();
+    scripted->second.pop_front();
+    return regs_[offset];
+  }
+  auto hook = readHooks_.find(offset);
+  if (hook != readHooks_.end()) {
+    return hook->second(offset, regs_);
+  }
+  auto it = regs_.find(offset);
+  return it == regs_.end() ? 0 : it->second;
+}
+
+void SimulatedFpgaRegisterBus::writeLocked(uint32_t offset, uint32_t value) {
+  regs_[offset] = value;
+  auto hook = writeHooks_.find(offset);
+  if (hook != writeHooks_.end()) {
+    hook->second(offset, value, regs_);
+  }
+}
+
+} // namespace facebook::fboss
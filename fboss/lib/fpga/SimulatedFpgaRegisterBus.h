@@ -0,0 +1,71 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FpgaRegisterBus.h"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * FPGA registers held in memory, to run the FPGA drivers without hardware.
+ *
+ * Registers read back the last value written, 0 if never written. Registers
+ * with side effects, like status registers or ones that start an operation
+ * on write, are modelled with hooks. Hooks run under the lock of the bus and
+ * get the whole register file, so they can read and update other registers
+ * atomically with the access. Bursts run under the lock too.
+ */
+class SimulatedFpgaRegisterBus : public FpgaRegisterBus {
+ public:
+  using Registers = std::unordered_map<uint32_t, uint32_t>;
+  // Value to return for a read of the register at offset
+  using ReadHook = std::function<uint32_t(uint32_t offset, Registers& regs)>;
+  // Called after value was stored in the register at offset
+  using WriteHook =
+      std::function<void(uint32_t offset, uint32_t value, Registers& regs)>;
+
+  explicit SimulatedFpgaRegisterBus(uint32_t size);
+
+  void setReadHook(uint32_t offset, ReadHook hook);
+  void setWriteHook(uint32_t offset, WriteHook hook);
+
+  /*
+   * The next reads of the register return values, one per read. The
+   * register keeps the last one once they are all read. Takes precedence
+   * over the read hook.
+   */
+  void scriptReads(uint32_t offset, std::vector<uint32_t> values);
+
+  /*
+   * Register access behind the back of the driver: no hooks, not counted.
+   */
+  uint32_t peek(uint32_t offset) const;
+  void poke(uint32_t offset, uint32_t value);
+
+ protected:
+  uint32_t readImpl(uint32_t offset) const override;
+  void writeImpl(uint32_t offset, uint32_t value) override;
+  void readBurstImpl(uint32_t offset, uint32_t* values, size_t count)
+      const override;
+  void writeBurstImpl(uint32_t offset, const uint32_t* values, size_t count)
+      override;
+
+ private:
+  uint32_t readLocked(uint32_t offset) const;
+  void writeLocked(uint32_t offset, uint32_t value);
+
+  mutable std::mutex mutex_;
+  // Reads can have side effects through the hooks and scripts
+  mutable Registers regs_;
+  mutable std::unordered_map<uint32_t, std::deque<uint32_t>> scriptedReads_;
+  std::unordered_map<uint32_t, ReadHook> readHooks_;
+  std::unordered_map<uint32_t, WriteHook> writeHooks_;
+};
+
+} // namespace facebook::fboss
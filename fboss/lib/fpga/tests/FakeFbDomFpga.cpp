@@ -0,0 +1,192 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace {
+constexpr uint32_t kFakeDomSize = 0x4000;
+// The status registers as the driver knows them, see FbDomFpga.h. This
+// only checks takeQsfpEvents() against its own offsets, not the hardware.
+constexpr uint32_t kQsfpIntrReg = facebook::fboss::FbDomFpga::kQsfpIntrReg;
+constexpr uint32_t kQsfpPresentReg =
+    facebook::fboss::FbDomFpga::kQsfpPresentReg;
+constexpr uint32_t kQsfpPresentChangeReg =
+    facebook::fboss::FbDomFpga::kQsfpPresentChangeReg;
+
+template <typename Register>
+uint32_t regAddr(uint32_t rtc) {
+  return Register::baseAddr::value + Register::addrIncr::value * rtc;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+FakeFbDomFpga::FakeFbDomFpga(uint32_t latencyPolls)
+    : FbDomFpga(std::make_unique<SimulatedFpgaRegisterBus>(kFakeDomSize), 1),
+      latencyPolls_(latencyPolls) {
+  auto bus = getSimulatedBus();
+  for (uint32_t rtc = 0; rtc < kNumRtcs; ++rtc) {
+    // Status reads have side effects
+    bus->setReadHook(
+        regAddr<I2cRtcStatus>(rtc),
+        [this, rtc](uint32_t, SimulatedFpgaRegisterBus::Registers&) {
+          return readStatus(rtc);
+        });
+    bus->setWriteHook(
+        regAddr<I2cDescriptorUpper>(rtc),
+        [this, rtc](
+            uint32_t,
+            uint32_t value,
+            SimulatedFpgaRegisterBus::Registers& regs) {
+          I2cDescriptorUpper upper;
+          upper.reg = value;
+          if (upper.valid) {
+            startTransaction(rtc, regs);
+          }
+        });
+  }
+  bus->setReadHook(
+      kQsfpPresentChangeReg,
+      [this](uint32_t, SimulatedFpgaRegisterBus::Registers&) {
+        std::lock_guard<std::mutex> g(mutex_);
+        return qsfpPresenceChanges_;
+      });
+  bus->setWriteHook(
+      kQsfpPresentChangeReg,
+      [this](uint32_t, uint32_t value, SimulatedFpgaRegisterBus::Registers&) {
+        std::lock_guard<std::mutex> g(mutex_);
+        qsfpPresenceChanges_ &= ~value;
+      });
+}
+
+SimulatedFpgaRegisterBus* FakeFbDomFpga::getSimulatedBus() const {
+  return static_cast<SimulatedFpgaRegisterBus*>(getRegisterBus());
+}
+
+void FakeFbDomFpga::startTransaction(
+    uint32_t rtc,
+    SimulatedFpgaRegisterBus::Registers& regs) {
+  std::lock_guard<std::mutex> g(mutex_);
+  CHECK(!rtcs_[rtc].inFlight) << "RTC " << rtc << " is busy";
+  I2cDescriptorLower lower;
+  I2cDescriptorUpper upper;
+  lower.reg = regs[regAddr<I2cDescriptorLower>(rtc)];
+  upper.reg = regs[regAddr<I2cDescriptorUpper>(rtc)];
+
+  auto& state = rtcs_[rtc];
+  state.inFlight = true;
+  state.done = false;
+  state.pollsLeft = latencyPolls_;
+  state.error = absent_.count(std::make_pair(rtc, upper.channel)) > 0;
+  maxInFlight_ = std::max(maxInFlight_, ++numInFlight_);
+  ++numTransactions_;
+  if (state.error) {
+    return;
+  }
+
+  // The data is moved right away, only the status is delayed
+  auto& module = modules_[rtc][upper.channel];
+  for (uint32_t i = 0; i < lower.len; ++i) {
+    uint32_t word = kFacebookFpgaRTCIOBlockSize * rtc + (i & ~3u);
+    uint32_t shift = (i & 3u) * 8;
+    uint8_t moduleOffset = upper.offset + i;
+    if (lower.op == 1) {
+      auto& data = regs[kFacebookFpgaRTCReadBlock + word];
+      data &= ~(0xffu << shift);
+      data |= static_cast<uint32_t>(module[moduleOffset]) << shift;
+    } else {
+      module[moduleOffset] = regs[kFacebookFpgaRTCWriteBlock + word] >> shift;
+    }
+  }
+}
+
+uint32_t FakeFbDomFpga::readStatus(uint32_t rtc) {
+  std::lock_guard<std::mutex> g(mutex_);
+  auto& state = rtcs_[rtc];
+  if (state.inFlight && state.pollsLeft > 0) {
+    --state.pollsLeft;
+  } else if (state.inFlight) {
+    // Stays done until the next transaction
+    state.inFlight = false;
+    state.done = true;
+    --numInFlight_;
+  }
+  I2cRtcStatus status;
+  status.reg = 0;
+  status.desc0done = state.done && !state.error;
+  status.desc0error = state.done && state.error;
+  return status.reg;
+}
+
+void FakeFbDomFpga::setPresent(uint32_t rtc, uint32_t channel, bool present) {
+  std::lock_guard<std::mutex> g(mutex_);
+  if (present) {
+    absent_.erase(std::make_pair(rtc, channel));
+  } else {
+    absent_.insert(std::make_pair(rtc, channel));
+  }
+}
+
+void FakeFbDomFpga::plugQsfp(int qsfp) {
+  setQsfpPresent(qsfp, true);
+}
+
+void FakeFbDomFpga::unplugQsfp(int qsfp) {
+  setQsfpPresent(qsfp, false);
+}
+
+void FakeFbDomFpga::setQsfpPresent(int qsfp, bool present) {
+  auto bus = getSimulatedBus();
+  auto presence = bus->peek(kQsfpPresentReg);
+  if (((presence >> qsfp) & 1) == present) {
+    return;
+  }
+  bus->poke(kQsfpPresentReg, presence ^ (1 << qsfp));
+  std::lock_guard<std::mutex> g(mutex_);
+  qsfpPresenceChanges_ |= 1 << qsfp;
+}
+
+void FakeFbDomFpga::setQsfpInterrupt(int qsfp, bool asserted) {
+  auto bus = getSimulatedBus();
+  auto interrupts = bus->peek(kQsfpIntrReg);
+  if (asserted) {
+    interrupts |= 1 << qsfp;
+  } else {
+    interrupts &= ~(1 << qsfp);
+  }
+  bus->poke(kQsfpIntrReg, interrupts);
+}
+
+uint8_t FakeFbDomFpga::getModuleByte(
+    uint32_t rtc,
+    uint32_t channel,
+    uint8_t offset) const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return modules_[rtc][channel][offset];
+}
+
+void FakeFbDomFpga::setModuleByte(
+    uint32_t rtc,
+    uint32_t channel,
+    uint8_t offset,
+    uint8_t value) {
+  std::lock_guard<std::mutex> g(mutex_);
+  modules_[rtc][channel][offset] = value;
+}
+
+uint32_t FakeFbDomFpga::getNumTransactions() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return numTransactions_;
+}
+
+uint32_t FakeFbDomFpga::getMaxInFlight() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return maxInFlight_;
+}
+
+} // namespace facebook::fboss
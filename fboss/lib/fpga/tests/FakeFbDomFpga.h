@@ -0,0 +1,86 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/lib/fpga/SimulatedFpgaRegisterBus.h"
+
+#include <array>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace facebook::fboss {
+
+/*
+ * DOM FPGA on a simulated register bus, modelling its I2C real time
+ * controllers (RTC) to exercise FbFpgaI2c without hardware. Each channel of
+ * each RTC is attached to a module with a flat 256 byte address space.
+ *
+ * Setting the valid bit of the upper descriptor of an RTC runs the
+ * transaction against the module. Its done bit is only reported after the
+ * status was read latencyPolls times, so transactions stay in flight long
+ * enough to overlap with the ones of other RTCs.
+ *
+ * QSFPs can be plugged in and removed, which the FPGA latches until the
+ * change is cleared.
+ */
+class FakeFbDomFpga : public FbDomFpga {
+ public:
+  static constexpr uint32_t kNumRtcs = 4;
+  static constexpr uint32_t kNumChannels = 4;
+
+  explicit FakeFbDomFpga(uint32_t latencyPolls = 0);
+
+  // The registers, to script the other ones
+  SimulatedFpgaRegisterBus* getSimulatedBus() const;
+
+  // Transactions to an absent module fail
+  void setPresent(uint32_t rtc, uint32_t channel, bool present);
+
+  uint8_t getModuleByte(uint32_t rtc, uint32_t channel, uint8_t offset) const;
+  void setModuleByte(
+      uint32_t rtc,
+      uint32_t channel,
+      uint8_t offset,
+      uint8_t value);
+
+  void plugQsfp(int qsfp);
+  void unplugQsfp(int qsfp);
+  void setQsfpInterrupt(int qsfp, bool asserted);
+
+  // Number of transactions run, and the most ever in flight at once
+  uint32_t getNumTransactions() const;
+  uint32_t getMaxInFlight() const;
+
+ private:
+  using ModuleMemory = std::array<uint8_t, 256>;
+
+  struct RtcState {
+    // Status reads left before the transaction in flight is done
+    uint32_t pollsLeft{0};
+    bool inFlight{false};
+    bool done{false};
+    bool error{false};
+  };
+
+  // Run under the lock of the bus, which is taken before mutex_
+  void startTransaction(
+      uint32_t rtc,
+      SimulatedFpgaRegisterBus::Registers& regs);
+  uint32_t readStatus(uint32_t rtc);
+  void setQsfpPresent(int qsfp, bool present);
+
+  const uint32_t latencyPolls_;
+  mutable std::mutex mutex_;
+  std::array<std::array<ModuleMemory, kNumChannels>, kNumRtcs> modules_{};
+  std::set<std::pair<uint32_t, uint32_t>> absent_;
+  std::array<RtcState, kNumRtcs> rtcs_;
+  uint32_t numInFlight_{0};
+  uint32_t maxInFlight_{0};
+  uint32_t numTransactions_{0};
+  // Latched presence changes, write 1 to clear
+  uint32_t qsfpPresenceChanges_{0};
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,168 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbDomFpga.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/lib/fpga/SimulatedFpgaRegisterBus.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr uint32_t kDomFpgaSize = 0x8000;
+constexpr uint32_t kPimTypeReg = 0x0;
+constexpr uint32_t kQsfpPresentReg = 0x0048;
+constexpr uint32_t kQsfpResetReg = 0x0070;
+constexpr uint32_t kPortLedBase = 0x0310;
+
+class FbDomFpgaTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    auto bus = std::make_unique<SimulatedFpgaRegisterBus>(kDomFpgaSize);
+    bus_ = bus.get();
+    fpga_ = std::make_unique<FbDomFpga>(std::move(bus), 1);
+    fpga_->initHW();
+  }
+
+  SimulatedFpgaRegisterBus* bus_;
+  std::unique_ptr<FbDomFpga> fpga_;
+};
+} // namespace
+
+TEST_F(FbDomFpgaTest, qsfpPresence) {
+  bus_->poke(kQsfpPresentReg, 0x5);
+  EXPECT_EQ(0x5, fpga_->getQsfpsPresence());
+  EXPECT_TRUE(fpga_->isQsfpPresent(0));
+  EXPECT_FALSE(fpga_->isQsfpPresent(1));
+  EXPECT_TRUE(fpga_->isQsfpPresent(2));
+
+  // A module plugged in between two scans
+  bus_->scriptReads(kQsfpPresentReg, {0x5, 0x7});
+  EXPECT_EQ(0x5, fpga_->getQsfpsPresence());
+  EXPECT_EQ(0x7, fpga_->getQsfpsPresence());
+  EXPECT_EQ(0x7, fpga_->getQsfpsPresence());
+}
+
+TEST_F(FbDomFpgaTest, qsfpReset) {
+  bus_->poke(kQsfpResetReg, 0xffff);
+  fpga_->ensureQsfpOutOfReset(3);
+  EXPECT_EQ(0xfff7, bus_->peek(kQsfpResetReg));
+  // Already out of reset, nothing to write
+  fpga_->ensureQsfpOutOfReset(3);
+  EXPECT_EQ(1, bus_->getAccessCounts()[kQsfpResetReg].writes);
+
+  std::vector<uint32_t> resetWrites;
+  bus_->setWriteHook(
+      kQsfpResetReg,
+      [&resetWrites](
+          uint32_t, uint32_t value, SimulatedFpgaRegisterBus::Registers&) {
+        resetWrites.push_back(value);
+      });
+  bus_->poke(kQsfpResetReg, 0x0);
+  fpga_->triggerQsfpHardReset(4);
+  EXPECT_EQ((std::vector<uint32_t>{0x10, 0x0}), resetWrites);
+}
+
+TEST_F(FbDomFpgaTest, frontPanelLed) {
+  fpga_->setFrontPanelLedColor(2, FbDomFpga::LedColor::GREEN);
+  EXPECT_EQ(
+      static_cast<uint32_t>(FbDomFpga::LedColor::GREEN),
+      bus_->peek(kPortLedBase + 2 * 4));
+  EXPECT_EQ(0, bus_->peek(kPortLedBase + 3 * 4));
+}
+
+TEST_F(FbDomFpgaTest, pimType) {
+  bus_->poke(kPimTypeReg, 0xA5001234);
+  EXPECT_EQ(FbDomFpga::PimType::MINIPACK_16O, fpga_->getPimType());
+  bus_->poke(kPimTypeReg, 0x12000000);
+  EXPECT_THROW(fpga_->getPimType(), FbossError);
+}
+
+TEST_F(FbDomFpgaTest, burstAccess) {
+  std::vector<uint32_t> values{1, 2, 3, 4};
+  fpga_->writeBurst(0x1000, values.data(), values.size());
+  for (uint32_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], bus_->peek(0x1000 + i * 4));
+  }
+
+  std::vector<uint32_t> readBack(values.size());
+  fpga_->readBurst(0x1000, readBack.data(), readBack.size());
+  EXPECT_EQ(values, readBack);
+
+  // Each register of the burst is counted once, peek and poke are not
+  auto counts = bus_->getAccessCounts();
+  EXPECT_EQ(values.size(), counts.size());
+  for (uint32_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(1, counts[0x1000 + i * 4].reads);
+    EXPECT_EQ(1, counts[0x1000 + i * 4].writes);
+  }
+  bus_->resetAccessCounts();
+  EXPECT_EQ(0, bus_->getTotalReads());
+  EXPECT_EQ(0, bus_->getTotalWrites());
+}
+
+TEST_F(FbDomFpgaTest, readHook) {
+  uint32_t reads = 0;
+  bus_->setReadHook(
+      0x100, [&reads](uint32_t, SimulatedFpgaRegisterBus::Registers& regs) {
+        // Clear on read
+        ++reads;
+        auto value = regs[0x100];
+        regs[0x100] = 0;
+        return value;
+      });
+  bus_->poke(0x100, 0xabcd);
+  EXPECT_EQ(0xabcd, fpga_->read(0x100));
+  EXPECT_EQ(0, fpga_->read(0x100));
+  EXPECT_EQ(2, reads);
+}
+
+TEST(FbDomFpgaEventsTest, plugAndUnplug) {
+  FakeFbDomFpga fpga;
+  EXPECT_EQ(0, fpga.takeQsfpEvents());
+
+  fpga.plugQsfp(3);
+  EXPECT_EQ(1 << 3, fpga.takeQsfpEvents());
+  EXPECT_TRUE(fpga.isQsfpPresent(3));
+  // Reported once
+  EXPECT_EQ(0, fpga.takeQsfpEvents());
+
+  // Changes between two checks are all reported, even if they cancel out
+  fpga.plugQsfp(1);
+  fpga.unplugQsfp(3);
+  fpga.plugQsfp(7);
+  fpga.unplugQsfp(7);
+  EXPECT_EQ((1 << 1) | (1 << 3) | (1 << 7), fpga.takeQsfpEvents());
+  EXPECT_EQ(1 << 1, fpga.getQsfpsPresence());
+}
+
+TEST(FbDomFpgaEventsTest, interrupts) {
+  FakeFbDomFpga fpga;
+  fpga.setQsfpInterrupt(5, true);
+  EXPECT_EQ(1 << 5, fpga.takeQsfpEvents());
+  // Still asserted, the flags of the module were not read yet
+  EXPECT_EQ(0, fpga.takeQsfpEvents());
+
+  fpga.setQsfpInterrupt(5, false);
+  EXPECT_EQ(0, fpga.takeQsfpEvents());
+  fpga.setQsfpInterrupt(5, true);
+  fpga.plugQsfp(0);
+  EXPECT_EQ((1 << 5) | 1, fpga.takeQsfpEvents());
+}
+
+TEST(FbDomFpgaEventsTest, singleBurst) {
+  FakeFbDomFpga fpga;
+  auto bus = fpga.getRegisterBus();
+  fpga.takeQsfpEvents();
+  // All of the status registers in one pass, nothing to clear
+  EXPECT_EQ(0, bus->getTotalWrites());
+  for (const auto& [offset, counts] : bus->getAccessCounts()) {
+    EXPECT_EQ(1, counts.reads) << "register " << offset;
+  }
+
+  bus->resetAccessCounts();
+  fpga.plugQsfp(2);
+  fpga.takeQsfpEvents();
+  EXPECT_EQ(1, bus->getTotalWrites());
+}
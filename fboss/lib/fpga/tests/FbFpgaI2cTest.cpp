@@ -0,0 +1,180 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+
+#include <folly/futures/Future.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr uint32_t kPim = 1;
+constexpr uint32_t kLatencyPolls = 2;
+
+std::vector<uint8_t> pattern(size_t len, uint8_t seed) {
+  std::vector<uint8_t> data(len);
+  std::iota(data.begin(), data.end(), seed);
+  return data;
+}
+} // namespace
+
+TEST(FbFpgaI2cTest, readWrite) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  FbFpgaI2c i2c(&fpga, 1, kPim);
+
+  // Lengths which are not a multiple of the 4 byte data registers
+  auto data = pattern(13, 0x40);
+  i2c.write(2, 0x80, folly::ByteRange(data.data(), data.size()));
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(data[i], fpga.getModuleByte(1, 2, 0x80 + i));
+  }
+
+  std::vector<uint8_t> buf(data.size());
+  i2c.read(2, 0x80, folly::MutableByteRange(buf.data(), buf.size()));
+  EXPECT_EQ(data, buf);
+  EXPECT_EQ(0x40, i2c.readByte(2, 0x80));
+  // Other channels are other modules
+  EXPECT_EQ(0, i2c.readByte(3, 0x80));
+
+  const auto& stats = i2c.getI2cControllerPlatformStats();
+  EXPECT_EQ(3, stats.readTotal_);
+  EXPECT_EQ(15, stats.readBytes_);
+  EXPECT_EQ(1, stats.writeTotal_);
+  EXPECT_EQ(13, stats.writeBytes_);
+}
+
+TEST(FbFpgaI2cTest, readAbsentModule) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  FbFpgaI2c i2c(&fpga, 0, kPim);
+  fpga.setPresent(0, 1, false);
+
+  EXPECT_THROW(i2c.readByte(1, 0), FbFpgaI2cError);
+  EXPECT_THROW(i2c.writeByte(1, 0, 0xff), FbFpgaI2cError);
+  EXPECT_EQ(1, i2c.getI2cControllerPlatformStats().readFailed_);
+  EXPECT_EQ(1, i2c.getI2cControllerPlatformStats().writeFailed_);
+}
+
+TEST(FbFpgaI2cTest, burstDataBlock) {
+  FakeFbDomFpga fpga;
+  FbFpgaI2c i2c(&fpga, 1, kPim);
+  auto bus = fpga.getRegisterBus();
+
+  auto data = pattern(128, 0);
+  i2c.write(0, 0x80, folly::ByteRange(data.data(), data.size()));
+  std::vector<uint8_t> buf(data.size());
+  bus->resetAccessCounts();
+  i2c.read(0, 0x80, folly::MutableByteRange(buf.data(), buf.size()));
+  EXPECT_EQ(data, buf);
+
+  // Two descriptors, one status poll and every word of the data block once
+  EXPECT_EQ(2, bus->getTotalWrites());
+  EXPECT_EQ(1 + 128 / 4, bus->getTotalReads());
+  auto counts = bus->getAccessCounts();
+  uint32_t readBlockAddr =
+      kFacebookFpgaRTCReadBlock + kFacebookFpgaRTCIOBlockSize * 1;
+  for (uint32_t word = 0; word < 128 / 4; ++word) {
+    EXPECT_EQ(1, counts[readBlockAddr + word * 4].reads);
+  }
+}
+
+TEST(FbFpgaI2cControllerTest, futureReadWrite) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  FbFpgaI2cController controller(&fpga, 3, kPim);
+
+  // Transactions of all channels are queued, and run in order
+  std::vector<folly::SemiFuture<folly::Unit>> writes;
+  std::vector<folly::SemiFuture<std::vector<uint8_t>>> reads;
+  for (uint8_t channel = 0; channel < FakeFbDomFpga::kNumChannels; ++channel) {
+    writes.push_back(controller.futureWrite(channel, 0, pattern(128, channel)));
+    reads.push_back(controller.futureRead(channel, 0, 128));
+  }
+  folly::collectAll(std::move(writes)).get();
+  auto results = folly::collectAll(std::move(reads)).get();
+  for (uint8_t channel = 0; channel < FakeFbDomFpga::kNumChannels; ++channel) {
+    EXPECT_EQ(pattern(128, channel), results[channel].value());
+  }
+
+  const auto& stats = controller.getI2cControllerPlatformStats();
+  EXPECT_EQ(4, stats.readTotal_);
+  EXPECT_EQ(512, stats.readBytes_);
+  EXPECT_EQ(4, stats.writeTotal_);
+  EXPECT_EQ(512, stats.writeBytes_);
+}
+
+TEST(FbFpgaI2cControllerTest, futureReadAbsentModule) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  FbFpgaI2cController controller(&fpga, 0, kPim);
+  fpga.setPresent(0, 2, false);
+
+  auto absent = controller.futureRead(2, 0, 1);
+  auto present = controller.futureRead(1, 0, 1);
+  EXPECT_THROW(std::move(absent).get(), FbFpgaI2cError);
+  // A failure does not affect the transactions queued behind it
+  EXPECT_EQ(std::vector<uint8_t>{0}, std::move(present).get());
+  EXPECT_EQ(1, controller.getI2cControllerPlatformStats().readFailed_);
+}
+
+TEST(FbFpgaI2cControllerTest, syncAfterFuture) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  FbFpgaI2cController controller(&fpga, 2, kPim);
+
+  // A synchronous access waits for the transactions queued before it
+  auto write = controller.futureWrite(0, 0x10, {0xaa, 0xbb});
+  EXPECT_EQ(0xbb, controller.readByte(0, 0x11));
+  controller.writeByte(0, 0x10, 0xcc);
+  std::move(write).get();
+  EXPECT_EQ(
+      (std::vector<uint8_t>{0xcc, 0xbb}),
+      controller.futureRead(0, 0x10, 2).get());
+
+  // Including those still pending behind the one in flight, such as a page
+  // select followed by a write to the selected page
+  auto pageSelect = controller.futureWrite(1, 0x7f, {0x3});
+  auto pageWrite = controller.futureWrite(1, 0x80, {0xdd});
+  EXPECT_EQ(0x3, controller.readByte(1, 0x7f));
+  EXPECT_EQ(0xdd, controller.readByte(1, 0x80));
+  std::move(pageSelect).get();
+  std::move(pageWrite).get();
+
+  // Synchronous accesses from the event base thread too
+  auto read = controller.futureRead(0, 0x10, 2);
+  uint8_t byte = 0;
+  controller.getEventBase()->runInEventBaseThreadAndWait(
+      [&]() { byte = controller.readByte(0, 0x11); });
+  EXPECT_EQ(0xbb, byte);
+  EXPECT_EQ((std::vector<uint8_t>{0xcc, 0xbb}), std::move(read).get());
+}
+
+TEST(FbFpgaI2cControllerTest, overlapControllers) {
+  FakeFbDomFpga fpga(kLatencyPolls);
+  std::vector<std::unique_ptr<FbFpgaI2cController>> controllers;
+  for (uint32_t rtc = 0; rtc < FakeFbDomFpga::kNumRtcs; ++rtc) {
+    controllers.push_back(
+        std::make_unique<FbFpgaI2cController>(&fpga, rtc, kPim));
+  }
+
+  // Issue page reads of every module from a single thread
+  constexpr int kPagesPerModule = 8;
+  std::vector<folly::SemiFuture<std::vector<uint8_t>>> reads;
+  for (uint32_t rtc = 0; rtc < FakeFbDomFpga::kNumRtcs; ++rtc) {
+    for (uint8_t channel = 0; channel < FakeFbDomFpga::kNumChannels;
+         ++channel) {
+      fpga.setModuleByte(
+          rtc, channel, 0x80, rtc * FakeFbDomFpga::kNumChannels + channel);
+      for (int page = 0; page < kPagesPerModule; ++page) {
+        reads.push_back(controllers[rtc]->futureRead(channel, 0x80, 128));
+      }
+    }
+  }
+  auto results = folly::collectAll(std::move(reads)).get();
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(i / kPagesPerModule, results[i].value()[0]);
+  }
+  EXPECT_EQ(results.size(), fpga.getNumTransactions());
+  // The controllers did not wait on each other
+  EXPECT_GT(fpga.getMaxInFlight(), 1);
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/lib/test/LoopbackHttpServer.h"
+
+#include <folly/Exception.h>
+#include <folly/Format.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace facebook::fboss {
+
+LoopbackHttpServer::LoopbackHttpServer(Handler handler)
+    : handler_(std::move(handler)) {
+  listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+  folly::checkUnixError(listenFd_, "socket()");
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  folly::checkUnixError(
+      bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)),
+      "bind()");
+  folly::checkUnixError(listen(listenFd_, 16), "listen()");
+
+  socklen_t len = sizeof(addr);
+  folly::checkUnixError(
+      getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len),
+      "getsockname()");
+  port_ = ntohs(addr.sin_port);
+
+  acceptThread_ = std::thread([this]() { acceptLoop(); });
+}
+
+LoopbackHttpServer::~LoopbackHttpServer() {
+  // Unblocks accept() and recv()
+  shutdown(listenFd_, SHUT_RDWR);
+  acceptThread_.join();
+  close(listenFd_);
+
+  std::lock_guard<std::mutex> g(mutex_);
+  for (auto fd : connectionFds_) {
+    shutdown(fd, SHUT_RDWR);
+  }
+  for (auto& thread : connectionThreads_) {
+    thread.join();
+  }
+  for (auto fd : connectionFds_) {
+    close(fd);
+  }
+}
+
+void LoopbackHttpServer::acceptLoop() {
+  while (true) {
+    int fd = accept(listenFd_, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    ++numConnections_;
+    std::lock_guard<std::mutex> g(mutex_);
+    connectionFds_.push_back(fd);
+    connectionThreads_.emplace_back([this, fd]() { serve(fd); });
+  }
+}
+
+void LoopbackHttpServer::serve(int fd) {
+  std::string buffer;
+  char chunk[4096];
+  while (true) {
+    auto end = buffer.find("\r\n\r\n");
+    if (end == std::string::npos) {
+      auto bytes = recv(fd, chunk, sizeof(chunk), 0);
+      if (bytes <= 0) {
+        return;
+      }
+      buffer.append(chunk, bytes);
+      continue;
+    }
+
+    // Request line: "GET <path> HTTP/1.1"
+    auto pathStart = buffer.find(' ') + 1;
+    auto pathEnd = buffer.find(' ', pathStart);
+    auto path = buffer.substr(pathStart, pathEnd - pathStart);
+    buffer.erase(0, end + 4);
+    ++numRequests_;
+
+    auto body = handler_(path);
+    auto response = body
+        ? folly::sformat(
+              "HTTP/1.1 200 OK\r\nContent-Length: {}\r\n\r\n{}",
+              body->size(),
+              *body)
+        : std::string("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+    // The client may have given up on the request and closed the connection
+    for (size_t sent = 0; sent < response.size();) {
+      auto bytes = send(
+          fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+      if (bytes <= 0) {
+        return;
+      }
+      sent += bytes;
+    }
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Minimal HTTP/1.1 server on 127.0.0.1, to test rest clients. Connections
+ * are kept alive and each one is served by its own thread, so the handler
+ * can be called concurrently. Requests for which the handler returns
+ * nothing get a 404.
+ */
+class LoopbackHttpServer {
+ public:
+  using Handler =
+      std::function<std::optional<std::string>(const std::string& path)>;
+
+  explicit LoopbackHttpServer(Handler handler);
+  ~LoopbackHttpServer();
+
+  int getPort() const {
+    return port_;
+  }
+  uint64_t getNumConnections() const {
+    return numConnections_;
+  }
+  uint64_t getNumRequests() const {
+    return numRequests_;
+  }
+
+ private:
+  void acceptLoop();
+  void serve(int fd);
+
+  // Forbidden copy constructor and assignment operator
+  LoopbackHttpServer(LoopbackHttpServer const&) = delete;
+  LoopbackHttpServer& operator=(LoopbackHttpServer const&) = delete;
+
+  Handler handler_;
+  int listenFd_{-1};
+  int port_{0};
+  std::atomic<uint64_t> numConnections_{0};
+  std::atomic<uint64_t> numRequests_{0};
+  std::thread acceptThread_;
+  std::mutex mutex_;
+  std::vector<int> connectionFds_;
+  std::vector<std::thread> connectionThreads_;
+};
+
+} // namespace facebook::fboss
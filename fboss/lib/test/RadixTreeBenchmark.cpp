@@ -27,6 +27,10 @@ DEFINE_int32(
     lookup_count,
     5000,
     "The number of elements to look up on each lookup iteration");
+DEFINE_int32(
+    bulk_load_count,
+    1000000,
+    "The number of prefixes in trees built by bulk load iterations");
 namespace {
 set<Prefix4> insertSet4;
 set<Prefix4> eraseSet4;
@@ -37,6 +41,8 @@ set<Prefix6> eraseSet6;
 set<Prefix6> exactMatchSet6;
 set<Prefix6> longestMatchSet6;
 vector<int> valueSet;
+vector<RadixTree<IPAddressV4, int>::BulkLoadEntry> bulkLoadEntries4;
+vector<RadixTree<IPAddressV6, int>::BulkLoadEntry> bulkLoadEntries6;
 
 // V4 Benchmarks
 template <typename TREE>
@@ -197,6 +203,40 @@ BENCHMARK_RELATIVE(RadixTreeLongestMatch6) {
   }
 }
 
+// Building a full table, e.g. on warm boot
+
+BENCHMARK(RadixTreeIncrementalBuild4) {
+  RadixTree<IPAddressV4, int> rtree;
+  for (const auto& entry : bulkLoadEntries4) {
+    rtree.insert(entry.ipAddress, entry.masklen, entry.value);
+  }
+}
+
+BENCHMARK_RELATIVE(RadixTreeBulkLoad4) {
+  RadixTree<IPAddressV4, int> rtree;
+  vector<RadixTree<IPAddressV4, int>::BulkLoadEntry> entries;
+  BENCHMARK_SUSPEND {
+    entries = bulkLoadEntries4;
+  }
+  rtree.bulkLoad(std::move(entries));
+}
+
+BENCHMARK(RadixTreeIncrementalBuild6) {
+  RadixTree<IPAddressV6, int> rtree;
+  for (const auto& entry : bulkLoadEntries6) {
+    rtree.insert(entry.ipAddress, entry.masklen, entry.value);
+  }
+}
+
+BENCHMARK_RELATIVE(RadixTreeBulkLoad6) {
+  RadixTree<IPAddressV6, int> rtree;
+  vector<RadixTree<IPAddressV6, int>::BulkLoadEntry> entries;
+  BENCHMARK_SUSPEND {
+    entries = bulkLoadEntries6;
+  }
+  rtree.bulkLoad(std::move(entries));
+}
+
 } // namespace
 
 int main(int /*argc*/, char* /*argv*/ []) {
@@ -252,5 +292,29 @@ int main(int /*argc*/, char* /*argv*/ []) {
     auto newIp = pfx.ip.mask(newMask);
     longestMatchSet6.insert(Prefix6(newIp, newMask));
   }
+
+  // Sorted prefixes for bulk loads, as in a serialized RIB
+  set<Prefix4> bulkLoadSet4;
+  while (bulkLoadSet4.size() < FLAGS_bulk_load_count) {
+    auto mask = folly::Random::rand32(8, 33);
+    auto ip = IPAddressV4::fromLongHBO(folly::Random::rand32()).mask(mask);
+    bulkLoadSet4.insert(Prefix4(ip, mask));
+  }
+  for (const auto& pfx : bulkLoadSet4) {
+    bulkLoadEntries4.push_back(
+        {pfx.ip, pfx.mask, static_cast<int>(bulkLoadEntries4.size())});
+  }
+  set<Prefix6> bulkLoadSet6;
+  while (bulkLoadSet6.size() < FLAGS_bulk_load_count) {
+    auto mask = folly::Random::rand32(16, 129);
+    ByteArray16 ba;
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+    bulkLoadSet6.insert(Prefix6(IPAddressV6(ba).mask(mask), mask));
+  }
+  for (const auto& pfx : bulkLoadSet6) {
+    bulkLoadEntries6.push_back(
+        {pfx.ip, pfx.mask, static_cast<int>(bulkLoadEntries6.size())});
+  }
   runBenchmarks();
 }
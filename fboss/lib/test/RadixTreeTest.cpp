@@ -1527,3 +1527,81 @@ TEST(RadixTree, SubTreeIterator) {
   }
   EXPECT_EQ(rtree.end().subTreeIterator(), rtree.end());
 }
+
+namespace {
+template <typename IPAddrType>
+IPAddrType randomAddress();
+
+template <>
+IPAddressV4 randomAddress<IPAddressV4>() {
+  return IPAddressV4::fromLongHBO(folly::Random::rand32());
+}
+
+template <>
+IPAddressV6 randomAddress<IPAddressV6>() {
+  folly::ByteArray16 ba;
+  *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+  *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+  return IPAddressV6(ba);
+}
+
+template <typename IPAddrType>
+void bulkLoadRandomPrefixes(int count) {
+  using Tree = RadixTree<IPAddrType, int>;
+  std::vector<typename Tree::BulkLoadEntry> entries;
+  Tree incremental;
+  for (int i = 0; i < count; ++i) {
+    // Leave the host bits set, bulkLoad should mask them like insert
+    auto ip = randomAddress<IPAddrType>();
+    uint8_t mask = folly::Random::rand32(IPAddrType::bitCount() + 1);
+    if (incremental.insert(ip, mask, i).second) {
+      // Duplicates are covered by BulkLoadLastDuplicateWins
+      entries.push_back({ip, mask, i});
+    }
+  }
+  Tree bulkLoaded;
+  bulkLoaded.bulkLoad(entries);
+  EXPECT_EQ(bulkLoaded.size(), incremental.size());
+  EXPECT_EQ(bulkLoaded, incremental);
+  EXPECT_TRUE(bulkLoaded.equalsIncrementalInsertion());
+
+  // Entries already in iteration order skip the sort
+  std::vector<typename Tree::BulkLoadEntry> sorted;
+  for (const auto& node : incremental) {
+    sorted.push_back({node.ipAddress(), node.masklen(), node.value()});
+  }
+  Tree sortedBulkLoaded;
+  sortedBulkLoaded.bulkLoad(std::move(sorted));
+  EXPECT_EQ(sortedBulkLoaded, incremental);
+}
+} // namespace
+
+TEST(RadixTree, BulkLoadRandomV4) {
+  bulkLoadRandomPrefixes<IPAddressV4>(10000);
+}
+
+TEST(RadixTree, BulkLoadRandomV6) {
+  bulkLoadRandomPrefixes<IPAddressV6>(10000);
+}
+
+TEST(RadixTree, BulkLoadLastDuplicateWins) {
+  RadixTree<IPAddressV4, int> rtree;
+  rtree.bulkLoad({{IPAddressV4("10.1.0.0"), 16, 1},
+                  {IPAddressV4("10.0.0.0"), 8, 2},
+                  {IPAddressV4("10.1.2.3"), 16, 3},
+                  {IPAddressV4("0.0.0.0"), 0, 4}});
+  EXPECT_EQ(rtree.size(), 3);
+  EXPECT_EQ(rtree.exactMatch(IPAddressV4("10.1.0.0"), 16)->value(), 3);
+  EXPECT_EQ(rtree.exactMatch(IPAddressV4("10.0.0.0"), 8)->value(), 2);
+  EXPECT_EQ(rtree.exactMatch(IPAddressV4("0.0.0.0"), 0)->value(), 4);
+  EXPECT_TRUE(rtree.equalsIncrementalInsertion());
+}
+
+TEST(RadixTree, BulkLoadEmpty) {
+  RadixTree<IPAddressV6, int> rtree;
+  rtree.bulkLoad({});
+  EXPECT_EQ(rtree.size(), 0);
+  EXPECT_EQ(rtree.begin(), rtree.end());
+  rtree.bulkLoad({{IPAddressV6("2401:db00::"), 32, 1}});
+  EXPECT_EQ(rtree.size(), 1);
+}
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/lib/RestClient.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/lib/test/LoopbackHttpServer.h"
+
+#include <folly/Conv.h>
+#include <folly/IPAddress.h>
+#include <folly/futures/Future.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace facebook::fboss {
+
+namespace {
+std::optional<std::string> echo(const std::string& path) {
+  if (path == "/missing") {
+    return std::nullopt;
+  }
+  if (path == "/api/sys/usb2i2c_reset") {
+    return std::string("{\"status\": \"done\"}");
+  }
+  return "echo " + path;
+}
+} // namespace
+
+TEST(RestClientTest, request) {
+  LoopbackHttpServer server(echo);
+  RestClient client(folly::IPAddress("127.0.0.1"), server.getPort());
+
+  EXPECT_TRUE(client.request("/api/sys/usb2i2c_reset"));
+  EXPECT_FALSE(client.request("/api/sys/other"));
+  EXPECT_EQ("echo /a", client.requestWithOutput("/a"));
+  EXPECT_THROW(client.requestWithOutput("/missing"), FbossError);
+}
+
+TEST(RestClientTest, reuseConnection) {
+  LoopbackHttpServer server(echo);
+  RestClient client(folly::IPAddress("127.0.0.1"), server.getPort());
+
+  for (int i = 0; i < 10; ++i) {
+    auto path = folly::to<std::string>("/sensor/", i);
+    EXPECT_EQ("echo " + path, client.requestWithOutput(path));
+  }
+  // All the requests went over the same connection
+  EXPECT_EQ(10, server.getNumRequests());
+  EXPECT_EQ(1, server.getNumConnections());
+  EXPECT_EQ(1, client.getNumConnections());
+}
+
+TEST(RestClientTest, concurrentRequests) {
+  std::atomic<int> running{0};
+  std::atomic<int> maxRunning{0};
+  LoopbackHttpServer server([&](const std::string& path) {
+    int now = ++running;
+    int max = maxRunning;
+    while (now > max && !maxRunning.compare_exchange_weak(max, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --running;
+    return echo(path);
+  });
+  RestClient client(folly::IPAddress("127.0.0.1"), server.getPort());
+
+  // Issued from a single thread, without waiting for each other
+  std::vector<folly::SemiFuture<std::string>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.push_back(
+        client.futureRequestWithOutput(folly::to<std::string>("/power/", i)));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (int i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(folly::to<std::string>("echo /power/", i), results[i].value());
+  }
+  EXPECT_GT(maxRunning, 1);
+  // Concurrent requests share a bounded number of persistent connections
+  EXPECT_LE(server.getNumConnections(), 4);
+}
+
+TEST(RestClientTest, timeout) {
+  LoopbackHttpServer server([](const std::string& path) {
+    if (path == "/slow") {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    return echo(path);
+  });
+  RestClient client(folly::IPAddress("127.0.0.1"), server.getPort());
+  client.setTimeout(std::chrono::milliseconds(50));
+
+  auto slow = client.futureRequestWithOutput("/slow");
+  EXPECT_EQ("echo /fast", client.requestWithOutput("/fast"));
+  EXPECT_THROW(std::move(slow).get(), FbossError);
+}
+
+TEST(RestClientTest, endpointStats) {
+  LoopbackHttpServer server(echo);
+  RestClient client(folly::IPAddress("127.0.0.1"), server.getPort());
+
+  client.requestWithOutput("/a");
+  client.requestWithOutput("/a");
+  client.requestWithOutput("/b");
+  EXPECT_THROW(client.requestWithOutput("/missing"), FbossError);
+
+  auto stats = client.getEndpointStats();
+  ASSERT_EQ(3, stats.size());
+  EXPECT_EQ(2, stats["/a"].requests);
+  EXPECT_EQ(0, stats["/a"].failures);
+  EXPECT_LE(stats["/a"].maxLatency, stats["/a"].totalLatency);
+  EXPECT_EQ(1, stats["/b"].requests);
+  EXPECT_EQ(1, stats["/missing"].requests);
+  EXPECT_EQ(1, stats["/missing"].failures);
+}
+
+} // namespace facebook::fboss
@@ -166,10 +166,12 @@ void CP2112::resetFromUserver() {
 }
 
 bool CP2112::resetFromRestEndpoint() {
-  BmcRestClient bmcClient;
-  bmcClient.setTimeout(std::chrono::milliseconds(2000));
   try {
-    auto ret = bmcClient.resetCP2112();
+    if (!bmcClient_) {
+      bmcClient_ = std::make_unique<BmcRestClient>();
+      bmcClient_->setTimeout(std::chrono::milliseconds(2000));
+    }
+    auto ret = bmcClient_->resetCP2112();
     if (ret) {
       VLOG(1) << "Reset CP2112 via REST endpoint passed.";
       return true;
@@ -17,10 +17,14 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 
 struct libusb_transfer;
 
 namespace facebook::fboss {
+
+class BmcRestClient;
+
 class CP2112Intf : public I2cController {
   // Bare-bones virtual interface to the CP2112 class. Used for gmock
   // testing.
@@ -433,6 +437,9 @@ class CP2112 : public CP2112Intf {
   std::chrono::milliseconds defaultTimeout_{500};
   std::chrono::time_point<std::chrono::steady_clock> lastResetTime_;
   std::chrono::milliseconds minResetInterval_{10000}; /* 10 seconds */
+  // Created on the first reset through the BMC, then reused so that its
+  // session to the BMC persists
+  std::unique_ptr<BmcRestClient> bmcClient_;
 };
 
 } // namespace facebook::fboss
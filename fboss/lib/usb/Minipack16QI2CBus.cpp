@@ -13,6 +13,14 @@
 
 #include <folly/container/Enumerate.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+DEFINE_bool(
+    minipack_qsfp_events,
+    false,
+    "Take qsfp presence changes and interrupts from the DOM FPGAs, rather "
+    "than polling every module. Off until the offsets of their status "
+    "registers are confirmed against the DOM FPGA register map");
 
 namespace {
 
@@ -130,6 +138,23 @@ void Minipack16QI2CBus::scanPresence(
   }
 }
 
+std::optional<std::set<unsigned int>> Minipack16QI2CBus::takeModuleEvents() {
+  if (!FLAGS_minipack_qsfp_events) {
+    return std::nullopt;
+  }
+  std::set<unsigned int> modules;
+  for (uint8_t pim = 1; pim <= MinipackFpga::kNumberPim; ++pim) {
+    // One burst of the status registers per pim
+    auto events = MinipackFpga::getInstance()->takeQsfpEvents(pim);
+    for (uint8_t port = 0; events; ++port, events >>= 1) {
+      if (events & 1) {
+        modules.insert(getModule(pim, port));
+      }
+    }
+  }
+  return modules;
+}
+
 void Minipack16QI2CBus::ensureOutOfReset(unsigned int module) {
   auto pim = getPim(module);
   auto port = getQsfpPimPort(module);
@@ -41,6 +41,7 @@ class Minipack16QI2CBus : public TransceiverI2CApi {
 
   bool isPresent(unsigned int module) override;
   void scanPresence(std::map<int32_t, ModulePresence>& presences) override;
+  std::optional<std::set<unsigned int>> takeModuleEvents() override;
   void ensureOutOfReset(unsigned int module) override;
   void verifyBus(bool /* autoReset */) override {}
 
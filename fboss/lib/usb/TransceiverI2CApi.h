@@ -14,6 +14,8 @@
 
 #include <cstdint>
 #include <map>
+#include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 
@@ -65,6 +67,16 @@ class TransceiverI2CApi {
    */
   virtual void scanPresence(std::map<int32_t, ModulePresence>& presences) = 0;
 
+  /*
+   * Modules which were plugged in or removed, or raised their interrupt,
+   * since the last call. Each event is only returned once. Platforms whose
+   * FPGA/CPLD does not latch these events return std::nullopt, their
+   * modules need to be polled.
+   */
+  virtual std::optional<std::set<unsigned int>> takeModuleEvents() {
+    return std::nullopt;
+  }
+
   /*
    * Function bring transceiver out of reset whenever a transceiver has been
    * detected plugging in.
@@ -19,6 +19,11 @@ DEFINE_int32(
     5,
     "Interval (in seconds) to run the main loop that determines "
     "if we need to change or fetch data for transceivers");
+DEFINE_int32(
+    transceiver_event_interval_ms,
+    500,
+    "Interval (in milliseconds) to check for transceiver events, i.e. "
+    "insertions, removals and module interrupts, on platforms latching them");
 
 int doServerLoop(std::shared_ptr<apache::thrift::ThriftServer>
         thriftServer, std::shared_ptr<QsfpServiceHandler>);
@@ -55,6 +60,14 @@ int main(int argc, char **argv) {
     std::chrono::seconds(FLAGS_loop_interval),
     "refreshTransceivers"
   );
+  // Only the transceivers with events pending, so it can run often
+  scheduler.addFunction(
+    [mgr = handler->getTransceiverManager()]() {
+      mgr->refreshPendingTransceivers();
+    },
+    std::chrono::milliseconds(FLAGS_transceiver_event_interval_ms),
+    "refreshPendingTransceivers"
+  );
 
   // Schedule the function to periodically send the I2c transaction
   // stats to the ServiceData object which gets pulled by FBagent.
@@ -28,6 +28,12 @@ class TransceiverManager {
   }
   virtual int getNumQsfpModules() = 0;
   virtual void refreshTransceivers() = 0;
+  /*
+   * Refresh only the transceivers with an event pending, e.g. plugged in or
+   * raising their interrupt. Nothing to do on platforms which do not latch
+   * transceiver events, refreshTransceivers() polls them instead.
+   */
+  virtual void refreshPendingTransceivers() = 0;
   virtual int scanTransceiverPresence(
       std::unique_ptr<std::vector<int32_t>> ids) = 0;
   virtual int numPortsPerTransceiver() = 0;
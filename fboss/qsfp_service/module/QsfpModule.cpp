@@ -139,7 +139,7 @@ TransceiverInfo QsfpModule::parseDataLocked() {
   }
   info.settings_ref() = getTransceiverSettingsInfo();
 
-  for (int i = 0; i < CHANNEL_COUNT; i++) {
+  for (unsigned int i = 0; i < numChannels(); i++) {
     Channel chan;
     chan.channel = i;
     info.channels.push_back(chan);
@@ -256,6 +256,17 @@ void QsfpModule::transceiverPortsChanged(
   }
 }
 
+std::vector<std::pair<const int, PortStatus>> QsfpModule::getPorts() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  return std::vector<std::pair<const int, PortStatus>>(
+      ports_.begin(), ports_.end());
+}
+
+bool QsfpModule::isPresent() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  return present_;
+}
+
 void QsfpModule::refresh() {
   lock_guard<std::mutex> g(qsfpModuleMutex_);
   refreshLocked();
@@ -283,6 +294,11 @@ folly::Future<folly::Unit> QsfpModule::futureRefresh() {
   });
 }
 
+void QsfpModule::markDataStale() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  lastRefreshTime_ = 0;
+}
+
 void QsfpModule::refreshLocked() {
   detectPresenceLocked();
 
@@ -80,6 +80,8 @@ class QsfpModule : public Transceiver {
   folly::Future<folly::Unit> futureRefresh() override;
   void refreshLocked();
 
+  void markDataStale() override;
+
   /*
    * Customize QSPF fields as necessary
    *
@@ -96,6 +98,17 @@ class QsfpModule : public Transceiver {
   void transceiverPortsChanged(
     const std::vector<std::pair<const int, PortStatus>>& ports) override;
 
+  /*
+   * Status of the logical ports of this transceiver, as last registered
+   * through transceiverPortsChanged()
+   */
+  std::vector<std::pair<const int, PortStatus>> getPorts();
+
+  /*
+   * Presence as detected by the last refresh, without accessing the module
+   */
+  bool isPresent();
+
   /*
    * The size of the pages used by QSFP.  See below for an explanation of
    * how they are laid out.  This needs to be publicly accessible for
@@ -225,6 +238,12 @@ class QsfpModule : public Transceiver {
    * Gather the sensor info for thrift queries
    */
   virtual GlobalSensors getSensorInfo() = 0;
+  /*
+   * Number of channels reported for thrift queries
+   */
+  virtual unsigned int numChannels() const {
+    return CHANNEL_COUNT;
+  }
   /*
    * Gather per-channel information for thrift queries
    */
@@ -47,6 +47,12 @@ class Transceiver {
   virtual void refresh() = 0;
   virtual folly::Future<folly::Unit> futureRefresh() = 0;
 
+  /*
+   * The transceiver signalled a change, e.g. through its interrupt: re-read
+   * its data at the next refresh rather than at the next refresh interval.
+   */
+  virtual void markDataStale() = 0;
+
   /*
    * Return all of the transceiver information
    */
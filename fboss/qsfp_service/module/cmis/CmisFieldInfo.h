@@ -205,7 +205,7 @@ class CmisFieldInfo {
 
 // Store multipliers for various conversion functions:
 
-typedef std::map<CmisField, std::uint32_t> CmisFieldMultiplier;
+typedef std::map<CmisField, double> CmisFieldMultiplier;
 
 // Store the mapping between port speed and ApplicationCode:
 
@@ -0,0 +1,736 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/qsfp_service/module/cmis/CmisModule.h"
+
+#include <array>
+#include <cmath>
+#include <string>
+#include "fboss/agent/FbossError.h"
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+#include "fboss/qsfp_service/module/TransceiverImpl.h"
+#include "fboss/qsfp_service/module/cmis/CmisFieldInfo.h"
+
+#include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <thrift/lib/cpp/util/EnumUtils.h>
+
+DEFINE_int32(
+    cmis_lane_monitor_refresh_interval,
+    10,
+    "how often to refetch the per lane monitors and flags of CMIS modules");
+
+using folly::IOBuf;
+using std::lock_guard;
+
+namespace {
+
+// SFF-8024 identifiers of the modules managed through CMIS
+constexpr uint8_t kQsfpDdIdentifier = 0x18;
+constexpr uint8_t kOsfpIdentifier = 0x19;
+constexpr uint8_t kQsfpCmisIdentifier = 0x1e;
+
+constexpr unsigned int kQsfpCmisLanes = 4;
+constexpr unsigned int kMaxLanes = 8;
+
+// Pages from 10h on are banked, each bank holding 8 lanes. Bank 0 holds
+// all the lanes we report.
+constexpr uint8_t kFirstBankedPage = 0x10;
+constexpr uint8_t kLaneBank = 0;
+
+/*
+ * CMIS module flags hold, from the lowest bit, the high alarm, low alarm,
+ * high warning and low warning of a sensor.
+ */
+facebook::fboss::FlagLevels getModuleFlags(uint8_t data, int offset) {
+  facebook::fboss::FlagLevels flags;
+  flags.alarm.high = data & (1 << offset);
+  flags.alarm.low = data & (1 << (offset + 1));
+  flags.warn.high = data & (1 << (offset + 2));
+  flags.warn.low = data & (1 << (offset + 3));
+  return flags;
+}
+
+/*
+ * CMIS lane flags are four bytes, the high alarm, low alarm, high warning
+ * and low warning, each with one bit per lane.
+ */
+facebook::fboss::FlagLevels getLaneFlags(const uint8_t* data, int lane) {
+  facebook::fboss::FlagLevels flags;
+  flags.alarm.high = data[0] & (1 << lane);
+  flags.alarm.low = data[1] & (1 << lane);
+  flags.warn.high = data[2] & (1 << lane);
+  flags.warn.low = data[3] & (1 << lane);
+  return flags;
+}
+
+} // namespace
+
+namespace facebook {
+namespace fboss {
+
+// As per CMIS 4.0, the data address is the page number, or LOWER
+enum CmisPages {
+  LOWER = -1,
+  PAGE00 = 0x00,
+  PAGE01 = 0x01,
+  PAGE02 = 0x02,
+  PAGE10 = 0x10,
+  PAGE11 = 0x11,
+};
+
+// As per CMIS 4.0
+static CmisFieldInfo::CmisFieldMap cmisFields = {
+    // Lower Page
+    {CmisField::IDENTIFIER, {CmisPages::LOWER, 0, 1}},
+    {CmisField::REVISION_COMPLIANCE, {CmisPages::LOWER, 1, 1}},
+    {CmisField::FLAT_MEM, {CmisPages::LOWER, 2, 1}},
+    {CmisField::MODULE_STATE, {CmisPages::LOWER, 3, 1}},
+    {CmisField::BANK0_FLAGS, {CmisPages::LOWER, 4, 1}},
+    {CmisField::BANK1_FLAGS, {CmisPages::LOWER, 5, 1}},
+    {CmisField::BANK2_FLAGS, {CmisPages::LOWER, 6, 1}},
+    {CmisField::BANK3_FLAGS, {CmisPages::LOWER, 7, 1}},
+    {CmisField::MODULE_FLAG, {CmisPages::LOWER, 8, 1}},
+    {CmisField::MODULE_ALARMS, {CmisPages::LOWER, 9, 3}},
+    {CmisField::TEMPERATURE, {CmisPages::LOWER, 14, 2}},
+    {CmisField::VCC, {CmisPages::LOWER, 16, 2}},
+    {CmisField::MODULE_CONTROL, {CmisPages::LOWER, 26, 1}},
+    {CmisField::APPLICATION_ADVERTISING1, {CmisPages::LOWER, 86, 4}},
+    {CmisField::BANK_SELECT, {CmisPages::LOWER, 126, 1}},
+    {CmisField::PAGE_SELECT_BYTE, {CmisPages::LOWER, 127, 1}},
+
+    // Page 00h
+    {CmisField::VENDOR_NAME, {CmisPages::PAGE00, 129, 16}},
+    {CmisField::VENDOR_OUI, {CmisPages::PAGE00, 145, 3}},
+    {CmisField::PART_NUMBER, {CmisPages::PAGE00, 148, 16}},
+    {CmisField::REVISION_NUMBER, {CmisPages::PAGE00, 164, 2}},
+    {CmisField::VENDOR_SERIAL_NUMBER, {CmisPages::PAGE00, 166, 16}},
+    {CmisField::MFG_DATE, {CmisPages::PAGE00, 182, 8}},
+    {CmisField::LENGTH_COPPER, {CmisPages::PAGE00, 202, 1}},
+    {CmisField::MEDIA_INTERFACE_TECHNOLOGY, {CmisPages::PAGE00, 212, 1}},
+
+    // Page 01h
+    {CmisField::LENGTH_SMF, {CmisPages::PAGE01, 132, 1}},
+    {CmisField::LENGTH_OM5, {CmisPages::PAGE01, 133, 1}},
+    {CmisField::LENGTH_OM4, {CmisPages::PAGE01, 134, 1}},
+    {CmisField::LENGTH_OM3, {CmisPages::PAGE01, 135, 1}},
+    {CmisField::LENGTH_OM2, {CmisPages::PAGE01, 136, 1}},
+    {CmisField::TX_SIG_INT_CONT_AD, {CmisPages::PAGE01, 161, 1}},
+    {CmisField::RX_SIG_INT_CONT_AD, {CmisPages::PAGE01, 162, 1}},
+
+    // Page 02h
+    {CmisField::TEMPERATURE_THRESH, {CmisPages::PAGE02, 128, 8}},
+    {CmisField::VCC_THRESH, {CmisPages::PAGE02, 136, 8}},
+    {CmisField::TX_PWR_THRESH, {CmisPages::PAGE02, 176, 8}},
+    {CmisField::TX_BIAS_THRESH, {CmisPages::PAGE02, 184, 8}},
+    {CmisField::RX_PWR_THRESH, {CmisPages::PAGE02, 192, 8}},
+
+    // Page 10h
+    {CmisField::DATA_PATH_DEINIT, {CmisPages::PAGE10, 128, 1}},
+    {CmisField::TX_POLARITY_FLIP, {CmisPages::PAGE10, 129, 1}},
+    {CmisField::TX_DISABLE, {CmisPages::PAGE10, 130, 1}},
+    {CmisField::TX_SQUELCH_DISABLE, {CmisPages::PAGE10, 131, 1}},
+    {CmisField::TX_FORCE_SQUELCH, {CmisPages::PAGE10, 132, 1}},
+    {CmisField::TX_ADAPTATION_FREEZE, {CmisPages::PAGE10, 134, 1}},
+    {CmisField::TX_ADAPTATION_STORE, {CmisPages::PAGE10, 135, 2}},
+    {CmisField::RX_POLARITY_FLIP, {CmisPages::PAGE10, 137, 1}},
+    {CmisField::RX_DISABLE, {CmisPages::PAGE10, 138, 1}},
+    {CmisField::RX_SQUELCH_DISABLE, {CmisPages::PAGE10, 139, 1}},
+    {CmisField::STAGE_CTRL_SET_0, {CmisPages::PAGE10, 143, 1}},
+    {CmisField::APP_SEL_LANE_1, {CmisPages::PAGE10, 145, 1}},
+    {CmisField::APP_SEL_LANE_2, {CmisPages::PAGE10, 146, 1}},
+    {CmisField::APP_SEL_LANE_3, {CmisPages::PAGE10, 147, 1}},
+    {CmisField::APP_SEL_LANE_4, {CmisPages::PAGE10, 148, 1}},
+
+    // Page 11h
+    {CmisField::DATA_PATH_STATE, {CmisPages::PAGE11, 128, 4}},
+    {CmisField::TX_FAULT_FLAG, {CmisPages::PAGE11, 135, 1}},
+    {CmisField::TX_LOS_FLAG, {CmisPages::PAGE11, 136, 1}},
+    {CmisField::TX_LOL_FLAG, {CmisPages::PAGE11, 137, 1}},
+    {CmisField::TX_EQ_FLAG, {CmisPages::PAGE11, 138, 1}},
+    {CmisField::TX_PWR_FLAG, {CmisPages::PAGE11, 139, 4}},
+    {CmisField::TX_BIAS_FLAG, {CmisPages::PAGE11, 143, 4}},
+    {CmisField::RX_LOS_FLAG, {CmisPages::PAGE11, 147, 1}},
+    {CmisField::RX_LOL_FLAG, {CmisPages::PAGE11, 148, 1}},
+    {CmisField::RX_PWR_FLAG, {CmisPages::PAGE11, 149, 4}},
+    {CmisField::CHANNEL_TX_PWR, {CmisPages::PAGE11, 154, 16}},
+    {CmisField::CHANNEL_TX_BIAS, {CmisPages::PAGE11, 170, 16}},
+    {CmisField::CHANNEL_RX_PWR, {CmisPages::PAGE11, 186, 16}},
+    {CmisField::ACTIVE_CTRL_LANE_1, {CmisPages::PAGE11, 206, 1}},
+    {CmisField::ACTIVE_CTRL_LANE_2, {CmisPages::PAGE11, 207, 1}},
+    {CmisField::ACTIVE_CTRL_LANE_3, {CmisPages::PAGE11, 208, 1}},
+    {CmisField::ACTIVE_CTRL_LANE_4, {CmisPages::PAGE11, 209, 1}},
+    {CmisField::TX_CDR_CONTROL, {CmisPages::PAGE11, 221, 1}},
+    {CmisField::RX_CDR_CONTROL, {CmisPages::PAGE11, 222, 1}},
+};
+
+/*
+ * Length in meters of one unit of the cable length fields. The single mode
+ * and copper lengths also have a power of ten multiplier in their top two
+ * bits.
+ */
+static CmisFieldMultiplier cmisMultiplier = {
+    {CmisField::LENGTH_SMF, 100},
+    {CmisField::LENGTH_OM5, 2},
+    {CmisField::LENGTH_OM4, 2},
+    {CmisField::LENGTH_OM3, 2},
+    {CmisField::LENGTH_OM2, 1},
+    {CmisField::LENGTH_COPPER, 0.1},
+};
+
+void getQsfpFieldAddress(
+    CmisField field,
+    int& dataAddress,
+    int& offset,
+    int& length) {
+  auto info = CmisFieldInfo::getCmisFieldAddress(cmisFields, field);
+  dataAddress = info.dataAddress;
+  offset = info.offset;
+  length = info.length;
+}
+
+CmisModule::CmisModule(
+    std::unique_ptr<TransceiverImpl> qsfpImpl,
+    unsigned int portsPerTransceiver)
+    : QsfpModule(std::move(qsfpImpl), portsPerTransceiver) {}
+
+CmisModule::~CmisModule() {}
+
+bool CmisModule::isCmisIdentifier(uint8_t identifier) {
+  return identifier == kQsfpDdIdentifier || identifier == kOsfpIdentifier ||
+      identifier == kQsfpCmisIdentifier;
+}
+
+double CmisModule::getQsfpDACLength() const {
+  return getQsfpCableLength(CmisField::LENGTH_COPPER);
+}
+
+int CmisModule::getQsfpDACGauge() const {
+  // CMIS has no field for the gauge
+  return 0;
+}
+
+GlobalSensors CmisModule::getSensorInfo() {
+  GlobalSensors info = GlobalSensors();
+  info.temp.value =
+      getQsfpSensor(CmisField::TEMPERATURE, CmisFieldInfo::getTemp);
+  info.vcc.value = getQsfpSensor(CmisField::VCC, CmisFieldInfo::getVcc);
+
+  int offset;
+  int length;
+  int dataAddress;
+  getQsfpFieldAddress(CmisField::MODULE_ALARMS, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+  info.temp.flags_ref() = getModuleFlags(data[0], 0);
+  info.vcc.flags_ref() = getModuleFlags(data[0], 4);
+  return info;
+}
+
+Vendor CmisModule::getVendorInfo() {
+  Vendor vendor = Vendor();
+  vendor.name = getQsfpString(CmisField::VENDOR_NAME);
+  vendor.oui = getQsfpString(CmisField::VENDOR_OUI);
+  vendor.partNumber = getQsfpString(CmisField::PART_NUMBER);
+  vendor.rev = getQsfpString(CmisField::REVISION_NUMBER);
+  vendor.serialNumber = getQsfpString(CmisField::VENDOR_SERIAL_NUMBER);
+  vendor.dateCode = getQsfpString(CmisField::MFG_DATE);
+  return vendor;
+}
+
+Cable CmisModule::getCableInfo() {
+  Cable cable = Cable();
+  cable.transmitterTech = getQsfpTransmitterTechnology();
+
+  if (!flatMem_) {
+    cable.singleMode_ref() = getQsfpCableLength(CmisField::LENGTH_SMF);
+    if (cable.singleMode_ref().value_or({}) == 0) {
+      cable.singleMode_ref().reset();
+    }
+    cable.om3_ref() = getQsfpCableLength(CmisField::LENGTH_OM3);
+    if (cable.om3_ref().value_or({}) == 0) {
+      cable.om3_ref().reset();
+    }
+    cable.om2_ref() = getQsfpCableLength(CmisField::LENGTH_OM2);
+    if (cable.om2_ref().value_or({}) == 0) {
+      cable.om2_ref().reset();
+    }
+  }
+  cable.copper_ref() = getQsfpCableLength(CmisField::LENGTH_COPPER);
+  if (cable.copper_ref().value_or({}) == 0) {
+    cable.copper_ref().reset();
+  }
+  if (!cable.copper_ref()) {
+    // length and gauge fields currently only supported for copper
+    return cable;
+  }
+
+  auto overrideDacCableInfo = getDACCableOverride();
+  if (overrideDacCableInfo) {
+    cable.length_ref() = overrideDacCableInfo->first;
+    cable.gauge_ref() = overrideDacCableInfo->second;
+  } else {
+    cable.length_ref() = getQsfpDACLength();
+    cable.gauge_ref() = getQsfpDACGauge();
+  }
+  if (cable.length_ref().value_or({}) == 0) {
+    cable.length_ref().reset();
+  }
+  if (cable.gauge_ref().value_or({}) == 0) {
+    cable.gauge_ref().reset();
+  }
+  return cable;
+}
+
+/*
+ * Threhold values are stored just once;  they aren't per-channel,
+ * so in all cases we simple assemble two-byte values and convert
+ * them based on the type of the field.
+ */
+ThresholdLevels CmisModule::getThresholdValues(
+    CmisField field,
+    double (*conversion)(uint16_t value)) {
+  int offset;
+  int length;
+  int dataAddress;
+  ThresholdLevels thresh;
+
+  CHECK(!flatMem_);
+
+  getQsfpFieldAddress(field, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+
+  CHECK_GE(length, 8);
+  thresh.alarm.high = conversion(data[0] << 8 | data[1]);
+  thresh.alarm.low = conversion(data[2] << 8 | data[3]);
+  thresh.warn.high = conversion(data[4] << 8 | data[5]);
+  thresh.warn.low = conversion(data[6] << 8 | data[7]);
+
+  return thresh;
+}
+
+std::optional<AlarmThreshold> CmisModule::getThresholdInfo() {
+  if (flatMem_) {
+    return {};
+  }
+  AlarmThreshold threshold = AlarmThreshold();
+  threshold.temp = getThresholdValues(
+      CmisField::TEMPERATURE_THRESH, CmisFieldInfo::getTemp);
+  threshold.vcc =
+      getThresholdValues(CmisField::VCC_THRESH, CmisFieldInfo::getVcc);
+  threshold.rxPwr =
+      getThresholdValues(CmisField::RX_PWR_THRESH, CmisFieldInfo::getPwr);
+  threshold.txBias =
+      getThresholdValues(CmisField::TX_BIAS_THRESH, CmisFieldInfo::getTxBias);
+  threshold.txPwr =
+      getThresholdValues(CmisField::TX_PWR_THRESH, CmisFieldInfo::getPwr);
+  return threshold;
+}
+
+uint8_t CmisModule::getSettingsValue(CmisField field, uint8_t mask) {
+  int offset;
+  int length;
+  int dataAddress;
+
+  getQsfpFieldAddress(field, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+
+  return data[0] & mask;
+}
+
+TransceiverSettings CmisModule::getTransceiverSettingsInfo() {
+  TransceiverSettings settings = TransceiverSettings();
+  if (flatMem_) {
+    // The lane pages, with the monitors, are not implemented
+    settings.cdrTx = FeatureState::UNSUPPORTED;
+    settings.cdrRx = FeatureState::UNSUPPORTED;
+    settings.powerMeasurement = FeatureState::UNSUPPORTED;
+  } else {
+    settings.cdrTx = CmisFieldInfo::getFeatureState(
+        getSettingsValue(CmisField::TX_SIG_INT_CONT_AD, CDR_IMPL_MASK),
+        getSettingsValue(CmisField::TX_CDR_CONTROL));
+    settings.cdrRx = CmisFieldInfo::getFeatureState(
+        getSettingsValue(CmisField::RX_SIG_INT_CONT_AD, CDR_IMPL_MASK),
+        getSettingsValue(CmisField::RX_CDR_CONTROL));
+    settings.powerMeasurement = FeatureState::ENABLED;
+  }
+  settings.powerControl = getPowerControlValue();
+  settings.rateSelect = getRateSelectValue();
+  settings.rateSelectSetting = getRateSelectSettingValue(settings.rateSelect);
+  return settings;
+}
+
+RateSelectSetting CmisModule::getRateSelectSettingValue(
+    RateSelectState /* state */) {
+  return RateSelectSetting::UNSUPPORTED;
+}
+
+RateSelectState CmisModule::getRateSelectValue() {
+  return RateSelectState::UNSUPPORTED;
+}
+
+PowerControlState CmisModule::getPowerControlValue() {
+  if (getSettingsValue(CmisField::MODULE_CONTROL, POWER_CONTROL_MASK)) {
+    return PowerControlState::POWER_LPMODE;
+  }
+  return PowerControlState::POWER_OVERRIDE;
+}
+
+unsigned int CmisModule::numChannels() const {
+  int offset;
+  int length;
+  int dataAddress;
+
+  getQsfpFieldAddress(CmisField::IDENTIFIER, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+  return data[0] == kQsfpCmisIdentifier ? kQsfpCmisLanes : kMaxLanes;
+}
+
+/*
+ * Iterate through the lanes of the module collecting appropriate data. The
+ * lane flags and monitors of page 11h have room for 8 lanes.
+ */
+bool CmisModule::getSensorsPerChanInfo(std::vector<Channel>& channels) {
+  if (flatMem_) {
+    return false;
+  }
+  int offset;
+  int length;
+  int dataAddress;
+
+  getQsfpFieldAddress(CmisField::RX_PWR_FLAG, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    channel.sensors.rxPwr.flags_ref() = getLaneFlags(data, channel.channel);
+  }
+
+  getQsfpFieldAddress(CmisField::TX_BIAS_FLAG, dataAddress, offset, length);
+  data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    channel.sensors.txBias.flags_ref() = getLaneFlags(data, channel.channel);
+  }
+
+  getQsfpFieldAddress(CmisField::TX_PWR_FLAG, dataAddress, offset, length);
+  data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    channel.sensors.txPwr.flags_ref() = getLaneFlags(data, channel.channel);
+  }
+
+  getQsfpFieldAddress(CmisField::CHANNEL_RX_PWR, dataAddress, offset, length);
+  data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    uint16_t value = data[0] << 8 | data[1];
+    channel.sensors.rxPwr.value = CmisFieldInfo::getPwr(value);
+    data += 2;
+    length -= 2;
+  }
+  CHECK_GE(length, 0);
+
+  getQsfpFieldAddress(CmisField::CHANNEL_TX_BIAS, dataAddress, offset, length);
+  data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    uint16_t value = data[0] << 8 | data[1];
+    channel.sensors.txBias.value = CmisFieldInfo::getTxBias(value);
+    data += 2;
+    length -= 2;
+  }
+  CHECK_GE(length, 0);
+
+  getQsfpFieldAddress(CmisField::CHANNEL_TX_PWR, dataAddress, offset, length);
+  data = getQsfpValuePtr(dataAddress, offset, length);
+  for (auto& channel : channels) {
+    uint16_t value = data[0] << 8 | data[1];
+    channel.sensors.txPwr.value = CmisFieldInfo::getPwr(value);
+    data += 2;
+    length -= 2;
+  }
+  CHECK_GE(length, 0);
+
+  return true;
+}
+
+std::string CmisModule::getQsfpString(CmisField field) const {
+  int offset;
+  int length;
+  int dataAddress;
+
+  getQsfpFieldAddress(field, dataAddress, offset, length);
+  const uint8_t* data = getQsfpValuePtr(dataAddress, offset, length);
+
+  while (length > 0 && data[length - 1] == ' ') {
+    --length;
+  }
+
+  std::string value(reinterpret_cast<const char*>(data), length);
+  return validateQsfpString(value) ? value : "UNKNOWN";
+}
+
+double CmisModule::getQsfpSensor(
+    CmisField field,
+    double (*conversion)(uint16_t value)) {
+  auto info = CmisFieldInfo::getCmisFieldAddress(cmisFields, field);
+  const uint8_t* data =
+      getQsfpValuePtr(info.dataAddress, info.offset, info.length);
+  return conversion(data[0] << 8 | data[1]);
+}
+
+/*
+ * Cable length is reported as a single byte, in field specific units. The
+ * single mode and copper lengths only use the lower six bits, and the top
+ * two bits multiply them by a power of ten.
+ */
+double CmisModule::getQsfpCableLength(CmisField field) const {
+  auto info = CmisFieldInfo::getCmisFieldAddress(cmisFields, field);
+  const uint8_t* data =
+      getQsfpValuePtr(info.dataAddress, info.offset, info.length);
+  auto multiplier = cmisMultiplier.at(field);
+  if (field == CmisField::LENGTH_SMF || field == CmisField::LENGTH_COPPER) {
+    return (*data & CABLE_LENGTH_MASK) * multiplier *
+        std::pow(10, *data >> 6);
+  }
+  return *data * multiplier;
+}
+
+TransmitterTechnology CmisModule::getQsfpTransmitterTechnology() const {
+  auto info = CmisFieldInfo::getCmisFieldAddress(
+      cmisFields, CmisField::MEDIA_INTERFACE_TECHNOLOGY);
+  const uint8_t* data =
+      getQsfpValuePtr(info.dataAddress, info.offset, info.length);
+
+  uint8_t transTech = *data;
+  if (transTech == DeviceTechnology::UNKNOWN_VALUE) {
+    return TransmitterTechnology::UNKNOWN;
+  } else if (transTech <= DeviceTechnology::OPTICAL_MAX_VALUE) {
+    return TransmitterTechnology::OPTICAL;
+  } else {
+    return TransmitterTechnology::COPPER;
+  }
+}
+
+void CmisModule::setQsfpIdprom() {
+  if (!present_) {
+    throw FbossError("Failed setting QSFP IDProm: QSFP is not present");
+  }
+
+  uint8_t flatMem;
+  int offset;
+  int length;
+  int dataAddress;
+  getQsfpFieldAddress(CmisField::FLAT_MEM, dataAddress, offset, length);
+  getQsfpValue(dataAddress, offset, length, &flatMem);
+  flatMem_ = flatMem & (1 << 7);
+  XLOG(DBG3) << "Detected CMIS module " << qsfpImpl_->getName()
+             << ", flatMem=" << flatMem_;
+}
+
+const uint8_t*
+CmisModule::getQsfpValuePtr(int dataAddress, int offset, int length) const {
+  /* if the cached values are not correct */
+  if (!cacheIsValid()) {
+    throw FbossError("Qsfp is either not present or the data is not read");
+  }
+  if (dataAddress == CmisPages::LOWER) {
+    CHECK_LE(offset + length, sizeof(lowerPage_));
+    /* Copy data from the cache */
+    return (lowerPage_ + offset);
+  }
+  offset -= MAX_QSFP_PAGE_SIZE;
+  CHECK_GE(offset, 0);
+  CHECK_LE(offset + length, MAX_QSFP_PAGE_SIZE);
+  if (dataAddress == CmisPages::PAGE00) {
+    return (page00_ + offset);
+  } else if (flatMem_) {
+    throw FbossError("Invalid Data Address 0x%d", dataAddress);
+  } else if (dataAddress == CmisPages::PAGE01) {
+    return (page01_ + offset);
+  } else if (dataAddress == CmisPages::PAGE02) {
+    return (page02_ + offset);
+  } else if (dataAddress == CmisPages::PAGE10) {
+    return (page10_ + offset);
+  } else if (dataAddress == CmisPages::PAGE11) {
+    return (page11_ + offset);
+  } else {
+    throw FbossError("Invalid Data Address 0x%d", dataAddress);
+  }
+}
+
+RawDOMData CmisModule::getRawDOMData() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  RawDOMData data;
+  if (present_) {
+    data.lower = IOBuf::wrapBufferAsValue(lowerPage_, MAX_QSFP_PAGE_SIZE);
+    data.page0 = IOBuf::wrapBufferAsValue(page00_, MAX_QSFP_PAGE_SIZE);
+  }
+  return data;
+}
+
+void CmisModule::markDataStale() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  lastRefreshTime_ = 0;
+  lastLaneMonitorRefreshTime_ = 0;
+}
+
+void CmisModule::getFieldValue(CmisField fieldName, uint8_t* fieldValue) {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  int offset;
+  int length;
+  int dataAddress;
+  getQsfpFieldAddress(fieldName, dataAddress, offset, length);
+  getQsfpValue(dataAddress, offset, length, fieldValue);
+}
+
+void CmisModule::readUpperPage(uint8_t page, uint8_t* data) {
+  // expects the lock to be held
+  bool banked = page >= kFirstBankedPage;
+  if (banked && selectedBank_ != kLaneBank) {
+    // The bank select byte is right before the page select one, so both
+    // are written at once
+    int offset;
+    int length;
+    int dataAddress;
+    getQsfpFieldAddress(CmisField::BANK_SELECT, dataAddress, offset, length);
+    std::array<uint8_t, 2> select = {{kLaneBank, page}};
+    qsfpImpl_->writeTransceiver(
+        TransceiverI2CApi::ADDR_QSFP, offset, select.size(), select.data());
+    selectedBank_ = kLaneBank;
+    selectedPage_ = page;
+  } else if (selectedPage_ != page) {
+    int offset;
+    int length;
+    int dataAddress;
+    getQsfpFieldAddress(
+        CmisField::PAGE_SELECT_BYTE, dataAddress, offset, length);
+    qsfpImpl_->writeTransceiver(
+        TransceiverI2CApi::ADDR_QSFP, offset, sizeof(page), &page);
+    selectedPage_ = page;
+  }
+  qsfpImpl_->readTransceiver(
+      TransceiverI2CApi::ADDR_QSFP,
+      MAX_QSFP_PAGE_SIZE,
+      MAX_QSFP_PAGE_SIZE,
+      data);
+}
+
+bool CmisModule::shouldRefreshLaneMonitors() const {
+  return std::time(nullptr) - lastLaneMonitorRefreshTime_ >=
+      FLAGS_cmis_lane_monitor_refresh_interval;
+}
+
+void CmisModule::updateQsfpData(bool allPages) {
+  // expects the lock to be held
+  if (!present_) {
+    return;
+  }
+  try {
+    XLOG(DBG2) << "Performing " << ((allPages) ? "full" : "partial")
+               << " qsfp data cache refresh for transceiver "
+               << folly::to<std::string>(qsfpImpl_->getName());
+    qsfpImpl_->readTransceiver(
+        TransceiverI2CApi::ADDR_QSFP, 0, sizeof(lowerPage_), lowerPage_);
+    lastRefreshTime_ = std::time(nullptr);
+    dirty_ = false;
+    setQsfpIdprom();
+
+    // Whatever selected the current page, the lower page tells which one
+    // it is
+    int offset;
+    int length;
+    int dataAddress;
+    getQsfpFieldAddress(CmisField::BANK_SELECT, dataAddress, offset, length);
+    getQsfpValue(dataAddress, offset, length, &selectedBank_);
+    getQsfpFieldAddress(
+        CmisField::PAGE_SELECT_BYTE, dataAddress, offset, length);
+    getQsfpValue(dataAddress, offset, length, &selectedPage_);
+
+    if (flatMem_) {
+      // Page 00h is the only upper page, and is always mapped in
+      if (allPages) {
+        qsfpImpl_->readTransceiver(
+            TransceiverI2CApi::ADDR_QSFP,
+            MAX_QSFP_PAGE_SIZE,
+            sizeof(page00_),
+            page00_);
+      }
+      return;
+    }
+
+    if (allPages) {
+      readUpperPage(CmisPages::PAGE00, page00_);
+      readUpperPage(CmisPages::PAGE01, page01_);
+      readUpperPage(CmisPages::PAGE02, page02_);
+      readUpperPage(CmisPages::PAGE10, page10_);
+    }
+    // Page 11h goes last: it is the only upper page partial refreshes
+    // read, and leaving it selected saves them a page select.
+    if (allPages || shouldRefreshLaneMonitors()) {
+      readUpperPage(CmisPages::PAGE11, page11_);
+      lastLaneMonitorRefreshTime_ = std::time(nullptr);
+    }
+  } catch (const std::exception& ex) {
+    // No matter what kind of exception throws, we need to set the dirty_ flag
+    // to true.
+    dirty_ = true;
+    XLOG(ERR) << "Error update data for transceiver:"
+              << folly::to<std::string>(qsfpImpl_->getName()) << ": "
+              << ex.what();
+    throw;
+  }
+}
+
+void CmisModule::setCdrIfSupported(
+    cfg::PortSpeed /* speed */,
+    FeatureState currentStateTx,
+    FeatureState currentStateRx) {
+  XLOG(DBG1) << "Port: " << folly::to<std::string>(qsfpImpl_->getName())
+             << " Not changing CDR, set by the selected application. Tx: "
+             << apache::thrift::util::enumNameSafe(currentStateTx)
+             << " Rx: " << apache::thrift::util::enumNameSafe(currentStateRx);
+}
+
+void CmisModule::setRateSelectIfSupported(
+    cfg::PortSpeed /* speed */,
+    RateSelectState currentState,
+    RateSelectSetting /* currentSetting */) {
+  if (currentState != RateSelectState::UNSUPPORTED) {
+    throw FbossError(folly::to<std::string>(
+        "Port: ",
+        qsfpImpl_->getName(),
+        " Rate select is not part of CMIS: ",
+        apache::thrift::util::enumNameSafe(currentState)));
+  }
+}
+
+void CmisModule::setPowerOverrideIfSupported(PowerControlState currentState) {
+  /*
+   * Note that this function expects to be called with qsfpModuleMutex_
+   * held.
+   */
+  auto portStr = folly::to<std::string>(qsfpImpl_->getName());
+  if (currentState == PowerControlState::POWER_OVERRIDE) {
+    XLOG(INFO) << "Port: " << portStr
+               << " Power override already correctly set, doing nothing";
+    return;
+  }
+
+  int offset;
+  int length;
+  int dataAddress;
+  getQsfpFieldAddress(CmisField::MODULE_CONTROL, dataAddress, offset, length);
+  uint8_t moduleControl;
+  getQsfpValue(dataAddress, offset, length, &moduleControl);
+  moduleControl &= ~POWER_CONTROL_MASK;
+
+  // Clear LowPwr, so that the module powers up
+  qsfpImpl_->writeTransceiver(
+      TransceiverI2CApi::ADDR_QSFP,
+      offset,
+      sizeof(moduleControl),
+      &moduleControl);
+
+  XLOG(INFO) << "Port " << portStr << ": CMIS module set to power setting "
+             << apache::thrift::util::enumNameSafe(
+                    PowerControlState::POWER_OVERRIDE);
+}
+
+} // namespace fboss
+} // namespace facebook
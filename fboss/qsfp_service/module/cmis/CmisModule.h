@@ -0,0 +1,218 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/qsfp_service/module/QsfpModule.h"
+
+#include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+namespace facebook {
+namespace fboss {
+
+enum class CmisField;
+
+/*
+ * Transceiver modules managed through the Common Management Interface
+ * Specification (CMIS), e.g. QSFP-DD and OSFP.
+ *
+ * CMIS modules have many more upper pages than SFF-8636 ones, and the per
+ * lane pages are banked, so reading all of them on each refresh would
+ * multiply the I2C time spent on a module. Pages are cached according to
+ * how often their content changes:
+ *  - the lower page, with the module level monitors and flags, is read on
+ *    every refresh
+ *  - the lane monitors and flags page (11h) is read on every refresh, but
+ *    no more often than --cmis_lane_monitor_refresh_interval
+ *  - the static pages (00h, 01h, 02h) and the lane control page (10h), are
+ *    only read after the module is inserted or a read failed
+ * Bank and page selects are only written when the page to read is not
+ * already selected.
+ */
+class CmisModule : public QsfpModule {
+ public:
+  explicit CmisModule(
+      std::unique_ptr<TransceiverImpl> qsfpImpl,
+      unsigned int portsPerTransceiver);
+  virtual ~CmisModule() override;
+
+  /*
+   * Whether the SFF-8024 identifier, in the first byte of the lower page,
+   * is one of a module managed through CMIS.
+   */
+  static bool isCmisIdentifier(uint8_t identifier);
+
+  /*
+   * Return the spec this transceiver follows.
+   */
+  TransceiverManagementInterface managementInterface() const override {
+    return TransceiverManagementInterface::CMIS;
+  }
+
+  /*
+   * Get the QSFP EEPROM Field
+   */
+  void getFieldValue(CmisField fieldName, uint8_t* fieldValue);
+
+  RawDOMData getRawDOMData() override;
+
+  /*
+   * Also re-read the lane monitors and flags at the next refresh: the lane
+   * LOS/LOL flags are what usually raise the module interrupt.
+   */
+  void markDataStale() override;
+
+ protected:
+  // no copy or assignment
+  CmisModule(CmisModule const&) = delete;
+  CmisModule& operator=(CmisModule const&) = delete;
+
+  // The bank and page select bytes, as last read or written. The lower
+  // page, read first on each refresh, tells which page is selected.
+  uint8_t selectedBank_{0};
+  uint8_t selectedPage_{0};
+  time_t lastLaneMonitorRefreshTime_{0};
+
+  // This needs to be initialized to 0 because in software simulated
+  // environment this should not contain any arbitrary values
+  uint8_t lowerPage_[MAX_QSFP_PAGE_SIZE] = {0};
+  uint8_t page00_[MAX_QSFP_PAGE_SIZE] = {0};
+  uint8_t page01_[MAX_QSFP_PAGE_SIZE] = {0};
+  uint8_t page02_[MAX_QSFP_PAGE_SIZE] = {0};
+  uint8_t page10_[MAX_QSFP_PAGE_SIZE] = {0};
+  uint8_t page11_[MAX_QSFP_PAGE_SIZE] = {0};
+
+  /*
+   * This function returns a pointer to the value in the static cached
+   * data after checking the length fits. The thread needs to have the lock
+   * before calling this function.
+   */
+  const uint8_t* getQsfpValuePtr(int dataAddress, int offset, int length)
+      const override;
+  /*
+   * Sets the IDProm cache data for the port
+   * The thread needs to have the lock before calling the function.
+   */
+  void setQsfpIdprom() override;
+  /*
+   * Take the module out of low power mode
+   */
+  void setPowerOverrideIfSupported(PowerControlState currentState) override;
+  /*
+   * CMIS modules set CDR through the application selected, which is left
+   * as the module configures it.
+   */
+  void setCdrIfSupported(
+      cfg::PortSpeed speed,
+      FeatureState currentStateTx,
+      FeatureState currentStateRx) override;
+  /*
+   * CMIS modules have no rate select.
+   */
+  void setRateSelectIfSupported(
+      cfg::PortSpeed speed,
+      RateSelectState currentState,
+      RateSelectSetting currentSetting) override;
+  /*
+   * returns individual sensor values after scaling
+   */
+  double getQsfpSensor(CmisField field, double (*conversion)(uint16_t value));
+  /*
+   * returns cable length (negative for "longer than we can represent")
+   */
+  double getQsfpCableLength(CmisField field) const;
+  /*
+   * returns the freeside transceiver technology type
+   */
+  TransmitterTechnology getQsfpTransmitterTechnology() const override;
+  /*
+   * This function returns various strings from the QSFP EEPROM
+   */
+  std::string getQsfpString(CmisField flag) const;
+  /*
+   * Fills in values for alarm and warning thresholds based on field name
+   */
+  ThresholdLevels getThresholdValues(
+      CmisField field,
+      double (*conversion)(uint16_t value));
+  /*
+   * Retreives all alarm and warning thresholds
+   */
+  std::optional<AlarmThreshold> getThresholdInfo() override;
+  /*
+   * Gather the sensor info for thrift queries
+   */
+  GlobalSensors getSensorInfo() override;
+  /*
+   * QSFP-DD and OSFP modules have 8 lanes, CMIS QSFP ones 4
+   */
+  unsigned int numChannels() const override;
+  /*
+   * Gather per-channel information for thrift queries
+   */
+  bool getSensorsPerChanInfo(std::vector<Channel>& channels) override;
+  /*
+   * Gather the vendor info for thrift queries
+   */
+  Vendor getVendorInfo() override;
+  /*
+   * Gather the cable info for thrift queries
+   */
+  Cable getCableInfo() override;
+  /*
+   * Retrieves the values of settings based on field name and bit placement
+   * Default mask is a noop
+   */
+  virtual uint8_t getSettingsValue(CmisField field, uint8_t mask = 0xff);
+  /*
+   * Gather info on what features are enabled and supported
+   */
+  TransceiverSettings getTransceiverSettingsInfo() override;
+  /*
+   * Return which rate select capability is being used, if any
+   */
+  RateSelectState getRateSelectValue() override;
+  /*
+   * Return the rate select optimised bit rates for each channel
+   */
+  RateSelectSetting getRateSelectSettingValue(RateSelectState state) override;
+  /*
+   * Return what power control capability is currently enabled
+   */
+  PowerControlState getPowerControlValue() override;
+  /*
+   * Update the cached data with the information from the physical module.
+   *
+   * The 'allPages' parameter determines whether the static pages and the
+   * lane control page are read too, see above.
+   */
+  void updateQsfpData(bool allPages = true) override;
+
+ private:
+  /*
+   * Select the upper page, and bank for the banked pages, unless it is
+   * already selected, then read it.
+   */
+  void readUpperPage(uint8_t page, uint8_t* data);
+  /*
+   * Whether --cmis_lane_monitor_refresh_interval passed since the lane
+   * monitors and flags were last read.
+   */
+  bool shouldRefreshLaneMonitors() const;
+
+  /*
+   * Helpers to parse DOM data for DAC cables.
+   */
+  double getQsfpDACLength() const override;
+  int getQsfpDACGauge() const override;
+  /*
+   * Provides the option to override the length/gauge values read from
+   * the DOM for certain transceivers. This is useful when vendors
+   * input incorrect data and the accuracy of these fields is
+   * important for proper tuning.
+   */
+  const std::optional<LengthAndGauge> getDACCableOverride() const override;
+};
+
+} // namespace fboss
+} // namespace facebook
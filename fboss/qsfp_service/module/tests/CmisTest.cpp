@@ -0,0 +1,283 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <folly/Conv.h>
+#include <folly/Memory.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <array>
+#include <cstdint>
+#include <map>
+#include "fboss/qsfp_service/module/QsfpModule.h"
+#include "fboss/qsfp_service/module/TransceiverImpl.h"
+#include "fboss/qsfp_service/module/cmis/CmisModule.h"
+
+#include <gtest/gtest.h>
+
+DECLARE_int32(qsfp_data_refresh_interval);
+DECLARE_int32(cmis_lane_monitor_refresh_interval);
+
+using namespace facebook::fboss;
+
+namespace {
+
+using Page = std::array<uint8_t, 128>;
+
+template <size_t N>
+void setBytes(Page& page, int offset, const std::array<uint8_t, N>& bytes) {
+  std::copy(bytes.begin(), bytes.end(), page.begin() + offset);
+}
+
+/*
+ * A CMIS module EEPROM, with the page and bank selects, which counts the
+ * selects written and the upper pages read.
+ */
+class CmisTransceiver : public TransceiverImpl {
+ public:
+  explicit CmisTransceiver(int module, bool flatMem = false)
+      : module_(module), moduleName_(folly::to<std::string>(module)) {
+    lower_.fill(0);
+    lower_[0] = 0x18; // QSFP-DD
+    lower_[2] = flatMem ? 0x80 : 0x00;
+    lower_[9] = 0x01; // Temperature high alarm
+    setBytes<4>(lower_, 14, {{0x1f, 0x04, 0x80, 0xdd}});
+    lower_[26] = 0x40; // Low power
+
+    for (auto page : {0x00, 0x01, 0x02, 0x10, 0x11}) {
+      pages_[page].fill(0);
+    }
+    std::string vendor = "FACETEST        ";
+    std::copy(vendor.begin(), vendor.end(), pages_[0x00].begin() + 1);
+    pages_[0x01][4] = 0x42; // Single mode, 2 * 100m * 10
+    pages_[0x01][7] = 50; // OM3, 50 * 2m
+    setBytes<8>(
+        pages_[0x02], 0, {{0x4b, 0x00, 0xfb, 0x00, 0x46, 0x00, 0x00, 0x00}});
+    pages_[0x11][22] = 0x82; // Lanes 2 and 8 rx power low alarm
+    setBytes<2>(pages_[0x11], 42, {{0x13, 0x88}}); // Lane 1 tx bias
+    setBytes<2>(pages_[0x11], 58, {{0x27, 0x10}}); // Lane 1 rx power
+    setBytes<2>(pages_[0x11], 72, {{0x13, 0x88}}); // Lane 8 rx power
+  }
+
+  int readTransceiver(int dataAddress, int offset, int len, uint8_t* fieldValue)
+      override {
+    EXPECT_EQ(0x50, dataAddress);
+    if (offset < QsfpModule::MAX_QSFP_PAGE_SIZE) {
+      EXPECT_LE(offset + len, QsfpModule::MAX_QSFP_PAGE_SIZE);
+      std::copy(
+          lower_.begin() + offset, lower_.begin() + offset + len, fieldValue);
+      return len;
+    }
+    offset -= QsfpModule::MAX_QSFP_PAGE_SIZE;
+    EXPECT_LE(offset + len, QsfpModule::MAX_QSFP_PAGE_SIZE);
+    int page = lower_[127];
+    if (page >= 0x10) {
+      EXPECT_EQ(0, lower_[126]);
+    }
+    auto& data = pages_.at(page);
+    std::copy(data.begin() + offset, data.begin() + offset + len, fieldValue);
+    ++pageReads[page];
+    return len;
+  }
+
+  int writeTransceiver(
+      int dataAddress,
+      int offset,
+      int len,
+      uint8_t* fieldValue) override {
+    EXPECT_EQ(0x50, dataAddress);
+    EXPECT_LE(offset + len, QsfpModule::MAX_QSFP_PAGE_SIZE);
+    std::copy(fieldValue, fieldValue + len, lower_.begin() + offset);
+    if (offset + len > 126) {
+      ++selects;
+    }
+    return len;
+  }
+
+  bool detectTransceiver() override {
+    return present;
+  }
+
+  folly::StringPiece getName() override {
+    return moduleName_;
+  }
+
+  int getNum() const override {
+    return module_;
+  }
+
+  void setIdentifier(uint8_t identifier) {
+    lower_[0] = identifier;
+  }
+
+  void selectPage(uint8_t bank, uint8_t page) {
+    lower_[126] = bank;
+    lower_[127] = page;
+  }
+
+  bool present{true};
+  int selects{0};
+  std::map<int, int> pageReads;
+
+ private:
+  int module_{0};
+  std::string moduleName_;
+  Page lower_;
+  std::map<int, Page> pages_;
+};
+
+class CmisTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    FLAGS_qsfp_data_refresh_interval = 0;
+    FLAGS_cmis_lane_monitor_refresh_interval = 0;
+  }
+
+  std::unique_ptr<CmisModule> makeModule(bool flatMem = false) {
+    auto impl = std::make_unique<CmisTransceiver>(1, flatMem);
+    transceiver_ = impl.get();
+    return std::make_unique<CmisModule>(std::move(impl), 4);
+  }
+
+  gflags::FlagSaver flagSaver_;
+  CmisTransceiver* transceiver_{nullptr};
+};
+
+} // namespace
+
+TEST_F(CmisTest, cmisRead) {
+  auto qsfp = makeModule();
+  qsfp->refresh();
+
+  TransceiverInfo info = qsfp->getTransceiverInfo();
+  EXPECT_EQ(
+      TransceiverManagementInterface::CMIS, qsfp->managementInterface());
+  EXPECT_EQ("FACETEST", info.vendor_ref().value_or({}).name);
+  EXPECT_EQ(2000, info.cable_ref().value_or({}).singleMode_ref().value_or({}));
+  EXPECT_EQ(100, info.cable_ref().value_or({}).om3_ref().value_or({}));
+  EXPECT_DOUBLE_EQ(3.2989, info.sensor_ref().value_or({}).vcc.value);
+  EXPECT_DOUBLE_EQ(31.015625, info.sensor_ref().value_or({}).temp.value);
+  EXPECT_TRUE(info.sensor_ref()
+                  .value_or({})
+                  .temp.flags_ref()
+                  .value_or({})
+                  .alarm.high);
+  EXPECT_DOUBLE_EQ(75.0, info.thresholds_ref().value_or({}).temp.alarm.high);
+  EXPECT_DOUBLE_EQ(-5.0, info.thresholds_ref().value_or({}).temp.alarm.low);
+  EXPECT_EQ(
+      PowerControlState::POWER_LPMODE,
+      info.settings_ref().value_or({}).powerControl);
+  // QSFP-DD modules have 8 lanes
+  ASSERT_EQ(8, info.channels.size());
+  EXPECT_DOUBLE_EQ(1.0, info.channels[0].sensors.rxPwr.value);
+  EXPECT_DOUBLE_EQ(10.0, info.channels[0].sensors.txBias.value);
+  EXPECT_DOUBLE_EQ(0.5, info.channels[7].sensors.rxPwr.value);
+  EXPECT_FALSE(
+      info.channels[0].sensors.rxPwr.flags_ref().value_or({}).alarm.low);
+  EXPECT_TRUE(
+      info.channels[1].sensors.rxPwr.flags_ref().value_or({}).alarm.low);
+  EXPECT_TRUE(
+      info.channels[7].sensors.rxPwr.flags_ref().value_or({}).alarm.low);
+}
+
+TEST_F(CmisTest, cmisQsfpLanes) {
+  auto qsfp = makeModule();
+  transceiver_->setIdentifier(0x1e); // QSFP+ or later with CMIS
+  qsfp->refresh();
+  EXPECT_EQ(4, qsfp->getTransceiverInfo().channels.size());
+}
+
+TEST_F(CmisTest, staticPagesReadOnce) {
+  auto qsfp = makeModule();
+  qsfp->refresh();
+  // Page 00h was already selected
+  EXPECT_EQ(4, transceiver_->selects);
+  for (auto page : {0x00, 0x01, 0x02, 0x10, 0x11}) {
+    EXPECT_EQ(1, transceiver_->pageReads[page]);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    qsfp->refresh();
+  }
+  // Only the lane monitors are read again, and they stay selected
+  EXPECT_EQ(4, transceiver_->selects);
+  EXPECT_EQ(4, transceiver_->pageReads[0x11]);
+  for (auto page : {0x00, 0x01, 0x02, 0x10}) {
+    EXPECT_EQ(1, transceiver_->pageReads[page]);
+  }
+}
+
+TEST_F(CmisTest, laneMonitorRefreshInterval) {
+  FLAGS_cmis_lane_monitor_refresh_interval = 3600;
+  auto qsfp = makeModule();
+  qsfp->refresh();
+  qsfp->refresh();
+  EXPECT_EQ(1, transceiver_->pageReads[0x11]);
+}
+
+TEST_F(CmisTest, markDataStaleRereadsLaneMonitors) {
+  FLAGS_qsfp_data_refresh_interval = 3600;
+  FLAGS_cmis_lane_monitor_refresh_interval = 3600;
+  auto qsfp = makeModule();
+  qsfp->refresh();
+  qsfp->refresh();
+  EXPECT_EQ(1, transceiver_->pageReads[0x11]);
+
+  // e.g. the module interrupt for a lane losing signal
+  qsfp->markDataStale();
+  qsfp->refresh();
+  EXPECT_EQ(2, transceiver_->pageReads[0x11]);
+  for (auto page : {0x00, 0x01, 0x02, 0x10}) {
+    EXPECT_EQ(1, transceiver_->pageReads[page]);
+  }
+}
+
+TEST_F(CmisTest, selectLeftByOthers) {
+  auto qsfp = makeModule();
+  transceiver_->selectPage(1, 0x11);
+  qsfp->refresh();
+  // Pages 00h, 01h and 02h, then bank and page 10h at once, then page 11h
+  EXPECT_EQ(5, transceiver_->selects);
+
+  // e.g. wedge_qsfp_util selected another page in between
+  transceiver_->selectPage(0, 0x02);
+  qsfp->refresh();
+  EXPECT_EQ(6, transceiver_->selects);
+  EXPECT_EQ(2, transceiver_->pageReads[0x11]);
+}
+
+TEST_F(CmisTest, flatMem) {
+  auto qsfp = makeModule(true);
+  qsfp->refresh();
+  qsfp->refresh();
+
+  TransceiverInfo info = qsfp->getTransceiverInfo();
+  EXPECT_EQ("FACETEST", info.vendor_ref().value_or({}).name);
+  EXPECT_FALSE(info.thresholds_ref());
+  EXPECT_TRUE(info.channels.empty());
+  EXPECT_EQ(0, transceiver_->selects);
+  EXPECT_EQ(1, transceiver_->pageReads[0x00]);
+  EXPECT_EQ(0, transceiver_->pageReads[0x11]);
+}
+
+TEST_F(CmisTest, reinsertRereadsStaticPages) {
+  auto qsfp = makeModule();
+  qsfp->refresh();
+  transceiver_->present = false;
+  qsfp->refresh();
+  EXPECT_FALSE(qsfp->getTransceiverInfo().vendor_ref());
+
+  transceiver_->present = true;
+  qsfp->refresh();
+  for (auto page : {0x00, 0x01, 0x02, 0x10}) {
+    EXPECT_EQ(2, transceiver_->pageReads[page]);
+  }
+  EXPECT_EQ(
+      "FACETEST", qsfp->getTransceiverInfo().vendor_ref().value_or({}).name);
+}
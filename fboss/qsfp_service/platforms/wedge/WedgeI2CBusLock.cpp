@@ -81,6 +81,14 @@ void WedgeI2CBusLock::scanPresence(
   wedgeI2CBus_->scanPresence(presence);
 }
 
+std::optional<std::set<unsigned int>> WedgeI2CBusLock::takeModuleEvents() {
+  // No BusGuard: only Minipack has event latches, in the DOM FPGAs, which
+  // are memory mapped and serialized by FbDomFpga rather than reached
+  // through the bus (its open() and close() do nothing). The other buses
+  // don't take events, so there is nothing to open the device for.
+  return wedgeI2CBus_->takeModuleEvents();
+}
+
 void WedgeI2CBusLock::ensureOutOfReset(unsigned int module) {
   BusGuard g(this);
   wedgeI2CBus_->ensureOutOfReset(module);
@@ -35,6 +35,7 @@ class WedgeI2CBusLock : public TransceiverI2CApi {
   void verifyBus(bool autoReset) override;
   bool isPresent(unsigned int module) override;
   void scanPresence(std::map<int32_t, ModulePresence>& presence) override;
+  std::optional<std::set<unsigned int>> takeModuleEvents() override;
   void ensureOutOfReset(unsigned int module) override;
 
   folly::EventBase* getEventBase(unsigned int module) override;
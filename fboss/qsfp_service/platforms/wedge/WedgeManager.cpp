@@ -1,14 +1,54 @@
 #include "fboss/qsfp_service/platforms/wedge/WedgeManager.h"
 
 #include <folly/gen/Base.h>
+#include <gflags/gflags.h>
+
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 
 #include <folly/logging/xlog.h>
 #include <fb303/ThreadCachedServiceData.h>
+#include <thrift/lib/cpp/util/EnumUtils.h>
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+#include "fboss/qsfp_service/module/cmis/CmisModule.h"
 #include "fboss/qsfp_service/module/sff/SffModule.h"
 #include "fboss/qsfp_service/platforms/wedge/WedgeQsfp.h"
 
+DEFINE_int32(
+    transceiver_full_refresh_interval,
+    10,
+    "Interval (in seconds) between refreshes of all transceivers on platforms "
+    "reporting transceiver events, as a safety net for missed events. "
+    "Other platforms refresh all transceivers on every main loop");
+
 namespace facebook { namespace fboss {
 
+namespace {
+/*
+ * Spec followed by the module plugged in, going by its identifier. nullopt
+ * if there is no module or its identifier could not be read.
+ */
+std::optional<TransceiverManagementInterface> detectManagementInterface(
+    TransceiverImpl* qsfpImpl) {
+  try {
+    if (!qsfpImpl->detectTransceiver()) {
+      return std::nullopt;
+    }
+    uint8_t identifier = 0;
+    qsfpImpl->readTransceiver(
+        TransceiverI2CApi::ADDR_QSFP, 0, sizeof(identifier), &identifier);
+    return CmisModule::isCmisIdentifier(identifier)
+        ? TransceiverManagementInterface::CMIS
+        : TransceiverManagementInterface::SFF;
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to read the identifier of transceiver "
+              << qsfpImpl->getNum() << ": " << ex.what();
+    return std::nullopt;
+  }
+}
+} // namespace
+
 WedgeManager::WedgeManager(std::unique_ptr<TransceiverPlatformApi> api) :
   qsfpPlatApi_(std::move(api)) {
   /* Constructor for WedgeManager class:
@@ -38,19 +78,74 @@ void WedgeManager::initTransceiverMap() {
   // Wedge port 0 is the CPU port, so the first port associated with
   // a QSFP+ is port 1.  We start the transceiver IDs with 0, though.
   for (int idx = 0; idx < getNumQsfpModules(); idx++) {
-    auto qsfpImpl = std::make_unique<WedgeQsfp>(idx, wedgeI2cBus_.get());
-    auto qsfp = std::make_unique<SffModule>(
-        std::move(qsfpImpl),
-        (portGroupMap_.size() == 0 ?
-          numPortsPerTransceiver() :
-          portGroupMap_[idx].size()));
-    transceivers_.push_back(move(qsfp));
+    transceivers_.push_back(createTransceiver(idx));
     XLOG(INFO) << "making QSFP for " << idx;
   }
 
   refreshTransceivers();
 }
 
+std::unique_ptr<QsfpModule> WedgeManager::createTransceiver(int32_t idx) {
+  auto qsfpImpl = std::make_unique<WedgeQsfp>(idx, wedgeI2cBus_.get());
+  auto portsPerTransceiver = portGroupMap_.size() == 0 ?
+      numPortsPerTransceiver() :
+      portGroupMap_[idx].size();
+  auto interface = detectManagementInterface(qsfpImpl.get());
+  if (interface) {
+    identifiedTransceivers_.insert(idx);
+  } else {
+    identifiedTransceivers_.erase(idx);
+  }
+  if (interface == TransceiverManagementInterface::CMIS) {
+    return std::make_unique<CmisModule>(
+        std::move(qsfpImpl), portsPerTransceiver);
+  }
+  return std::make_unique<SffModule>(std::move(qsfpImpl), portsPerTransceiver);
+}
+
+void WedgeManager::updateTransceiverTypes(
+    const std::vector<int32_t>& ids,
+    bool mayHaveChanged) {
+  std::vector<Transceiver*> rebuilt;
+  for (auto idx : ids) {
+    auto current = dynamic_cast<QsfpModule*>(transceivers_[idx].get());
+    if (!current) {
+      continue;
+    }
+    if (!current->isPresent()) {
+      // Whatever module gets plugged in next is identified again
+      identifiedTransceivers_.erase(idx);
+      continue;
+    }
+    if (!mayHaveChanged && identifiedTransceivers_.count(idx)) {
+      continue;
+    }
+
+    auto transceiver = createTransceiver(idx);
+    if (!identifiedTransceivers_.count(idx) ||
+        transceiver->managementInterface() == current->managementInterface()) {
+      continue;
+    }
+    XLOG(INFO) << "Transceiver " << idx << " is now managed through "
+               << apache::thrift::util::enumNameSafe(
+                      transceiver->managementInterface());
+    {
+      // The new object starts where the agent left the old one. Ports are
+      // only synced under the shared lock, so none are lost in between.
+      std::unique_lock<folly::SharedMutex> g(transceiversLock_);
+      auto ports = current->getPorts();
+      transceivers_[idx] = std::move(transceiver);
+      if (!ports.empty()) {
+        transceivers_[idx]->transceiverPortsChanged(ports);
+      }
+    }
+    rebuilt.push_back(transceivers_[idx].get());
+  }
+  if (!rebuilt.empty()) {
+    refreshInParallel(rebuilt);
+  }
+}
+
 void WedgeManager::getTransceiversInfo(std::map<int32_t, TransceiverInfo>& info,
     std::unique_ptr<std::vector<int32_t>> ids) {
   XLOG(INFO) << "Received request for getTransceiverInfo, with ids: "
@@ -60,6 +155,7 @@ void WedgeManager::getTransceiversInfo(std::map<int32_t, TransceiverInfo>& info,
       folly::gen::appendTo(*ids);
   }
 
+  std::shared_lock<folly::SharedMutex> g(transceiversLock_);
   for (const auto& i : *ids) {
     TransceiverInfo trans;
     if (isValidTransceiver(i)) {
@@ -83,6 +179,7 @@ void WedgeManager::getTransceiversRawDOMData(
     folly::gen::range(0, getNumQsfpModules()) |
       folly::gen::appendTo(*ids);
   }
+  std::shared_lock<folly::SharedMutex> g(transceiversLock_);
   for (const auto& i : *ids) {
     RawDOMData data;
     if (isValidTransceiver(i)) {
@@ -98,6 +195,7 @@ void WedgeManager::getTransceiversRawDOMData(
 }
 
 void WedgeManager::customizeTransceiver(int32_t idx, cfg::PortSpeed speed) {
+  std::shared_lock<folly::SharedMutex> g(transceiversLock_);
   transceivers_.at(idx)->customizeTransceiver(speed);
 }
 
@@ -114,6 +212,7 @@ void WedgeManager::syncPorts(
       }) |
       folly::gen::as<std::vector>();
 
+  std::shared_lock<folly::SharedMutex> g(transceiversLock_);
   for (auto& group : groups) {
     int32_t transceiverIdx = group.key();
     XLOG(INFO) << "Syncing ports of transceiver " << transceiverIdx;
@@ -137,16 +236,67 @@ void WedgeManager::refreshTransceivers() {
     return;
   }
 
-  std::vector<folly::Future<folly::Unit>> futs;
-  XLOG(INFO) << "Start refreshing all transceivers...";
+  auto now = std::chrono::steady_clock::now();
+  if (moduleEventsSupported_ &&
+      now - lastFullRefresh_ <
+          std::chrono::seconds(FLAGS_transceiver_full_refresh_interval)) {
+    // Insertions, removals and interrupts are picked up by
+    // refreshPendingTransceivers() in the meantime
+    return;
+  }
+  lastFullRefresh_ = now;
 
+  std::vector<Transceiver*> transceivers;
+  std::vector<int32_t> ids;
   for (const auto& transceiver : transceivers_) {
+    ids.push_back(ids.size());
+    transceivers.push_back(transceiver.get());
+  }
+  XLOG(INFO) << "Start refreshing all transceivers...";
+  refreshInParallel(transceivers);
+  // Modules plugged in since they were last polled
+  updateTransceiverTypes(ids, false);
+  XLOG(INFO) << "Finished refreshing all transceivers";
+}
+
+void WedgeManager::refreshPendingTransceivers() {
+  auto events = wedgeI2cBus_->takeModuleEvents();
+  moduleEventsSupported_ = events.has_value();
+  if (!events || events->empty()) {
+    return;
+  }
+
+  std::vector<Transceiver*> transceivers;
+  std::vector<int32_t> ids;
+  for (auto module : *events) {
+    // Modules are numbered from 1 on the bus
+    int32_t idx = module - 1;
+    if (!isValidTransceiver(idx)) {
+      XLOG(ERR) << "Event for unknown transceiver module " << module;
+      continue;
+    }
+    // A module raises its interrupt when its flags changed, so read them
+    // now rather than at the next refresh interval
+    transceivers_[idx]->markDataStale();
+    ids.push_back(idx);
+    transceivers.push_back(transceivers_[idx].get());
+  }
+  XLOG(DBG2) << "Refreshing " << transceivers.size()
+             << " transceivers with events pending";
+  refreshInParallel(transceivers);
+  // The event may be a module replaced by one of another type
+  updateTransceiverTypes(ids, true);
+}
+
+void WedgeManager::refreshInParallel(
+    const std::vector<Transceiver*>& transceivers) {
+  std::vector<folly::Future<folly::Unit>> futs;
+  for (auto transceiver : transceivers) {
     XLOG(DBG3) << "Fired to refresh transceiver " << transceiver->getID();
     futs.push_back(transceiver->futureRefresh());
   }
 
   folly::collectAllUnsafe(futs.begin(), futs.end()).wait();
-  XLOG(INFO) << "Finished refreshing all transceivers";
 }
 
 int WedgeManager::scanTransceiverPresence(
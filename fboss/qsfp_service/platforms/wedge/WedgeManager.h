@@ -1,12 +1,17 @@
 #pragma once
 
 #include <boost/container/flat_map.hpp>
+#include <folly/SharedMutex.h>
+
+#include <chrono>
+#include <set>
 
 #include "fboss/agent/AgentConfig.h"
 #include "fboss/lib/i2c/gen-cpp2/i2c_controller_stats_types.h"
 #include "fboss/lib/usb/WedgeI2CBus.h"
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 #include "fboss/qsfp_service/TransceiverManager.h"
+#include "fboss/qsfp_service/module/QsfpModule.h"
 #include "fboss/lib/usb/TransceiverPlatformApi.h"
 
 namespace facebook { namespace fboss {
@@ -38,6 +43,7 @@ class WedgeManager : public TransceiverManager {
     return 4;
   }
   void refreshTransceivers() override;
+  void refreshPendingTransceivers() override;
 
   int scanTransceiverPresence(
       std::unique_ptr<std::vector<int32_t>> ids) override;
@@ -74,6 +80,35 @@ class WedgeManager : public TransceiverManager {
   PortGroups portGroupMap_;
 
  private:
+  void refreshInParallel(const std::vector<Transceiver*>& transceivers);
+
+  /*
+   * Module object for transceiver idx, following the spec of the module
+   * plugged in if its identifier can be read, SFF-8636 otherwise.
+   */
+  std::unique_ptr<QsfpModule> createTransceiver(int32_t idx);
+  /*
+   * Rebuild the module objects of the transceivers in ids, just refreshed,
+   * whose module follows another spec than the object. The identifier is
+   * only read again from modules present which were not identified yet, or
+   * all of them if mayHaveChanged, e.g. after presence change events.
+   */
+  void updateTransceiverTypes(
+      const std::vector<int32_t>& ids,
+      bool mayHaveChanged);
+
+  // Transceivers whose module object was created from the identifier of
+  // the module plugged in. Only used from the refresh thread.
+  std::set<int32_t> identifiedTransceivers_;
+  // Held exclusively by the refresh thread to replace a module object, and
+  // shared by the other threads accessing the module objects
+  folly::SharedMutex transceiversLock_;
+
+  // Whether the bus reports transceiver events, so that polling all of them
+  // is only a safety net. Only used from the refresh thread.
+  bool moduleEventsSupported_{false};
+  std::chrono::steady_clock::time_point lastFullRefresh_;
+
   // Forbidden copy constructor and assignment operator
   WedgeManager(WedgeManager const &) = delete;
   WedgeManager& operator=(WedgeManager const &) = delete;
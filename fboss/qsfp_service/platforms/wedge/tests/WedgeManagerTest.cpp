@@ -11,6 +11,8 @@
 #include "fboss/qsfp_service/platforms/wedge/WedgeManager.h"
 #include <folly/Memory.h>
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/lib/fpga/tests/FakeFbDomFpga.h"
+#include "fboss/lib/usb/TransceiverI2CApi.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 #include "fboss/qsfp_service/module/tests/MockSffModule.h"
 #include "fboss/qsfp_service/module/tests/MockTransceiverImpl.h"
@@ -22,6 +24,53 @@ using namespace facebook::fboss;
 using namespace ::testing;
 namespace {
 
+/*
+ * Modules behind the QSFP ports of a DOM FPGA with simulated registers, or
+ * of an I2C bus which does not report transceiver events if there is none.
+ */
+class FakeFpgaI2CApi : public TransceiverI2CApi {
+ public:
+  explicit FakeFpgaI2CApi(FakeFbDomFpga* fpga) : fpga_(fpga) {}
+
+  void open() override {}
+  void close() override {}
+  void verifyBus(bool /* autoReset */) override {}
+  // Only the identifier of the modules reads back
+  void moduleRead(unsigned int module, uint8_t, int offset, int, uint8_t* buf)
+      override {
+    if (offset == 0) {
+      buf[0] = identifiers[module];
+    }
+  }
+  void moduleWrite(unsigned int, uint8_t, int, int, const uint8_t*) override {
+  }
+  bool isPresent(unsigned int module) override {
+    return fpga_ && fpga_->isQsfpPresent(module - 1);
+  }
+  void scanPresence(std::map<int32_t, ModulePresence>& /* presences */)
+      override {}
+
+  std::optional<std::set<unsigned int>> takeModuleEvents() override {
+    if (!fpga_) {
+      return std::nullopt;
+    }
+    std::set<unsigned int> modules;
+    auto events = fpga_->takeQsfpEvents();
+    for (unsigned int port = 0; events; ++port, events >>= 1) {
+      if (events & 1) {
+        modules.insert(port + 1);
+      }
+    }
+    return modules;
+  }
+
+  // SFF-8024 identifier of the module plugged in, by module number
+  std::map<unsigned int, uint8_t> identifiers;
+
+ private:
+  FakeFbDomFpga* fpga_;
+};
+
 class MockWedgeManager : public WedgeManager {
  public:
   explicit MockWedgeManager() : WedgeManager() {}
@@ -34,7 +83,48 @@ class MockWedgeManager : public WedgeManager {
     }
   }
 
+  // Transceivers whose presence is that of the ports of fpga
+  void makeTransceiverMap(FakeFbDomFpga* fpga) {
+    wedgeI2cBus_ = std::make_unique<FakeFpgaI2CApi>(fpga);
+    for (int idx = 0; idx < getNumQsfpModules(); idx++) {
+      auto impl = std::make_unique<NiceMock<MockTransceiverImpl>>();
+      ON_CALL(*impl, getNum()).WillByDefault(Return(idx));
+      ON_CALL(*impl, detectTransceiver())
+          .WillByDefault(Invoke([this, idx]() {
+            return wedgeI2cBus_->isPresent(idx + 1);
+          }));
+      mockImpls_.push_back(impl.get());
+      auto qsfp = std::make_unique<NiceMock<MockSffModule>>(
+          std::move(impl), numPortsPerTransceiver());
+      mockTransceivers_.push_back(qsfp.get());
+      transceivers_.push_back(move(qsfp));
+    }
+  }
+
+  QsfpModule* getTransceiver(int idx) {
+    return dynamic_cast<QsfpModule*>(transceivers_[idx].get());
+  }
+
+  FakeFpgaI2CApi* getFakeBus() {
+    return static_cast<FakeFpgaI2CApi*>(wedgeI2cBus_.get());
+  }
+
+  // Expect the transceivers to be refreshed, the others not to be
+  void expectRefreshed(const std::set<int>& refreshed) {
+    for (size_t idx = 0; idx < mockImpls_.size(); idx++) {
+      EXPECT_CALL(*mockImpls_[idx], detectTransceiver())
+          .Times(refreshed.count(idx));
+    }
+  }
+
+  void verifyRefreshed() {
+    for (auto impl : mockImpls_) {
+      Mock::VerifyAndClearExpectations(impl);
+    }
+  }
+
   std::vector<MockSffModule*> mockTransceivers_;
+  std::vector<MockTransceiverImpl*> mockImpls_;
 };
 
 class WedgeManagerTest : public ::testing::Test {
@@ -46,6 +136,27 @@ class WedgeManagerTest : public ::testing::Test {
   std::unique_ptr<NiceMock<MockWedgeManager>> wedgeManager_;
 };
 
+class WedgeManagerEventsTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    gflags::SetCommandLineOptionWithMode(
+        "transceiver_full_refresh_interval", "3600", gflags::SET_FLAGS_DEFAULT);
+    wedgeManager_ = std::make_unique<NiceMock<MockWedgeManager>>();
+    wedgeManager_->makeTransceiverMap(&fpga_);
+  }
+
+  std::set<int> allTransceivers() const {
+    std::set<int> all;
+    for (int idx = 0; idx < wedgeManager_->getNumQsfpModules(); idx++) {
+      all.insert(idx);
+    }
+    return all;
+  }
+
+  FakeFbDomFpga fpga_;
+  std::unique_ptr<NiceMock<MockWedgeManager>> wedgeManager_;
+};
+
 TEST_F(WedgeManagerTest, getTransceiverInfo) {
   // If no ids are passed in, info for all should be returned
   for (const auto& trans : wedgeManager_->mockTransceivers_) {
@@ -65,4 +176,81 @@ TEST_F(WedgeManagerTest, getTransceiverInfo) {
       std::make_unique<std::vector<int32_t>>(data));
 }
 
+TEST_F(WedgeManagerEventsTest, refreshOnlyPending) {
+  fpga_.plugQsfp(2);
+  fpga_.plugQsfp(5);
+  wedgeManager_->expectRefreshed({2, 5});
+  wedgeManager_->refreshPendingTransceivers();
+  wedgeManager_->verifyRefreshed();
+
+  // Nothing happened since
+  wedgeManager_->expectRefreshed({});
+  wedgeManager_->refreshPendingTransceivers();
+  wedgeManager_->verifyRefreshed();
+
+  fpga_.unplugQsfp(5);
+  fpga_.setQsfpInterrupt(9, true);
+  wedgeManager_->expectRefreshed({5, 9});
+  wedgeManager_->refreshPendingTransceivers();
+  wedgeManager_->verifyRefreshed();
+}
+
+TEST_F(WedgeManagerEventsTest, fullRefreshIsSafetyNet) {
+  // Before events are known to be reported, everything is polled
+  wedgeManager_->expectRefreshed(allTransceivers());
+  wedgeManager_->refreshTransceivers();
+  wedgeManager_->verifyRefreshed();
+
+  wedgeManager_->refreshPendingTransceivers();
+  wedgeManager_->expectRefreshed({});
+  wedgeManager_->refreshTransceivers();
+  wedgeManager_->verifyRefreshed();
+
+  gflags::SetCommandLineOptionWithMode(
+      "transceiver_full_refresh_interval", "0", gflags::SET_FLAGS_DEFAULT);
+  wedgeManager_->expectRefreshed(allTransceivers());
+  wedgeManager_->refreshTransceivers();
+  wedgeManager_->verifyRefreshed();
+}
+
+TEST(WedgeManagerNoEventsTest, pollAll) {
+  auto wedgeManager = std::make_unique<NiceMock<MockWedgeManager>>();
+  wedgeManager->makeTransceiverMap(nullptr);
+
+  wedgeManager->expectRefreshed({});
+  wedgeManager->refreshPendingTransceivers();
+  wedgeManager->verifyRefreshed();
+
+  std::set<int> all;
+  for (int idx = 0; idx < wedgeManager->getNumQsfpModules(); idx++) {
+    all.insert(idx);
+  }
+  for (int i = 0; i < 2; i++) {
+    wedgeManager->expectRefreshed(all);
+    wedgeManager->refreshTransceivers();
+    wedgeManager->verifyRefreshed();
+  }
+}
+
+}
+
+TEST_F(WedgeManagerEventsTest, rebuildOnInsertion) {
+  // Slot 3 was empty when the module objects were created. Presence comes
+  // from the refresh, without reading the whole module again.
+  for (auto idx : {3, 5}) {
+    EXPECT_CALL(*wedgeManager_->mockTransceivers_[idx], getTransceiverInfo())
+        .Times(0);
+  }
+  wedgeManager_->getFakeBus()->identifiers[4] = 0x18; // QSFP-DD
+  wedgeManager_->getFakeBus()->identifiers[6] = 0x11; // QSFP28
+
+  fpga_.plugQsfp(3);
+  fpga_.plugQsfp(5);
+  wedgeManager_->refreshPendingTransceivers();
+  EXPECT_EQ(
+      TransceiverManagementInterface::CMIS,
+      wedgeManager_->getTransceiver(3)->managementInterface());
+  // Modules of the type of their object are left alone
+  EXPECT_EQ(
+      wedgeManager_->mockTransceivers_[5], wedgeManager_->getTransceiver(5));
 }
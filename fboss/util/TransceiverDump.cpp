@@ -0,0 +1,181 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+#include "fboss/util/TransceiverDump.h"
+
+#include <folly/Conv.h>
+#include <folly/Range.h>
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+
+#include <unistd.h>
+
+namespace {
+constexpr size_t kPageSize = 128;
+
+folly::StringPiece sfpString(const uint8_t* buf, size_t offset, size_t len) {
+  const uint8_t* start = buf + offset;
+  while (len > 0 && start[len - 1] == ' ') {
+    --len;
+  }
+  return folly::StringPiece(reinterpret_cast<const char*>(start), len);
+}
+
+uint16_t u16At(const uint8_t* buf, size_t offset) {
+  return (buf[offset] << 8) | buf[offset + 1];
+}
+
+std::string hexPage(const folly::IOBuf& page) {
+  return folly::hexlify(folly::ByteRange(page.data(), kPageSize));
+}
+
+folly::dynamic portToDynamic(const facebook::fboss::RawDOMData& rawDOMData) {
+  auto lowerBuf = rawDOMData.lower.data();
+  auto page0Buf = rawDOMData.page0.data();
+
+  folly::dynamic channels = folly::dynamic::array;
+  for (int channel = 0; channel < 4; ++channel) {
+    // Same units as printChannelMonitor()
+    channels.push_back(folly::dynamic::object("channel", channel + 1)(
+        "rxPowerMw", 0.0001 * u16At(lowerBuf, 34 + 2 * channel))(
+        "txBiasMa", (131.0 * u16At(lowerBuf, 42 + 2 * channel)) / 65535)(
+        "txPowerMw", 0.0001 * u16At(lowerBuf, 50 + 2 * channel)));
+  }
+
+  folly::dynamic port = folly::dynamic::object("present", true)(
+      "identifier", lowerBuf[0])(
+      "temperatureC",
+      static_cast<int8_t>(lowerBuf[22]) + (lowerBuf[23] / 256.0))(
+      "supplyVoltageV", u16At(lowerBuf, 26) / 10000.0)("channels", channels)(
+      "vendor", sfpString(page0Buf, 20, 16))(
+      "vendorPN", sfpString(page0Buf, 40, 16))(
+      "vendorRev", sfpString(page0Buf, 56, 2))(
+      "vendorSN", sfpString(page0Buf, 68, 16))(
+      "dateCode", sfpString(page0Buf, 84, 8))(
+      "lower", hexPage(rawDOMData.lower))(
+      "page0", hexPage(rawDOMData.page0));
+  if (rawDOMData.__isset.page3) {
+    port["page3"] = hexPage(rawDOMData.page3_ref().value_unchecked());
+  }
+  return port;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+RawDOMData fetchDataFromLocalI2CBus(TransceiverI2CApi* bus, unsigned int port) {
+  RawDOMData rawDOMData;
+  rawDOMData.lower = IOBuf(IOBuf::CREATE, kPageSize);
+  rawDOMData.lower.append(kPageSize);
+  rawDOMData.page0 = IOBuf(IOBuf::CREATE, kPageSize);
+  rawDOMData.page0.append(kPageSize);
+
+  // Read the lower 128 bytes.
+  bus->moduleRead(port, TransceiverI2CApi::ADDR_QSFP, 0,
+    128, rawDOMData.lower.writableData());
+
+  uint8_t flatMem = rawDOMData.lower.data()[2] & (1 << 2);
+
+  // Read page 0 from the upper 128 bytes.
+  // First see if we need to select page 0.
+  if (!flatMem) {
+    uint8_t page0 = 0;
+    if (rawDOMData.lower.data()[127] != page0) {
+      bus->moduleWrite(port, TransceiverI2CApi::ADDR_QSFP,
+                       127, 1, &page0);
+      usleep(20000); // Delay required by Intel Transceiver.
+    }
+  }
+  bus->moduleRead(port, TransceiverI2CApi::ADDR_QSFP, 128,
+    128, rawDOMData.page0.writableData());
+
+  // Make sure page3 exist
+  if (!flatMem) {
+    auto& page3Buf = rawDOMData.page3_ref().value_unchecked();
+    page3Buf = IOBuf(IOBuf::CREATE, kPageSize);
+    page3Buf.append(kPageSize);
+    uint8_t page3 = 0x3;
+    bus->moduleWrite(port, TransceiverI2CApi::ADDR_QSFP, 127, 1, &page3);
+    usleep(20000); // Delay required by Intel Transceiver.
+
+    // read page 3
+    bus->moduleRead(
+        port,
+        TransceiverI2CApi::ADDR_QSFP,
+        128,
+        128,
+        page3Buf.writableData());
+    rawDOMData.__isset.page3 = true;
+  }
+  return rawDOMData;
+}
+
+std::map<folly::EventBase*, std::vector<unsigned int>> groupPortsByBus(
+    TransceiverI2CApi* bus,
+    const std::vector<unsigned int>& ports) {
+  std::map<folly::EventBase*, std::vector<unsigned int>> groups;
+  for (auto port : ports) {
+    groups[bus->getEventBase(port)].push_back(port);
+  }
+  return groups;
+}
+
+std::map<unsigned int, TransceiverDump> dumpTransceivers(
+    TransceiverI2CApi* bus,
+    const std::vector<unsigned int>& ports) {
+  std::map<unsigned int, TransceiverDump> dumps;
+  auto readGroup = [bus](const std::vector<unsigned int>& group) {
+    std::map<unsigned int, TransceiverDump> groupDumps;
+    for (auto port : group) {
+      auto& dump = groupDumps[port];
+      try {
+        dump.data = fetchDataFromLocalI2CBus(bus, port);
+      } catch (const I2cError& ex) {
+        // This generally means the QSFP module is not present.
+        dump.error = folly::to<std::string>("not present: ", ex.what());
+      } catch (const std::exception& ex) {
+        dump.error = ex.what();
+      }
+    }
+    return groupDumps;
+  };
+
+  std::vector<folly::Future<std::map<unsigned int, TransceiverDump>>> futures;
+  const std::vector<unsigned int>* localGroup = nullptr;
+  auto groups = groupPortsByBus(bus, ports);
+  for (const auto& [evb, group] : groups) {
+    if (!evb) {
+      localGroup = &group;
+      continue;
+    }
+    futures.push_back(folly::via(evb).thenValue(
+        [&readGroup, &group = group](auto&&) { return readGroup(group); }));
+  }
+  // Ports without an event base are read from here, meanwhile
+  if (localGroup) {
+    dumps = readGroup(*localGroup);
+  }
+
+  for (auto& groupDumps : folly::collectAll(std::move(futures)).get()) {
+    auto& result = groupDumps.value();
+    dumps.insert(
+        std::make_move_iterator(result.begin()),
+        std::make_move_iterator(result.end()));
+  }
+  return dumps;
+}
+
+folly::dynamic transceiverDumpToDynamic(
+    const std::map<unsigned int, TransceiverDump>& dumps) {
+  folly::dynamic ports = folly::dynamic::object;
+  for (const auto& [port, dump] : dumps) {
+    auto key = folly::to<std::string>(port);
+    if (dump.data) {
+      ports[key] = portToDynamic(*dump.data);
+    } else {
+      ports[key] =
+          folly::dynamic::object("present", false)("error", dump.error);
+    }
+  }
+  return ports;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,52 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+#pragma once
+
+#include "fboss/lib/usb/TransceiverI2CApi.h"
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+#include <folly/dynamic.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Read the lower page, page 0 and (if the memory is paged) page 3 of a
+ * transceiver over a local I2C bus.
+ */
+RawDOMData fetchDataFromLocalI2CBus(TransceiverI2CApi* bus, unsigned int port);
+
+struct TransceiverDump {
+  // Set if the transceiver could be read
+  std::optional<RawDOMData> data;
+  std::string error;
+};
+
+/*
+ * Group ports by the bus they are read through. Ports of different groups
+ * can be read concurrently, the ones of a group must be read one by one.
+ * Ports whose bus has no event base all end up in one group.
+ */
+std::map<folly::EventBase*, std::vector<unsigned int>> groupPortsByBus(
+    TransceiverI2CApi* bus,
+    const std::vector<unsigned int>& ports);
+
+/*
+ * Read ports through fetchDataFromLocalI2CBus(), concurrently across the
+ * independent buses, on the event base of each bus. Returns once all the
+ * ports are read, with the data or error of each.
+ */
+std::map<unsigned int, TransceiverDump> dumpTransceivers(
+    TransceiverI2CApi* bus,
+    const std::vector<unsigned int>& ports);
+
+/*
+ * Decoded monitoring and vendor fields of each port, and its raw pages.
+ */
+folly::dynamic transceiverDumpToDynamic(
+    const std::map<unsigned int, TransceiverDump>& dumps);
+
+} // namespace facebook::fboss
@@ -0,0 +1,312 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Offline load balancing analysis. Runs a flow corpus, either read from a pcap
+ * file or generated synthetically, through one or more stages of emulated
+ * ECMP hashing and reports how evenly each stage spreads the flows.
+ *
+ * Example, a 3 stage fabric reusing the same hash config everywhere:
+ *   lb_hash_util --stages CRC16_CCITT:4,CRC16_CCITT:16,CRC16_CCITT:4
+ */
+#include "fboss/agent/LoadBalancerHashEmulator.h"
+
+#include <folly/Conv.h>
+#include <folly/IPAddress.h>
+#include <folly/Random.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <thrift/lib/cpp/util/EnumUtils.h>
+
+#include <fstream>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+using namespace facebook::fboss;
+
+DEFINE_string(
+    stages,
+    "CRC16_CCITT:64",
+    "Comma separated list of ECMP stages, as ALGORITHM:FANOUT[:SEED]");
+DEFINE_string(v4_fields, "src,dst", "IPv4 fields to hash on");
+DEFINE_string(v6_fields, "src,dst", "IPv6 fields to hash on (src,dst,label)");
+DEFINE_string(transport_fields, "src,dst", "L4 ports to hash on");
+DEFINE_bool(
+    per_switch_seed,
+    false,
+    "Give every switch its own seed, as the agent does by default");
+DEFINE_string(pcap_file, "", "Read flows from this pcap file");
+DEFINE_bool(dedup_flows, true, "Only count each flow of the pcap once");
+DEFINE_int32(num_flows, 100000, "Number of synthetic flows");
+DEFINE_string(src_prefix, "2401:db00:1::/64", "Synthetic flow sources");
+DEFINE_string(dst_prefix, "2401:db00:2::/64", "Synthetic flow destinations");
+DEFINE_bool(print_loads, false, "Print the load of every member");
+
+namespace {
+
+std::set<std::string> parseList(const std::string& list) {
+  std::vector<std::string> items;
+  folly::split(',', list, items, true);
+  return std::set<std::string>(items.begin(), items.end());
+}
+
+MultiStageEcmpEmulator::Stage parseStage(const std::string& spec) {
+  std::vector<std::string> parts;
+  folly::split(':', spec, parts);
+  if (parts.size() < 2 || parts.size() > 3) {
+    throw std::invalid_argument("Invalid stage " + spec);
+  }
+  cfg::HashingAlgorithm algorithm;
+  if (!apache::thrift::TEnumTraits<cfg::HashingAlgorithm>::findValue(
+          parts[0].c_str(), &algorithm)) {
+    throw std::invalid_argument("Unknown hashing algorithm " + parts[0]);
+  }
+  auto fanout = folly::to<uint32_t>(parts[1]);
+  uint32_t seed = parts.size() == 3 ? folly::to<uint32_t>(parts[2]) : 0;
+
+  auto v4 = parseList(FLAGS_v4_fields);
+  auto v6 = parseList(FLAGS_v6_fields);
+  auto transport = parseList(FLAGS_transport_fields);
+  LoadBalancer::IPv4Fields v4Fields;
+  LoadBalancer::IPv6Fields v6Fields;
+  LoadBalancer::TransportFields transportFields;
+  if (v4.count("src")) {
+    v4Fields.insert(LoadBalancer::IPv4Field::SOURCE_ADDRESS);
+  }
+  if (v4.count("dst")) {
+    v4Fields.insert(LoadBalancer::IPv4Field::DESTINATION_ADDRESS);
+  }
+  if (v6.count("src")) {
+    v6Fields.insert(LoadBalancer::IPv6Field::SOURCE_ADDRESS);
+  }
+  if (v6.count("dst")) {
+    v6Fields.insert(LoadBalancer::IPv6Field::DESTINATION_ADDRESS);
+  }
+  if (v6.count("label")) {
+    v6Fields.insert(LoadBalancer::IPv6Field::FLOW_LABEL);
+  }
+  if (transport.count("src")) {
+    transportFields.insert(LoadBalancer::TransportField::SOURCE_PORT);
+  }
+  if (transport.count("dst")) {
+    transportFields.insert(LoadBalancer::TransportField::DESTINATION_PORT);
+  }
+  return {LoadBalancerHashEmulator(
+              algorithm, seed, v4Fields, v6Fields, transportFields),
+          fanout,
+          FLAGS_per_switch_seed};
+}
+
+folly::IPAddress randomAddress(const folly::CIDRNetwork& prefix) {
+  auto bytes = prefix.first.bytes();
+  std::array<uint8_t, 16> addr{};
+  std::copy(bytes, bytes + prefix.first.byteCount(), addr.begin());
+  for (size_t bit = prefix.second; bit < prefix.first.bitCount(); ++bit) {
+    if (folly::Random::rand32() & 1) {
+      addr[bit / 8] |= 0x80 >> (bit % 8);
+    }
+  }
+  return folly::IPAddress::fromBinary(
+      folly::ByteRange(addr.data(), prefix.first.byteCount()));
+}
+
+std::vector<LoadBalancerFlow> syntheticFlows() {
+  auto src = folly::IPAddress::createNetwork(FLAGS_src_prefix);
+  auto dst = folly::IPAddress::createNetwork(FLAGS_dst_prefix);
+  std::vector<LoadBalancerFlow> flows;
+  flows.reserve(FLAGS_num_flows);
+  for (int i = 0; i < FLAGS_num_flows; ++i) {
+    flows.emplace_back(
+        randomAddress(src),
+        randomAddress(dst),
+        1024 + folly::Random::rand32(64512),
+        folly::Random::oneIn(2) ? 443 : 1024 + folly::Random::rand32(64512),
+        folly::Random::rand32(1 << 20));
+  }
+  return flows;
+}
+
+uint16_t get16(const uint8_t* p) {
+  return (uint16_t(p[0]) << 8) | p[1];
+}
+
+uint32_t get32(const uint8_t* p) {
+  return (uint32_t(get16(p)) << 16) | get16(p + 2);
+}
+
+/*
+ * Extract the hash fields of an ethernet frame, returning false for frames
+ * which are neither IP nor MPLS.
+ */
+bool parseFrame(const uint8_t* p, size_t len, LoadBalancerFlow* flow) {
+  if (len < 14) {
+    return false;
+  }
+  size_t off = 12;
+  uint16_t ethertype = get16(p + off);
+  // Skip 802.1Q/802.1ad tags
+  while ((ethertype == 0x8100 || ethertype == 0x88a8) && off + 6 <= len) {
+    off += 4;
+    ethertype = get16(p + off);
+  }
+  off += 2;
+  if (ethertype == 0x8847) {
+    while (off + 4 <= len && flow->numLabels < flow->labels.size()) {
+      auto entry = get32(p + off);
+      flow->labels[flow->numLabels++] = entry >> 12;
+      off += 4;
+      if (entry & 0x100) {
+        // Bottom of stack
+        break;
+      }
+    }
+    return flow->numLabels > 0;
+  }
+  uint8_t proto;
+  if (ethertype == 0x0800) {
+    if (off + 20 > len) {
+      return false;
+    }
+    proto = p[off + 9];
+    std::copy(p + off + 12, p + off + 16, flow->srcIp.begin());
+    std::copy(p + off + 16, p + off + 20, flow->dstIp.begin());
+    off += (p[off] & 0x0F) * 4;
+  } else if (ethertype == 0x86dd) {
+    if (off + 40 > len) {
+      return false;
+    }
+    flow->isV6 = true;
+    flow->flowLabel = get32(p + off) & 0xFFFFF;
+    proto = p[off + 6];
+    std::copy(p + off + 8, p + off + 24, flow->srcIp.begin());
+    std::copy(p + off + 24, p + off + 40, flow->dstIp.begin());
+    off += 40;
+  } else {
+    return false;
+  }
+  // TCP and UDP
+  if ((proto == 6 || proto == 17) && off + 4 <= len) {
+    flow->srcPort = get16(p + off);
+    flow->dstPort = get16(p + off + 2);
+  }
+  return true;
+}
+
+std::vector<LoadBalancerFlow> pcapFlows(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  uint32_t header[6];
+  if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    throw std::runtime_error(path + " is not a pcap file");
+  }
+  bool swapped;
+  if (header[0] == 0xa1b2c3d4 || header[0] == 0xa1b23c4d) {
+    swapped = false;
+  } else if (header[0] == 0xd4c3b2a1 || header[0] == 0x4d3cb2a1) {
+    swapped = true;
+  } else {
+    throw std::runtime_error(path + " is not a pcap file");
+  }
+  auto fix = [swapped](uint32_t v) {
+    return swapped ? __builtin_bswap32(v) : v;
+  };
+
+  std::vector<LoadBalancerFlow> flows;
+  std::unordered_set<std::string> seen;
+  std::vector<uint8_t> frame;
+  uint32_t record[4];
+  uint64_t numFrames = 0;
+  while (in.read(reinterpret_cast<char*>(record), sizeof(record))) {
+    auto capLen = fix(record[2]);
+    frame.resize(capLen);
+    if (!in.read(reinterpret_cast<char*>(frame.data()), capLen)) {
+      break;
+    }
+    ++numFrames;
+    LoadBalancerFlow flow;
+    if (!parseFrame(frame.data(), capLen, &flow)) {
+      continue;
+    }
+    if (FLAGS_dedup_flows) {
+      auto key = folly::to<std::string>(
+          folly::StringPiece(
+              reinterpret_cast<const char*>(flow.srcIp.data()), 16),
+          folly::StringPiece(
+              reinterpret_cast<const char*>(flow.dstIp.data()), 16),
+          ":",
+          flow.srcPort,
+          ":",
+          flow.dstPort,
+          ":",
+          flow.flowLabel,
+          ":",
+          flow.labels[0],
+          ":",
+          flow.labels[1],
+          ":",
+          flow.labels[2]);
+      if (!seen.insert(std::move(key)).second) {
+        continue;
+      }
+    }
+    flows.push_back(flow);
+  }
+  LOG(INFO) << "Read " << flows.size() << " flows from " << numFrames
+            << " frames";
+  return flows;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  std::vector<MultiStageEcmpEmulator::Stage> stages;
+  std::vector<std::string> specs;
+  folly::split(',', FLAGS_stages, specs, true);
+  for (const auto& spec : specs) {
+    stages.push_back(parseStage(spec));
+  }
+  auto flows =
+      FLAGS_pcap_file.empty() ? syntheticFlows() : pcapFlows(FLAGS_pcap_file);
+
+  MultiStageEcmpEmulator emulator(std::move(stages));
+  auto reports = emulator.run(
+      folly::Range<const LoadBalancerFlow*>(flows.data(), flows.size()));
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const auto& report = reports[i];
+    printf(
+        "stage %zu (%s): %u switches x %u members, imbalance mean %.3f "
+        "max %.3f, %lu unused members\n",
+        i,
+        specs[i].c_str(),
+        report.numSwitches,
+        report.fanout,
+        report.meanImbalance,
+        report.maxImbalance,
+        report.unusedMembers);
+    if (!FLAGS_print_loads) {
+      continue;
+    }
+    for (uint32_t sw = 0; sw < report.numSwitches; ++sw) {
+      printf("  switch %u:", sw);
+      for (uint32_t m = 0; m < report.fanout; ++m) {
+        printf(" %lu", report.memberLoad[uint64_t(sw) * report.fanout + m]);
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
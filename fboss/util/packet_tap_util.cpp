@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Reference consumer of the agent packet tap. It subscribes to the shared
+ * memory ring published by wedge_agent (--packet_tap_name) and either prints
+ * a summary line per packet or writes the packets to a pcap file.
+ */
+#include "fboss/agent/capture/PacketTap.h"
+#include "fboss/agent/capture/PcapFile.h"
+#include "fboss/agent/capture/PcapPkt.h"
+
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+DEFINE_string(tap, "/fboss_packet_tap", "Name of the packet tap to read");
+DEFINE_string(direction, "", "Only read 'rx' or 'tx' packets");
+DEFINE_int32(ethertype, 0, "Only read packets with this ethertype");
+DEFINE_int32(port, 0, "Only read packets received on this port");
+DEFINE_int32(sample_rate, 1, "Read one out of every N matching packets");
+DEFINE_string(pcap_file, "", "Write packets to this pcap file");
+DEFINE_int32(count, 0, "Exit after reading this many packets");
+DEFINE_int32(poll_interval_us, 100, "Sleep interval when the ring is empty");
+
+namespace {
+std::atomic<bool> stopRequested{false};
+
+void handleSignal(int /* sig */) {
+  stopRequested = true;
+}
+
+PcapPkt toPcapPkt(
+    const PacketTapRecordHeader& record,
+    folly::ByteRange data) {
+  auto timestamp = system_clock::time_point(
+      duration_cast<system_clock::duration>(nanoseconds(record.timestampNs)));
+  if (record.direction == PacketTapDirection::RX) {
+    RxPacketData pkt;
+    pkt.srcPort = record.port;
+    pkt.srcVlan = record.vlan;
+    pkt.packetData = folly::fbstring(
+        reinterpret_cast<const char*>(data.data()), data.size());
+    return PcapPkt(&pkt, timestamp);
+  }
+  TxPacketData pkt;
+  pkt.packetData =
+      folly::fbstring(reinterpret_cast<const char*>(data.data()), data.size());
+  return PcapPkt(&pkt, timestamp);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  PacketTapFilter filter;
+  if (FLAGS_direction == "rx") {
+    filter.directions = static_cast<uint8_t>(PacketTapDirection::RX);
+  } else if (FLAGS_direction == "tx") {
+    filter.directions = static_cast<uint8_t>(PacketTapDirection::TX);
+  } else if (!FLAGS_direction.empty()) {
+    LOG(ERROR) << "Unknown direction " << FLAGS_direction;
+    return 1;
+  }
+  filter.ethertype = FLAGS_ethertype;
+  filter.port = FLAGS_port;
+  filter.sampleRate = FLAGS_sample_rate;
+
+  PacketTapReader reader(FLAGS_tap, filter);
+  std::unique_ptr<PcapFile> pcap;
+  if (!FLAGS_pcap_file.empty()) {
+    pcap = std::make_unique<PcapFile>(FLAGS_pcap_file, true);
+    pcap->writeGlobalHeader();
+  }
+
+  signal(SIGINT, handleSignal);
+  signal(SIGTERM, handleSignal);
+
+  std::vector<uint8_t> buf(reader.snapLen());
+  std::vector<PcapPkt> batch;
+  PacketTapRecordHeader record;
+  uint64_t numRead = 0;
+  while (!stopRequested && (FLAGS_count == 0 || numRead < FLAGS_count)) {
+    if (!reader.readNext(&record, folly::MutableByteRange(buf.data(), buf.size()))) {
+      if (pcap && !batch.empty()) {
+        pcap->writePackets(batch);
+        batch.clear();
+      }
+      std::this_thread::sleep_for(microseconds(FLAGS_poll_interval_us));
+      continue;
+    }
+    ++numRead;
+    auto data = folly::ByteRange(buf.data(), record.capLen);
+    if (pcap) {
+      batch.push_back(toPcapPkt(record, data));
+      continue;
+    }
+    printf(
+        "%s seq=%lu port=%u aggPort=%u vlan=%u ethertype=0x%04x len=%u\n",
+        record.direction == PacketTapDirection::RX ? "RX" : "TX",
+        record.seqNum,
+        record.port,
+        record.aggregatePort,
+        record.vlan,
+        record.ethertype,
+        record.origLen);
+  }
+  if (pcap && !batch.empty()) {
+    pcap->writePackets(batch);
+  }
+  printf(
+      "read %lu packets, lost %lu packets\n", reader.delivered(), reader.lost());
+  return 0;
+}
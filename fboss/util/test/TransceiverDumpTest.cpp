@@ -0,0 +1,167 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+#include "fboss/util/TransceiverDump.h"
+
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+/*
+ * Transceivers behind numBuses independent buses, each with its own event
+ * base like the FPGA based platforms. Every transaction takes latency, and
+ * transactions on the same bus must not overlap.
+ */
+class FakeTransceiverI2CApi : public TransceiverI2CApi {
+ public:
+  FakeTransceiverI2CApi(
+      int numBuses,
+      int portsPerBus,
+      std::chrono::microseconds latency)
+      : portsPerBus_(portsPerBus), latency_(latency), busy_(numBuses) {
+    for (int i = 0; i < numBuses; ++i) {
+      evbThreads_.push_back(std::make_unique<folly::ScopedEventBaseThread>());
+    }
+  }
+
+  void open() override {}
+  void close() override {}
+  void verifyBus(bool /* autoReset */) override {}
+  bool isPresent(unsigned int module) override {
+    return module != absentPort;
+  }
+  void scanPresence(std::map<int32_t, ModulePresence>& /* presences */)
+      override {}
+
+  void moduleRead(
+      unsigned int module,
+      uint8_t /* i2cAddress */,
+      int offset,
+      int len,
+      uint8_t* buf) override {
+    transaction(module);
+    if (!isPresent(module)) {
+      throw I2cError("no module");
+    }
+    for (int i = 0; i < len; ++i) {
+      // Paged memory, the lower page says where the module is
+      buf[i] = (offset + i == 0) ? module : 0;
+    }
+  }
+
+  void moduleWrite(
+      unsigned int module,
+      uint8_t /* i2cAddress */,
+      int /* offset */,
+      int /* len */,
+      const uint8_t* /* buf */) override {
+    transaction(module);
+  }
+
+  folly::EventBase* getEventBase(unsigned int module) override {
+    return evbThreads_[bus(module)]->getEventBase();
+  }
+
+  int getMaxConcurrent() const {
+    return maxConcurrent_;
+  }
+  bool overlapped() const {
+    return overlapped_;
+  }
+
+  unsigned int absentPort{0};
+
+ private:
+  int bus(unsigned int module) const {
+    return (module - 1) / portsPerBus_;
+  }
+
+  void transaction(unsigned int module) {
+    auto& busy = busy_[bus(module)];
+    if (busy.exchange(true)) {
+      overlapped_ = true;
+    }
+    int now = ++concurrent_;
+    int max = maxConcurrent_;
+    while (now > max && !maxConcurrent_.compare_exchange_weak(max, now)) {
+    }
+    std::this_thread::sleep_for(latency_);
+    --concurrent_;
+    busy = false;
+  }
+
+  const int portsPerBus_;
+  const std::chrono::microseconds latency_;
+  std::vector<std::unique_ptr<folly::ScopedEventBaseThread>> evbThreads_;
+  std::vector<std::atomic<bool>> busy_;
+  std::atomic<int> concurrent_{0};
+  std::atomic<int> maxConcurrent_{0};
+  std::atomic<bool> overlapped_{false};
+};
+
+std::vector<unsigned int> portRange(unsigned int first, unsigned int last) {
+  std::vector<unsigned int> ports;
+  for (auto port = first; port <= last; ++port) {
+    ports.push_back(port);
+  }
+  return ports;
+}
+} // namespace
+
+TEST(TransceiverDumpTest, groupPortsByBus) {
+  FakeTransceiverI2CApi bus(4, 4, std::chrono::microseconds(0));
+  auto groups = groupPortsByBus(&bus, portRange(1, 16));
+  ASSERT_EQ(4, groups.size());
+  for (const auto& [evb, ports] : groups) {
+    EXPECT_EQ(4, ports.size());
+    for (auto port : ports) {
+      EXPECT_EQ(evb, bus.getEventBase(port));
+    }
+  }
+}
+
+TEST(TransceiverDumpTest, readBusesConcurrently) {
+  FakeTransceiverI2CApi bus(8, 4, std::chrono::milliseconds(1));
+  bus.absentPort = 7;
+  auto ports = portRange(1, 32);
+
+  auto dumps = dumpTransceivers(&bus, ports);
+  ASSERT_EQ(ports.size(), dumps.size());
+  for (auto port : ports) {
+    const auto& dump = dumps[port];
+    if (port == bus.absentPort) {
+      EXPECT_FALSE(dump.data);
+      EXPECT_FALSE(dump.error.empty());
+    } else {
+      ASSERT_TRUE(dump.data);
+      EXPECT_EQ(port, dump.data->lower.data()[0]);
+      EXPECT_TRUE(dump.data->__isset.page3);
+    }
+  }
+  // Buses were read in parallel, but each one a transaction at a time
+  EXPECT_GT(bus.getMaxConcurrent(), 1);
+  EXPECT_FALSE(bus.overlapped());
+}
+
+TEST(TransceiverDumpTest, json) {
+  FakeTransceiverI2CApi bus(2, 2, std::chrono::microseconds(0));
+  bus.absentPort = 2;
+
+  auto json = transceiverDumpToDynamic(dumpTransceivers(&bus, {1, 2}));
+  EXPECT_TRUE(json["1"]["present"].asBool());
+  EXPECT_EQ(1, json["1"]["identifier"].asInt());
+  EXPECT_EQ(4, json["1"]["channels"].size());
+  EXPECT_EQ(256, json["1"]["lower"].asString().size());
+  EXPECT_TRUE(json["1"].count("page3"));
+  EXPECT_FALSE(json["2"]["present"].asBool());
+  EXPECT_FALSE(json["2"]["error"].asString().empty());
+}
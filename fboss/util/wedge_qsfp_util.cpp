@@ -1,5 +1,6 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 #include "fboss/util/wedge_qsfp_util.h"
+#include "fboss/util/TransceiverDump.h"
 
 #include "fboss/lib/usb/WedgeI2CBus.h"
 #include "fboss/lib/usb/Wedge100I2CBus.h"
@@ -11,6 +12,7 @@
 #include <folly/Exception.h>
 #include <folly/FileUtil.h>
 #include <folly/Memory.h>
+#include <folly/json.h>
 #include <folly/init/Init.h>
 #include <folly/io/async/EventBase.h>
 #include <gflags/gflags.h>
@@ -64,6 +66,12 @@ DEFINE_bool(optical_loopback, false,
             "Set the module to be optical loopback, only for Miniphoton");
 DEFINE_bool(clear_loopback, false,
             "Clear the module loopback bits, only for Miniphoton");
+DEFINE_bool(parallel_dump, false,
+    "With --direct_i2c, read the ports of independent buses concurrently, "
+    "and print them once all are read");
+DEFINE_bool(json, false,
+    "With --direct_i2c, print the transceiver data as JSON. Implies "
+    "--parallel_dump");
 
 enum LoopbackMode {
   noLoopback,
@@ -201,49 +209,6 @@ std::map<int32_t, RawDOMData> fetchDataFromQsfpService(
   return rawDOMDataMap;
 }
 
-RawDOMData fetchDataFromLocalI2CBus(TransceiverI2CApi* bus, unsigned int port) {
-  RawDOMData rawDOMData;
-  rawDOMData.lower = IOBuf(IOBuf::CREATE, 128);
-  rawDOMData.page0 = IOBuf(IOBuf::CREATE, 128);
-
-  // Read the lower 128 bytes.
-  bus->moduleRead(port, TransceiverI2CApi::ADDR_QSFP, 0,
-    128, rawDOMData.lower.writableData());
-
-  uint8_t flatMem = rawDOMData.lower.data()[2] & (1 << 2);
-
-  // Read page 0 from the upper 128 bytes.
-  // First see if we need to select page 0.
-  if (!flatMem) {
-    uint8_t page0 = 0;
-    if (rawDOMData.lower.data()[127] != page0) {
-      bus->moduleWrite(port, TransceiverI2CApi::ADDR_QSFP,
-                       127, 1, &page0);
-      usleep(20000); // Delay required by Intel Transceiver.
-    }
-  }
-  bus->moduleRead(port, TransceiverI2CApi::ADDR_QSFP, 128,
-    128, rawDOMData.page0.writableData());
-
-  // Make sure page3 exist
-  if (!flatMem) {
-    rawDOMData.page3_ref().value_unchecked() = IOBuf(IOBuf::CREATE, 128);
-    uint8_t page3 = 0x3;
-    bus->moduleWrite(port, TransceiverI2CApi::ADDR_QSFP, 127, 1, &page3);
-    usleep(20000); // Delay required by Intel Transceiver.
-
-    // read page 3
-    bus->moduleRead(
-        port,
-        TransceiverI2CApi::ADDR_QSFP,
-        128,
-        128,
-        rawDOMData.page3_ref().value_unchecked().writableData());
-    rawDOMData.__isset.page3 = true;
-  }
-  return rawDOMData;
-}
-
 void printPortSummary(TransceiverI2CApi*) {
   // TODO: Implement code for showing a summary of all ports.
   // At the moment I haven't tested this since my test switch has some
@@ -556,6 +521,28 @@ bool doMiniphotonLoopback(TransceiverI2CApi* bus, unsigned int port, LoopbackMod
   return true;
 }
 
+/* Read all the ports, concurrently on independent buses, then print them
+ * in order, as JSON if asked to.
+ */
+int dumpPorts(TransceiverI2CApi* bus, const std::vector<unsigned int>& ports) {
+  auto dumps = dumpTransceivers(bus, ports);
+  if (FLAGS_json) {
+    printf(
+        "%s\n", folly::toPrettyJson(transceiverDumpToDynamic(dumps)).c_str());
+  }
+
+  int retcode = EX_OK;
+  for (const auto& [portNum, dump] : dumps) {
+    if (!dump.data) {
+      fprintf(stderr, "Port %d: %s\n", portNum, dump.error.c_str());
+      retcode = EX_SOFTWARE;
+    } else if (!FLAGS_json) {
+      printPortDetail(*dump.data, portNum);
+    }
+  }
+  return retcode;
+}
+
 int main(int argc, char* argv[]) {
   folly::init(&argc, &argv, true);
   gflags::SetCommandLineOptionWithMode(
@@ -649,6 +636,11 @@ int main(int argc, char* argv[]) {
     return EX_OK;
   }
 
+  if (FLAGS_direct_i2c && printInfo &&
+      (FLAGS_parallel_dump || FLAGS_json)) {
+    return dumpPorts(bus.get(), ports);
+  }
+
   int retcode = EX_OK;
   for (unsigned int portNum : ports) {
     if (FLAGS_clear_low_power && overrideLowPower(bus.get(), portNum, 0x5)) {